@@ -0,0 +1,326 @@
+#!/usr/bin/env python3
+"""
+Dispatch-throughput benchmark for the PTO runtime.
+
+Launches synthetic task graphs (see orchestration/bench_orch.cpp) whose
+kernels do nothing or spin for a fixed time, so the measured time is the
+runtime's own overhead. Sweeps graph shape, task count, block_dim,
+aicpu_thread_num and core partitioning, and writes the results as JSON.
+
+Usage:
+    # Simulation (no hardware required)
+    python examples/dispatch_benchmark/bench_dispatch.py -p a2a3sim -o results.json
+
+    # Hardware, 2 us kernels, selected shapes
+    python examples/dispatch_benchmark/bench_dispatch.py -p a2a3 --kernel-us 2 \\
+        --shapes chain,fan --tasks 1000,10000 --block-dims 4,24 --threads 1,2,4
+
+    # Uneven splits, static against dynamic core partitioning
+    python examples/dispatch_benchmark/bench_dispatch.py -p a2a3sim --block-dims 5,7 --threads 2,3 \
+        --partitioning static,dynamic
+
+    # Fail if throughput dropped more than 10% against an earlier run
+    python examples/dispatch_benchmark/bench_dispatch.py -p a2a3sim --baseline old.json
+
+Metrics per configuration (medians over --repeat launches):
+    tasks_per_sec               Tasks divided by the scheduler run time
+    sched_overhead_us_per_task  Run time beyond the ideal makespan (kernels
+                                only, no scheduler cost; Runtime.predict()),
+                                divided by the task count
+    launch_latency_us           Host wall time of launch_runtime() beyond
+                                the scheduler run time
+"""
+
+import argparse
+import contextlib
+import importlib.util
+import json
+import os
+import platform as host_platform
+import statistics
+import sys
+import time
+from pathlib import Path
+
+# Graph shapes: name -> (BenchShape in bench_orch.cpp, percent of AIC tasks)
+SHAPES = {
+    "chain": (0, 0),
+    "fan": (1, 0),
+    "diamond": (2, 0),
+    "layered": (3, 0),
+    "mixed": (3, 34),
+}
+
+# Runtime::core_partitioning values (CorePartitioning in runtime.h)
+PARTITIONING = {
+    "static": 0,
+    "dynamic": 1,
+}
+
+_BENCH_DIR = Path(__file__).parent.resolve()
+_PROJECT_ROOT = _BENCH_DIR.parent.parent
+
+
+def _load_module_from_path(module_path: Path, module_name: str):
+    """Dynamically load a Python module from file path."""
+    spec = importlib.util.spec_from_file_location(module_name, module_path)
+    if spec is None or spec.loader is None:
+        raise ImportError(f"Cannot load module from {module_path}")
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+def _int_list(text: str):
+    return [int(x) for x in text.split(",") if x]
+
+
+@contextlib.contextmanager
+def _quiet(enabled: bool):
+    """Send the runtime's stdout logging to /dev/null while enabled."""
+    if not enabled:
+        yield
+        return
+    sys.stdout.flush()
+    saved = os.dup(1)
+    devnull = os.open(os.devnull, os.O_WRONLY)
+    try:
+        os.dup2(devnull, 1)
+        yield
+    finally:
+        sys.stdout.flush()
+        os.dup2(saved, 1)
+        os.close(devnull)
+        os.close(saved)
+
+
+class DispatchBenchmark:
+    """
+    Builds the runtime and benchmark kernels once, then measures one graph
+    configuration per run_case() call.
+    """
+
+    def __init__(self, platform: str, device_id: int, kernel_us: float, width: int, seed: int,
+                 repeat: int, warmup: int, quiet: bool = True):
+        self.platform = platform
+        self.device_id = device_id
+        self.kernel_us = kernel_us
+        self.width = width
+        self.seed = seed
+        self.repeat = repeat
+        self.warmup = warmup
+        self.quiet = quiet
+
+        kernels_dir = _BENCH_DIR / ("sim_kernels" if platform == "a2a3sim" else "kernels")
+        self._config = _load_module_from_path(kernels_dir / "kernel_config.py", "dispatch_bench_kernel_config")
+
+    def setup(self) -> None:
+        """Build the runtime, set the device and register the kernels."""
+        from runtime_builder import RuntimeBuilder
+        from bindings import bind_host_binary, register_kernel, set_device
+        from elf_parser import extract_text_section
+
+        if self.platform == "a2a3" and not os.environ.get("ASCEND_HOME_PATH"):
+            raise EnvironmentError("ASCEND_HOME_PATH not set")
+
+        with _quiet(self.quiet):
+            builder = RuntimeBuilder(runtime_root=_PROJECT_ROOT, platform=self.platform)
+            compiler = builder.get_pto_compiler()
+            host_binary, self._aicpu_binary, self._aicore_binary = builder.build("host_build_graph")
+            self._Runtime = bind_host_binary(host_binary)
+            set_device(self.device_id)
+
+            orch = self._config.ORCHESTRATION
+            self._orch_binary = compiler.compile_orchestration(
+                orch["source"],
+                extra_include_dirs=[str(_PROJECT_ROOT / "src" / "runtime" / "host_build_graph" / "runtime")]
+                + compiler.get_platform_include_dirs(),
+            )
+            self._orch_function = orch["function_name"]
+
+            pto_isa_root = os.environ.get("PTO_ISA_ROOT", "/tmp/unused")
+            for kernel in self._config.KERNELS:
+                incore_o = compiler.compile_incore(kernel["source"], core_type=kernel["core_type"],
+                                                   pto_isa_root=pto_isa_root)
+                register_kernel(kernel["func_id"], extract_text_section(incore_o))
+
+    def run_case(self, shape: str, tasks: int, block_dim: int, threads: int, partitioning: str) -> dict:
+        """
+        Build one graph, launch it warmup + repeat times and return its metrics.
+        """
+        from bindings import CostModel, launch_runtime
+
+        shape_id, aic_percent = SHAPES[shape]
+        func_args = [shape_id, tasks, self.width, self.seed, aic_percent, int(self.kernel_us * 1000),
+                     self._config.COUNTER_TICKS_PER_MS, PARTITIONING[partitioning]]
+
+        runs, walls, stats = [], [], []
+        with _quiet(self.quiet):
+            runtime = self._Runtime()
+            start = time.perf_counter()
+            runtime.initialize(self._orch_binary, self._orch_function, func_args)
+            build_us = (time.perf_counter() - start) * 1e6
+            try:
+                for i in range(self.warmup + self.repeat):
+                    start = time.perf_counter()
+                    launch_runtime(runtime, aicpu_thread_num=threads, block_dim=block_dim,
+                                   device_id=self.device_id, aicpu_binary=self._aicpu_binary,
+                                   aicore_binary=self._aicore_binary)
+                    wall_us = (time.perf_counter() - start) * 1e6
+                    if i >= self.warmup:
+                        launch_stats = runtime.get_stats()
+                        runs.append(launch_stats["run_us"])
+                        walls.append(wall_us)
+                        stats.append(launch_stats)
+                # Makespan with the kernels alone: what a free scheduler would
+                # reach with the threads the launches actually used
+                ideal_us = runtime.predict(CostModel(default_us=self.kernel_us), block_dim,
+                                           stats[0]["thread_count"])["makespan_us"]
+            finally:
+                runtime.finalize()
+
+        run_us = statistics.median(runs)
+        wall_us = statistics.median(walls)
+        median_stats = min(stats, key=lambda s: abs(s["run_us"] - run_us))
+        loops = median_stats["loop_iterations"]
+        return {
+            "shape": shape,
+            "tasks": tasks,
+            "block_dim": block_dim,
+            "aicpu_thread_num": threads,
+            "threads_used": median_stats["thread_count"],
+            "partitioning": partitioning,
+            "kernel_us": self.kernel_us,
+            "build_us": build_us,
+            "run_us": run_us,
+            "wall_us": wall_us,
+            "ideal_us": ideal_us,
+            "tasks_per_sec": tasks / run_us * 1e6 if run_us > 0 else 0.0,
+            "sched_overhead_us_per_task": max(run_us - ideal_us, 0.0) / tasks,
+            "launch_latency_us": max(wall_us - run_us, 0.0),
+            "avg_dispatch_latency_us": median_stats["avg_dispatch_latency_us"],
+            "max_dispatch_latency_us": median_stats["max_dispatch_latency_us"],
+            "queue_op_us": median_stats["queue_op_us"],
+            "idle_fraction": median_stats["idle_iterations"] / loops if loops else 0.0,
+            "blocks_migrated": median_stats["blocks_migrated"],
+        }
+
+
+def _case_key(result: dict):
+    return (result["shape"], result["tasks"], result["block_dim"], result["aicpu_thread_num"], result["kernel_us"],
+            result.get("partitioning", "static"))
+
+
+def compare_with_baseline(results: list, baseline_path: Path, tolerance: float) -> list:
+    """
+    Return the results whose throughput dropped by more than tolerance
+    (a fraction) against the same configuration in a baseline file.
+    """
+    with open(baseline_path) as f:
+        baseline = {_case_key(r): r for r in json.load(f)["results"]}
+    regressions = []
+    for result in results:
+        old = baseline.get(_case_key(result))
+        if old is None or old["tasks_per_sec"] <= 0:
+            continue
+        change = result["tasks_per_sec"] / old["tasks_per_sec"] - 1.0
+        if change < -tolerance:
+            regressions.append((result, old, change))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Measure PTO runtime dispatch throughput on synthetic task graphs",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog=__doc__.split("Usage:")[1],
+    )
+    parser.add_argument("-p", "--platform", default="a2a3sim", choices=["a2a3", "a2a3sim"],
+                        help="Platform name (default: a2a3sim)")
+    parser.add_argument("-d", "--device", type=int, default=int(os.environ.get("PTO_DEVICE_ID", "0")),
+                        help="Device ID (default: from PTO_DEVICE_ID env or 0)")
+    parser.add_argument("--shapes", default=",".join(SHAPES),
+                        help=f"Comma-separated graph shapes out of {', '.join(SHAPES)} (default: all)")
+    parser.add_argument("--tasks", default="1000,10000", help="Comma-separated task counts (default: 1000,10000)")
+    parser.add_argument("--block-dims", default="1,2,4", help="Comma-separated block_dim values (default: 1,2,4)")
+    parser.add_argument("--threads", default="1,2,4",
+                        help="Comma-separated aicpu_thread_num values, 0 = one per available AICPU "
+                             "(default: 1,2,4)")
+    parser.add_argument("--partitioning", default="static",
+                        help=f"Comma-separated core partitioning modes out of {', '.join(PARTITIONING)} "
+                             "(default: static)")
+    parser.add_argument("--kernel-us", type=float, default=0.0,
+                        help="Kernel duration in microseconds, 0 for no-op kernels (default: 0)")
+    parser.add_argument("--width", type=int, default=16,
+                        help="Parallel tasks per diamond or layer (default: 16)")
+    parser.add_argument("--seed", type=int, default=1, help="Seed of the random graphs (default: 1)")
+    parser.add_argument("--repeat", type=int, default=5, help="Measured launches per configuration (default: 5)")
+    parser.add_argument("--warmup", type=int, default=1, help="Unmeasured launches first (default: 1)")
+    parser.add_argument("-o", "--output", help="Write the results to this JSON file")
+    parser.add_argument("--baseline", help="Compare throughput with a JSON file from an earlier run")
+    parser.add_argument("--tolerance", type=float, default=0.1,
+                        help="Throughput drop counted as a regression (default: 0.1 = 10%%)")
+    parser.add_argument("-v", "--verbose", action="store_true", help="Show the runtime's own output")
+    args = parser.parse_args()
+
+    shapes = [s for s in args.shapes.split(",") if s]
+    unknown = [s for s in shapes if s not in SHAPES]
+    if unknown:
+        parser.error(f"unknown shape(s): {', '.join(unknown)}")
+    partitionings = [p for p in args.partitioning.split(",") if p]
+    unknown = [p for p in partitionings if p not in PARTITIONING]
+    if unknown:
+        parser.error(f"unknown partitioning mode(s): {', '.join(unknown)}")
+
+    sys.path.insert(0, str(_PROJECT_ROOT / "python"))
+
+    bench = DispatchBenchmark(args.platform, args.device, args.kernel_us, args.width, args.seed,
+                              args.repeat, args.warmup, quiet=not args.verbose)
+    print(f"=== Building runtime and kernels ({args.platform}) ===")
+    bench.setup()
+
+    results = []
+    header = f"{'shape':<8} {'tasks':>7} {'blocks':>6} {'thr':>3} {'part':<7} {'tasks/s':>12} " \
+             f"{'ovh us/task':>11} {'launch us':>10} {'run us':>11}"
+    print(header)
+    print("-" * len(header))
+    for shape in shapes:
+        for tasks in _int_list(args.tasks):
+            for block_dim in _int_list(args.block_dims):
+                for threads in _int_list(args.threads):
+                    for partitioning in partitionings:
+                        r = bench.run_case(shape, tasks, block_dim, threads, partitioning)
+                        results.append(r)
+                        print(f"{shape:<8} {tasks:>7} {block_dim:>6} {r['threads_used']:>3} {partitioning:<7} "
+                              f"{r['tasks_per_sec']:>12.0f} {r['sched_overhead_us_per_task']:>11.3f} "
+                              f"{r['launch_latency_us']:>10.1f} {r['run_us']:>11.1f}", flush=True)
+
+    report = {
+        "platform": args.platform,
+        "host": host_platform.node(),
+        "timestamp": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "sim_engine": os.environ.get("PTO_SIM_ENGINE", "") if args.platform == "a2a3sim" else "",
+        "width": args.width,
+        "seed": args.seed,
+        "repeat": args.repeat,
+        "results": results,
+    }
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(report, f, indent=2)
+        print(f"\nWrote {len(results)} results to {args.output}")
+
+    if args.baseline:
+        regressions = compare_with_baseline(results, Path(args.baseline), args.tolerance)
+        for result, old, change in regressions:
+            print(f"REGRESSION {result['shape']} tasks={result['tasks']} block_dim={result['block_dim']} "
+                  f"threads={result['aicpu_thread_num']} {result['partitioning']}: {old['tasks_per_sec']:.0f} -> "
+                  f"{result['tasks_per_sec']:.0f} tasks/s ({change:+.1%})")
+        if regressions:
+            return 1
+        print(f"\nNo throughput regression beyond {args.tolerance:.0%} against {args.baseline}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
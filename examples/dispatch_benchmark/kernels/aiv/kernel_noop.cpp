@@ -0,0 +1,29 @@
+/**
+ * No-op Kernel
+ *
+ * Returns right away. A graph of no-op tasks runs as fast as the AICPU
+ * scheduler can dispatch and retire them, so its launch time is pure
+ * runtime overhead.
+ *
+ * The kernel touches neither cube nor vector units; kernel_config.py builds
+ * the same source for AIC and AIV cores.
+ */
+
+#include <cstdint>
+
+#ifndef __gm__
+#define __gm__
+#endif
+
+#ifndef __aicore__
+#define __aicore__ [aicore]
+#endif
+
+/**
+ * No-op kernel implementation
+ *
+ * @param args  Argument array (unused)
+ */
+extern "C" __aicore__ __attribute__((always_inline)) void kernel_noop(__gm__ int64_t* args) {
+    (void)args;
+}
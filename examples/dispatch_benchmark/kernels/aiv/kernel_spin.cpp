@@ -0,0 +1,32 @@
+/**
+ * Fixed-Duration Kernel
+ *
+ * Busy-waits on the system counter for a given number of ticks, giving
+ * every task the same known latency independent of memory bandwidth.
+ *
+ * The kernel touches neither cube nor vector units; kernel_config.py builds
+ * the same source for AIC and AIV cores.
+ */
+
+#include <cstdint>
+
+#ifndef __gm__
+#define __gm__
+#endif
+
+#ifndef __aicore__
+#define __aicore__ [aicore]
+#endif
+
+/**
+ * Fixed-duration kernel implementation
+ *
+ * @param args  Argument array:
+ *              args[0] = duration in system counter ticks (50 MHz)
+ */
+extern "C" __aicore__ __attribute__((always_inline)) void kernel_spin(__gm__ int64_t* args) {
+    uint64_t ticks = static_cast<uint64_t>(args[0]);
+    uint64_t start = get_sys_cnt();
+    while (get_sys_cnt() - start < ticks) {
+    }
+}
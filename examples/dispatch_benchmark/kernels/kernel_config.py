@@ -0,0 +1,28 @@
+"""
+Kernel and Orchestration Configuration (Dispatch Benchmark)
+
+No-op and fixed-duration kernels for measuring the runtime on a2a3. The
+kernels use no cube or vector instructions, so the same sources are built
+for AIV (func_ids 0, 1) and AIC (func_ids 2, 3) cores.
+"""
+
+from pathlib import Path
+
+_KERNELS_ROOT = Path(__file__).parent
+
+# Orchestration config (shared with sim_kernels)
+ORCHESTRATION = {
+    "source": str(_KERNELS_ROOT.parent / "orchestration" / "bench_orch.cpp"),
+    "function_name": "build_bench_graph",
+}
+
+# Frequency of the counter kernel_spin reads (system counter, 50 MHz)
+COUNTER_TICKS_PER_MS = 50000
+
+# Kernel configs
+KERNELS = [
+    {"func_id": 0, "source": str(_KERNELS_ROOT / "aiv" / "kernel_noop.cpp"), "core_type": "aiv"},
+    {"func_id": 1, "source": str(_KERNELS_ROOT / "aiv" / "kernel_spin.cpp"), "core_type": "aiv"},
+    {"func_id": 2, "source": str(_KERNELS_ROOT / "aiv" / "kernel_noop.cpp"), "core_type": "aic"},
+    {"func_id": 3, "source": str(_KERNELS_ROOT / "aiv" / "kernel_spin.cpp"), "core_type": "aic"},
+]
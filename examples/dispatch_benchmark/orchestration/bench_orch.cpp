@@ -0,0 +1,182 @@
+/**
+ * Dispatch Benchmark Orchestration
+ *
+ * Generates synthetic task graphs for measuring the runtime itself. The
+ * kernels do no work (or spin for a fixed time), so launch time is
+ * scheduling, dispatch and completion overhead.
+ *
+ * Graph shapes (args[0]):
+ * - BENCH_CHAIN:   t0 -> t1 -> ... -> tN-1; one task ready at a time, so
+ *                  every task pays the full dispatch/complete round trip
+ * - BENCH_FAN:     one root -> N-2 parallel tasks -> one sink; stresses
+ *                  releasing and joining very wide fan-out/fan-in
+ * - BENCH_DIAMOND: stacked diamonds, join -> `width` tasks -> join -> ...
+ * - BENCH_LAYERED: random layered DAG, layers of `width` tasks, each task
+ *                  depending on 1-3 random tasks of the previous layer
+ *
+ * Every shape can mix AIC and AIV tasks: aic_percent of the tasks (chosen
+ * pseudo-randomly from the seed) run on AIC cores, the rest on AIV.
+ */
+
+#include "runtime.h"
+#include "host_counter.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+enum BenchShape {
+    BENCH_CHAIN = 0,
+    BENCH_FAN = 1,
+    BENCH_DIAMOND = 2,
+    BENCH_LAYERED = 3,
+};
+
+// func_ids, matching kernel_config.py
+constexpr int FUNC_NOOP_AIV = 0;
+constexpr int FUNC_SPIN_AIV = 1;
+constexpr int FUNC_NOOP_AIC = 2;
+constexpr int FUNC_SPIN_AIC = 3;
+
+constexpr int CORE_AIC = 0;
+constexpr int CORE_AIV = 1;
+
+// Deterministic generator, so a seed always yields the same graph
+struct Lcg {
+    uint64_t state;
+    uint32_t next() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<uint32_t>(state >> 33);
+    }
+};
+
+/**
+ * Measure the host counter the simulation spin kernel reads
+ *
+ * @return Counter ticks per millisecond
+ */
+uint64_t calibrate_host_counter() {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t ticks_start = read_host_counter();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t ticks = read_host_counter() - ticks_start;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<uint64_t>(ticks / ms);
+}
+
+}  // namespace
+
+extern "C" {
+
+/**
+ * Build a synthetic benchmark graph
+ *
+ * Expected args: [shape, task_count, width, seed, aic_percent, kernel_ns,
+ *                 counter_ticks_per_ms, core_partitioning (optional)]
+ * - kernel_ns = 0 runs the no-op kernels, otherwise the spin kernels busy
+ *   wait kernel_ns nanoseconds
+ * - counter_ticks_per_ms is the frequency of the counter the spin kernels
+ *   read (a2a3: 50000); 0 measures the host counter (a2a3sim)
+ * - core_partitioning is a CorePartitioning value (default: static)
+ */
+int build_bench_graph(Runtime* runtime, uint64_t* args, int arg_count) {
+    if (arg_count < 7) {
+        std::cerr << "build_bench_graph: Expected at least 7 args, got " << arg_count << '\n';
+        return -1;
+    }
+
+    int shape = static_cast<int>(args[0]);
+    int task_count = static_cast<int>(args[1]);
+    int width = static_cast<int>(args[2]);
+    Lcg rng{args[3]};
+    uint32_t aic_percent = static_cast<uint32_t>(args[4]);
+    uint64_t kernel_ns = args[5];
+    uint64_t ticks_per_ms = args[6];
+    if (arg_count > 7) {
+        runtime->core_partitioning = static_cast<int>(args[7]);
+    }
+
+    if (task_count < 1 || width < 1 || shape < BENCH_CHAIN || shape > BENCH_LAYERED) {
+        std::cerr << "build_bench_graph: Invalid shape " << shape << ", task_count " << task_count
+                  << " or width " << width << '\n';
+        return -1;
+    }
+
+    uint64_t spin_ticks = 0;
+    if (kernel_ns > 0) {
+        if (ticks_per_ms == 0) {
+            // Once per process; the loaded orchestration SO is cached
+            static const uint64_t host_ticks_per_ms = calibrate_host_counter();
+            ticks_per_ms = host_ticks_per_ms;
+        }
+        spin_ticks = kernel_ns * ticks_per_ms / 1000000;
+    }
+
+    std::cout << "\n=== build_bench_graph: shape " << shape << ", " << task_count << " tasks, width " << width
+              << ", " << aic_percent << "% AIC, kernel " << kernel_ns << " ns ===" << '\n';
+
+    // Task ids are handed out in order, so task i of the graph is id i
+    uint64_t task_args[1] = {spin_ticks};
+    for (int i = 0; i < task_count; i++) {
+        bool aic = rng.next() % 100 < aic_percent;
+        int func_id = aic ? (kernel_ns > 0 ? FUNC_SPIN_AIC : FUNC_NOOP_AIC)
+                          : (kernel_ns > 0 ? FUNC_SPIN_AIV : FUNC_NOOP_AIV);
+        if (runtime->add_task(task_args, 1, func_id, aic ? CORE_AIC : CORE_AIV) != i) {
+            std::cerr << "Error: Failed to add task " << i << '\n';
+            return -1;
+        }
+    }
+
+    switch (shape) {
+        case BENCH_CHAIN:
+            for (int i = 1; i < task_count; i++) {
+                runtime->add_successor(i - 1, i);
+            }
+            break;
+
+        case BENCH_FAN:
+            for (int i = 1; i < task_count - 1; i++) {
+                runtime->add_successor(0, i);
+                runtime->add_successor(i, task_count - 1);
+            }
+            if (task_count == 2) {
+                runtime->add_successor(0, 1);
+            }
+            break;
+
+        case BENCH_DIAMOND:
+            // Joins at 0, width + 1, 2 * (width + 1), ...; a short last
+            // group has no join
+            for (int join = 0; join < task_count; join += width + 1) {
+                int next_join = join + width + 1;
+                for (int i = join + 1; i < next_join && i < task_count; i++) {
+                    runtime->add_successor(join, i);
+                    if (next_join < task_count) {
+                        runtime->add_successor(i, next_join);
+                    }
+                }
+            }
+            break;
+
+        case BENCH_LAYERED:
+            for (int layer = width; layer < task_count; layer += width) {
+                int prev = layer - width;
+                for (int i = layer; i < layer + width && i < task_count; i++) {
+                    int fanin = 1 + static_cast<int>(rng.next() % 3);
+                    int first = static_cast<int>(rng.next() % width);
+                    // Distinct predecessors: consecutive tasks of the previous layer
+                    for (int k = 0; k < fanin && k < width; k++) {
+                        runtime->add_successor(prev + (first + k) % width, i);
+                    }
+                }
+            }
+            break;
+    }
+
+    std::cout << "Created runtime with " << runtime->get_task_count() << " tasks\n";
+    return 0;
+}
+
+}  // extern "C"
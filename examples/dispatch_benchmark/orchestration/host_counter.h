@@ -0,0 +1,29 @@
+/**
+ * Host Cycle Counter
+ *
+ * Read by the simulation spin kernel and calibrated by the orchestration.
+ * Simulation kernels are loaded as a bare .text section and cannot call
+ * into libc (std::chrono, clock_gettime), so the counter is read with a
+ * single instruction instead.
+ */
+
+#ifndef DISPATCH_BENCHMARK_HOST_COUNTER_H
+#define DISPATCH_BENCHMARK_HOST_COUNTER_H
+
+#include <cstdint>
+
+static inline __attribute__((always_inline)) uint64_t read_host_counter() {
+#if defined(__x86_64__)
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+#error "read_host_counter: unsupported host architecture"
+#endif
+}
+
+#endif  // DISPATCH_BENCHMARK_HOST_COUNTER_H
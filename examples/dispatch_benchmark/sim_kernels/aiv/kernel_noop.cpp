@@ -0,0 +1,18 @@
+/**
+ * No-op Kernel (Simulation)
+ *
+ * Returns right away. A graph of no-op tasks runs as fast as the AICPU
+ * scheduler can dispatch and retire them, so its launch time is pure
+ * runtime overhead. Used for both AIC and AIV tasks.
+ */
+
+#include <cstdint>
+
+/**
+ * No-op kernel implementation
+ *
+ * @param args  Argument array (unused)
+ */
+extern "C" void kernel_noop(int64_t* args) {
+    (void)args;
+}
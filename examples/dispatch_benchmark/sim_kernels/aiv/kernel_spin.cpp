@@ -0,0 +1,24 @@
+/**
+ * Fixed-Duration Kernel (Simulation)
+ *
+ * Busy-waits on the host cycle counter for a given number of ticks. The
+ * orchestration converts the requested duration with the counter frequency
+ * it measured. Used for both AIC and AIV tasks.
+ */
+
+#include <cstdint>
+
+#include "../../orchestration/host_counter.h"
+
+/**
+ * Fixed-duration kernel implementation
+ *
+ * @param args  Argument array:
+ *              args[0] = duration in host counter ticks
+ */
+extern "C" void kernel_spin(int64_t* args) {
+    uint64_t ticks = static_cast<uint64_t>(args[0]);
+    uint64_t start = read_host_counter();
+    while (read_host_counter() - start < ticks) {
+    }
+}
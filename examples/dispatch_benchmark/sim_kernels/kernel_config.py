@@ -0,0 +1,28 @@
+"""
+Kernel and Orchestration Configuration (Dispatch Benchmark, Simulation)
+
+No-op and fixed-duration kernels for measuring the runtime on a2a3sim.
+Simulation kernels are plain C++ compiled with g++; the same sources serve
+AIV (func_ids 0, 1) and AIC (func_ids 2, 3) tasks.
+"""
+
+from pathlib import Path
+
+_KERNELS_ROOT = Path(__file__).parent
+
+# Orchestration config (shared with kernels)
+ORCHESTRATION = {
+    "source": str(_KERNELS_ROOT.parent / "orchestration" / "bench_orch.cpp"),
+    "function_name": "build_bench_graph",
+}
+
+# kernel_spin reads the host cycle counter; 0 lets the orchestration measure it
+COUNTER_TICKS_PER_MS = 0
+
+# Kernel configs (simulation kernels, compiled with g++)
+KERNELS = [
+    {"func_id": 0, "source": str(_KERNELS_ROOT / "aiv" / "kernel_noop.cpp"), "core_type": "aiv"},
+    {"func_id": 1, "source": str(_KERNELS_ROOT / "aiv" / "kernel_spin.cpp"), "core_type": "aiv"},
+    {"func_id": 2, "source": str(_KERNELS_ROOT / "aiv" / "kernel_noop.cpp"), "core_type": "aic"},
+    {"func_id": 3, "source": str(_KERNELS_ROOT / "aiv" / "kernel_spin.cpp"), "core_type": "aic"},
+]
@@ -3,10 +3,44 @@
  *
  * Implements: out[i] = src[i] + scalar
  *
- * This is a simple loop-based implementation for simulation.
+ * Written with the same PTO tile instructions as the a2a3 kernel; the
+ * simulation versions (src/platform/a2a3sim/aicore/pto) run them with
+ * host SIMD. Unlike the a2a3 kernel, which handles one 128x128 tile, this
+ * one walks the whole tensor in 8x128 blocks, small enough for the tiles
+ * to stay in the host's L1 cache; a partial last row goes in a single-row
+ * tile.
  */
 
 #include <cstdint>
+#include <pto/pto-inst.hpp>
+#include <pto/common/constants.hpp>
+
+using namespace pto;
+
+constexpr int kTRows_ = 8;
+constexpr int kTCols_ = 128;
+
+using GlobalData = GlobalTensor<float, Shape<1, 1, 1, kTRows_, kTCols_>, Stride<1, 1, 1, kTCols_, 1>>;
+using TileData = Tile<TileType::Vec, float, kTRows_, kTCols_, BLayout::RowMajor, -1, -1>;
+
+static __attribute__((always_inline)) inline void add_scalar_block(float* src, float scalar, float* out, int rows,
+    int cols) {
+    TileData srcTile(rows, cols);
+    TileData dstTile(rows, cols);
+    TASSIGN(srcTile, 0x0);
+    TASSIGN(dstTile, 0x10000);
+
+    GlobalData srcGlobal(src);
+    GlobalData dstGlobal(out);
+
+    TLOAD(srcTile, srcGlobal);
+    set_flag(PIPE_MTE2, PIPE_V, EVENT_ID0);
+    wait_flag(PIPE_MTE2, PIPE_V, EVENT_ID0);
+    TADDS(dstTile, srcTile, scalar);
+    set_flag(PIPE_V, PIPE_MTE3, EVENT_ID0);
+    wait_flag(PIPE_V, PIPE_MTE3, EVENT_ID0);
+    TSTORE(dstGlobal, dstTile);
+}
 
 /**
  * Tensor + scalar addition kernel implementation
@@ -31,7 +65,11 @@ extern "C" void kernel_add_scalar(int64_t* args) {
     float* out = reinterpret_cast<float*>(args[2]);
     int size = static_cast<int>(args[3]);
 
-    for (int i = 0; i < size; i++) {
-        out[i] = src[i] + scalar;
+    for (int offset = 0; offset < size;) {
+        int count = size - offset < kTRows_ * kTCols_ ? size - offset : kTRows_ * kTCols_;
+        int rows = count / kTCols_;
+        int cols = rows > 0 ? kTCols_ : count;
+        add_scalar_block(src + offset, scalar, out + offset, rows > 0 ? rows : 1, cols);
+        offset += rows > 0 ? rows * kTCols_ : count;
     }
 }
@@ -3,10 +3,48 @@
  *
  * Implements: out[i] = src0[i] * src1[i]
  *
- * This is a simple loop-based implementation for simulation.
+ * Written with the same PTO tile instructions as the a2a3 kernel; the
+ * simulation versions (src/platform/a2a3sim/aicore/pto) run them with
+ * host SIMD. Unlike the a2a3 kernel, which handles one 128x128 tile, this
+ * one walks the whole tensor in 8x128 blocks, small enough for the tiles
+ * to stay in the host's L1 cache; a partial last row goes in a single-row
+ * tile.
  */
 
 #include <cstdint>
+#include <pto/pto-inst.hpp>
+#include <pto/common/constants.hpp>
+
+using namespace pto;
+
+constexpr int kTRows_ = 8;
+constexpr int kTCols_ = 128;
+
+using GlobalData = GlobalTensor<float, Shape<1, 1, 1, kTRows_, kTCols_>, Stride<1, 1, 1, kTCols_, 1>>;
+using TileData = Tile<TileType::Vec, float, kTRows_, kTCols_, BLayout::RowMajor, -1, -1>;
+
+static __attribute__((always_inline)) inline void kernel_mul_block(float* src0, float* src1, float* out, int rows,
+    int cols) {
+    TileData src0Tile(rows, cols);
+    TileData src1Tile(rows, cols);
+    TileData dstTile(rows, cols);
+    TASSIGN(src0Tile, 0x0);
+    TASSIGN(src1Tile, 0x10000);
+    TASSIGN(dstTile, 0x20000);
+
+    GlobalData src0Global(src0);
+    GlobalData src1Global(src1);
+    GlobalData dstGlobal(out);
+
+    TLOAD(src0Tile, src0Global);
+    TLOAD(src1Tile, src1Global);
+    set_flag(PIPE_MTE2, PIPE_V, EVENT_ID0);
+    wait_flag(PIPE_MTE2, PIPE_V, EVENT_ID0);
+    TMUL(dstTile, src0Tile, src1Tile);
+    set_flag(PIPE_V, PIPE_MTE3, EVENT_ID0);
+    wait_flag(PIPE_V, PIPE_MTE3, EVENT_ID0);
+    TSTORE(dstGlobal, dstTile);
+}
 
 /**
  * Element-wise multiplication kernel implementation
@@ -23,7 +61,11 @@ extern "C" void kernel_mul(int64_t* args) {
     float* out = reinterpret_cast<float*>(args[2]);
     int size = static_cast<int>(args[3]);
 
-    for (int i = 0; i < size; i++) {
-        out[i] = src0[i] * src1[i];
+    for (int offset = 0; offset < size;) {
+        int count = size - offset < kTRows_ * kTCols_ ? size - offset : kTRows_ * kTCols_;
+        int rows = count / kTCols_;
+        int cols = rows > 0 ? kTCols_ : count;
+        kernel_mul_block(src0 + offset, src1 + offset, out + offset, rows > 0 ? rows : 1, cols);
+        offset += rows > 0 ? rows * kTCols_ : count;
     }
 }
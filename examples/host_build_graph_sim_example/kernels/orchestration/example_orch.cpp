@@ -6,9 +6,14 @@
  * This orchestration function:
  * 1. Receives host pointers and sizes in args
  * 2. Allocates device memory via runtime->host_api
- * 3. Copies input data to device via runtime->host_api
+ * 3. Queues the input copies via runtime->host_api; they are synchronized
+ *    as one batch once orchestration returns
  * 4. Records output tensor for copy-back during finalize
- * 5. Builds the task graph
+ * 5. Declares intermediates c, d, e as planned buffers
+ * 6. Builds the task graph as tiled data-parallel stages; the runtime
+ *    infers the dependencies between tiles
+ * 7. Publishes each stage as it is built, so a streaming launch starts on
+ *    it while the next stage is still being added
  */
 
 // Include runtime.h first to get full Runtime class definition
@@ -38,27 +43,28 @@ int build_example_graph(Runtime* runtime, uint64_t* args, int arg_count) {
     std::cout << "Formula: (a + b + 1)(a + b + 2)\n";
     std::cout << "SIZE: " << SIZE << " elements\n";
 
-    // Allocate device memory and copy inputs
+    // Allocate device memory and queue the input copies. device_malloc_host()
+    // lets the simulator alias the host buffers, making the copies no-ops
     std::cout << "\n=== Allocating Device Memory ===" << '\n';
 
-    void* dev_a = runtime->host_api.device_malloc(size_a);
+    void* dev_a = runtime->host_api.device_malloc_host(host_a, size_a);
     if (!dev_a) {
         std::cerr << "Error: Failed to allocate device memory for a\n";
         return -1;
     }
-    runtime->host_api.copy_to_device(dev_a, host_a, size_a);
-    std::cout << "Tensor a: " << size_a << " bytes copied to device\n";
+    runtime->host_api.copy_to_device_async(dev_a, host_a, size_a);
+    std::cout << "Tensor a: " << size_a << " bytes queued for the device\n";
 
-    void* dev_b = runtime->host_api.device_malloc(size_b);
+    void* dev_b = runtime->host_api.device_malloc_host(host_b, size_b);
     if (!dev_b) {
         std::cerr << "Error: Failed to allocate device memory for b\n";
         runtime->host_api.device_free(dev_a);
         return -1;
     }
-    runtime->host_api.copy_to_device(dev_b, host_b, size_b);
-    std::cout << "Tensor b: " << size_b << " bytes copied to device\n";
+    runtime->host_api.copy_to_device_async(dev_b, host_b, size_b);
+    std::cout << "Tensor b: " << size_b << " bytes queued for the device\n";
 
-    void* dev_f = runtime->host_api.device_malloc(size_f);
+    void* dev_f = runtime->host_api.device_malloc_host(host_f, size_f);
     if (!dev_f) {
         std::cerr << "Error: Failed to allocate device memory for f\n";
         runtime->host_api.device_free(dev_a);
@@ -69,24 +75,31 @@ int build_example_graph(Runtime* runtime, uint64_t* args, int arg_count) {
     runtime->record_tensor_pair(host_f, dev_f, size_f);
     std::cout << "Tensor f (output): " << size_f << " bytes allocated\n";
 
-    // Allocate intermediate tensors (c, d, e)
+    // Declare intermediate tensors (c, d, e); the runtime places them in a
+    // shared arena after orchestration and patches their addresses into the
+    // bound task args
     size_t BYTES = SIZE * sizeof(float);
-    void* dev_c = runtime->host_api.device_malloc(BYTES);
-    void* dev_d = runtime->host_api.device_malloc(BYTES);
-    void* dev_e = runtime->host_api.device_malloc(BYTES);
+    int buf_c = runtime->add_buffer(BYTES);
+    int buf_d = runtime->add_buffer(BYTES);
+    int buf_e = runtime->add_buffer(BYTES);
 
-    if (!dev_c || !dev_d || !dev_e) {
-        std::cerr << "Error: Failed to allocate intermediate tensors\n";
+    if (buf_c < 0 || buf_d < 0 || buf_e < 0) {
+        std::cerr << "Error: Failed to declare intermediate tensors\n";
         runtime->host_api.device_free(dev_a);
         runtime->host_api.device_free(dev_b);
         runtime->host_api.device_free(dev_f);
-        if (dev_c) runtime->host_api.device_free(dev_c);
-        if (dev_d) runtime->host_api.device_free(dev_d);
-        if (dev_e) runtime->host_api.device_free(dev_e);
         return -1;
     }
 
-    std::cout << "Allocated intermediate tensors c, d, e\n";
+    std::cout << "Declared intermediate tensors c, d, e\n";
+
+    // Each stage is split into tiles of TILE elements, one task per tile.
+    // Dependencies are inferred per tile, so tile k of a stage only waits
+    // for tile k of the stages it reads. The simulation kernels take any tile size.
+    constexpr uint64_t TILE = 32 * 128;
+    uint64_t dev_a_addr = reinterpret_cast<uint64_t>(dev_a);
+    uint64_t dev_b_addr = reinterpret_cast<uint64_t>(dev_b);
+    uint64_t dev_f_addr = reinterpret_cast<uint64_t>(dev_f);
 
     // Helper union to encode float scalar as uint64_t
     union {
@@ -94,52 +107,65 @@ int build_example_graph(Runtime* runtime, uint64_t* args, int arg_count) {
         uint64_t u64;
     } scalar_converter;
 
-    // Task 0: c = a + b (func_id=0: kernel_add, AIV)
-    uint64_t args_t0[4];
-    args_t0[0] = reinterpret_cast<uint64_t>(dev_a);  // src0
-    args_t0[1] = reinterpret_cast<uint64_t>(dev_b);  // src1
-    args_t0[2] = reinterpret_cast<uint64_t>(dev_c);  // out
-    args_t0[3] = SIZE;                                // size
-    int t0 = runtime->add_task(args_t0, 4, 0, 1);
-
-    // Task 1: d = c + 1 (func_id=1: kernel_add_scalar, AIV)
-    uint64_t args_t1[4];
-    args_t1[0] = reinterpret_cast<uint64_t>(dev_c);  // src
+    // Stage 0: c = a + b (func_id=0: kernel_add, AIV)
+    // args: [src0, src1, out, size]; tensor args and size are set per tile
+    uint64_t args_t0[4] = {0, 0, 0, 0};
+    ParallelOperand ops_t0[] = {
+        {0, TENSOR_IN, dev_a_addr, -1, sizeof(float)},
+        {1, TENSOR_IN, dev_b_addr, -1, sizeof(float)},
+        {2, TENSOR_OUT, 0, buf_c, sizeof(float)},
+    };
+    int t0 = runtime->add_parallel_task(args_t0, 4, 0, 1, ops_t0, 3, SIZE, TILE, 3);
+
+    // Hand the stage to a streaming launch (no-op otherwise); later stages
+    // only add edges into their own new tasks
+    runtime->publish_tasks();
+
+    // Stage 1: d = c + 1 (func_id=1: kernel_add_scalar, AIV)
+    // args: [src, scalar, out, size]
+    uint64_t args_t1[4] = {0, 0, 0, 0};
     scalar_converter.f32 = 1.0f;
-    args_t1[1] = scalar_converter.u64;                // scalar=1.0
-    args_t1[2] = reinterpret_cast<uint64_t>(dev_d);  // out
-    args_t1[3] = SIZE;                                // size
-    int t1 = runtime->add_task(args_t1, 4, 1, 1);
-
-    // Task 2: e = c + 2 (func_id=1: kernel_add_scalar, AIV)
-    uint64_t args_t2[4];
-    args_t2[0] = reinterpret_cast<uint64_t>(dev_c);  // src
+    args_t1[1] = scalar_converter.u64;
+    ParallelOperand ops_t1[] = {
+        {0, TENSOR_IN, 0, buf_c, sizeof(float)},
+        {2, TENSOR_OUT, 0, buf_d, sizeof(float)},
+    };
+    int t1 = runtime->add_parallel_task(args_t1, 4, 1, 1, ops_t1, 2, SIZE, TILE, 3);
+    runtime->publish_tasks();
+
+    // Stage 2: e = c + 2 (func_id=1: kernel_add_scalar, AIV)
+    uint64_t args_t2[4] = {0, 0, 0, 0};
     scalar_converter.f32 = 2.0f;
-    args_t2[1] = scalar_converter.u64;                // scalar=2.0
-    args_t2[2] = reinterpret_cast<uint64_t>(dev_e);  // out
-    args_t2[3] = SIZE;                                // size
-    int t2 = runtime->add_task(args_t2, 4, 1, 1);
-
-    // Task 3: f = d * e (func_id=2: kernel_mul, AIV)
-    uint64_t args_t3[4];
-    args_t3[0] = reinterpret_cast<uint64_t>(dev_d);  // src0
-    args_t3[1] = reinterpret_cast<uint64_t>(dev_e);  // src1
-    args_t3[2] = reinterpret_cast<uint64_t>(dev_f);  // out
-    args_t3[3] = SIZE;                                // size
-    int t3 = runtime->add_task(args_t3, 4, 2, 1);
-
-    // Add dependencies
-    runtime->add_successor(t0, t1);  // t0 → t1
-    runtime->add_successor(t0, t2);  // t0 → t2
-    runtime->add_successor(t1, t3);  // t1 → t3
-    runtime->add_successor(t2, t3);  // t2 → t3
-
-    std::cout << "\nTasks:\n";
-    std::cout << "  task" << t0 << ": c = a + b\n";
-    std::cout << "  task" << t1 << ": d = c + 1\n";
-    std::cout << "  task" << t2 << ": e = c + 2\n";
-    std::cout << "  task" << t3 << ": f = d * e\n";
-    std::cout << "Dependencies: t0→t1, t0→t2, t1→t3, t2→t3\n";
+    args_t2[1] = scalar_converter.u64;
+    ParallelOperand ops_t2[] = {
+        {0, TENSOR_IN, 0, buf_c, sizeof(float)},
+        {2, TENSOR_OUT, 0, buf_e, sizeof(float)},
+    };
+    int t2 = runtime->add_parallel_task(args_t2, 4, 1, 1, ops_t2, 2, SIZE, TILE, 3);
+    runtime->publish_tasks();
+
+    // Stage 3: f = d * e (func_id=2: kernel_mul, AIV)
+    // args: [src0, src1, out, size]
+    uint64_t args_t3[4] = {0, 0, 0, 0};
+    ParallelOperand ops_t3[] = {
+        {0, TENSOR_IN, 0, buf_d, sizeof(float)},
+        {1, TENSOR_IN, 0, buf_e, sizeof(float)},
+        {2, TENSOR_OUT, dev_f_addr, -1, sizeof(float)},
+    };
+    int t3 = runtime->add_parallel_task(args_t3, 4, 2, 1, ops_t3, 3, SIZE, TILE, 3);
+
+    if (t0 < 0 || t1 < 0 || t2 < 0 || t3 < 0) {
+        std::cerr << "Error: Failed to add tasks\n";
+        return -1;
+    }
+
+    int tiles = static_cast<int>((SIZE + TILE - 1) / TILE);
+    std::cout << "\nStages (" << tiles << " tile tasks each):\n";
+    std::cout << "  tasks " << t0 << "-" << t0 + tiles - 1 << ": c = a + b\n";
+    std::cout << "  tasks " << t1 << "-" << t1 + tiles - 1 << ": d = c + 1\n";
+    std::cout << "  tasks " << t2 << "-" << t2 + tiles - 1 << ": e = c + 2\n";
+    std::cout << "  tasks " << t3 << "-" << t3 + tiles - 1 << ": f = d * e\n";
+    std::cout << "Dependencies (inferred per tile): c→d, c→e, d→f, e→f\n";
 
     std::cout << "Created runtime with " << runtime->get_task_count() << " tasks\n";
     runtime->print_runtime();
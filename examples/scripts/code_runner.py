@@ -112,6 +112,14 @@ class CodeRunner:
         runtime_name: Runtime implementation name (default: "host_build_graph")
         device_id: Device ID (defaults to PTO_DEVICE_ID env var or 0)
         platform: Platform name ("a2a3" for hardware, "a2a3sim" for simulation, default: "a2a3")
+        zero_copy: Let the simulated device use the numpy arrays as tensors
+            instead of copying them (a2a3sim only, default: False)
+        fuse_chains: Run linear task chains as single tasks (default: False)
+        streaming: Launch the runtime first and run the orchestration while
+            the device executes the tasks it has published (a2a3sim only,
+            default: False)
+        save_graph: Write the built graph to this file after initialization
+            (with several parameter sets, the last one wins; default: None)
     """
 
     def __init__(
@@ -121,11 +129,23 @@ class CodeRunner:
         runtime_name: str = "host_build_graph",
         device_id: Optional[int] = None,
         platform: str = "a2a3",
+        zero_copy: bool = False,
+        fuse_chains: bool = False,
+        streaming: bool = False,
+        save_graph: Optional[str] = None,
     ):
+        if fuse_chains and streaming:
+            raise ValueError("fuse_chains is not available with streaming orchestration")
+        if save_graph and streaming:
+            raise ValueError("save_graph is not available with streaming orchestration")
         self.kernels_dir = Path(kernels_dir).resolve()
         self.golden_path = Path(golden_path).resolve()
         self.runtime_name = runtime_name
         self.platform = platform
+        self.zero_copy = zero_copy
+        self.fuse_chains = fuse_chains
+        self.streaming = streaming
+        self.save_graph = save_graph
         self.project_root = _get_project_root()
 
         # Resolve device ID
@@ -151,6 +171,7 @@ class CodeRunner:
         # Runtime configuration
         self.aicpu_thread_num = 3
         self.block_dim = 3
+        self.stream_max_tasks = 4096  # Task limit of a streaming runtime
 
     def _load_kernel_config(self):
         """Load kernel_config.py from kernels directory."""
@@ -226,6 +247,8 @@ class CodeRunner:
         Returns:
             List of func_args values (pointers, sizes, count)
         """
+        from bindings import host_buffer
+
         # Determine tensor order
         if self.tensor_order:
             order = self.tensor_order
@@ -241,9 +264,9 @@ class CodeRunner:
                     f"Tensor '{name}' from TENSOR_ORDER not found in generate_inputs() result.\n"
                     f"Available tensors: {list(tensors.keys())}"
                 )
-            arr = tensors[name]
-            ptrs.append(arr.ctypes.data)
-            sizes.append(arr.nbytes)
+            ptr, nbytes = host_buffer(tensors[name])
+            ptrs.append(ptr)
+            sizes.append(nbytes)
 
         # Get element count from first tensor
         count = tensors[order[0]].size
@@ -276,8 +299,11 @@ class CodeRunner:
         """
         # Import runtime modules (deferred to allow skip_if_no_env to work)
         from runtime_builder import RuntimeBuilder
-        from bindings import bind_host_binary, register_kernel, set_device, launch_runtime
+        from bindings import (
+            bind_host_binary, register_kernel, set_device, set_host_aliasing, launch_runtime, launch_runtime_async
+        )
         from elf_parser import extract_text_section
+        from compile_cache import get_compile_cache
 
         # Skip if environment not available (only for a2a3 platform)
         if self.platform == "a2a3":
@@ -301,6 +327,8 @@ class CodeRunner:
 
         print(f"\n=== Setting Device {self.device_id} ===")
         set_device(self.device_id)
+        if self.zero_copy:
+            set_host_aliasing(True, self.device_id)
 
         # Step 3: Compile orchestration
         print("\n=== Compiling Orchestration ===")
@@ -329,7 +357,11 @@ class CodeRunner:
                 core_type=kernel["core_type"],
                 pto_isa_root=pto_isa_root,
             )
-            kernel_bin = extract_text_section(incore_o)
+            cache = get_compile_cache()
+            kernel_bin = cache.get_or_build(
+                cache.key("text", self.platform, data=[incore_o]),
+                lambda: extract_text_section(incore_o),
+            )
             register_kernel(kernel["func_id"], kernel_bin)
 
         print("All kernels compiled and registered")
@@ -364,7 +396,14 @@ class CodeRunner:
             # Create and initialize runtime
             print("\n=== Initializing Runtime ===")
             runtime = Runtime()
-            runtime.initialize(orch_so_binary, self.orchestration["function_name"], func_args)
+            if self.streaming:
+                runtime.initialize_streaming(self.stream_max_tasks)
+            else:
+                runtime.initialize(orch_so_binary, self.orchestration["function_name"], func_args)
+                if self.fuse_chains:
+                    print(f"Fused {runtime.fuse_chains()} tasks into chains")
+                if self.save_graph:
+                    runtime.save_graph(self.save_graph)
 
             # Launch runtime
             print("\n=== Launching Runtime ===")
@@ -373,14 +412,30 @@ class CodeRunner:
             import sys
             sys.stdout.flush()  # Ensure output is visible before potential hang
 
-            launch_runtime(
-                runtime,
-                aicpu_thread_num=self.aicpu_thread_num,
-                block_dim=self.block_dim,
-                device_id=self.device_id,
-                aicpu_binary=aicpu_binary,
-                aicore_binary=aicore_binary,
-            )
+            if self.streaming:
+                # The device starts on the first published batch while the
+                # orchestration is still adding tasks
+                launch = launch_runtime_async(
+                    runtime,
+                    aicpu_thread_num=self.aicpu_thread_num,
+                    block_dim=self.block_dim,
+                    device_id=self.device_id,
+                    aicpu_binary=aicpu_binary,
+                    aicore_binary=aicore_binary,
+                )
+                try:
+                    runtime.stream(orch_so_binary, self.orchestration["function_name"], func_args)
+                finally:
+                    launch.wait()
+            else:
+                launch_runtime(
+                    runtime,
+                    aicpu_thread_num=self.aicpu_thread_num,
+                    block_dim=self.block_dim,
+                    device_id=self.device_id,
+                    aicpu_binary=aicpu_binary,
+                    aicore_binary=aicore_binary,
+                )
 
             print("Launch completed successfully")  # Will only print if not hung
 
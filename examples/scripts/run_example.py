@@ -88,6 +88,30 @@ Golden.py interface:
         help="Platform name: 'a2a3' for hardware, 'a2a3sim' for simulation (default: a2a3)"
     )
 
+    parser.add_argument(
+        "--zero-copy",
+        action="store_true",
+        help="Let the simulated device use the host tensors in place instead of copying them (a2a3sim only)"
+    )
+
+    parser.add_argument(
+        "--fuse-chains",
+        action="store_true",
+        help="Run linear task chains as single tasks (fewer dispatches)"
+    )
+
+    parser.add_argument(
+        "--streaming",
+        action="store_true",
+        help="Execute tasks while the orchestration is still building the graph (a2a3sim only)"
+    )
+
+    parser.add_argument(
+        "--save-graph",
+        metavar="PATH",
+        help="Write the built task graph to a file (see Runtime.load_graph())"
+    )
+
     parser.add_argument(
         "-v", "--verbose",
         action="store_true",
@@ -134,6 +158,10 @@ Golden.py interface:
             runtime_name=args.runtime,
             device_id=args.device,
             platform=args.platform,
+            zero_copy=args.zero_copy,
+            fuse_chains=args.fuse_chains,
+            streaming=args.streaming,
+            save_graph=args.save_graph,
         )
 
         runner.run()
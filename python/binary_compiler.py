@@ -3,6 +3,7 @@ import subprocess
 import tempfile
 from pathlib import Path
 from typing import List
+from compile_cache import get_compile_cache
 from toolchain import AICoreToolchain, AICPUToolchain, HostToolchain, HostSimToolchain
 
 
@@ -19,6 +20,8 @@ class BinaryCompiler:
     Platform determines which toolchains and CMake directories are used:
     - "a2a3": ccec for aicore, aarch64 cross-compiler for aicpu, gcc for host
     - "a2a3sim": all use host gcc/g++ (builds host-compatible .so files)
+
+    Built binaries are cached on disk by content (see compile_cache.py).
     """
     _instances = {}
 
@@ -170,11 +173,28 @@ class BinaryCompiler:
             )
 
         cmake_args = toolchain.gen_cmake_args(include_dirs, source_dirs)
+        # Device log messages below PTO_DEVICE_LOG_LEVEL are compiled out of the AICPU library
+        log_level = os.environ.get("PTO_DEVICE_LOG_LEVEL")
+        if target_platform == "aicpu" and log_level:
+            cmake_args += f" -DPTO_DEVICE_LOG_LEVEL={log_level}"
         cmake_source_dir = toolchain.get_root_dir()
         binary_name = toolchain.get_binary_name()
 
-        return self._run_compilation(
-            cmake_source_dir, cmake_args, binary_name, platform=target_platform.upper()
+        # The CMake projects also pull in the platform's common dirs and the
+        # shared C API headers, so the whole platform tree is part of the key
+        tools = [getattr(toolchain, attr) for attr in ("cc", "cxx", "ld") if hasattr(toolchain, attr)]
+        key = get_compile_cache().key(
+            target_platform, self.platform,
+            tools=["cmake"] + tools,
+            flags=[cmake_args, binary_name],
+            dirs=[self.platform_dir, self.project_root / "src" / "platform" / "include"]
+            + list(include_dirs) + list(source_dirs),
+        )
+        return get_compile_cache().get_or_build(
+            key,
+            lambda: self._run_compilation(
+                cmake_source_dir, cmake_args, binary_name, platform=target_platform.upper()
+            ),
         )
 
     def _run_compilation(
@@ -29,14 +29,17 @@ from ctypes import (
     CDLL,
     POINTER,
     c_char_p,
+    c_double,
     c_int,
     c_void_p,
     c_uint8,
+    c_uint32,
     c_uint64,
     c_size_t,
+    Structure,
 )
 from pathlib import Path
-from typing import Union, List, Optional
+from typing import Dict, Union, List, Optional, Tuple
 import ctypes
 import tempfile
 
@@ -49,6 +52,161 @@ _lib = None
 # Runtime Library Loader
 # ============================================================================
 
+class DeviceMemoryStats(Structure):
+    """Mirror of the C DeviceMemoryStats struct."""
+
+    _fields_ = [
+        ("bytes_in_use", c_uint64),
+        ("peak_bytes", c_uint64),
+        ("bytes_reserved", c_uint64),
+        ("alloc_count", c_uint64),
+        ("cache_hits", c_uint64),
+    ]
+
+
+# Must match PTO_RUNTIME_STATS_MAX_CORES in pto_runtime_c_api.h
+RUNTIME_STATS_MAX_CORES = 72
+
+
+class RuntimeStats(Structure):
+    """Mirror of the C RuntimeStats struct."""
+
+    _fields_ = [
+        ("thread_count", c_int),
+        ("core_count", c_int),
+        ("run_us", c_double),
+        ("loop_iterations", c_uint64),
+        ("idle_iterations", c_uint64),
+        ("tasks_dispatched", c_uint64),
+        ("tasks_completed", c_uint64),
+        ("blocks_migrated", c_uint64),
+        ("avg_dispatch_latency_us", c_double),
+        ("max_dispatch_latency_us", c_double),
+        ("queue_op_us", c_double),
+        ("max_ready_depth", c_int * 3),
+        ("core_busy_fraction", c_double * RUNTIME_STATS_MAX_CORES),
+    ]
+
+
+# Must match PTO_COST_MODEL_MAX_FUNCS / PTO_PREDICTION_MAX_THREADS in pto_runtime_c_api.h
+COST_MODEL_MAX_FUNCS = 64
+PREDICTION_MAX_THREADS = 16
+
+
+class KernelCostModel(Structure):
+    """Mirror of the C KernelCostModel struct."""
+
+    _fields_ = [
+        ("defined", c_int),
+        ("bytes_arg", c_int),
+        ("base_us", c_double),
+        ("us_per_byte", c_double),
+    ]
+
+
+class CostModel(Structure):
+    """
+
+    Mirror of the C CostModel struct: timing assumptions for Runtime.predict().
+
+    Kernels without an entry take default_us. The scheduler costs default to
+    zero, which predicts an ideal scheduler; calibrate them against a real
+    run to predict its overhead.
+    """
+
+    _fields_ = [
+        ("kernels", KernelCostModel * COST_MODEL_MAX_FUNCS),
+        ("default_us", c_double),
+        ("dispatch_us", c_double),
+        ("complete_us", c_double),
+        ("handshake_us", c_double),
+        ("ready_queue_policy", c_int),
+        ("handshake_depth", c_int),
+    ]
+
+    def __init__(self, default_us: float = 1.0, dispatch_us: float = 0.0, complete_us: float = 0.0,
+                 handshake_us: float = 0.0, ready_queue_policy: int = -1, handshake_depth: int = 0):
+        """
+
+        Args:
+            default_us: Latency of kernels without an entry
+            dispatch_us: AICPU time to dequeue a task and post it to a core
+            complete_us: AICPU time to retire a task and release its successors
+            handshake_us: One-way AICPU <-> AICore handshake latency
+            ready_queue_policy: ReadyQueuePolicy to predict (0=LIFO, 1=FIFO,
+                2=stealing, 3=priority), -1 = the runtime's
+            handshake_depth: Tasks in flight per core to predict, 0 = the runtime's
+        """
+
+        super().__init__()
+        self.default_us = default_us
+        self.dispatch_us = dispatch_us
+        self.complete_us = complete_us
+        self.handshake_us = handshake_us
+        self.ready_queue_policy = ready_queue_policy
+        self.handshake_depth = handshake_depth
+
+    def set_kernel(self, func_id: int, base_us: float, us_per_byte: float = 0.0, bytes_arg: int = -1) -> None:
+        """
+
+        Model a kernel as base_us + us_per_byte * (task argument bytes_arg).
+
+        Args:
+            func_id: Function identifier (< COST_MODEL_MAX_FUNCS)
+            base_us: Latency of every call
+            us_per_byte: Added per byte of the size argument
+            bytes_arg: Index of the task argument holding a byte count, -1 = none
+        """
+
+        if not 0 <= func_id < COST_MODEL_MAX_FUNCS:
+            raise ValueError(f"func_id {func_id} out of range [0, {COST_MODEL_MAX_FUNCS})")
+        self.kernels[func_id] = KernelCostModel(1, bytes_arg, base_us, us_per_byte)
+
+    @classmethod
+    def from_trace(cls, path: Union[str, Path], **kwargs) -> "CostModel":
+        """
+
+        Build a model with the mean kernel latency per func_id of a trace.
+
+        Args:
+            path: Chrome trace written by Runtime.export_trace() (on hardware
+                for hardware predictions)
+            **kwargs: Scheduler costs, as for CostModel()
+
+        Returns:
+            CostModel with a constant latency for every func_id in the trace
+        """
+
+        import json
+        with open(path) as f:
+            events = json.load(f)["traceEvents"]
+        durations: Dict[int, List[float]] = {}
+        for event in events:
+            if event.get("ph") == "X" and event.get("cat") == "task":
+                durations.setdefault(event["args"]["func_id"], []).append(event["dur"])
+        model = cls(**kwargs)
+        for func_id, values in durations.items():
+            if 0 <= func_id < COST_MODEL_MAX_FUNCS:
+                model.set_kernel(func_id, sum(values) / len(values))
+        return model
+
+
+class RuntimePrediction(Structure):
+    """Mirror of the C RuntimePrediction struct."""
+
+    _fields_ = [
+        ("thread_count", c_int),
+        ("core_count", c_int),
+        ("task_count", c_int),
+        ("makespan_us", c_double),
+        ("critical_path_us", c_double),
+        ("total_work_us", c_double),
+        ("avg_ready_wait_us", c_double),
+        ("thread_busy_fraction", c_double * PREDICTION_MAX_THREADS),
+        ("core_busy_fraction", c_double * RUNTIME_STATS_MAX_CORES),
+    ]
+
+
 class RuntimeLibraryLoader:
     """Loads and manages the PTO runtime C API library."""
 
@@ -92,6 +250,25 @@ class RuntimeLibraryLoader:
         ]
         self.lib.init_runtime.restype = c_int
 
+        # init_streaming_runtime / stream_orchestration - build the graph while it runs
+        self.lib.init_streaming_runtime.argtypes = [c_void_p, c_int, c_int, c_int]  # runtime, task/arg/edge limits
+        self.lib.init_streaming_runtime.restype = c_int
+        self.lib.stream_orchestration.argtypes = [
+            c_void_p,               # runtime
+            POINTER(c_uint8),       # orch_so_binary
+            c_size_t,               # orch_so_size
+            c_char_p,               # orch_func_name
+            POINTER(c_uint64),      # func_args
+            c_int,                  # func_args_count
+        ]
+        self.lib.stream_orchestration.restype = c_int
+
+        # save_runtime_graph / load_runtime_graph - graph files instead of orchestration
+        self.lib.save_runtime_graph.argtypes = [c_void_p, c_char_p]
+        self.lib.save_runtime_graph.restype = c_int
+        self.lib.load_runtime_graph.argtypes = [c_void_p, c_char_p, POINTER(c_uint64), c_int]
+        self.lib.load_runtime_graph.restype = c_int
+
         # launch_runtime - device init + execute runtime
         self.lib.launch_runtime.argtypes = [
             c_void_p,           # runtime
@@ -105,6 +282,59 @@ class RuntimeLibraryLoader:
         ]
         self.lib.launch_runtime.restype = c_int
 
+        # launch_runtime_async / wait_runtime - overlap host work with execution
+        self.lib.launch_runtime_async.argtypes = [
+            c_void_p,           # runtime
+            c_int,              # aicpu_thread_num
+            c_int,              # block_dim
+            c_int,              # device_id
+            POINTER(c_uint8),   # aicpu_binary
+            c_size_t,           # aicpu_size
+            POINTER(c_uint8),   # aicore_binary
+            c_size_t,           # aicore_size
+            POINTER(c_void_p),  # launch (output)
+        ]
+        self.lib.launch_runtime_async.restype = c_int
+        self.lib.wait_runtime.argtypes = [c_void_p]
+        self.lib.wait_runtime.restype = c_int
+
+        # start/stop_persistent_executor - keep executors resident across launches
+        self.lib.start_persistent_executor.argtypes = [
+            c_int,              # aicpu_thread_num
+            c_int,              # block_dim
+            c_int,              # device_id
+            POINTER(c_uint8),   # aicpu_binary
+            c_size_t,           # aicpu_size
+            POINTER(c_uint8),   # aicore_binary
+            c_size_t,           # aicore_size
+        ]
+        self.lib.start_persistent_executor.restype = c_int
+        self.lib.stop_persistent_executor.argtypes = [c_int]  # device_id
+        self.lib.stop_persistent_executor.restype = c_int
+
+        # set_task_arg - rebind a task argument between replays
+        self.lib.set_task_arg.argtypes = [c_void_p, c_int, c_int, c_uint64]
+        self.lib.set_task_arg.restype = c_int
+
+        # fuse_task_chains - run linear task chains as single tasks
+        self.lib.fuse_task_chains.argtypes = [c_void_p]
+        self.lib.fuse_task_chains.restype = c_int
+
+        # set_profiling / export_trace - per-task timestamps as a Chrome trace
+        self.lib.set_profiling.argtypes = [c_void_p, c_int]
+        self.lib.set_profiling.restype = c_int
+        self.lib.export_trace.argtypes = [c_void_p, c_char_p]
+        self.lib.export_trace.restype = c_int
+
+        # get_runtime_stats - scheduler counters of the last launch
+        self.lib.get_runtime_stats.argtypes = [c_void_p, POINTER(RuntimeStats)]
+        self.lib.get_runtime_stats.restype = c_int
+
+        # predict_runtime - offline cost-model prediction of a graph
+        self.lib.predict_runtime.argtypes = [
+            c_void_p, c_int, c_int, POINTER(CostModel), POINTER(RuntimePrediction)]
+        self.lib.predict_runtime.restype = c_int
+
         # finalize_runtime - validate + cleanup
         self.lib.finalize_runtime.argtypes = [c_void_p]
         self.lib.finalize_runtime.restype = c_int
@@ -113,10 +343,45 @@ class RuntimeLibraryLoader:
         self.lib.register_kernel.argtypes = [c_int, POINTER(c_uint8), c_size_t]
         self.lib.register_kernel.restype = c_int
 
+        # register_kernels - register a batch of kernels with one upload
+        self.lib.register_kernels.argtypes = [
+            c_int,                      # count
+            POINTER(c_int),             # func_ids
+            POINTER(POINTER(c_uint8)),  # bin_data
+            POINTER(c_size_t),          # bin_sizes
+        ]
+        self.lib.register_kernels.restype = c_int
+
         # set_device - set device and create streams
         self.lib.set_device.argtypes = [c_int]
         self.lib.set_device.restype = c_int
 
+        # set_host_aliasing - let a simulated device use host buffers as tensors
+        self.lib.set_host_aliasing.argtypes = [c_int, c_int]  # device_id, enable
+        self.lib.set_host_aliasing.restype = c_int
+
+        # set_device_partitioning - run launches concurrently on disjoint block ranges
+        self.lib.set_device_partitioning.argtypes = [c_int, c_int]  # device_id, device_blocks
+        self.lib.set_device_partitioning.restype = c_int
+
+        # host_malloc_pinned / host_free_pinned - page-locked host staging memory
+        self.lib.host_malloc_pinned.argtypes = [c_size_t]
+        self.lib.host_malloc_pinned.restype = c_void_p
+
+        self.lib.host_free_pinned.argtypes = [c_void_p]
+        self.lib.host_free_pinned.restype = None
+
+        # get_device_memory_stats - memory pool statistics of a device
+        self.lib.get_device_memory_stats.argtypes = [c_int, POINTER(DeviceMemoryStats)]
+        self.lib.get_device_memory_stats.restype = c_int
+
+        # enable_device_log / dump_device_log - binary AICPU log rings
+        self.lib.enable_device_log.argtypes = [c_int, c_uint32]  # device_id, records_per_thread
+        self.lib.enable_device_log.restype = c_int
+
+        self.lib.dump_device_log.argtypes = [c_int, c_char_p]  # device_id, path
+        self.lib.dump_device_log.restype = c_int
+
 
 # ============================================================================
 # Python Wrapper Classes
@@ -197,6 +462,255 @@ class Runtime:
         if rc != 0:
             raise RuntimeError(f"init_runtime failed: {rc}")
 
+    def initialize_streaming(self, max_tasks: int, max_args: int = 0, max_edges: int = 0) -> None:
+        """
+
+        Initialize an empty runtime whose graph is built while it runs.
+
+        The runtime can be launched right away with launch_runtime_async();
+        stream() then runs the orchestration, whose tasks start executing as
+        soon as it publishes them. Simulation only.
+
+        Args:
+            max_tasks: Maximum number of tasks the orchestration may add
+            max_args: Args pool limit (0 = max_tasks * RUNTIME_MAX_ARGS)
+            max_edges: Edge limit (0 = max_tasks * RUNTIME_STREAM_EDGES_PER_TASK)
+
+        Raises:
+            RuntimeError: If the platform does not support streaming or
+                allocation fails
+        """
+
+        rc = self.lib.init_streaming_runtime(self._handle, max_tasks, max_args, max_edges)
+        if rc != 0:
+            raise RuntimeError(f"init_streaming_runtime failed: {rc}")
+
+    def stream(
+        self,
+        orch_so_binary: bytes,
+        orch_func_name: str,
+        func_args: Optional[List[int]] = None
+    ) -> None:
+        """
+
+        Run the orchestration of a runtime set up with initialize_streaming().
+
+        Tasks reach the running launch in the batches the orchestration
+        publishes with runtime->publish_tasks(); the graph is sealed when the
+        function returns, after which the launch can finish. The graph is
+        also sealed on failure, so the launch can still be waited for.
+
+        Args:
+            orch_so_binary: Orchestration shared library binary data
+            orch_func_name: Name of the orchestration function to call
+            func_args: Arguments for orchestration (host pointers, sizes, etc.)
+
+        Raises:
+            RuntimeError: If the orchestration fails
+        """
+
+        func_args = func_args or []
+        func_args_count = len(func_args)
+        func_args_array = (c_uint64 * func_args_count)(*func_args) if func_args_count > 0 else None
+        orch_so_array = (c_uint8 * len(orch_so_binary)).from_buffer_copy(orch_so_binary)
+
+        rc = self.lib.stream_orchestration(
+            self._handle,
+            orch_so_array,
+            len(orch_so_binary),
+            orch_func_name.encode('utf-8'),
+            func_args_array,
+            func_args_count
+        )
+        if rc != 0:
+            raise RuntimeError(f"stream_orchestration failed: {rc}")
+
+    def save_graph(self, path: Union[str, Path]) -> None:
+        """
+
+        Save the built graph to a file that load_graph() can start from.
+
+        Args that point into the runtime's device allocations are stored as
+        relocations against tensor slots, numbered in the order in which the
+        orchestration allocated them (the planned buffer arena last).
+        Tensor contents are not saved.
+
+        Args:
+            path: Output file path
+
+        Raises:
+            RuntimeError: If the runtime is streaming or the file cannot be written
+        """
+
+        rc = self.lib.save_runtime_graph(self._handle, str(path).encode('utf-8'))
+        if rc != 0:
+            raise RuntimeError(f"save_runtime_graph failed: {rc}")
+
+    def load_graph(self, path: Union[str, Path], host_tensors: Optional[List[int]] = None) -> None:
+        """
+
+        Initialize the runtime from a graph file instead of an orchestration.
+
+        The file is mapped and used in place. Tensor slot k is bound to the
+        host buffer at host_tensors[k] (e.g. the pointer from host_buffer()):
+        it is copied to the device before launch and, for outputs, copied
+        back by finalize(). Slots past the end of the list or given as 0 get
+        uninitialized device memory.
+
+        Args:
+            path: Graph file written by save_graph()
+            host_tensors: Host buffer addresses by tensor slot
+
+        Raises:
+            RuntimeError: If the file is invalid or was written by another build
+        """
+
+        host_tensors = host_tensors or []
+        count = len(host_tensors)
+        tensors_array = (c_uint64 * count)(*host_tensors) if count > 0 else None
+        rc = self.lib.load_runtime_graph(self._handle, str(path).encode('utf-8'), tensors_array, count)
+        if rc != 0:
+            raise RuntimeError(f"load_runtime_graph failed: {rc}")
+
+    def set_task_arg(self, task_id: int, arg_idx: int, value: int) -> None:
+        """
+
+        Replace one argument of a task in the built graph.
+
+        Used to rebind tensor base pointers before replaying the graph with
+        another launch_runtime() call. The updated graph is uploaded on the
+        next launch.
+
+        Args:
+            task_id: Task ID assigned during orchestration
+            arg_idx: Argument index within the task
+            value: New argument value (e.g. a device pointer)
+
+        Raises:
+            RuntimeError: If the task or argument index is invalid
+        """
+
+        rc = self.lib.set_task_arg(self._handle, task_id, arg_idx, value)
+        if rc != 0:
+            raise RuntimeError(f"set_task_arg failed: {rc}")
+
+    def fuse_chains(self) -> int:
+        """
+
+        Fuse linear chains of tasks so each chain is dispatched once.
+
+        A task that is the only successor of its only predecessor (same core
+        type, same affinity) runs on that predecessor's core right after it.
+        Call after initialize() and before the first launch.
+
+        Returns:
+            Number of tasks absorbed into chains
+
+        Raises:
+            RuntimeError: If the runtime handle is invalid or the graph has a
+                dependency cycle
+        """
+
+        absorbed = self.lib.fuse_task_chains(self._handle)
+        if absorbed < 0:
+            raise RuntimeError(f"fuse_task_chains failed: {absorbed}")
+        return absorbed
+
+    def set_profiling(self, enable: bool = True) -> None:
+        """
+
+        Record per-task timestamps in later launches of this runtime.
+
+        The AICore executor stamps each kernel's start and end and the core
+        it ran on; the AICPU scheduler stamps dispatch and completion.
+
+        Args:
+            enable: Whether to record timestamps
+
+        Raises:
+            RuntimeError: If the runtime handle is invalid
+        """
+
+        rc = self.lib.set_profiling(self._handle, 1 if enable else 0)
+        if rc != 0:
+            raise RuntimeError(f"set_profiling failed: {rc}")
+
+    def export_trace(self, path: Union[str, Path]) -> None:
+        """
+
+        Write the timestamps of the last launch as a Chrome trace JSON file.
+
+        Open the file with chrome://tracing or https://ui.perfetto.dev.
+        Must be called after the launch finished and before finalize().
+
+        Args:
+            path: Output file path
+
+        Raises:
+            RuntimeError: If nothing was recorded or the file cannot be written
+        """
+
+        rc = self.lib.export_trace(self._handle, str(path).encode('utf-8'))
+        if rc != 0:
+            raise RuntimeError(f"export_trace failed: {rc}")
+
+    def get_stats(self) -> dict:
+        """
+
+        Get the scheduler counters of the last launch.
+
+        Must be called after the launch finished and before finalize().
+
+        Returns:
+            Dict with the RuntimeStats fields. max_ready_depth is a dict
+            keyed by "aic", "aiv" and "block"; core_busy_fraction is a list
+            with one entry per core.
+
+        Raises:
+            RuntimeError: If the runtime was not launched or is in flight
+        """
+
+        stats = RuntimeStats()
+        rc = self.lib.get_runtime_stats(self._handle, ctypes.byref(stats))
+        if rc != 0:
+            raise RuntimeError(f"get_runtime_stats failed: {rc}")
+        result = {name: getattr(stats, name) for name, _ in RuntimeStats._fields_}
+        result["max_ready_depth"] = dict(zip(("aic", "aiv", "block"), stats.max_ready_depth))
+        result["core_busy_fraction"] = list(stats.core_busy_fraction[:stats.core_count])
+        return result
+
+    def predict(self, model: CostModel, block_dim: int, aicpu_thread_num: int = 1) -> dict:
+        """
+
+        Predict the execution of this runtime's graph without a device.
+
+        Replays the graph on modelled cores with virtual clocks and modelled
+        AICPU scheduler threads, using the runtime's scheduler settings
+        unless the model overrides them.
+
+        Args:
+            model: Timing assumptions
+            block_dim: Number of blocks to model (1 block = 1 AIC + 2 AIV)
+            aicpu_thread_num: Number of AICPU scheduler threads to model
+
+        Returns:
+            Dict with the RuntimePrediction fields; thread_busy_fraction and
+            core_busy_fraction are lists with one entry per thread and core.
+
+        Raises:
+            RuntimeError: If the configuration is invalid or the graph cannot finish
+        """
+
+        prediction = RuntimePrediction()
+        rc = self.lib.predict_runtime(self._handle, aicpu_thread_num, block_dim, ctypes.byref(model),
+                                      ctypes.byref(prediction))
+        if rc != 0:
+            raise RuntimeError(f"predict_runtime failed: {rc}")
+        result = {name: getattr(prediction, name) for name, _ in RuntimePrediction._fields_}
+        result["thread_busy_fraction"] = list(prediction.thread_busy_fraction[:prediction.thread_count])
+        result["core_busy_fraction"] = list(prediction.core_busy_fraction[:prediction.core_count])
+        return result
+
     def finalize(self) -> None:
         """
 
@@ -256,6 +770,40 @@ def register_kernel(func_id: int, binary_data: bytes) -> None:
         raise RuntimeError(f"register_kernel failed: {rc}")
 
 
+def register_kernels(kernels: Dict[int, bytes]) -> None:
+    """
+
+    Register several kernel binaries at once.
+
+    All binaries are packed into one image that is uploaded with a single
+    device allocation and copy, which is much cheaper than calling
+    register_kernel() once per kernel for models with many kernels.
+
+    Args:
+        kernels: Mapping of func_id to kernel .text section binary data
+
+    Raises:
+        RuntimeError: If not initialized or registration fails
+        ValueError: If any binary is empty
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    if any(not binary_data for binary_data in kernels.values()):
+        raise ValueError("binary_data cannot be empty")
+
+    count = len(kernels)
+    func_ids = (c_int * count)(*kernels.keys())
+    bin_arrays = [(c_uint8 * len(data)).from_buffer_copy(data) for data in kernels.values()]
+    bin_data = (POINTER(c_uint8) * count)(*[ctypes.cast(arr, POINTER(c_uint8)) for arr in bin_arrays])
+    bin_sizes = (c_size_t * count)(*[len(data) for data in kernels.values()])
+    rc = _lib.register_kernels(count, func_ids, bin_data, bin_sizes)
+    if rc != 0:
+        raise RuntimeError(f"register_kernels failed: {rc}")
+
+
 def set_device(device_id: int) -> None:
     """
 
@@ -268,6 +816,10 @@ def set_device(device_id: int) -> None:
 
     Binary loading happens later in launch_runtime().
 
+    The device becomes current for the calling thread only: kernels
+    registered and runtimes initialized afterwards on this thread belong to
+    it. Drive several devices concurrently with one thread per device.
+
     Args:
         device_id: Device ID (0-15)
 
@@ -299,9 +851,12 @@ def launch_runtime(
     Initializes DeviceRunner singleton (if first call), copies runtime to device,
     launches kernels, synchronizes, and copies runtime back from device.
 
+    The same runtime can be launched repeatedly to replay its graph without
+    re-running orchestration; only changed graph data is re-uploaded.
+
     Args:
         runtime: Runtime to execute (must have been initialized via runtime.initialize())
-        aicpu_thread_num: Number of AICPU scheduler threads
+        aicpu_thread_num: Number of AICPU scheduler threads, 0 = one per available AICPU
         block_dim: Number of blocks (1 block = 1 AIC + 2 AIV)
         device_id: Device ID (0-15)
         aicpu_binary: Binary data of AICPU shared object
@@ -333,6 +888,383 @@ def launch_runtime(
         raise RuntimeError(f"launch_runtime failed: {rc}")
 
 
+class LaunchHandle:
+    """
+    A launch started by launch_runtime_async().
+
+    Keeps the launched runtime alive until wait() has been called.
+    """
+
+    def __init__(self, runtime: "Runtime", handle: c_void_p):
+        self._runtime = runtime
+        self._handle = handle
+
+    @property
+    def done(self) -> bool:
+        """True once wait() has returned."""
+        return self._handle is None
+
+    def wait(self) -> None:
+        """
+        Block until the launch has finished executing.
+
+        Raises:
+            RuntimeError: If execution failed
+        """
+        if self._handle is None:
+            return
+        handle, self._handle = self._handle, None
+        rc = _lib.wait_runtime(handle)
+        self._runtime = None
+        if rc != 0:
+            raise RuntimeError(f"wait_runtime failed: {rc}")
+
+
+def launch_runtime_async(
+    runtime: "Runtime",
+    aicpu_thread_num: int,
+    block_dim: int,
+    device_id: int,
+    aicpu_binary: bytes,
+    aicore_binary: bytes,
+) -> LaunchHandle:
+    """
+    Start executing a runtime on the device and return immediately.
+
+    Takes the same arguments as launch_runtime(). The host can build and
+    launch further runtimes while this one runs; launches finish in
+    submission order unless the device is partitioned (see
+    set_device_partitioning()). The runtime must not be relaunched or finalized
+    before the returned handle has been waited for.
+
+    Returns:
+        LaunchHandle whose wait() blocks until execution has finished
+
+    Raises:
+        RuntimeError: If not initialized or the launch fails
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    aicpu_array = (c_uint8 * len(aicpu_binary)).from_buffer_copy(aicpu_binary)
+    aicore_array = (c_uint8 * len(aicore_binary)).from_buffer_copy(aicore_binary)
+
+    handle = c_void_p()
+    rc = _lib.launch_runtime_async(
+        runtime._handle,
+        aicpu_thread_num,
+        block_dim,
+        device_id,
+        aicpu_array,
+        len(aicpu_binary),
+        aicore_array,
+        len(aicore_binary),
+        ctypes.byref(handle),
+    )
+    if rc != 0:
+        raise RuntimeError(f"launch_runtime_async failed: {rc}")
+    return LaunchHandle(runtime, handle)
+
+
+def wait_runtime(launch: LaunchHandle) -> None:
+    """
+    Wait for a launch started by launch_runtime_async() to finish.
+
+    Args:
+        launch: Handle returned by launch_runtime_async()
+
+    Raises:
+        RuntimeError: If execution failed
+    """
+    launch.wait()
+
+
+def start_persistent_executor(
+    aicpu_thread_num: int,
+    block_dim: int,
+    device_id: int,
+    aicpu_binary: bytes,
+    aicore_binary: bytes,
+) -> None:
+    """
+    Launch the executor kernels once and keep them resident.
+
+    Until stop_persistent_executor(), launch_runtime() and
+    launch_runtime_async() hand graphs to the resident executors through a
+    device doorbell instead of launching kernels per graph. Launches must
+    use the same aicpu_thread_num and block_dim.
+
+    Args:
+        aicpu_thread_num: Number of AICPU scheduler threads, 0 = one per available AICPU
+        block_dim: Number of blocks (1 block = 1 AIC + 2 AIV)
+        device_id: Device ID (0-15)
+        aicpu_binary: Binary data of AICPU shared object
+        aicore_binary: Binary data of AICore kernel
+
+    Raises:
+        RuntimeError: If not initialized or the executors cannot be started
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    aicpu_array = (c_uint8 * len(aicpu_binary)).from_buffer_copy(aicpu_binary)
+    aicore_array = (c_uint8 * len(aicore_binary)).from_buffer_copy(aicore_binary)
+
+    rc = _lib.start_persistent_executor(
+        aicpu_thread_num,
+        block_dim,
+        device_id,
+        aicpu_array,
+        len(aicpu_binary),
+        aicore_array,
+        len(aicore_binary),
+    )
+    if rc != 0:
+        raise RuntimeError(f"start_persistent_executor failed: {rc}")
+
+
+def stop_persistent_executor(device_id: int = 0) -> None:
+    """
+    Wait for outstanding submissions and stop the resident executors.
+
+    Args:
+        device_id: Device the executors were started on
+
+    Raises:
+        RuntimeError: If not initialized or shutdown fails
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    rc = _lib.stop_persistent_executor(device_id)
+    if rc != 0:
+        raise RuntimeError(f"stop_persistent_executor failed: {rc}")
+
+
+def set_host_aliasing(enable: bool = True, device_id: int = 0) -> None:
+    """
+    Let a simulated device use host buffers as tensors instead of copying them.
+
+    Orchestration that allocates tensors with host_api.device_malloc_host()
+    then gets the host buffer itself back: inputs are read and outputs
+    written in place, and neither the copies to the device nor the
+    copy-back in finalize() move any data. The buffers (see host_buffer())
+    must stay alive and untouched until the runtime is finalized.
+
+    Args:
+        enable: True to alias host buffers, False to copy them again
+        device_id: Device to configure
+
+    Raises:
+        RuntimeError: If not initialized or the platform cannot alias host
+            memory (only a2a3sim can)
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    rc = _lib.set_host_aliasing(device_id, 1 if enable else 0)
+    if rc != 0:
+        raise RuntimeError(f"set_host_aliasing failed: {rc}")
+
+
+def set_device_partitioning(device_blocks: int, device_id: int = 0) -> None:
+    """
+    Run later launches of a simulated device concurrently on disjoint block ranges.
+
+    The device is treated as device_blocks blocks. Each launch_runtime_async()
+    is placed into a free range of its block_dim blocks with its own AICPU
+    scheduler state and starts right away; a launch that does not fit waits
+    for running ones to finish. Launches are admitted in submission order
+    but may complete in any order, so independent small graphs share the
+    device instead of running one after another.
+
+    Args:
+        device_blocks: Blocks of the device, 0 to run launches in order again
+        device_id: Device to configure
+
+    Raises:
+        RuntimeError: If not initialized, launches are in flight, the
+            persistent executor is running, or the platform cannot
+            partition a device (only a2a3sim can)
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    rc = _lib.set_device_partitioning(device_id, device_blocks)
+    if rc != 0:
+        raise RuntimeError(f"set_device_partitioning failed: {rc}")
+
+
+def host_buffer(obj) -> Tuple[int, int]:
+    """
+    Get the address and size of a host buffer without copying it.
+
+    Accepts any object exporting a writable, C-contiguous buffer (numpy
+    arrays, bytearray, array.array, ...). Use it to pass tensors to an
+    orchestration function as func_args.
+
+    Args:
+        obj: Buffer-protocol object
+
+    Returns:
+        (address, nbytes); address is 0 for an empty buffer
+
+    Raises:
+        ValueError: If the buffer is read-only or not C-contiguous
+    """
+
+    view = memoryview(obj)
+    if not view.c_contiguous:
+        raise ValueError("host_buffer: buffer is not C-contiguous")
+    if view.readonly:
+        raise ValueError("host_buffer: buffer is read-only")
+    if view.nbytes == 0:
+        return 0, 0
+    view = view.cast("B")
+    return ctypes.addressof(ctypes.c_char.from_buffer(view)), view.nbytes
+
+
+def alloc_pinned(nbytes: int):
+    """
+    Allocate a page-locked host buffer on the current device.
+
+    Tensors placed in pinned memory are transferred by the DMA engine
+    directly; other host buffers are staged through a pinned block first.
+    The buffer works with host_buffer() and numpy.frombuffer(). Release it
+    with free_pinned() and drop every view of it first.
+
+    Args:
+        nbytes: Size in bytes
+
+    Returns:
+        ctypes char array over the pinned memory
+
+    Raises:
+        RuntimeError: If not initialized or out of pinned memory
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    ptr = _lib.host_malloc_pinned(nbytes)
+    if not ptr:
+        raise RuntimeError(f"alloc_pinned failed for {nbytes} bytes")
+    return (ctypes.c_char * nbytes).from_address(ptr)
+
+
+def free_pinned(buffer) -> None:
+    """
+    Free a buffer returned by alloc_pinned().
+
+    Args:
+        buffer: Buffer returned by alloc_pinned()
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    _lib.host_free_pinned(ctypes.addressof(buffer))
+
+
+def get_device_memory_stats(device_id: int = 0) -> dict:
+    """
+    Get the memory pool statistics of a device.
+
+    Args:
+        device_id: Device to query
+
+    Returns:
+        Dict with bytes_in_use, peak_bytes, bytes_reserved, alloc_count,
+        cache_hits and hit_rate (cache_hits / alloc_count)
+
+    Raises:
+        RuntimeError: If not initialized or the query fails
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    stats = DeviceMemoryStats()
+    rc = _lib.get_device_memory_stats(device_id, ctypes.byref(stats))
+    if rc != 0:
+        raise RuntimeError(f"get_device_memory_stats failed: {rc}")
+    result = {name: getattr(stats, name) for name, _ in DeviceMemoryStats._fields_}
+    result["hit_rate"] = stats.cache_hits / stats.alloc_count if stats.alloc_count else 0.0
+    return result
+
+
+def enable_device_log(records_per_thread: int = 4096, device_id: int = 0) -> None:
+    """
+    Record the AICPU log messages of later launches in binary rings.
+
+    Each AICPU scheduler thread appends raw records (format id plus
+    arguments) to its own ring instead of formatting messages on the
+    device, so logging barely changes scheduling timing. Full rings
+    overwrite their oldest records. Use dump_device_log() to read them.
+
+    Messages below the compile-time level are not built into the AICPU
+    library at all; set PTO_DEVICE_LOG_LEVEL (0=debug, 1=info, 2=warn,
+    3=error, 4=none; default 1) when building the runtime to change it.
+
+    Args:
+        records_per_thread: Ring size per thread, 0 to log as text again
+        device_id: Device whose launches to record
+
+    Raises:
+        RuntimeError: If not initialized, launches are in flight or
+            allocation fails
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    rc = _lib.enable_device_log(device_id, records_per_thread)
+    if rc != 0:
+        raise RuntimeError(f"enable_device_log failed: {rc}")
+
+
+def dump_device_log(path: Optional[Union[str, Path]] = None, device_id: int = 0) -> int:
+    """
+    Format the AICPU log messages recorded since the last dump.
+
+    Records of all threads are merged by timestamp. Wait for the device's
+    launches first. The rings are emptied afterwards.
+
+    Args:
+        path: Output text file (default: stdout)
+        device_id: Device to read
+
+    Returns:
+        Number of messages written
+
+    Raises:
+        RuntimeError: If not initialized, the log is not enabled or decoding fails
+    """
+
+    global _lib
+    if _lib is None:
+        raise RuntimeError("Runtime not loaded. Call bind_host_binary() first.")
+
+    rc = _lib.dump_device_log(device_id, str(path).encode() if path is not None else None)
+    if rc < 0:
+        raise RuntimeError(f"dump_device_log failed: {rc}")
+    return rc
+
+
 # ============================================================================
 # Public API
 # ============================================================================
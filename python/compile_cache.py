@@ -0,0 +1,207 @@
+"""
+Content-addressed on-disk cache for compiled artifacts.
+
+Compiling the runtime binaries, orchestration SOs and incore kernels takes
+tens of seconds, even when nothing changed. The compilers key every artifact
+with a hash of everything that affects its output: the source contents, the
+contents of the include/source directories, the toolchain version, the flags
+and the platform. An artifact with a known key is loaded from disk instead
+of being rebuilt.
+
+Environment:
+    PTO_COMPILE_CACHE_DIR: Cache directory (default: ~/.cache/pto_runtime)
+    PTO_COMPILE_CACHE=0:   Disable the cache
+
+Concurrency: entries are written to a temporary file and renamed into place,
+so readers only ever see complete artifacts. Builders of the same key hold
+an flock on the entry's lock file, so parallel jobs on one host compile each
+artifact once and the others wait for it.
+"""
+
+import fcntl
+import hashlib
+import os
+import subprocess
+import tempfile
+from pathlib import Path
+from typing import Callable, Dict, Iterable, Optional, Tuple, Union
+
+
+# Bump to invalidate all entries written by an older cache layout
+CACHE_VERSION = "1"
+
+_SKIP_DIRS = {"__pycache__", ".git"}
+
+
+class CompileCache:
+    """
+    Persistent artifact cache shared by all compilers of a process.
+
+    Use key() to describe an artifact and get_or_build() to load it or
+    build and store it.
+    """
+
+    def __init__(self, cache_dir: Optional[Union[str, Path]] = None, enabled: Optional[bool] = None):
+        """
+        Initialize the cache.
+
+        Args:
+            cache_dir: Cache directory. Defaults to PTO_COMPILE_CACHE_DIR or
+                       ~/.cache/pto_runtime.
+            enabled: Whether artifacts are cached. Defaults to False if
+                     PTO_COMPILE_CACHE is "0", True otherwise.
+        """
+        if cache_dir is None:
+            cache_dir = os.environ.get("PTO_COMPILE_CACHE_DIR",
+                                       str(Path.home() / ".cache" / "pto_runtime"))
+        if enabled is None:
+            enabled = os.environ.get("PTO_COMPILE_CACHE", "1") != "0"
+        self.cache_dir = Path(cache_dir)
+        self.enabled = enabled
+        self._tool_versions: Dict[str, str] = {}
+        self._dir_digests: Dict[Tuple, str] = {}
+
+    def key(
+        self,
+        kind: str,
+        platform: str,
+        tools: Iterable[str] = (),
+        flags: Iterable[str] = (),
+        files: Iterable[Union[str, Path]] = (),
+        dirs: Iterable[Union[str, Path]] = (),
+        data: Iterable[bytes] = (),
+    ) -> str:
+        """
+        Compute the key of an artifact.
+
+        Args:
+            kind: Artifact kind (e.g. "incore", "orchestration", "host")
+            platform: Target platform
+            tools: Compiler executables; their --version output is hashed
+            flags: Compiler flags or other options
+            files: Source files whose contents are hashed
+            dirs: Directories whose files (recursively) are hashed
+            data: Raw inputs (e.g. an object file a .text section comes from)
+
+        Returns:
+            Hex digest identifying the artifact
+        """
+        h = hashlib.sha256()
+
+        def add(tag: str, value: Union[str, bytes]) -> None:
+            if isinstance(value, str):
+                value = value.encode()
+            h.update(f"{tag}:{len(value)}:".encode())
+            h.update(value)
+
+        add("version", CACHE_VERSION)
+        add("kind", kind)
+        add("platform", platform)
+        for tool in tools:
+            add("tool", self._tool_version(tool))
+        for flag in flags:
+            add("flag", flag)
+        for path in files:
+            add("file", str(Path(path).resolve()))
+            add("contents", Path(path).read_bytes())
+        for path in dirs:
+            add("dir", self._dir_digest(Path(path)))
+        for blob in data:
+            add("data", blob)
+        return h.hexdigest()
+
+    def get_or_build(self, key: str, build: Callable[[], bytes]) -> bytes:
+        """
+        Load an artifact, or build and store it.
+
+        Args:
+            key: Key from key()
+            build: Produces the artifact on a cache miss
+
+        Returns:
+            Artifact contents
+        """
+        if not self.enabled:
+            return build()
+
+        entry = self.cache_dir / key[:2] / key
+        data = self._read(entry)
+        if data is not None:
+            print(f"[CompileCache] Hit: {key[:16]} ({len(data)} bytes)")
+            return data
+
+        entry.parent.mkdir(parents=True, exist_ok=True)
+        with open(entry.with_suffix(".lock"), "w") as lock:
+            fcntl.flock(lock, fcntl.LOCK_EX)
+            # Another job may have built it while we waited for the lock
+            data = self._read(entry)
+            if data is not None:
+                print(f"[CompileCache] Hit: {key[:16]} ({len(data)} bytes)")
+                return data
+
+            data = build()
+            fd, tmp_path = tempfile.mkstemp(dir=entry.parent, prefix=".tmp_")
+            try:
+                with os.fdopen(fd, "wb") as f:
+                    f.write(data)
+                os.replace(tmp_path, entry)
+            except BaseException:
+                os.unlink(tmp_path)
+                raise
+        print(f"[CompileCache] Stored: {key[:16]} ({len(data)} bytes)")
+        return data
+
+    @staticmethod
+    def _read(entry: Path) -> Optional[bytes]:
+        try:
+            return entry.read_bytes()
+        except FileNotFoundError:
+            return None
+
+    def _tool_version(self, tool: str) -> str:
+        """Identify a compiler by its path and --version output."""
+        if tool not in self._tool_versions:
+            try:
+                result = subprocess.run([tool, "--version"], capture_output=True, text=True, timeout=30)
+                version = result.stdout + result.stderr
+            except (OSError, subprocess.SubprocessError):
+                version = "unknown"
+            self._tool_versions[tool] = f"{tool}\n{version}"
+        return self._tool_versions[tool]
+
+    def _dir_digest(self, root: Path) -> str:
+        """
+        Hash the names and contents of all files under a directory.
+
+        Digests are memoized per process with the files' sizes and mtimes,
+        so unchanged directories are only read once.
+        """
+        root = root.resolve()
+        files = []
+        if root.is_dir():
+            for dirpath, dirnames, filenames in os.walk(root):
+                dirnames[:] = sorted(d for d in dirnames if d not in _SKIP_DIRS)
+                for name in sorted(filenames):
+                    path = Path(dirpath) / name
+                    st = path.stat()
+                    files.append((str(path.relative_to(root)), st.st_size, st.st_mtime_ns))
+
+        signature = (str(root), tuple(files))
+        if signature not in self._dir_digests:
+            h = hashlib.sha256(str(root).encode())
+            for rel, _, _ in files:
+                h.update(rel.encode() + b"\0")
+                h.update(hashlib.sha256((root / rel).read_bytes()).digest())
+            self._dir_digests[signature] = h.hexdigest()
+        return self._dir_digests[signature]
+
+
+_default_cache: Optional[CompileCache] = None
+
+
+def get_compile_cache() -> CompileCache:
+    """Return the process-wide cache configured from the environment."""
+    global _default_cache
+    if _default_cache is None:
+        _default_cache = CompileCache()
+    return _default_cache
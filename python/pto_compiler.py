@@ -1,10 +1,41 @@
+import functools
 import os
+import platform
 import subprocess
 import sys
 import time
 from pathlib import Path
 from typing import List, Optional
 
+from compile_cache import get_compile_cache
+
+
+@functools.lru_cache(maxsize=None)
+def _sim_target_flags() -> tuple:
+    """
+    Target flags of simulation kernels and a description of the target.
+
+    x86 kernels are built for the host CPU so the tile instructions
+    (src/platform/a2a3sim/aicore/pto) use its widest SIMD; NEON is part of
+    the AArch64 baseline. The description (what the compiler resolves
+    -march=native to) goes into the compile cache key, so a cache shared
+    between different CPUs does not hand out objects for the wrong one.
+
+    Returns:
+        (flags, description)
+    """
+    if platform.machine().lower() not in ("x86_64", "amd64", "i386", "i686"):
+        return (), platform.machine()
+    flags = ("-march=native",)
+    try:
+        result = subprocess.run(
+            ["g++", *flags, "-Q", "--help=target"], capture_output=True, text=True
+        )
+        description = result.stdout
+    except FileNotFoundError:
+        description = ""
+    return flags, description
+
 
 class PTOCompiler:
     """
@@ -15,6 +46,9 @@ class PTOCompiler:
     - "a2a3sim": Uses g++ for simulation kernels (host execution)
 
     Both platforms use g++ for orchestration compilation.
+
+    Results are cached on disk by content (see compile_cache.py), so
+    unchanged sources are not recompiled.
     """
 
     def __init__(self, platform: str = "a2a3", ascend_home_path: Optional[str] = None):
@@ -127,7 +161,21 @@ class PTOCompiler:
             extra_include_dirs=extra_include_dirs
         )
 
-        # Execute compilation
+        # Key on everything that reaches ccec except the temp output path
+        include_dirs = [os.path.dirname(source_path), pto_include] + list(extra_include_dirs or [])
+        key = get_compile_cache().key(
+            "incore", self.platform,
+            tools=[self.cc_path],
+            flags=[arg for arg in cmd if arg != output_path],
+            files=[source_path],
+            dirs=include_dirs,
+        )
+        return get_compile_cache().get_or_build(
+            key, lambda: self._run_incore_compile(cmd, output_path, source_path, core_type)
+        )
+
+    def _run_incore_compile(self, cmd: List[str], output_path: str, source_path: str, core_type: str) -> bytes:
+        """Run ccec and return the object file contents."""
         core_type_name = "AIV" if core_type == "aiv" else "AIC"
         print(f"\n{'='*80}")
         print(f"[Incore] Compiling ({core_type_name}): {source_path}")
@@ -281,7 +329,22 @@ class PTOCompiler:
         # Output and input
         cmd.extend(["-o", output_path, source_path])
 
-        # Print compilation command
+        # Key on everything that reaches g++ except the temp output path. The
+        # Ascend include dir is keyed by path only (it is large and versioned
+        # with the toolkit).
+        key = get_compile_cache().key(
+            "orchestration", self.platform,
+            tools=["g++"],
+            flags=[arg for arg in cmd if arg != output_path],
+            files=[source_path],
+            dirs=[os.path.dirname(source_path)] + list(extra_include_dirs or []),
+        )
+        return get_compile_cache().get_or_build(
+            key, lambda: self._run_orchestration_compile(cmd, output_path, source_path)
+        )
+
+    def _run_orchestration_compile(self, cmd: List[str], output_path: str, source_path: str) -> bytes:
+        """Run g++ and return the shared library contents."""
         print(f"\n{'='*80}")
         print(f"[Orchestration] Compiling: {source_path}")
         print(f"  Command: {' '.join(cmd)}")
@@ -328,6 +391,8 @@ class PTOCompiler:
 
         This compiles a simulation kernel (plain C++ code) to an object file,
         which can then have its .text section extracted for execution on host.
+        Kernels may use the PTO tile instructions: <pto/pto-inst.hpp>
+        resolves to their host implementation in src/platform/a2a3sim/aicore.
 
         Args:
             source_path: Path to kernel source file (.cpp)
@@ -347,16 +412,38 @@ class PTOCompiler:
         timestamp = int(time.time() * 1000)
         output_path = f"/tmp/sim_kernel_{timestamp}_{os.getpid()}.o"
 
-        # Build compilation command
+        # Build compilation command. Only the .text section is loaded, so
+        # nothing may call out of it: no stack protector (__stack_chk_fail)
+        # and no loops turned into memcpy/memset calls.
+        target_flags, target = _sim_target_flags()
+        tile_include = str(self.platform_dir / "aicore")
         cmd = [
             "g++", "-c",
             "-O2", "-fPIC", "-fno-plt",
+            "-fno-stack-protector",
             "-std=c++17",
+            *target_flags,
+            f"-I{tile_include}",
             "-o", output_path,
             source_path
         ]
+        if platform.system() != "Darwin":
+            cmd.insert(cmd.index("-std=c++17"), "-fno-tree-loop-distribute-patterns")
+
+        key = get_compile_cache().key(
+            "incore", self.platform,
+            tools=["g++"],
+            flags=[arg for arg in cmd if arg != output_path],
+            files=[source_path],
+            dirs=[os.path.dirname(source_path), os.path.join(tile_include, "pto")],
+            data=[target.encode()],
+        )
+        return get_compile_cache().get_or_build(
+            key, lambda: self._run_sim_compile(cmd, output_path, source_path)
+        )
 
-        # Print compilation command
+    def _run_sim_compile(self, cmd: List[str], output_path: str, source_path: str) -> bytes:
+        """Run g++ and return the object file contents."""
         print(f"\n{'='*80}")
         print(f"[SimKernel] Compiling: {source_path}")
         print(f"  Command: {' '.join(cmd)}")
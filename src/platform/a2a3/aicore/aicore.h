@@ -21,4 +21,7 @@
 #define __out__
 #endif
 
+// Idle hint of the polling loops - a device core has nothing to yield to
+#define core_idle() ((void)0)
+
 #endif
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "aicore.h"
 
 class Runtime;
+struct ExecutorDoorbell;
 
 #ifdef __AIV__
 #define KERNEL_ENTRY(x) \
@@ -23,6 +24,7 @@ class Runtime;
 [[block_local]] int core_type;
 
 extern __aicore__ void aicore_execute(__gm__ Runtime* runtime, int block_idx, int core_type);
+extern __aicore__ void aicore_execute_persistent(__gm__ ExecutorDoorbell* doorbell, int block_idx, int core_type);
 
 /**
  * Kernel entry point with control loop
@@ -36,10 +38,14 @@ extern __aicore__ void aicore_execute(__gm__ Runtime* runtime, int block_idx, in
  *    - Use DCCI to ensure cache coherency with AICPU
  *
  * Each core (AIC or AIV) gets its own handshake buffer indexed by block_idx.
+ * With a doorbell the kernel stays resident and runs the protocol once per
+ * graph submitted through it.
  *
- * @param runtime Address of Runtime structure in device memory
+ * @param runtime  Address of Runtime structure in device memory
+ * @param doorbell Persistent executor doorbell, or nullptr for one graph
  */
-extern "C" __global__ __aicore__ void KERNEL_ENTRY(aicore_kernel)(__gm__ Runtime* runtime) {
+extern "C" __global__ __aicore__ void KERNEL_ENTRY(aicore_kernel)(__gm__ Runtime* runtime,
+    __gm__ ExecutorDoorbell* doorbell) {
     // Calculate block_idx for this core
 #ifdef __AIV__
     block_idx = get_block_idx() * get_subblockdim() + get_subblockid() + get_block_num();
@@ -48,5 +54,9 @@ extern "C" __global__ __aicore__ void KERNEL_ENTRY(aicore_kernel)(__gm__ Runtime
     block_idx = get_block_idx();
     core_type = 0;
 #endif
+    if (doorbell != nullptr) {
+        aicore_execute_persistent(doorbell, block_idx, core_type);
+        return;
+    }
     aicore_execute(runtime, block_idx, core_type);
 }
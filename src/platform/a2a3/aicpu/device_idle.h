@@ -0,0 +1,11 @@
+/**
+ * Idle hint for AICPU kernel
+ *
+ * The scheduler calls aicpu_idle() whenever a polling pass found nothing to
+ * do. Each scheduler thread owns its AICPU core, so this is only the ARMv8
+ * spin-wait hint.
+ */
+
+#pragma once
+
+static inline void aicpu_idle() { asm volatile("yield" ::: "memory"); }
@@ -1,5 +1,10 @@
 /**
  * Device logging header for AICPU kernel
+ *
+ * Messages below PTO_DEVICE_LOG_LEVEL are compiled out. While the calling
+ * thread is bound to a log buffer (device_log_bind) messages are recorded
+ * in its binary ring instead of going to dlog; warnings and errors go to
+ * dlog as well. See common/device_log_ring.h.
  */
 
 #pragma once
@@ -9,6 +14,8 @@
 
 #include <cassert>
 
+#include "common/device_log_ring.h"
+#include "device_time.h"
 #include "dlog_pub.h"
 
 extern bool g_is_log_enable_debug;
@@ -26,38 +33,65 @@ constexpr const char *TILE_FWK_DEVICE_MACHINE = "AI_CPU";
 
 inline bool is_debug_mode() { return g_is_log_enable_debug; }
 
-#define D_DEV_LOGD(MODE_NAME, fmt, ...)                                                 \
-    do {                                                                                \
-        if (is_log_enable_debug()) {                                                       \
-            dlog_debug(AICPU, "%lu %s\n" #fmt, GET_TID(), __FUNCTION__, ##__VA_ARGS__); \
-        }                                                                               \
+#define D_DEV_LOGD(MODE_NAME, fmt, ...)                                                             \
+    do {                                                                                            \
+        if (device_log_ring_bound()) {                                                              \
+            DEVICE_LOG_RING_WRITE(DEVICE_LOG_LEVEL_DEBUG, get_sys_cnt_aicpu(), fmt, ##__VA_ARGS__); \
+        } else if (is_log_enable_debug()) {                                                         \
+            dlog_debug(AICPU, "%lu %s\n" #fmt, GET_TID(), __FUNCTION__, ##__VA_ARGS__);             \
+        }                                                                                           \
     } while (false)
 
-#define D_DEV_LOGI(MODE_NAME, fmt, ...)                                                \
-    do {                                                                               \
-        if (is_log_enable_info()) {                                                       \
-            dlog_info(AICPU, "%lu %s\n" #fmt, GET_TID(), __FUNCTION__, ##__VA_ARGS__); \
-        }                                                                              \
+#define D_DEV_LOGI(MODE_NAME, fmt, ...)                                                            \
+    do {                                                                                           \
+        if (device_log_ring_bound()) {                                                             \
+            DEVICE_LOG_RING_WRITE(DEVICE_LOG_LEVEL_INFO, get_sys_cnt_aicpu(), fmt, ##__VA_ARGS__); \
+        } else if (is_log_enable_info()) {                                                         \
+            dlog_info(AICPU, "%lu %s\n" #fmt, GET_TID(), __FUNCTION__, ##__VA_ARGS__);             \
+        }                                                                                          \
     } while (false)
 
-#define D_DEV_LOGW(MODE_NAME, fmt, ...)                                                \
-    do {                                                                               \
-        if (is_log_enable_warn()) {                                                       \
-            dlog_warn(AICPU, "%lu %s\n" #fmt, GET_TID(), __FUNCTION__, ##__VA_ARGS__); \
-        }                                                                              \
+// Warnings and errors reach dlog even when they are also recorded
+#define D_DEV_LOGW(MODE_NAME, fmt, ...)                                                            \
+    do {                                                                                           \
+        if (device_log_ring_bound()) {                                                             \
+            DEVICE_LOG_RING_WRITE(DEVICE_LOG_LEVEL_WARN, get_sys_cnt_aicpu(), fmt, ##__VA_ARGS__); \
+        }                                                                                          \
+        if (is_log_enable_warn()) {                                                                \
+            dlog_warn(AICPU, "%lu %s\n" #fmt, GET_TID(), __FUNCTION__, ##__VA_ARGS__);             \
+        }                                                                                          \
     } while (false)
 
-#define D_DEV_LOGE(MODE_NAME, fmt, ...)                                                 \
-    do {                                                                                \
-        if (is_log_enable_error()) {                                                       \
-            dlog_error(AICPU, "%lu %s\n" #fmt, GET_TID(), __FUNCTION__, ##__VA_ARGS__); \
-        }                                                                               \
+#define D_DEV_LOGE(MODE_NAME, fmt, ...)                                                             \
+    do {                                                                                            \
+        if (device_log_ring_bound()) {                                                              \
+            DEVICE_LOG_RING_WRITE(DEVICE_LOG_LEVEL_ERROR, get_sys_cnt_aicpu(), fmt, ##__VA_ARGS__); \
+        }                                                                                           \
+        if (is_log_enable_error()) {                                                                \
+            dlog_error(AICPU, "%lu %s\n" #fmt, GET_TID(), __FUNCTION__, ##__VA_ARGS__);             \
+        }                                                                                           \
     } while (false)
 
+#if PTO_DEVICE_LOG_LEVEL <= DEVICE_LOG_LEVEL_DEBUG
 #define DEV_DEBUG(fmt, args...) D_DEV_LOGD(TILE_FWK_DEVICE_MACHINE, fmt, ##args)
+#else
+#define DEV_DEBUG(fmt, args...) DEVICE_LOG_STRIPPED(fmt, ##args)
+#endif
+#if PTO_DEVICE_LOG_LEVEL <= DEVICE_LOG_LEVEL_INFO
 #define DEV_INFO(fmt, args...) D_DEV_LOGI(TILE_FWK_DEVICE_MACHINE, fmt, ##args)
+#else
+#define DEV_INFO(fmt, args...) DEVICE_LOG_STRIPPED(fmt, ##args)
+#endif
+#if PTO_DEVICE_LOG_LEVEL <= DEVICE_LOG_LEVEL_WARN
 #define DEV_WARN(fmt, args...) D_DEV_LOGW(TILE_FWK_DEVICE_MACHINE, fmt, ##args)
+#else
+#define DEV_WARN(fmt, args...) DEVICE_LOG_STRIPPED(fmt, ##args)
+#endif
+#if PTO_DEVICE_LOG_LEVEL <= DEVICE_LOG_LEVEL_ERROR
 #define DEV_ERROR(fmt, args...) D_DEV_LOGE(TILE_FWK_DEVICE_MACHINE, fmt, ##args)
+#else
+#define DEV_ERROR(fmt, args...) DEVICE_LOG_STRIPPED(fmt, ##args)
+#endif
 
 #define DEV_ASSERT_MSG(expr, fmt, args...)                           \
     do {                                                             \
@@ -0,0 +1,19 @@
+/**
+ * Device timestamp header for AICPU kernel
+ *
+ * Reads the same SoC system counter that AICore kernels read with
+ * get_sys_cnt(), so AICPU and AICore timestamps share one time base.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Read the system counter (ARMv8 generic timer virtual count)
+ */
+static inline uint64_t get_sys_cnt_aicpu() {
+    uint64_t cnt;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(cnt));
+    return cnt;
+}
@@ -7,6 +7,7 @@
 
 // Forward declaration of aicpu_execute (implemented in aicpu_executor.cpp)
 extern "C" int aicpu_execute(Runtime *arg);
+extern "C" int aicpu_execute_persistent(ExecutorDoorbell *doorbell);
 
 extern "C" __attribute__((visibility("default"))) int StaticTileFwkBackendKernelServer(void *arg) {
     if (arg == nullptr) {
@@ -44,6 +45,8 @@ extern "C" __attribute__((visibility("default"))) int DynTileFwkBackendKernelSer
  *
  * This is the main entry point for the AICPU runtime executor kernel.
  * It extracts the Runtime from KernelArgs and delegates to AicpuExecute.
+ * When KernelArgs carries a doorbell the kernel stays resident instead and
+ * runs every graph submitted through it until shutdown.
  *
  * Note: Function name is hardcoded in libaicpu_extend_kernels.so
  *
@@ -56,8 +59,13 @@ extern "C" __attribute__((visibility("default"))) int DynTileFwkBackendKernelSer
         return -1;
     }
 
-    // Extract Runtime from KernelArgs
     auto k_args = (KernelArgs *)arg;
+    if (k_args->doorbell != nullptr) {
+        DEV_INFO("%s", "DynTileFwkBackendKernelServer: Entering persistent executor loop");
+        return aicpu_execute_persistent(k_args->doorbell);
+    }
+
+    // Extract Runtime from KernelArgs
     Runtime *runtime = k_args->runtime_args;
 
     if (runtime == nullptr) {
@@ -18,6 +18,7 @@
 // Forward declaration
 class DeviceArgs;
 class Runtime;
+struct ExecutorDoorbell;
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +40,8 @@ extern "C" {
  * - device_args: Written by host, read by AICPU (contains aicpu_so_bin/aicpu_so_len)
  * - runtime_args: Written by host, read by AICPU (task runtime, includes
  * handshake buffers)
+ * - doorbell: Written by host, read by AICPU; set only when launching the
+ * persistent executor, which takes graphs from the doorbell instead
  *
  * Note: AICore kernels receive Runtime* directly, not KernelArgs
  *       - AICPU: accesses runtime_args->workers directly
@@ -48,6 +51,7 @@ struct KernelArgs {
     uint64_t unused[5] = {0};          // Alignment padding (required by CANN runtime offset)
     DeviceArgs *device_args{nullptr};  // Device arguments (AICPU reads, contains SO info)
     Runtime *runtime_args{nullptr};     // Task runtime in device memory
+    ExecutorDoorbell *doorbell{nullptr};  // Persistent executor doorbell, nullptr for one-shot launches
 };
 
 #ifdef __cplusplus
@@ -9,8 +9,12 @@
 
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <vector>
 
+#include "host/device_log_decoder.h"
 #include "runtime.h"
 
 // =============================================================================
@@ -51,25 +55,87 @@ int KernelArgsHelper::finalize_device_args() {
     return 0;
 }
 
-int KernelArgsHelper::init_runtime_args(const Runtime& host_runtime, MemoryAllocator& allocator) {
+int KernelArgsHelper::init_runtime_args(Runtime& host_runtime, MemoryAllocator& allocator, rtStream_t stream) {
     allocator_ = &allocator;
 
+    // Replay: the graph from the previous launch is still resident, so only
+    // the header (handshakes and launch parameters) and the args changed
+    // since then have to be copied. The AICPU executor restores per-task
+    // fanin on the device.
+    if (args.runtime_args != nullptr && resident_runtime == &host_runtime &&
+        resident_graph_version == host_runtime.get_graph_version()) {
+        uint64_t dev_base = reinterpret_cast<uint64_t>(args.runtime_args);
+        size_t header_size = host_runtime.get_device_header_size();
+        size_t args_offset = host_runtime.get_device_args_offset();
+        int range_count = 0;
+        const ArgRange* ranges = host_runtime.get_dirty_arg_ranges(&range_count);
+
+        // Stage the header and every dirty range back to back, then queue
+        // one copy per (already merged) range and wait once for all of them
+        size_t staged_size = header_size;
+        for (int i = 0; i < range_count; i++) {
+            staged_size += (ranges[i].end - ranges[i].begin) * sizeof(uint64_t);
+        }
+        std::vector<uint8_t> staging(staged_size);
+        host_runtime.write_device_header(staging.data(), dev_base);
+        int rc = rtMemcpyAsync(args.runtime_args, runtime_args_capacity, staging.data(), header_size,
+            RT_MEMCPY_HOST_TO_DEVICE, stream);
+        size_t staged = header_size;
+        for (int i = 0; i < range_count && rc == 0; i++) {
+            size_t offset = args_offset + ranges[i].begin * sizeof(uint64_t);
+            size_t bytes = (ranges[i].end - ranges[i].begin) * sizeof(uint64_t);
+            std::memcpy(staging.data() + staged, &host_runtime.task_args[ranges[i].begin], bytes);
+            rc = rtMemcpyAsync(reinterpret_cast<void*>(dev_base + offset), runtime_args_capacity - offset,
+                staging.data() + staged, bytes, RT_MEMCPY_HOST_TO_DEVICE, stream);
+            staged += bytes;
+        }
+        if (rc != 0) {
+            std::cerr << "Error: rtMemcpyAsync for runtime header or dirty args failed: " << rc << '\n';
+        }
+        // The staging buffer must outlive the queued copies, even failed ones
+        int sync_rc = rtStreamSynchronize(stream);
+        if (sync_rc != 0) {
+            std::cerr << "Error: rtStreamSynchronize for dirty args failed: " << sync_rc << '\n';
+            return sync_rc;
+        }
+        if (rc != 0) {
+            return rc;
+        }
+        host_runtime.clear_dirty_args();
+        return 0;
+    }
+
+    // Only the device header and the used part of the task graph are uploaded
+    uint64_t image_size = host_runtime.get_device_image_size();
+    if (args.runtime_args != nullptr && image_size > runtime_args_capacity) {
+        allocator_->free(args.runtime_args);
+        args.runtime_args = nullptr;
+    }
     if (args.runtime_args == nullptr) {
-        uint64_t runtime_size = sizeof(Runtime);
-        void* runtime_dev = allocator_->alloc(runtime_size);
+        void* runtime_dev = allocator_->alloc(image_size);
         if (runtime_dev == nullptr) {
             std::cerr << "Error: Alloc for runtime_args failed\n";
             return -1;
         }
         args.runtime_args = reinterpret_cast<Runtime*>(runtime_dev);
+        runtime_args_capacity = image_size;
     }
-    int rc = rtMemcpy(args.runtime_args, sizeof(Runtime), &host_runtime, sizeof(Runtime), RT_MEMCPY_HOST_TO_DEVICE);
+
+    // Stage the image on the host so the whole graph goes over in one copy
+    std::vector<uint8_t> image(image_size);
+    host_runtime.write_device_image(image.data(), reinterpret_cast<uint64_t>(args.runtime_args));
+    int rc = rtMemcpy(args.runtime_args, runtime_args_capacity, image.data(), image_size, RT_MEMCPY_HOST_TO_DEVICE);
     if (rc != 0) {
         std::cerr << "Error: rtMemcpy for runtime failed: " << rc << '\n';
         allocator_->free(args.runtime_args);
         args.runtime_args = nullptr;
+        runtime_args_capacity = 0;
+        resident_runtime = nullptr;
         return rc;
     }
+    resident_runtime = &host_runtime;
+    resident_graph_version = host_runtime.get_graph_version();
+    host_runtime.clear_dirty_args();
     return 0;
 }
 
@@ -77,6 +143,8 @@ int KernelArgsHelper::finalize_runtime_args() {
     if (args.runtime_args != nullptr && allocator_ != nullptr) {
         int rc = allocator_->free(args.runtime_args);
         args.runtime_args = nullptr;
+        runtime_args_capacity = 0;
+        resident_runtime = nullptr;
         return rc;
     }
     return 0;
@@ -127,11 +195,29 @@ int AicpuSoInfo::finalize() {
 // DeviceRunner Implementation
 // =============================================================================
 
-DeviceRunner& DeviceRunner::get() {
-    static DeviceRunner runner;
-    return runner;
+namespace {
+// Current device of each host thread, see DeviceRunner::set_current_device()
+thread_local int t_current_device = 0;
+}  // namespace
+
+DeviceRunner& DeviceRunner::get() { return get(t_current_device); }
+
+DeviceRunner& DeviceRunner::get(int device_id) {
+    static std::mutex registry_mutex;
+    static std::unique_ptr<DeviceRunner> registry[MAX_DEVICES];
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::unique_ptr<DeviceRunner>& runner = registry[device_id];
+    if (!runner) {
+        runner.reset(new DeviceRunner(device_id));
+    }
+    return *runner;
 }
 
+void DeviceRunner::set_current_device(int device_id) { t_current_device = device_id; }
+
+int DeviceRunner::current_device() { return t_current_device; }
+
 DeviceRunner::~DeviceRunner() { finalize(); }
 
 int DeviceRunner::ensure_device_initialized(
@@ -147,9 +233,18 @@ int DeviceRunner::ensure_device_initialized(
 }
 
 int DeviceRunner::ensure_device_set(int device_id) {
-    // Check if already initialized
+    if (device_id != registry_id_) {
+        std::cerr << "Error: device " << device_id << " requested from the runner of device " << registry_id_ << '\n';
+        return -1;
+    }
+
+    // Already initialized: only bind the device to the calling thread
     if (stream_aicpu_ != nullptr) {
-        return 0;
+        int rc = rtCtxSetCurrent(context_);
+        if (rc != 0) {
+            std::cerr << "Error: rtCtxSetCurrent for device " << device_id_ << " failed: " << rc << '\n';
+        }
+        return rc;
     }
 
     device_id_ = device_id;
@@ -161,6 +256,12 @@ int DeviceRunner::ensure_device_set(int device_id) {
         return rc;
     }
 
+    rc = rtCtxGetCurrent(&context_);
+    if (rc != 0) {
+        std::cerr << "Error: rtCtxGetCurrent failed: " << rc << '\n';
+        return rc;
+    }
+
     // Create streams
     rc = rtStreamCreate(&stream_aicpu_, 0);
     if (rc != 0) {
@@ -176,7 +277,25 @@ int DeviceRunner::ensure_device_set(int device_id) {
         return rc;
     }
 
-    std::cout << "DeviceRunner: device=" << device_id << " set, streams created\n";
+    rc = rtStreamCreate(&stream_transfer_, 0);
+    if (rc != 0) {
+        std::cerr << "Error: rtStreamCreate (transfer) failed: " << rc << '\n';
+        rtStreamDestroy(stream_aicpu_);
+        rtStreamDestroy(stream_aicore_);
+        stream_aicpu_ = nullptr;
+        stream_aicore_ = nullptr;
+        return rc;
+    }
+
+    uint32_t aicpu_count = 0;
+    rc = rtGetAiCpuCount(&aicpu_count);
+    if (rc != 0 || aicpu_count == 0) {
+        std::cerr << "Warning: rtGetAiCpuCount failed (" << rc << "), assuming 1 AICPU\n";
+        aicpu_count = 1;
+    }
+    aicpu_count_ = static_cast<int>(aicpu_count);
+
+    std::cout << "DeviceRunner: device=" << device_id << " set, streams created, " << aicpu_count_ << " AICPUs\n";
     return 0;
 }
 
@@ -216,6 +335,7 @@ int DeviceRunner::ensure_binaries_loaded(
         return rc;
     }
 
+    aicpu_so_binary_ = aicpu_so_binary;
     binaries_loaded_ = true;
     std::cout << "DeviceRunner: binaries loaded\n";
     return 0;
@@ -237,12 +357,109 @@ int DeviceRunner::copy_from_device(void* host_ptr, const void* dev_ptr, size_t b
     return rtMemcpy(host_ptr, bytes, dev_ptr, bytes, RT_MEMCPY_DEVICE_TO_HOST);
 }
 
+int DeviceRunner::copy_to_device_async(void* dev_ptr, const void* host_ptr, size_t bytes) {
+    if (stream_transfer_ == nullptr) {
+        std::cerr << "Error: device not set before an asynchronous copy\n";
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+    const void* src = host_ptr;
+    if (!pinned_pool_.contains(host_ptr, bytes)) {
+        void* staging = pinned_pool_.alloc(bytes);
+        if (staging == nullptr) {
+            // Out of pinned memory: fall back to a pageable synchronous copy
+            return copy_to_device(dev_ptr, host_ptr, bytes);
+        }
+        std::memcpy(staging, host_ptr, bytes);
+        staged_transfers_.push_back(StagedTransfer{staging, nullptr, bytes});
+        src = staging;
+    }
+    int rc = rtMemcpyAsync(dev_ptr, bytes, src, bytes, RT_MEMCPY_HOST_TO_DEVICE, stream_transfer_);
+    if (rc != 0) {
+        std::cerr << "Error: rtMemcpyAsync to device failed: " << rc << '\n';
+        if (transfer_status_ == 0) transfer_status_ = rc;
+    }
+    return rc;
+}
+
+int DeviceRunner::copy_from_device_async(void* host_ptr, const void* dev_ptr, size_t bytes) {
+    if (stream_transfer_ == nullptr) {
+        std::cerr << "Error: device not set before an asynchronous copy\n";
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+    void* dst = host_ptr;
+    if (!pinned_pool_.contains(host_ptr, bytes)) {
+        void* staging = pinned_pool_.alloc(bytes);
+        if (staging == nullptr) {
+            return copy_from_device(host_ptr, dev_ptr, bytes);
+        }
+        staged_transfers_.push_back(StagedTransfer{staging, host_ptr, bytes});
+        dst = staging;
+    }
+    int rc = rtMemcpyAsync(dst, bytes, dev_ptr, bytes, RT_MEMCPY_DEVICE_TO_HOST, stream_transfer_);
+    if (rc != 0) {
+        std::cerr << "Error: rtMemcpyAsync from device failed: " << rc << '\n';
+        if (transfer_status_ == 0) transfer_status_ = rc;
+    }
+    return rc;
+}
+
+int DeviceRunner::sync_transfers() {
+    std::lock_guard<std::mutex> lock(transfer_mutex_);
+    if (stream_transfer_ == nullptr) {
+        return 0;
+    }
+    int rc = rtStreamSynchronize(stream_transfer_);
+    if (rc != 0) {
+        std::cerr << "Error: rtStreamSynchronize (transfer) failed: " << rc << '\n';
+    } else {
+        rc = transfer_status_;
+    }
+    for (const StagedTransfer& staged : staged_transfers_) {
+        if (staged.host_dst != nullptr && rc == 0) {
+            std::memcpy(staged.host_dst, staged.staging, staged.bytes);
+        }
+        pinned_pool_.free(staged.staging);
+    }
+    staged_transfers_.clear();
+    transfer_status_ = 0;
+    return rc;
+}
+
 int DeviceRunner::run(Runtime& runtime,
     int block_dim,
     int device_id,
     const std::vector<uint8_t>& aicpu_so_binary,
     const std::vector<uint8_t>& aicore_kernel_binary,
     int launch_aicpu_num) {
+    LaunchRecord* launch = nullptr;
+    int rc = run_async(runtime, block_dim, device_id, aicpu_so_binary, aicore_kernel_binary, launch_aicpu_num, &launch);
+    if (rc != 0) {
+        return rc;
+    }
+    return wait_launch(launch);
+}
+
+int DeviceRunner::run_async(Runtime& runtime,
+    int block_dim,
+    int device_id,
+    const std::vector<uint8_t>& aicpu_so_binary,
+    const std::vector<uint8_t>& aicore_kernel_binary,
+    int launch_aicpu_num,
+    LaunchRecord** launch) {
+    *launch = nullptr;
+    for (const LaunchRecord& pending : pending_launches_) {
+        if (pending.runtime == &runtime) {
+            std::cerr << "Error: runtime is still in flight; wait for its previous launch first\n";
+            return -1;
+        }
+    }
+    // Fail unsupported configurations before any core is started
+    if (runtime.check_launch() != 0) {
+        return -1;
+    }
+
     // Ensure device is initialized (lazy initialization)
     int rc = ensure_device_initialized(device_id, aicpu_so_binary, aicore_kernel_binary);
     if (rc != 0) {
@@ -250,6 +467,24 @@ int DeviceRunner::run(Runtime& runtime,
         return rc;
     }
 
+    // Tensor uploads still queued on the transfer stream must land before
+    // the kernels read them
+    rc = sync_transfers();
+    if (rc != 0) {
+        return rc;
+    }
+
+    launch_aicpu_num = resolve_aicpu_num(launch_aicpu_num, block_dim);
+    if (launch_aicpu_num < 0) {
+        return -1;
+    }
+
+    if (doorbell_dev_ != nullptr && (block_dim != persistent_block_dim_ || launch_aicpu_num != persistent_aicpu_num_)) {
+        std::cerr << "Error: persistent executor was started with block_dim=" << persistent_block_dim_ << " and "
+                  << persistent_aicpu_num_ << " AICPU instance(s)\n";
+        return -1;
+    }
+
     // Calculate execution parameters
     block_dim_ = block_dim;
 
@@ -264,6 +499,7 @@ int DeviceRunner::run(Runtime& runtime,
     worker_count_ = num_ai_core;  // Store for print_handshake_results in destructor
     runtime.block_dim = block_dim;
     runtime.sche_cpu_num = launch_aicpu_num;
+    runtime.device_log_buffer = reinterpret_cast<uint64_t>(log_buffer_);
 
     // Calculate number of AIC cores (1/3 of total)
     int num_aic = block_dim;  // Round up for 1/3
@@ -272,8 +508,13 @@ int DeviceRunner::run(Runtime& runtime,
         runtime.workers[i].aicpu_ready = 0;
         runtime.workers[i].aicore_done = 0;
         runtime.workers[i].control = 0;
-        runtime.workers[i].task = 0;
-        runtime.workers[i].task_status = 0;
+        runtime.workers[i].dispatch_seq = 0;
+        runtime.workers[i].complete_seq = 0;
+        runtime.workers[i].completion_slot = -1;
+        runtime.completion_board[i] = 0;
+        for (int s = 0; s < RUNTIME_HANDSHAKE_SLOTS; s++) {
+            runtime.workers[i].slot_task[s] = 0;
+        }
         // Set core type: first 1/3 are AIC (0), remaining 2/3 are AIV (1)
         runtime.workers[i].core_type = (i < num_aic) ? 0 : 1;
     }
@@ -285,79 +526,520 @@ int DeviceRunner::run(Runtime& runtime,
         Task* task = runtime.get_task(i);
         if (task != nullptr) {
             uint64_t addr = get_function_bin_addr(task->func_id);
-            task->function_bin_addr = addr;
+            if (task->function_bin_addr != addr) {
+                task->function_bin_addr = addr;
+                runtime.invalidate_graph();  // Resident device copy is stale
+            }
             std::cout << "  Task " << i << " (func_id=" << task->func_id << ") -> function_bin_addr=0x" << std::hex
                       << addr << std::dec << '\n';
         }
     }
     std::cout << '\n';
 
-    // Initialize runtime args
-    rc = kernel_args_.init_runtime_args(runtime, mem_alloc_);
+    // Initialize runtime args in this runtime's own device copy
+    KernelArgsHelper& slot = runtime_args_[&runtime];
+    slot.args.device_args = kernel_args_.args.device_args;
+    {
+        // Replays queue their copies on the transfer stream
+        std::lock_guard<std::mutex> lock(transfer_mutex_);
+        rc = slot.init_runtime_args(runtime, mem_alloc_, stream_transfer_);
+    }
     if (rc != 0) {
         std::cerr << "Error: init_runtime_args failed: " << rc << '\n';
         return rc;
     }
+    last_runtime_args_ = std::addressof(slot);  // KernelArgsHelper overloads operator&
+
+    // Resident executors pick the graph up from the doorbell
+    if (doorbell_dev_ != nullptr) {
+        return submit_persistent(runtime, slot.args.runtime_args, launch);
+    }
 
     // Launch AICPU init kernel
-    rc = launch_aicpu_kernel(stream_aicpu_, &kernel_args_.args, "DynTileFwkKernelServerInit", 1);
+    rc = launch_aicpu_kernel(stream_aicpu_, &slot.args, "DynTileFwkKernelServerInit", 1);
     if (rc != 0) {
         std::cerr << "Error: launch_aicpu_kernel (init) failed: " << rc << '\n';
-        kernel_args_.finalize_runtime_args();
+        slot.finalize_runtime_args();
         return rc;
     }
 
     // Launch AICPU main kernel
-    rc = launch_aicpu_kernel(stream_aicpu_, &kernel_args_.args, "DynTileFwkKernelServer", launch_aicpu_num);
+    rc = launch_aicpu_kernel(stream_aicpu_, &slot.args, "DynTileFwkKernelServer", launch_aicpu_num);
     if (rc != 0) {
         std::cerr << "Error: launch_aicpu_kernel (main) failed: " << rc << '\n';
-        kernel_args_.finalize_runtime_args();
+        slot.finalize_runtime_args();
         return rc;
     }
 
     // Launch AICore kernel
-    rc = launch_aicore_kernel(stream_aicore_, kernel_args_.args.runtime_args);
+    rc = launch_aicore_kernel(stream_aicore_, slot.args.runtime_args);
     if (rc != 0) {
         std::cerr << "Error: launch_aicore_kernel failed: " << rc << '\n';
-        kernel_args_.finalize_runtime_args();
+        slot.finalize_runtime_args();
         return rc;
     }
 
-    // Synchronize streams
-    rc = rtStreamSynchronize(stream_aicpu_);
+    // Record completion on both streams; wait_launch() synchronizes on them
+    LaunchRecord record;
+    record.runner = this;
+    record.runtime = &runtime;
+    rc = rtEventCreate(&record.aicpu_done);
+    if (rc == 0) {
+        rc = rtEventRecord(record.aicpu_done, stream_aicpu_);
+    }
+    if (rc == 0) {
+        rc = rtEventCreate(&record.aicore_done);
+    }
+    if (rc == 0) {
+        rc = rtEventRecord(record.aicore_done, stream_aicore_);
+    }
     if (rc != 0) {
-        std::cerr << "Error: rtStreamSynchronize (AICPU) failed: " << rc << '\n';
-        kernel_args_.finalize_runtime_args();
+        std::cerr << "Error: recording launch completion events failed: " << rc << '\n';
+        if (record.aicpu_done != nullptr) rtEventDestroy(record.aicpu_done);
+        if (record.aicore_done != nullptr) rtEventDestroy(record.aicore_done);
+        // Fall back to a blocking wait so the device copy is not reused early
+        rtStreamSynchronize(stream_aicpu_);
+        rtStreamSynchronize(stream_aicore_);
         return rc;
     }
 
-    rc = rtStreamSynchronize(stream_aicore_);
-    if (rc != 0) {
-        std::cerr << "Error: rtStreamSynchronize (AICore) failed: " << rc << '\n';
-        kernel_args_.finalize_runtime_args();
+    pending_launches_.push_back(record);
+    *launch = &pending_launches_.back();
+    return 0;
+}
+
+int DeviceRunner::wait_launch(LaunchRecord* launch) {
+    if (launch == nullptr) {
+        return -1;
+    }
+    auto it = pending_launches_.begin();
+    while (it != pending_launches_.end() && &*it != launch) {
+        ++it;
+    }
+    if (it == pending_launches_.end()) {
+        std::cerr << "Error: unknown or already completed launch handle\n";
+        return -1;
+    }
+
+    if (it->submit_seq != 0) {
+        int rc = 0;
+        if (!it->retired) {
+            rc = wait_persistent_done(it->submit_seq);
+            if (rc == 0) {
+                rc = rtMemcpy(&it->status, sizeof(it->status), const_cast<int32_t*>(&doorbell_dev_->status),
+                    sizeof(it->status), RT_MEMCPY_DEVICE_TO_HOST);
+            }
+        }
+        if (rc == 0) {
+            rc = it->status;
+        }
+        pending_launches_.erase(it);
         return rc;
     }
 
+    int rc = rtEventSynchronize(it->aicpu_done);
+    if (rc != 0) {
+        std::cerr << "Error: rtEventSynchronize (AICPU) failed: " << rc << '\n';
+    }
+    int rc_aicore = rtEventSynchronize(it->aicore_done);
+    if (rc_aicore != 0) {
+        std::cerr << "Error: rtEventSynchronize (AICore) failed: " << rc_aicore << '\n';
+        if (rc == 0) rc = rc_aicore;
+    }
+    rtEventDestroy(it->aicpu_done);
+    rtEventDestroy(it->aicore_done);
+    pending_launches_.erase(it);
+
     // Note: FinalizeRuntimeArgs is deferred to Finalize() so PrintHandshakeResults can access device data
 
+    return rc;
+}
+
+int DeviceRunner::resolve_aicpu_num(int launch_aicpu_num, int block_dim) const {
+    if (launch_aicpu_num < 0 || launch_aicpu_num > RUNTIME_MAX_SCHED_THREADS) {
+        std::cerr << "Error: aicpu_thread_num " << launch_aicpu_num << " is out of range (0-"
+                  << RUNTIME_MAX_SCHED_THREADS << ")\n";
+        return -1;
+    }
+    if (launch_aicpu_num > 0) {
+        return launch_aicpu_num;
+    }
+    int available = aicpu_count_;
+    if (block_dim > 0 && available > block_dim) available = block_dim;
+    return available < RUNTIME_MAX_SCHED_THREADS ? available : RUNTIME_MAX_SCHED_THREADS;
+}
+
+// =============================================================================
+// Persistent Executors
+// =============================================================================
+
+int DeviceRunner::start_persistent(int block_dim,
+    int device_id,
+    const std::vector<uint8_t>& aicpu_so_binary,
+    const std::vector<uint8_t>& aicore_kernel_binary,
+    int launch_aicpu_num) {
+    if (doorbell_dev_ != nullptr) {
+        std::cerr << "Error: persistent executor is already running\n";
+        return -1;
+    }
+    if (block_dim <= 0 || block_dim * cores_per_blockdim_ > RUNTIME_MAX_WORKER || launch_aicpu_num < 0) {
+        std::cerr << "Error: invalid persistent executor configuration (block_dim=" << block_dim
+                  << ", aicpu_thread_num=" << launch_aicpu_num << ")\n";
+        return -1;
+    }
+
+    int rc = ensure_device_initialized(device_id, aicpu_so_binary, aicore_kernel_binary);
+    if (rc != 0) {
+        std::cerr << "Error: ensure_device_initialized failed: " << rc << '\n';
+        return rc;
+    }
+
+    launch_aicpu_num = resolve_aicpu_num(launch_aicpu_num, block_dim);
+    if (launch_aicpu_num < 0) {
+        return -1;
+    }
+
+    // The resident kernels occupy the streams; let one-shot launches finish
+    while (!pending_launches_.empty()) {
+        wait_launch(&pending_launches_.front());
+    }
+
+    ExecutorDoorbell* doorbell = static_cast<ExecutorDoorbell*>(mem_alloc_.alloc(sizeof(ExecutorDoorbell)));
+    if (doorbell == nullptr) {
+        std::cerr << "Error: Failed to allocate executor doorbell\n";
+        return -1;
+    }
+    ExecutorDoorbell host_doorbell;
+    std::memset(&host_doorbell, 0, sizeof(host_doorbell));
+    rc = rtMemcpy(doorbell, sizeof(ExecutorDoorbell), &host_doorbell, sizeof(host_doorbell), RT_MEMCPY_HOST_TO_DEVICE);
+    if (rc != 0) {
+        std::cerr << "Error: rtMemcpy for executor doorbell failed: " << rc << '\n';
+        mem_alloc_.free(doorbell);
+        return rc;
+    }
+
+    persistent_args_ = KernelArgs();
+    persistent_args_.device_args = kernel_args_.args.device_args;
+    persistent_args_.doorbell = doorbell;
+    block_dim_ = block_dim;
+
+    rc = launch_aicpu_kernel(stream_aicpu_, &persistent_args_, "DynTileFwkKernelServerInit", 1);
+    if (rc == 0) {
+        rc = launch_aicpu_kernel(stream_aicpu_, &persistent_args_, "DynTileFwkKernelServer", launch_aicpu_num);
+    }
+    if (rc == 0) {
+        rc = launch_aicore_kernel(stream_aicore_, nullptr, doorbell);
+    }
+    if (rc != 0) {
+        std::cerr << "Error: launching persistent executor failed: " << rc << '\n';
+        // Release any kernel that did start before freeing the doorbell
+        int32_t shutdown = 1;
+        rtMemcpy(const_cast<int32_t*>(&doorbell->shutdown), sizeof(shutdown), &shutdown, sizeof(shutdown),
+            RT_MEMCPY_HOST_TO_DEVICE);
+        rtStreamSynchronize(stream_aicpu_);
+        rtStreamSynchronize(stream_aicore_);
+        mem_alloc_.free(doorbell);
+        return rc;
+    }
+
+    doorbell_dev_ = doorbell;
+    persistent_block_dim_ = block_dim;
+    persistent_aicpu_num_ = launch_aicpu_num;
+    persistent_submitted_ = 0;
+    std::cout << "=== Persistent executor started: " << launch_aicpu_num << " AICPU instance(s), block_dim="
+              << block_dim << " ===" << '\n';
+    return 0;
+}
+
+int DeviceRunner::stop_persistent() {
+    if (doorbell_dev_ == nullptr) {
+        return 0;
+    }
+
+    int rc = wait_persistent_done(persistent_submitted_);
+    int32_t status = 0;
+    if (rc == 0) {
+        rc = rtMemcpy(&status, sizeof(status), const_cast<int32_t*>(&doorbell_dev_->status), sizeof(status),
+            RT_MEMCPY_DEVICE_TO_HOST);
+    }
+
+    // Launches that were never waited for keep their status
+    for (LaunchRecord& pending : pending_launches_) {
+        if (pending.submit_seq != 0 && !pending.retired) {
+            pending.status = (rc == 0) ? status : rc;
+            pending.retired = true;
+        }
+    }
+
+    int32_t shutdown = 1;
+    int rc_stop = rtMemcpy(const_cast<int32_t*>(&doorbell_dev_->shutdown), sizeof(shutdown), &shutdown,
+        sizeof(shutdown), RT_MEMCPY_HOST_TO_DEVICE);
+    if (rc_stop == 0) {
+        rc_stop = rtStreamSynchronize(stream_aicpu_);
+    }
+    if (rc_stop == 0) {
+        rc_stop = rtStreamSynchronize(stream_aicore_);
+    }
+    if (rc_stop != 0) {
+        std::cerr << "Error: stopping persistent executor failed: " << rc_stop << '\n';
+        if (rc == 0) rc = rc_stop;
+    }
+
+    mem_alloc_.free(doorbell_dev_);
+    doorbell_dev_ = nullptr;
+    persistent_block_dim_ = 0;
+    persistent_aicpu_num_ = 0;
+    std::cout << "=== Persistent executor stopped after " << persistent_submitted_ << " graph(s) ===" << '\n';
+    return rc;
+}
+
+int DeviceRunner::submit_persistent(Runtime& runtime, Runtime* dev_runtime, LaunchRecord** launch) {
+    // One submission at a time: the doorbell has a single runtime slot
+    int rc = wait_persistent_done(persistent_submitted_);
+    if (rc != 0) {
+        return rc;
+    }
+    for (LaunchRecord& pending : pending_launches_) {
+        if (pending.submit_seq == persistent_submitted_ && !pending.retired) {
+            rc = rtMemcpy(&pending.status, sizeof(pending.status), const_cast<int32_t*>(&doorbell_dev_->status),
+                sizeof(pending.status), RT_MEMCPY_DEVICE_TO_HOST);
+            if (rc != 0) {
+                return rc;
+            }
+            pending.retired = true;
+        }
+    }
+
+    // rtMemcpy is synchronous, so the executors see runtime and status
+    // before the new submit_seq
+    uint64_t runtime_addr = reinterpret_cast<uint64_t>(dev_runtime);
+    int32_t status = 0;
+    uint32_t seq = persistent_submitted_ + 1;
+    rc = rtMemcpy(const_cast<uint64_t*>(&doorbell_dev_->runtime), sizeof(runtime_addr), &runtime_addr,
+        sizeof(runtime_addr), RT_MEMCPY_HOST_TO_DEVICE);
+    if (rc == 0) {
+        rc = rtMemcpy(const_cast<int32_t*>(&doorbell_dev_->status), sizeof(status), &status, sizeof(status),
+            RT_MEMCPY_HOST_TO_DEVICE);
+    }
+    if (rc == 0) {
+        rc = rtMemcpy(const_cast<uint32_t*>(&doorbell_dev_->submit_seq), sizeof(seq), &seq, sizeof(seq),
+            RT_MEMCPY_HOST_TO_DEVICE);
+    }
+    if (rc != 0) {
+        std::cerr << "Error: ringing executor doorbell failed: " << rc << '\n';
+        return rc;
+    }
+    persistent_submitted_ = seq;
+
+    LaunchRecord record;
+    record.runner = this;
+    record.runtime = &runtime;
+    record.submit_seq = seq;
+    pending_launches_.push_back(record);
+    *launch = &pending_launches_.back();
+    return 0;
+}
+
+int DeviceRunner::wait_persistent_done(uint32_t seq) {
+    while (true) {
+        uint32_t done = 0;
+        int rc = rtMemcpy(&done, sizeof(done), const_cast<uint32_t*>(&doorbell_dev_->done_seq), sizeof(done),
+            RT_MEMCPY_DEVICE_TO_HOST);
+        if (rc != 0) {
+            std::cerr << "Error: reading executor doorbell failed: " << rc << '\n';
+            return rc;
+        }
+        if (static_cast<int32_t>(done - seq) >= 0) {
+            return 0;
+        }
+    }
+}
+
+void DeviceRunner::release_runtime(const Runtime& runtime) {
+    auto it = runtime_args_.find(&runtime);
+    if (it == runtime_args_.end()) {
+        return;
+    }
+    if (last_runtime_args_ == std::addressof(it->second)) {
+        last_runtime_args_ = nullptr;
+    }
+    it->second.finalize_runtime_args();
+    runtime_args_.erase(it);
+}
+
+int DeviceRunner::fetch_task_timing(Runtime& runtime) {
+    for (const LaunchRecord& pending : pending_launches_) {
+        if (pending.runtime == &runtime) {
+            std::cerr << "Error: runtime is still in flight; wait for its launch first\n";
+            return -1;
+        }
+    }
+    auto it = runtime_args_.find(&runtime);
+    if (it == runtime_args_.end() || it->second.args.runtime_args == nullptr) {
+        std::cerr << "Error: runtime has not been launched on this device\n";
+        return -1;
+    }
+
+    // Task holds atomics, so stage the device array as raw bytes
+    int task_count = runtime.get_task_count();
+    std::vector<uint8_t> staging(task_count * sizeof(Task));
+    if (staging.empty()) {
+        return 0;
+    }
+    const char* dev_tasks =
+        reinterpret_cast<const char*>(it->second.args.runtime_args) + runtime.get_device_header_size();
+    int rc = rtMemcpy(staging.data(), staging.size(), dev_tasks, staging.size(), RT_MEMCPY_DEVICE_TO_HOST);
+    if (rc != 0) {
+        std::cerr << "Error: rtMemcpy for task timestamps failed: " << rc << '\n';
+        return rc;
+    }
+
+    const Task* device = reinterpret_cast<const Task*>(staging.data());
+    for (int i = 0; i < task_count; i++) {
+        Task* task = runtime.get_task(i);
+        task->start_time = device[i].start_time;
+        task->end_time = device[i].end_time;
+        task->dispatch_time = device[i].dispatch_time;
+        task->complete_time = device[i].complete_time;
+        task->exec_core = device[i].exec_core;
+    }
     return 0;
 }
 
+int DeviceRunner::fetch_scheduler_stats(Runtime& runtime) {
+    for (const LaunchRecord& pending : pending_launches_) {
+        if (pending.runtime == &runtime) {
+            std::cerr << "Error: runtime is still in flight; wait for its launch first\n";
+            return -1;
+        }
+    }
+    auto it = runtime_args_.find(&runtime);
+    if (it == runtime_args_.end() || it->second.args.runtime_args == nullptr) {
+        std::cerr << "Error: runtime has not been launched on this device\n";
+        return -1;
+    }
+
+    // sched_stats and core_busy_ticks are adjacent in the device header
+    char* host_begin = reinterpret_cast<char*>(runtime.sched_stats);
+    char* host_end = reinterpret_cast<char*>(runtime.core_busy_ticks + RUNTIME_MAX_WORKER);
+    size_t offset = host_begin - reinterpret_cast<char*>(&runtime);
+    size_t size = host_end - host_begin;
+    const char* dev_begin = reinterpret_cast<const char*>(it->second.args.runtime_args) + offset;
+    int rc = rtMemcpy(host_begin, size, dev_begin, size, RT_MEMCPY_DEVICE_TO_HOST);
+    if (rc != 0) {
+        std::cerr << "Error: rtMemcpy for scheduler stats failed: " << rc << '\n';
+    }
+    return rc;
+}
+
+int DeviceRunner::enable_device_log(uint32_t records_per_thread) {
+    if (stream_aicpu_ == nullptr) {
+        std::cerr << "Error: Device not set. Call set_device() before enable_device_log()\n";
+        return -1;
+    }
+    if (!pending_launches_.empty()) {
+        std::cerr << "Error: cannot change the device log while launches are in flight\n";
+        return -1;
+    }
+    if (log_buffer_ != nullptr) {
+        mem_alloc_.free(log_buffer_);
+        log_buffer_ = nullptr;
+        log_records_per_thread_ = 0;
+    }
+    if (records_per_thread == 0) {
+        return 0;
+    }
+
+    size_t size = device_log_buffer_size(records_per_thread);
+    void* buffer = mem_alloc_.alloc(size);
+    if (buffer == nullptr) {
+        std::cerr << "Error: Failed to allocate the device log buffer (" << size << " bytes)\n";
+        return -1;
+    }
+    // Only the ring headers have to be valid; records beyond head are never read
+    std::vector<DeviceLogRing> rings(DEVICE_LOG_MAX_THREADS);
+    memset(rings.data(), 0, rings.size() * sizeof(DeviceLogRing));
+    for (DeviceLogRing& ring : rings) {
+        ring.capacity = records_per_thread;
+    }
+    size_t header_size = rings.size() * sizeof(DeviceLogRing);
+    int rc = rtMemcpy(buffer, header_size, rings.data(), header_size, RT_MEMCPY_HOST_TO_DEVICE);
+    if (rc != 0) {
+        std::cerr << "Error: rtMemcpy for the device log buffer failed: " << rc << '\n';
+        mem_alloc_.free(buffer);
+        return rc;
+    }
+    log_buffer_ = buffer;
+    log_records_per_thread_ = records_per_thread;
+    return 0;
+}
+
+int DeviceRunner::dump_device_log(const char* path) {
+    if (log_buffer_ == nullptr) {
+        std::cerr << "Error: device log is not enabled\n";
+        return -1;
+    }
+    if (!pending_launches_.empty()) {
+        std::cerr << "Error: launches are still in flight; wait for them first\n";
+        return -1;
+    }
+    if (aicpu_so_binary_.empty()) {
+        std::cerr << "Error: no AICPU library loaded to decode the device log\n";
+        return -1;
+    }
+
+    std::vector<uint8_t> host(device_log_buffer_size(log_records_per_thread_));
+    int rc = rtMemcpy(host.data(), host.size(), log_buffer_, host.size(), RT_MEMCPY_DEVICE_TO_HOST);
+    if (rc != 0) {
+        std::cerr << "Error: rtMemcpy for the device log failed: " << rc << '\n';
+        return -1;
+    }
+
+    FILE* out = path != nullptr ? fopen(path, "w") : stdout;
+    if (out == nullptr) {
+        std::cerr << "Error: Failed to open device log file " << path << '\n';
+        return -1;
+    }
+    int count = decode_device_log(aicpu_so_binary_.data(), aicpu_so_binary_.size(), host.data(),
+        SYS_CNT_TICKS_PER_US, out);
+    if (path != nullptr) {
+        fclose(out);
+    } else {
+        fflush(out);
+    }
+
+    // Empty the rings for the next dump
+    DeviceLogRing* rings = reinterpret_cast<DeviceLogRing*>(host.data());
+    for (int t = 0; t < DEVICE_LOG_MAX_THREADS; t++) {
+        rings[t].head = 0;
+    }
+    size_t header_size = DEVICE_LOG_MAX_THREADS * sizeof(DeviceLogRing);
+    rc = rtMemcpy(log_buffer_, header_size, rings, header_size, RT_MEMCPY_HOST_TO_DEVICE);
+    if (rc != 0) {
+        std::cerr << "Error: rtMemcpy to reset the device log failed: " << rc << '\n';
+        return -1;
+    }
+    return count;
+}
+
 void DeviceRunner::print_handshake_results() {
-    if (stream_aicpu_ == nullptr || worker_count_ == 0 || kernel_args_.args.runtime_args == nullptr) {
+    if (stream_aicpu_ == nullptr || worker_count_ == 0 || last_runtime_args_ == nullptr ||
+        last_runtime_args_->args.runtime_args == nullptr) {
         return;
     }
 
     // Allocate temporary buffer to read handshake data from device
     std::vector<Handshake> workers(worker_count_);
     size_t total_size = sizeof(Handshake) * worker_count_;
-    rtMemcpy(workers.data(), total_size, kernel_args_.args.runtime_args->workers, total_size, RT_MEMCPY_DEVICE_TO_HOST);
+    rtMemcpy(workers.data(), total_size, last_runtime_args_->args.runtime_args->workers, total_size,
+        RT_MEMCPY_DEVICE_TO_HOST);
 
     std::cout << "Handshake results for " << worker_count_ << " cores:" << std::endl;
     for (int i = 0; i < worker_count_; i++) {
         std::cout << "  Core " << i << ": aicore_done=" << workers[i].aicore_done
                   << " aicpu_ready=" << workers[i].aicpu_ready << " control=" << workers[i].control
-                  << " task=" << workers[i].task << std::endl;
+                  << " dispatched=" << workers[i].dispatch_seq << " completed=" << workers[i].complete_seq
+                  << std::endl;
     }
 }
 
@@ -366,11 +1048,21 @@ int DeviceRunner::finalize() {
         return 0;
     }
 
+    // Stop resident executors, then drain launches that were never waited for
+    stop_persistent();
+    while (!pending_launches_.empty()) {
+        wait_launch(&pending_launches_.front());
+    }
+
     // Print handshake results before cleanup (reads from device memory)
     print_handshake_results();
 
     // Cleanup runtime args (deferred from Run)
-    kernel_args_.finalize_runtime_args();
+    for (auto& entry : runtime_args_) {
+        entry.second.finalize_runtime_args();
+    }
+    runtime_args_.clear();
+    last_runtime_args_ = nullptr;
 
     // Cleanup kernel args (deviceArgs)
     kernel_args_.finalize_device_args();
@@ -381,8 +1073,16 @@ int DeviceRunner::finalize() {
     // Clear kernel address mapping
     func_id_to_addr_.clear();
     binaries_loaded_ = false;
-
-    // Destroy streams
+    aicpu_so_binary_.clear();
+    log_buffer_ = nullptr;  // Freed with the pool below
+    log_records_per_thread_ = 0;
+
+    // Destroy streams, letting queued transfers finish first
+    sync_transfers();
+    if (stream_transfer_ != nullptr) {
+        rtStreamDestroy(stream_transfer_);
+        stream_transfer_ = nullptr;
+    }
     if (stream_aicpu_ != nullptr) {
         rtStreamDestroy(stream_aicpu_);
         stream_aicpu_ = nullptr;
@@ -393,9 +1093,16 @@ int DeviceRunner::finalize() {
     }
 
     // Free all remaining allocations (including handshake buffer and binGmAddr)
+    MemoryStats stats = mem_alloc_.get_stats();
+    if (stats.alloc_count > 0) {
+        std::cout << "Memory pool: peak " << stats.peak_bytes << " bytes, " << stats.cache_hits << "/"
+                  << stats.alloc_count << " allocations served from cache\n";
+    }
     mem_alloc_.finalize();
+    pinned_pool_.finalize();
 
     device_id_ = -1;
+    context_ = nullptr;
     worker_count_ = 0;
     aicore_kernel_binary_.clear();
 
@@ -426,7 +1133,7 @@ int DeviceRunner::launch_aicpu_kernel(rtStream_t stream, KernelArgs* k_args, con
         rtKernelType_t::KERNEL_TYPE_AICPU_KFC, "AST_DYN_AICPU", aicpu_num, &rt_args, nullptr, stream, 0);
 }
 
-int DeviceRunner::launch_aicore_kernel(rtStream_t stream, Runtime* runtime) {
+int DeviceRunner::launch_aicore_kernel(rtStream_t stream, Runtime* runtime, ExecutorDoorbell* doorbell) {
     if (aicore_kernel_binary_.empty()) {
         std::cerr << "Error: AICore kernel binary is empty\n";
         return -1;
@@ -450,9 +1157,10 @@ int DeviceRunner::launch_aicore_kernel(rtStream_t stream, Runtime* runtime) {
 
     struct Args {
         Runtime* runtime;
+        ExecutorDoorbell* doorbell;
     };
-    // Pass device address of Runtime to AICore
-    Args args = {runtime};
+    // Pass device address of Runtime (or of the persistent doorbell) to AICore
+    Args args = {runtime, doorbell};
     rtArgsEx_t rt_args;
     std::memset(&rt_args, 0, sizeof(rt_args));
     rt_args.args = &args;
@@ -525,6 +1233,67 @@ int DeviceRunner::register_kernel(int func_id, const uint8_t* bin_data, size_t b
     return 0;
 }
 
+int DeviceRunner::register_kernels(const int* func_ids, const uint8_t* const* bin_data, const size_t* bin_sizes,
+                                   int count) {
+    if (count < 0 || (count > 0 && (func_ids == nullptr || bin_data == nullptr || bin_sizes == nullptr))) {
+        std::cerr << "Error: Invalid kernel batch\n";
+        return -1;
+    }
+
+    // Device must be set first (set_device() must be called before register_kernels())
+    if (stream_aicpu_ == nullptr) {
+        std::cerr << "Error: Device not set. Call set_device() before register_kernels()\n";
+        return -1;
+    }
+
+    // Keep the first occurrence of every func_id that is not registered yet
+    std::vector<int> ids;
+    std::vector<const uint8_t*> bins;
+    std::vector<size_t> sizes;
+    std::set<int> batch;
+    for (int i = 0; i < count; i++) {
+        if (bin_data[i] == nullptr || bin_sizes[i] == 0) {
+            std::cerr << "Error: Invalid kernel binary data for func_id=" << func_ids[i] << '\n';
+            return -1;
+        }
+        if (func_id_to_addr_.find(func_ids[i]) != func_id_to_addr_.end() || !batch.insert(func_ids[i]).second) {
+            std::cout << "Kernel func_id=" << func_ids[i] << " already registered, skipping\n";
+            continue;
+        }
+        ids.push_back(func_ids[i]);
+        bins.push_back(bin_data[i]);
+        sizes.push_back(bin_sizes[i]);
+    }
+    if (ids.empty()) {
+        return 0;
+    }
+
+    // One image, one allocation, one copy
+    std::vector<uint8_t> image;
+    pack_core_function_bins(bins.data(), sizes.data(), ids.size(), &image);
+    void* gm_addr = mem_alloc_.alloc(image.size());
+    if (gm_addr == nullptr) {
+        std::cerr << "Error: Failed to allocate device GM memory for " << ids.size() << " kernels\n";
+        return -1;
+    }
+    int rc = rtMemcpy(gm_addr, image.size(), image.data(), image.size(), RT_MEMCPY_HOST_TO_DEVICE);
+    if (rc != 0) {
+        std::cerr << "Error: rtMemcpy to device failed: " << rc << '\n';
+        mem_alloc_.free(gm_addr);
+        return rc;
+    }
+
+    CoreFunctionBinCache* cache = reinterpret_cast<CoreFunctionBinCache*>(image.data());
+    for (size_t i = 0; i < ids.size(); i++) {
+        uint64_t code_offset = cache->get_kernel(i)->data - image.data();
+        func_id_to_addr_[ids[i]] = reinterpret_cast<uint64_t>(gm_addr) + code_offset;
+    }
+
+    std::cout << "Registered " << ids.size() << " kernels in one " << image.size() << "-byte image at 0x" << std::hex
+              << reinterpret_cast<uint64_t>(gm_addr) << std::dec << '\n';
+    return 0;
+}
+
 uint64_t DeviceRunner::get_function_bin_addr(int func_id) {
     auto it = func_id_to_addr_.find(func_id);
     if (it == func_id_to_addr_.end()) {
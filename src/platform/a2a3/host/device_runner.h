@@ -17,7 +17,10 @@
 #include <runtime/rt.h>
 
 #include <cstdint>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -53,6 +56,11 @@ struct DeviceArgs {
 struct KernelArgsHelper {
     KernelArgs args;
     MemoryAllocator* allocator_{nullptr};
+    uint64_t runtime_args_capacity{0};  // Bytes allocated at args.runtime_args
+
+    // Runtime whose graph is currently resident at args.runtime_args
+    const Runtime* resident_runtime{nullptr};
+    uint64_t resident_graph_version{0};
 
     /**
      * Initialize device arguments by allocating device memory and copying data
@@ -73,11 +81,19 @@ struct KernelArgsHelper {
     /**
      * Initialize runtime arguments by allocating device memory and copying data
      *
+     * Uploads the runtime's device image (header plus packed task graph) in a
+     * single copy. The device buffer is reused across runs and only grows.
+     * When the same runtime is launched again with an unchanged graph
+     * structure, only the header and the dirty args ranges are re-uploaded:
+     * they are staged in one host buffer, copied asynchronously on `stream`
+     * and synchronized once.
+     *
      * @param host_runtime  Host-side runtime to copy to device
      * @param allocator  Memory allocator to use
+     * @param stream  Stream for the replay copies (synchronized before returning)
      * @return 0 on success, error code on failure
      */
-    int init_runtime_args(const Runtime& host_runtime, MemoryAllocator& allocator);
+    int init_runtime_args(Runtime& host_runtime, MemoryAllocator& allocator, rtStream_t stream);
 
     /**
      * Free device memory allocated for runtime arguments
@@ -97,6 +113,26 @@ struct KernelArgsHelper {
     KernelArgs* operator&() { return &args; }
 };
 
+/**
+ * Launch in flight on the device, returned by DeviceRunner::run_async()
+ *
+ * Completion is tracked with one event recorded on each stream after the
+ * kernels, so waiting does not block unrelated work queued behind it.
+ * Launches handed to the persistent executor record no events and are
+ * identified by their doorbell submission number instead.
+ */
+class DeviceRunner;
+
+struct LaunchRecord {
+    DeviceRunner* runner{nullptr};  // Device the launch was queued on
+    Runtime* runtime{nullptr};
+    rtEvent_t aicpu_done{nullptr};
+    rtEvent_t aicore_done{nullptr};
+    uint32_t submit_seq{0};   // Doorbell submission number, 0 = not persistent
+    bool retired{false};      // Persistent only: status below is final
+    int status{0};            // Persistent only: AICPU status of the submission
+};
+
 /**
  * AICPU shared object information and management
  *
@@ -126,10 +162,11 @@ struct AicpuSoInfo {
 };
 
 /**
- * Device runner singleton for kernel execution
+ * Per-device runner for kernel execution
  *
- * This class provides a unified interface for launching AICPU and AICore
- * kernels on Ascend devices. It handles:
+ * One instance exists per device, each with its own streams, allocator,
+ * kernel registry and launch queue, so several devices can be driven
+ * concurrently from one process (one host thread per device). It handles:
  * - Device initialization and resource management
  * - Tensor memory allocation and data transfer
  * - AICPU kernel launching with dynamic arguments
@@ -139,13 +176,41 @@ struct AicpuSoInfo {
  */
 class DeviceRunner {
 public:
+    static constexpr int MAX_DEVICES = 16;
+    static constexpr double SYS_CNT_TICKS_PER_US = 50.0;  // System counter frequency (50 MHz)
+
     /**
-     * Get singleton instance
+     * Get the runner of the calling thread's current device
      *
-     * @return Reference to the singleton DeviceRunner instance
+     * The current device is chosen per thread with set_current_device()
+     * (the C API's set_device()) and defaults to device 0.
+     *
+     * @return Reference to the current device's DeviceRunner
      */
     static DeviceRunner& get();
 
+    /**
+     * Get the runner of a device, creating it on first use
+     *
+     * @param device_id  Device ID (0 to MAX_DEVICES - 1)
+     * @return Reference to that device's DeviceRunner
+     */
+    static DeviceRunner& get(int device_id);
+
+    /**
+     * Select the device used by get() on the calling thread
+     *
+     * @param device_id  Device ID (0 to MAX_DEVICES - 1)
+     */
+    static void set_current_device(int device_id);
+
+    /**
+     * Get the calling thread's current device
+     *
+     * @return Device ID used by get()
+     */
+    static int current_device();
+
     /**
      * Allocate device tensor memory
      *
@@ -181,6 +246,63 @@ public:
      */
     int copy_from_device(void* host_ptr, const void* dev_ptr, size_t bytes);
 
+    /**
+     * Allocate page-locked host memory
+     *
+     * Asynchronous copies from and to pinned memory need no staging copy.
+     *
+     * @param bytes  Size in bytes
+     * @return Host pointer on success, nullptr on failure
+     */
+    void* allocate_pinned(size_t bytes) { return pinned_pool_.alloc(bytes); }
+
+    /**
+     * Free host memory returned by allocate_pinned()
+     *
+     * @param host_ptr  Pinned host pointer
+     */
+    void free_pinned(void* host_ptr) { pinned_pool_.free(host_ptr); }
+
+    /**
+     * Queue a copy from host to device on the transfer stream
+     *
+     * A pageable source is copied into a pinned staging block first, so the
+     * caller may reuse it as soon as the call returns. A pinned source
+     * (allocate_pinned()) is read directly by the DMA engine and must stay
+     * unchanged until sync_transfers(). Synchronous copies do not wait for
+     * queued ones.
+     *
+     * @param dev_ptr   Device pointer
+     * @param host_ptr  Host pointer
+     * @param bytes     Number of bytes to copy
+     * @return 0 on success, error code if the copy could not be queued
+     */
+    int copy_to_device_async(void* dev_ptr, const void* host_ptr, size_t bytes);
+
+    /**
+     * Queue a copy from device to host on the transfer stream
+     *
+     * The host buffer holds the data once sync_transfers() has returned; a
+     * pageable destination is filled from its staging block by the sync.
+     *
+     * @param host_ptr  Host pointer
+     * @param dev_ptr   Device pointer
+     * @param bytes     Number of bytes to copy
+     * @return 0 on success, error code if the copy could not be queued
+     */
+    int copy_from_device_async(void* host_ptr, const void* dev_ptr, size_t bytes);
+
+    /**
+     * Wait for every queued transfer of the device
+     *
+     * One stream synchronization covers all copies queued so far, from any
+     * host thread. Staged downloads are then copied to their destinations
+     * and the staging blocks recycled.
+     *
+     * @return 0 on success, the first error of a queued transfer otherwise
+     */
+    int sync_transfers();
+
     /**
      * Execute a runtime
      *
@@ -200,7 +322,7 @@ public:
      * @param device_id            Device ID (0-15)
      * @param aicpu_so_binary       Binary data of AICPU shared object
      * @param aicore_kernel_binary  Binary data of AICore kernel
-     * @param launch_aicpu_num      Number of AICPU instances (default: 1)
+     * @param launch_aicpu_num      Number of AICPU instances, 0 = one per AICPU (default: 1)
      * @return 0 on success, error code on failure
      */
     int run(Runtime& runtime,
@@ -210,6 +332,158 @@ public:
         const std::vector<uint8_t>& aicore_kernel_binary,
         int launch_aicpu_num = 1);
 
+    /**
+     * Start executing a runtime without waiting for it to finish
+     *
+     * Performs steps 1-6 of run() and records a completion event on each
+     * stream. Every runtime keeps its own device copy, so the host can build
+     * and launch further runtimes while this one executes; launches run on
+     * the device in submission order. A runtime cannot be launched again
+     * until its previous launch has been waited for.
+     *
+     * @param runtime              Runtime to execute
+     * @param block_dim            Number of blocks (1 block = 1 AIC + 2 AIV)
+     * @param device_id            Device ID (0-15)
+     * @param aicpu_so_binary      Binary data of AICPU shared object
+     * @param aicore_kernel_binary Binary data of AICore kernel
+     * @param launch_aicpu_num     Number of AICPU instances, 0 = one per AICPU
+     * @param launch               Output: handle to pass to wait_launch()
+     * @return 0 on success, error code on failure
+     */
+    int run_async(Runtime& runtime,
+        int block_dim,
+        int device_id,
+        const std::vector<uint8_t>& aicpu_so_binary,
+        const std::vector<uint8_t>& aicore_kernel_binary,
+        int launch_aicpu_num,
+        LaunchRecord** launch);
+
+    /**
+     * Wait for a launch started by run_async() and release its handle
+     *
+     * @param launch  Handle returned by run_async()
+     * @return 0 on success, error code on failure
+     */
+    int wait_launch(LaunchRecord* launch);
+
+    /**
+     * Create a device memory arena (see MemoryAllocator::create_arena)
+     *
+     * @return Arena id
+     */
+    int create_arena() { return mem_alloc_.create_arena(); }
+
+    /**
+     * Select the arena that subsequent allocate_tensor() calls of the calling
+     * thread belong to
+     *
+     * @param arena  Arena id, or 0 for none
+     */
+    void set_current_arena(int arena) { mem_alloc_.set_current_arena(arena); }
+
+    /**
+     * Free every tensor of an arena in one call
+     *
+     * @param arena  Arena id
+     * @return Number of tensors freed
+     */
+    size_t release_arena(int arena) { return mem_alloc_.release_arena(arena); }
+
+    /**
+     * List the tensors of an arena in allocation order
+     *
+     * @param arena  Arena id
+     * @return Device address and size of every tensor
+     */
+    std::vector<std::pair<void*, size_t>> arena_tensors(int arena) const { return mem_alloc_.arena_allocations(arena); }
+
+    /**
+     * Get statistics of the device memory pool
+     */
+    MemoryStats get_memory_stats() const { return mem_alloc_.get_stats(); }
+
+    /**
+     * Free the device copy kept for a runtime
+     *
+     * Called when the runtime is finalized. The runtime must not be in flight.
+     *
+     * @param runtime  Runtime whose device copy is no longer needed
+     */
+    void release_runtime(const Runtime& runtime);
+
+    /**
+     * Copy the DFX timestamps of a runtime's last launch back to the host
+     *
+     * Reads the task array of the runtime's device copy and updates the
+     * start/end/dispatch/complete times and executing core of every host
+     * task. The runtime must have been launched and must not be in flight.
+     *
+     * @param runtime  Runtime launched with profiling enabled
+     * @return 0 on success, error code on failure
+     */
+    int fetch_task_timing(Runtime& runtime);
+
+    /**
+     * Make the scheduler counters of a runtime's last launch available
+     *
+     * Runtime::sched_stats and core_busy_ticks are written by the AICPU in
+     * the runtime's device copy; this copies them back into the host runtime.
+     *
+     * @param runtime  Launched runtime
+     * @return 0 on success, error code on failure
+     */
+    int fetch_scheduler_stats(Runtime& runtime);
+
+    /**
+     * Record AICPU log messages in binary rings instead of printing them
+     *
+     * Allocates a device buffer with a ring of records_per_thread records
+     * per AICPU scheduler thread (see common/device_log_ring.h); later
+     * launches on this device log into it. An earlier buffer and its
+     * records are discarded. No launch may be in flight.
+     *
+     * @param records_per_thread  Ring size, 0 = free the buffer and log as text again
+     * @return 0 on success, error code on failure
+     */
+    int enable_device_log(uint32_t records_per_thread);
+
+    /**
+     * Format the recorded AICPU log messages and empty the rings
+     *
+     * @param path  Output file, nullptr = stdout
+     * @return Number of messages written, or -1 on failure
+     */
+    int dump_device_log(const char* path);
+
+    /**
+     * Launch executor kernels that stay resident and serve later launches
+     *
+     * The AICPU and AICore kernels are launched once with a doorbell in
+     * device memory. Until stop_persistent(), run()/run_async() only upload
+     * the runtime and ring the doorbell, so no kernels are launched per
+     * graph. Launches must use the block_dim and AICPU thread count given
+     * here.
+     *
+     * @param block_dim            Number of blocks (1 block = 1 AIC + 2 AIV)
+     * @param device_id            Device ID (0-15)
+     * @param aicpu_so_binary      AICPU shared object binary
+     * @param aicore_kernel_binary AICore kernel binary
+     * @param launch_aicpu_num     Number of AICPU instances, 0 = one per AICPU
+     * @return 0 on success, error code on failure
+     */
+    int start_persistent(int block_dim,
+        int device_id,
+        const std::vector<uint8_t>& aicpu_so_binary,
+        const std::vector<uint8_t>& aicore_kernel_binary,
+        int launch_aicpu_num);
+
+    /**
+     * Wait for outstanding submissions and stop the resident executors
+     *
+     * @return 0 on success (also when no executor is running)
+     */
+    int stop_persistent();
+
     /**
      * Print handshake results from device
      *
@@ -247,11 +521,12 @@ public:
      * Internal method used by run(). Can be called directly for custom
      * workflows.
      *
-     * @param stream  AICore stream
+     * @param stream    AICore stream
      * @param runtime   Pointer to device runtime
+     * @param doorbell  Persistent executor doorbell, nullptr for one graph
      * @return 0 on success, error code on failure
      */
-    int launch_aicore_kernel(rtStream_t stream, Runtime* runtime);
+    int launch_aicore_kernel(rtStream_t stream, Runtime* runtime, ExecutorDoorbell* doorbell = nullptr);
 
     /**
      * Register a kernel binary for a func_id
@@ -270,6 +545,21 @@ public:
      */
     int register_kernel(int func_id, const uint8_t* bin_data, size_t bin_size);
 
+    /**
+     * Register a batch of kernel binaries with one allocation and one copy
+     *
+     * Packs the .text sections into a single CoreFunctionBinCache image,
+     * uploads it and fills func_id_to_addr_ from its offsets. func_ids that
+     * are already registered (or repeated within the batch) are skipped.
+     *
+     * @param func_ids   Function identifier of each kernel
+     * @param bin_data   Kernel .text section binary data of each kernel
+     * @param bin_sizes  Size of each binary in bytes
+     * @param count      Number of kernels
+     * @return 0 on success, -1 on error
+     */
+    int register_kernels(const int* func_ids, const uint8_t* const* bin_data, const size_t* bin_sizes, int count);
+
     /**
      * Get function_bin_addr for a given func_id
      *
@@ -289,17 +579,24 @@ public:
      * - rtSetDevice(device_id)
      * - Create AICPU and AICore streams
      *
+     * Once initialized, binds the device context to the calling thread so
+     * that any host thread can drive this device.
+     *
      * @param device_id  Device ID (0-15)
      * @return 0 on success, error code on failure
      */
     int ensure_device_set(int device_id);
 
 private:
-    DeviceRunner() = default;
+    friend struct std::default_delete<DeviceRunner>;
+    explicit DeviceRunner(int registry_id) : registry_id_(registry_id) {}
     ~DeviceRunner();
 
     // Internal state
+    int registry_id_;  // Device this runner was created for
     int device_id_{-1};
+    rtContext_t context_{nullptr};  // Device context, bound per calling thread
+    int aicpu_count_{1};            // AICPUs of the device (rtGetAiCpuCount)
     int block_dim_{0};
     int cores_per_blockdim_{3};
     int worker_count_{0};  // Stored for print_handshake_results in destructor
@@ -307,14 +604,44 @@ private:
 
     // Memory management
     MemoryAllocator mem_alloc_;
+    PinnedHostPool pinned_pool_;
+
+    // Staging blocks of queued transfers, released by sync_transfers()
+    struct StagedTransfer {
+        void* staging;   // Pinned block the DMA engine reads or writes
+        void* host_dst;  // Pageable destination of a download, nullptr for an upload
+        size_t bytes;
+    };
+    std::mutex transfer_mutex_;
+    std::vector<StagedTransfer> staged_transfers_;
+    int transfer_status_{0};  // First failed rtMemcpyAsync since the last sync
 
     // Device resources
     rtStream_t stream_aicpu_{nullptr};
     rtStream_t stream_aicore_{nullptr};
+    rtStream_t stream_transfer_{nullptr};  // Asynchronous tensor copies (copy_*_async)
     AicpuSoInfo so_info_;
-    KernelArgsHelper kernel_args_;
+    KernelArgsHelper kernel_args_;  // Shared device_args; runtime_args live in runtime_args_
     DeviceArgs device_args_;
 
+    // Per-runtime device copies, so several runtimes can be in flight
+    std::map<const Runtime*, KernelArgsHelper> runtime_args_;
+    const KernelArgsHelper* last_runtime_args_{nullptr};  // For print_handshake_results
+    std::list<LaunchRecord> pending_launches_;
+
+    // Resident executors (start_persistent), nullptr doorbell when inactive
+    ExecutorDoorbell* doorbell_dev_{nullptr};  // Device memory
+    KernelArgs persistent_args_;
+    int persistent_block_dim_{0};
+    int persistent_aicpu_num_{0};
+    uint32_t persistent_submitted_{0};
+
+    // AICPU log rings (enable_device_log, device memory) and the image of
+    // the AICPU library, whose format section decodes them
+    void* log_buffer_{nullptr};
+    uint32_t log_records_per_thread_{0};
+    std::vector<uint8_t> aicpu_so_binary_;
+
     // Kernel binary management
     bool binaries_loaded_{false};            // true after AICPU SO loaded
     std::map<int, uint64_t> func_id_to_addr_;  // func_id -> function_bin_addr (device GM)
@@ -349,6 +676,39 @@ private:
      * @return 0 on success, error code on failure
      */
     int ensure_binaries_loaded(const std::vector<uint8_t>& aicpu_so_binary, const std::vector<uint8_t>& aicore_kernel_binary);
+
+    /**
+     * Scheduler threads of a launch
+     *
+     * 0 asks for one thread per AICPU of the device, at most one per block
+     * and RUNTIME_MAX_SCHED_THREADS.
+     *
+     * @param launch_aicpu_num  Requested AICPU instances
+     * @param block_dim         Blocks of the launch
+     * @return Thread count, or -1 if launch_aicpu_num is out of range
+     */
+    int resolve_aicpu_num(int launch_aicpu_num, int block_dim) const;
+
+    /**
+     * Ring the persistent executor doorbell for an uploaded runtime
+     *
+     * Waits for the previous submission to finish first, since the doorbell
+     * holds a single runtime.
+     *
+     * @param runtime       Host runtime being launched
+     * @param dev_runtime   Its device copy
+     * @param launch        Output: handle to pass to wait_launch()
+     * @return 0 on success, error code on failure
+     */
+    int submit_persistent(Runtime& runtime, Runtime* dev_runtime, LaunchRecord** launch);
+
+    /**
+     * Poll the doorbell until submission seq has finished
+     *
+     * @param seq  Doorbell submission number
+     * @return 0 on success, error code if the doorbell cannot be read
+     */
+    int wait_persistent_done(uint32_t seq);
 };
 
 #endif  // RUNTIME_DEVICERUNNER_H
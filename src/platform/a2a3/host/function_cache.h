@@ -32,7 +32,10 @@
 #ifndef RUNTIME_FUNCTION_CACHE_H
 #define RUNTIME_FUNCTION_CACHE_H
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <vector>
 
 /**
  * Single kernel binary container
@@ -98,4 +101,48 @@ struct CoreFunctionBinCache {
     uint64_t get_total_size() const { return sizeof(CoreFunctionBinCache) + num_kernels * sizeof(uint64_t) + data_size; }
 };
 
+/**
+ * Alignment of every CoreFunctionBin within a packed cache image
+ *
+ * Matches the allocator's block alignment, so a kernel in a packed image
+ * is laid out exactly like an individually allocated one.
+ */
+constexpr uint64_t CORE_FUNCTION_BIN_ALIGN = 512;
+
+/**
+ * Pack kernel binaries into one CoreFunctionBinCache image
+ *
+ * Every CoreFunctionBin starts at a CORE_FUNCTION_BIN_ALIGN-aligned offset
+ * from the start of the image; offsets are stored relative to the binary
+ * data region as get_kernel() expects.
+ *
+ * @param bins   Kernel .text section of each kernel
+ * @param sizes  Size of each binary in bytes
+ * @param count  Number of kernels
+ * @param image  Output buffer, resized to the image's total size
+ */
+inline void pack_core_function_bins(const uint8_t* const* bins, const size_t* sizes, uint64_t count,
+                                    std::vector<uint8_t>* image) {
+    uint64_t header_size = sizeof(CoreFunctionBinCache) + count * sizeof(uint64_t);
+    std::vector<uint64_t> offsets(count);
+    uint64_t data_size = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t start = (header_size + data_size + CORE_FUNCTION_BIN_ALIGN - 1) / CORE_FUNCTION_BIN_ALIGN *
+                         CORE_FUNCTION_BIN_ALIGN;
+        offsets[i] = start - header_size;
+        data_size = offsets[i] + sizeof(uint64_t) + sizes[i];
+    }
+
+    image->assign(header_size + data_size, 0);
+    CoreFunctionBinCache* cache = reinterpret_cast<CoreFunctionBinCache*>(image->data());
+    cache->data_size = data_size;
+    cache->num_kernels = count;
+    for (uint64_t i = 0; i < count; i++) {
+        cache->get_offsets()[i] = offsets[i];
+        CoreFunctionBin* bin = cache->get_kernel(i);
+        bin->size = sizes[i];
+        std::memcpy(bin->data, bins[i], sizes[i]);
+    }
+}
+
 #endif  // RUNTIME_FUNCTION_CACHE_H
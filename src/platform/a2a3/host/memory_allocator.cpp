@@ -2,74 +2,368 @@
  * Memory Allocator Implementation
  *
  * This file implements centralized device memory management using the
- * Ascend CANN runtime API with RAII pattern.
+ * Ascend CANN runtime API with RAII pattern, as a caching pool of size
+ * classes on top of large rtMalloc slabs.
  */
 
 #include "memory_allocator.h"
 
 #include <runtime/rt.h>
 
+#include <algorithm>
 #include <iostream>
 
+namespace {
+
+// Size class of a small request: smallest power of two >= size, from MIN_BLOCK
+int small_class(size_t size) {
+    int cls = 0;
+    size_t block = MemoryAllocator::MIN_BLOCK;
+    while (block < size) {
+        block <<= 1;
+        cls++;
+    }
+    return cls;
+}
+
+}  // namespace
+
 MemoryAllocator::~MemoryAllocator() { finalize(); }
 
-void* MemoryAllocator::alloc(size_t size) {
+int MemoryAllocator::backend_alloc(void** ptr, size_t size) { return rtMalloc(ptr, size, RT_MEMORY_HBM, 0); }
+
+int MemoryAllocator::backend_free(void* ptr) { return rtFree(ptr); }
+
+void* MemoryAllocator::take_block(size_t size, int size_class, size_t* rounded, int* rc) {
+    if (size_class >= 0) {
+        size_t block_size = MIN_BLOCK << size_class;
+        *rounded = block_size;
+        std::vector<void*>& free_list = small_free_[size_class];
+        if (free_list.empty()) {
+            void* slab = nullptr;
+            *rc = backend_alloc(&slab, SLAB_SIZE);
+            if (*rc != 0) {
+                return nullptr;
+            }
+            slabs_.push_back(slab);
+            stats_.bytes_reserved += SLAB_SIZE;
+
+            // Push in reverse so blocks are handed out in address order
+            size_t count = SLAB_SIZE / block_size;
+            for (size_t i = count; i > 0; i--) {
+                free_list.push_back(static_cast<char*>(slab) + (i - 1) * block_size);
+            }
+        } else {
+            stats_.cache_hits++;
+        }
+        void* ptr = free_list.back();
+        free_list.pop_back();
+        return ptr;
+    }
+
+    size_t block_size = (size + SLAB_SIZE - 1) / SLAB_SIZE * SLAB_SIZE;
+    *rounded = block_size;
+    auto cached = large_free_.find(block_size);
+    if (cached != large_free_.end() && !cached->second.empty()) {
+        void* ptr = cached->second.back();
+        cached->second.pop_back();
+        stats_.cache_hits++;
+        return ptr;
+    }
     void* ptr = nullptr;
-    int rc = rtMalloc(&ptr, size, RT_MEMORY_HBM, 0);
-    if (rc != 0) {
+    *rc = backend_alloc(&ptr, block_size);
+    if (*rc != 0) {
+        return nullptr;
+    }
+    large_blocks_.insert(ptr);
+    stats_.bytes_reserved += block_size;
+    return ptr;
+}
+
+void* MemoryAllocator::alloc(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size == 0) {
+        size = MIN_BLOCK;
+    }
+    int size_class = (size <= SLAB_SIZE) ? small_class(size) : -1;
+
+    size_t rounded = 0;
+    int rc = 0;
+    void* ptr = take_block(size, size_class, &rounded, &rc);
+    if (ptr == nullptr && !large_free_.empty()) {
+        // Out of device memory: hand cached large blocks back and retry
+        trim_locked();
+        ptr = take_block(size, size_class, &rounded, &rc);
+    }
+    if (ptr == nullptr) {
         std::cerr << "Error: rtMalloc failed: " << rc << " (size=" << size << ")\n";
         return nullptr;
     }
 
-    // Track the pointer
-    ptr_set_.insert(ptr);
+    int arena = 0;
+    if (!current_arena_.empty()) {
+        auto current = current_arena_.find(std::this_thread::get_id());
+        if (current != current_arena_.end()) {
+            arena = current->second;
+        }
+    }
+    Block block{rounded, size_class, arena, 0, size, next_seq_++};
+    if (arena != 0) {
+        std::vector<void*>& members = arena_blocks_[arena];
+        block.arena_pos = members.size();
+        members.push_back(ptr);
+    }
+    live_[ptr] = block;
+
+    stats_.alloc_count++;
+    stats_.bytes_in_use += rounded;
+    if (stats_.bytes_in_use > stats_.peak_bytes) {
+        stats_.peak_bytes = stats_.bytes_in_use;
+    }
     return ptr;
 }
 
+void MemoryAllocator::release_block(void* ptr, Block& block) {
+    if (block.size_class >= 0) {
+        small_free_[block.size_class].push_back(ptr);
+    } else {
+        large_free_[block.size].push_back(ptr);
+    }
+    stats_.bytes_in_use -= block.size;
+}
+
+void MemoryAllocator::detach_from_arena(Block& block) {
+    auto it = arena_blocks_.find(block.arena);
+    if (it == arena_blocks_.end()) {
+        return;
+    }
+    // Swap-remove, fixing up the position of the block moved into the hole
+    std::vector<void*>& members = it->second;
+    void* moved = members.back();
+    members[block.arena_pos] = moved;
+    members.pop_back();
+    if (block.arena_pos < members.size()) {
+        live_[moved].arena_pos = block.arena_pos;
+    }
+    block.arena = 0;
+}
+
 int MemoryAllocator::free(void* ptr) {
     if (ptr == nullptr) {
         return 0;
     }
+    std::lock_guard<std::mutex> lock(mutex_);
 
     // Check if we're tracking this pointer
-    auto it = ptr_set_.find(ptr);
-    if (it == ptr_set_.end()) {
+    auto it = live_.find(ptr);
+    if (it == live_.end()) {
         // Not tracked by us, don't free
         return 0;
     }
 
-    // Free the memory
-    int rc = rtFree(ptr);
-    if (rc != 0) {
-        std::cerr << "Error: rtFree failed: " << rc << '\n';
-        return rc;
+    if (it->second.arena != 0) {
+        detach_from_arena(it->second);
     }
-
-    // Remove from tracking set
-    ptr_set_.erase(it);
+    release_block(ptr, it->second);
+    live_.erase(it);
     return 0;
 }
 
-int MemoryAllocator::finalize() {
-    // Idempotent - safe to call multiple times
-    if (finalized_) {
+int MemoryAllocator::create_arena() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int arena = next_arena_++;
+    arena_blocks_[arena];
+    return arena;
+}
+
+void MemoryAllocator::set_current_arena(int arena) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (arena != 0) {
+        current_arena_[std::this_thread::get_id()] = arena;
+    } else {
+        current_arena_.erase(std::this_thread::get_id());
+    }
+}
+
+size_t MemoryAllocator::release_arena(int arena) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = arena_blocks_.find(arena);
+    if (it == arena_blocks_.end()) {
         return 0;
     }
+    size_t released = it->second.size();
+    for (void* ptr : it->second) {
+        auto block = live_.find(ptr);
+        release_block(ptr, block->second);
+        live_.erase(block);
+    }
+    arena_blocks_.erase(it);
+    for (auto current = current_arena_.begin(); current != current_arena_.end();) {
+        if (current->second == arena) {
+            current = current_arena_.erase(current);
+        } else {
+            ++current;
+        }
+    }
+    return released;
+}
 
+std::vector<std::pair<void*, size_t>> MemoryAllocator::arena_allocations(int arena) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<uint64_t, void*>> ordered;
+    auto it = arena_blocks_.find(arena);
+    if (it != arena_blocks_.end()) {
+        for (void* ptr : it->second) {
+            ordered.emplace_back(live_.at(ptr).seq, ptr);
+        }
+    }
+    std::sort(ordered.begin(), ordered.end());
+    std::vector<std::pair<void*, size_t>> result;
+    for (const auto& entry : ordered) {
+        result.emplace_back(entry.second, live_.at(entry.second).requested);
+    }
+    return result;
+}
+
+int MemoryAllocator::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return trim_locked();
+}
+
+int MemoryAllocator::trim_locked() {
     int last_error = 0;
+    for (auto& entry : large_free_) {
+        for (void* ptr : entry.second) {
+            int rc = backend_free(ptr);
+            if (rc != 0) {
+                std::cerr << "Error: rtFree failed during trim: " << rc << '\n';
+                last_error = rc;
+            }
+            large_blocks_.erase(ptr);
+            stats_.bytes_reserved -= entry.first;
+        }
+    }
+    large_free_.clear();
+    return last_error;
+}
 
-    // Free all remaining tracked pointers
-    for (void* ptr : ptr_set_) {
-        int rc = rtFree(ptr);
+int MemoryAllocator::finalize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int last_error = 0;
+
+    // Free every driver allocation, whether its blocks are live or cached
+    for (void* slab : slabs_) {
+        int rc = backend_free(slab);
         if (rc != 0) {
             std::cerr << "Error: rtFree failed during Finalize: " << rc << '\n';
             last_error = rc;
         }
     }
+    for (void* ptr : large_blocks_) {
+        int rc = backend_free(ptr);
+        if (rc != 0) {
+            std::cerr << "Error: rtFree failed during Finalize: " << rc << '\n';
+            last_error = rc;
+        }
+    }
+
+    slabs_.clear();
+    large_blocks_.clear();
+    live_.clear();
+    for (std::vector<void*>& free_list : small_free_) {
+        free_list.clear();
+    }
+    large_free_.clear();
+    arena_blocks_.clear();
+    current_arena_.clear();
+    stats_ = MemoryStats();
+
+    return last_error;
+}
+
+size_t MemoryAllocator::get_allocation_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return live_.size();
+}
+
+MemoryStats MemoryAllocator::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+// =============================================================================
+// PinnedHostPool
+// =============================================================================
 
-    // Clear the set
-    ptr_set_.clear();
-    finalized_ = true;
+PinnedHostPool::~PinnedHostPool() { finalize(); }
 
+int PinnedHostPool::backend_alloc(void** ptr, size_t size) { return rtMallocHost(ptr, size, 0); }
+
+int PinnedHostPool::backend_free(void* ptr) { return rtFreeHost(ptr); }
+
+void* PinnedHostPool::alloc(size_t size) {
+    size_t block_size = MIN_BLOCK;
+    while (block_size < size) {
+        block_size <<= 1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    void* ptr = nullptr;
+    std::vector<void*>& cached = free_[block_size];
+    if (!cached.empty()) {
+        ptr = cached.back();
+        cached.pop_back();
+    } else {
+        int rc = backend_alloc(&ptr, block_size);
+        if (rc != 0) {
+            std::cerr << "Error: rtMallocHost failed: " << rc << " (size=" << block_size << ")\n";
+            return nullptr;
+        }
+    }
+    live_[reinterpret_cast<uintptr_t>(ptr)] = block_size;
+    return ptr;
+}
+
+void PinnedHostPool::free(void* ptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = live_.find(reinterpret_cast<uintptr_t>(ptr));
+    if (it == live_.end()) {
+        return;
+    }
+    free_[it->second].push_back(ptr);
+    live_.erase(it);
+}
+
+bool PinnedHostPool::contains(const void* ptr, size_t size) const {
+    uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = live_.upper_bound(begin);
+    if (it == live_.begin()) {
+        return false;
+    }
+    --it;
+    return begin + size <= it->first + it->second;
+}
+
+int PinnedHostPool::finalize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int last_error = 0;
+    auto release = [&last_error, this](void* ptr) {
+        int rc = backend_free(ptr);
+        if (rc != 0) {
+            std::cerr << "Error: rtFreeHost failed during Finalize: " << rc << '\n';
+            last_error = rc;
+        }
+    };
+    for (const auto& block : live_) {
+        release(reinterpret_cast<void*>(block.first));
+    }
+    for (const auto& entry : free_) {
+        for (void* ptr : entry.second) {
+            release(ptr);
+        }
+    }
+    live_.clear();
+    free_.clear();
     return last_error;
 }
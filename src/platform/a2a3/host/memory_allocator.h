@@ -6,27 +6,57 @@
  * ensures proper cleanup, preventing memory leaks.
  *
  * Key Features:
- * - Automatic tracking of all allocated device memory
- * - Safe deallocation with existence checking
+ * - Caching pool: small blocks are carved from 2 MB rtMalloc slabs in
+ *   power-of-two size classes, larger blocks are rtMalloc'd individually;
+ *   freed blocks are kept for reuse instead of being returned to the driver
+ * - O(1) alloc/free (hash lookup plus free-list push/pop)
+ * - Optional arenas: blocks allocated while an arena is current can be
+ *   released together with release_arena()
+ * - Statistics (bytes in use, peak, reserved, cache hit rate)
  * - Automatic cleanup via destructor (RAII pattern)
  * - Idempotent finalize() for explicit cleanup with error checking
+ * - PinnedHostPool: cached host staging memory for asynchronous transfers
  */
 
 #ifndef RUNTIME_MEMORYALLOCATOR_H
 #define RUNTIME_MEMORYALLOCATOR_H
 
 #include <cstddef>
-#include <set>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * Allocation statistics of a MemoryAllocator
+ */
+struct MemoryStats {
+    uint64_t bytes_in_use{0};    // Bytes of live blocks (rounded to their size class)
+    uint64_t peak_bytes{0};      // High-water mark of bytes_in_use
+    uint64_t bytes_reserved{0};  // Bytes currently held from the driver
+    uint64_t alloc_count{0};     // Successful alloc() calls
+    uint64_t cache_hits{0};      // alloc() calls served without a driver allocation
+};
 
 /**
  * MemoryAllocator class for managing device memory
  *
  * This class wraps the CANN runtime memory allocation APIs (rtMalloc/rtFree)
- * and provides automatic tracking of allocations to prevent memory leaks.
- * Uses RAII pattern for automatic cleanup.
+ * with a caching pool and provides automatic tracking of allocations to
+ * prevent memory leaks. Uses RAII pattern for automatic cleanup.
+ *
+ * Thread-safe: allocations of one device may come from any host thread.
  */
 class MemoryAllocator {
 public:
+    static constexpr size_t SLAB_SIZE = 2ULL << 20;  // Backing allocation for small classes
+    static constexpr size_t MIN_BLOCK = 512;         // Smallest size class (also the alignment)
+    static constexpr int NUM_SMALL_CLASSES = 13;     // 512 B .. 2 MB
+
     MemoryAllocator() = default;
     ~MemoryAllocator();
 
@@ -37,8 +67,10 @@ public:
     /**
      * Allocate device memory and track the pointer
      *
-     * Allocates device memory using rtMalloc and stores the pointer in the
-     * tracking set for automatic cleanup.
+     * Serves the request from the cache of its size class if possible,
+     * otherwise carves a new slab (small classes) or calls rtMalloc (large
+     * blocks, rounded up to a multiple of SLAB_SIZE). If the driver is out
+     * of memory, cached large blocks are released and the call retried.
      *
      * @param size  Size in bytes to allocate
      * @return Device pointer on success, nullptr on failure
@@ -46,23 +78,62 @@ public:
     void* alloc(size_t size);
 
     /**
-     * Free device memory if tracked
+     * Return device memory to the pool if tracked
      *
-     * Checks if the pointer exists in the tracking set. If found, frees the
-     * memory using rtFree and removes it from the set. Safe to call with
-     * nullptr or untracked pointers.
+     * Safe to call with nullptr or untracked pointers.
      *
      * @param ptr  Device pointer to free
-     * @return 0 on success, error code on failure, 0 if ptr not tracked
+     * @return 0 on success, 0 if ptr not tracked
      */
     int free(void* ptr);
 
     /**
-     * Free all remaining tracked allocations
+     * Create an arena for grouping allocations
      *
-     * Iterates through all tracked pointers, frees them using rtFree, and
-     * clears the tracking set. Can be called explicitly for error checking,
-     * or automatically via destructor. Idempotent - safe to call multiple
+     * @return Arena id (> 0)
+     */
+    int create_arena();
+
+    /**
+     * Select the arena that subsequent alloc() calls of the calling
+     * thread belong to
+     *
+     * @param arena  Arena id from create_arena(), or 0 for none
+     */
+    void set_current_arena(int arena);
+
+    /**
+     * Return every live block of an arena to the pool in one call
+     *
+     * @param arena  Arena id from create_arena()
+     * @return Number of blocks released
+     */
+    size_t release_arena(int arena);
+
+    /**
+     * List the live blocks of an arena in allocation order
+     *
+     * @param arena  Arena id from create_arena()
+     * @return Pointer and requested size of every block
+     */
+    std::vector<std::pair<void*, size_t>> arena_allocations(int arena) const;
+
+    /**
+     * Release cached blocks that can be handed back to the driver
+     *
+     * Frees cached large blocks. Small-class slabs stay reserved until
+     * finalize().
+     *
+     * @return 0 on success, error code if any rtFree failed
+     */
+    int trim();
+
+    /**
+     * Free all driver allocations
+     *
+     * Frees every slab and large block, including blocks still in use, and
+     * resets the pool. Can be called explicitly for error checking, or
+     * automatically via destructor. Idempotent - safe to call multiple
      * times.
      *
      * @return 0 on success, error code if any frees failed
@@ -72,13 +143,108 @@ public:
     /**
      * Get number of tracked allocations
      *
-     * @return Number of currently tracked pointers
+     * @return Number of live blocks
+     */
+    size_t get_allocation_count() const;
+
+    /**
+     * Get pool statistics
      */
-    size_t get_allocation_count() const { return ptr_set_.size(); }
+    MemoryStats get_stats() const;
 
 private:
-    std::set<void*> ptr_set_;
-    bool finalized_{false};
+    struct Block {
+        size_t size;       // Rounded block size
+        int size_class;    // Small class index, or -1 for a large block
+        int arena;         // Owning arena, 0 = none
+        size_t arena_pos;  // Index in arena_blocks_[arena]
+        size_t requested;  // Size asked for by the caller
+        uint64_t seq;      // Allocation order
+    };
+
+    int backend_alloc(void** ptr, size_t size);
+    int backend_free(void* ptr);
+    void* take_block(size_t size, int size_class, size_t* rounded, int* rc);
+    void release_block(void* ptr, Block& block);
+    void detach_from_arena(Block& block);
+    int trim_locked();
+
+    mutable std::mutex mutex_;
+    std::unordered_map<void*, Block> live_;                      // Blocks handed out
+    std::vector<void*> small_free_[NUM_SMALL_CLASSES];           // Cached small blocks
+    std::unordered_map<size_t, std::vector<void*>> large_free_;  // Cached large blocks by size
+    std::vector<void*> slabs_;                                   // Small-class backing slabs
+    std::unordered_set<void*> large_blocks_;                     // All large blocks (live or cached)
+    std::unordered_map<int, std::vector<void*>> arena_blocks_;   // Live blocks per arena
+    std::unordered_map<std::thread::id, int> current_arena_;     // Arena selected by each thread
+    int next_arena_{1};
+    uint64_t next_seq_{0};
+    MemoryStats stats_;
+};
+
+/**
+ * Caching pool of page-locked (pinned) host memory
+ *
+ * The DMA engine reads and writes pinned memory directly, so copies from
+ * it can run asynchronously at link bandwidth, while pageable memory is
+ * bounced through a driver buffer on every copy. Blocks come from
+ * rtMallocHost, rounded up to a power of two of at least MIN_BLOCK, and are
+ * kept for reuse after free() since pinning is expensive.
+ *
+ * Thread-safe.
+ */
+class PinnedHostPool {
+public:
+    static constexpr size_t MIN_BLOCK = 64 << 10;  // Smallest block (also the alignment)
+
+    PinnedHostPool() = default;
+    ~PinnedHostPool();
+
+    // Prevent copying
+    PinnedHostPool(const PinnedHostPool&) = delete;
+    PinnedHostPool& operator=(const PinnedHostPool&) = delete;
+
+    /**
+     * Allocate a block, from the cache if one of its size is free
+     *
+     * @param size  Size in bytes
+     * @return Host pointer on success, nullptr on failure
+     */
+    void* alloc(size_t size);
+
+    /**
+     * Return a block to the cache
+     *
+     * Safe to call with nullptr or untracked pointers.
+     *
+     * @param ptr  Pointer returned by alloc()
+     */
+    void free(void* ptr);
+
+    /**
+     * Check whether a host range lies inside one live block
+     *
+     * @param ptr   Start of the range
+     * @param size  Length of the range in bytes
+     */
+    bool contains(const void* ptr, size_t size) const;
+
+    /**
+     * Free every block, live or cached
+     *
+     * Idempotent - safe to call multiple times.
+     *
+     * @return 0 on success, error code if any free failed
+     */
+    int finalize();
+
+private:
+    int backend_alloc(void** ptr, size_t size);
+    int backend_free(void* ptr);
+
+    mutable std::mutex mutex_;
+    std::map<uintptr_t, size_t> live_;                     // Block address -> size, ordered for contains()
+    std::unordered_map<size_t, std::vector<void*>> free_;  // Cached blocks by size
 };
 
 #endif  // RUNTIME_MEMORYALLOCATOR_H
@@ -8,12 +8,121 @@
 #include "host/pto_runtime_c_api.h"
 
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <new>  // for placement new
 #include <vector>
 
 #include "device_runner.h"
 #include "runtime.h"
 
+namespace {
+
+// Device each runtime was initialized on (its tensors live there) and the
+// memory arena holding the tensors allocated by its orchestration
+struct RuntimeHome {
+    int device;
+    int arena;
+};
+std::mutex g_runtime_device_mutex;
+std::map<const Runtime*, RuntimeHome> g_runtime_device;
+
+bool valid_device(int device_id) { return device_id >= 0 && device_id < DeviceRunner::MAX_DEVICES; }
+
+int runtime_device(const Runtime* runtime) {
+    std::lock_guard<std::mutex> lock(g_runtime_device_mutex);
+    auto it = g_runtime_device.find(runtime);
+    return it != g_runtime_device.end() ? it->second.device : DeviceRunner::current_device();
+}
+
+int runtime_arena(const Runtime* runtime) {
+    std::lock_guard<std::mutex> lock(g_runtime_device_mutex);
+    auto it = g_runtime_device.find(runtime);
+    return it != g_runtime_device.end() ? it->second.arena : 0;
+}
+
+// HostApi::release_runtime_memory: frees the runtime's arena in one call
+void release_runtime_memory(Runtime* runtime) {
+    RuntimeHome home{0, 0};
+    {
+        std::lock_guard<std::mutex> lock(g_runtime_device_mutex);
+        auto it = g_runtime_device.find(runtime);
+        if (it == g_runtime_device.end()) {
+            return;
+        }
+        home = it->second;
+        it->second.arena = 0;
+    }
+    if (home.arena != 0) {
+        DeviceRunner::get(home.device).release_arena(home.arena);
+    }
+}
+
+/**
+ * Get the runner that launches runtime on device_id
+ *
+ * @return Runner, or nullptr if device_id is out of range or is not the
+ *         device the runtime was initialized on
+ */
+DeviceRunner* launch_runner(const Runtime* runtime, int device_id) {
+    if (!valid_device(device_id)) {
+        std::cerr << "Error: invalid device_id " << device_id << '\n';
+        return nullptr;
+    }
+    int home = runtime_device(runtime);
+    if (home != device_id) {
+        std::cerr << "Error: runtime was initialized on device " << home << ", cannot launch it on device "
+                  << device_id << '\n';
+        return nullptr;
+    }
+    return &DeviceRunner::get(device_id);
+}
+
+// Makes a device current for the calling thread until the end of the scope
+class CurrentDeviceScope {
+public:
+    explicit CurrentDeviceScope(int device_id) : saved_(DeviceRunner::current_device()) {
+        DeviceRunner::set_current_device(device_id);
+    }
+    ~CurrentDeviceScope() { DeviceRunner::set_current_device(saved_); }
+
+private:
+    int saved_;
+};
+
+/**
+ * Construct a Runtime in user-allocated memory on the current device
+ *
+ * Tensors allocated during its orchestration land on that device, grouped
+ * in an arena so finalize can free them in one call.
+ */
+Runtime* construct_runtime(RuntimeHandle runtime) {
+    // Placement new to construct Runtime in user-allocated memory
+    Runtime* r = new (runtime) Runtime();
+    int arena = DeviceRunner::get().create_arena();
+    {
+        std::lock_guard<std::mutex> lock(g_runtime_device_mutex);
+        g_runtime_device[r] = RuntimeHome{DeviceRunner::current_device(), arena};
+    }
+
+    // Initialize host API function pointers (host-only, not available on device)
+    r->host_api.device_malloc = device_malloc;
+    r->host_api.device_malloc_host = device_malloc_host;
+    r->host_api.device_free = device_free;
+    r->host_api.copy_to_device = copy_to_device;
+    r->host_api.copy_from_device = copy_from_device;
+    r->host_api.release_runtime_memory = release_runtime_memory;
+    r->host_api.host_malloc_pinned = host_malloc_pinned;
+    r->host_api.host_free_pinned = host_free_pinned;
+    r->host_api.copy_to_device_async = copy_to_device_async;
+    r->host_api.copy_from_device_async = copy_from_device_async;
+    r->host_api.sync_transfers = sync_transfers;
+    r->host_api.get_function_bin_addr = nullptr;
+    return r;
+}
+
+}  // namespace
+
 extern "C" {
 
 /* ===========================================================================
@@ -28,12 +137,24 @@ int init_runtime_impl(Runtime* runtime,
                     uint64_t* func_args,
                     int func_args_count);
 int validate_runtime_impl(Runtime* runtime);
+int export_trace_impl(Runtime* runtime, const char* path, double ticks_per_us);
+int get_runtime_stats_impl(Runtime* runtime, RuntimeStats* stats, double ticks_per_us);
+int predict_runtime_impl(Runtime* runtime, int thread_count, int block_dim, const CostModel* model,
+                         RuntimePrediction* prediction);
+int save_graph_impl(Runtime* runtime, const char* path, const GraphTensor* tensors, int tensor_count);
+int load_graph_impl(Runtime* runtime, const char* path, const uint64_t* host_tensors, int host_tensor_count);
 
 /* Forward declarations for device memory functions used in init_runtime */
 void* device_malloc(size_t size);
+void* device_malloc_host(void* host_ptr, size_t size);
 void device_free(void* dev_ptr);
 int copy_to_device(void* dev_ptr, const void* host_ptr, size_t size);
 int copy_from_device(void* host_ptr, const void* dev_ptr, size_t size);
+void* host_malloc_pinned(size_t size);
+void host_free_pinned(void* host_ptr);
+int copy_to_device_async(void* dev_ptr, const void* host_ptr, size_t size);
+int copy_from_device_async(void* host_ptr, const void* dev_ptr, size_t size);
+int sync_transfers(void);
 
 /* ===========================================================================
  */
@@ -58,18 +179,75 @@ int init_runtime(RuntimeHandle runtime,
     }
 
     try {
-        // Placement new to construct Runtime in user-allocated memory
-        Runtime* r = new (runtime) Runtime();
-
-        // Initialize host API function pointers (host-only, not available on device)
-        r->host_api.device_malloc = device_malloc;
-        r->host_api.device_free = device_free;
-        r->host_api.copy_to_device = copy_to_device;
-        r->host_api.copy_from_device = copy_from_device;
+        Runtime* r = construct_runtime(runtime);
 
         // Delegate SO loading and orchestration to init_runtime_impl
-        return init_runtime_impl(r, orch_so_binary, orch_so_size,
-                               orch_func_name, func_args, func_args_count);
+        DeviceRunner& runner = DeviceRunner::get();
+        runner.set_current_arena(runtime_arena(r));
+        int rc = init_runtime_impl(r, orch_so_binary, orch_so_size,
+                                   orch_func_name, func_args, func_args_count);
+        runner.set_current_arena(0);
+        return rc;
+    } catch (...) {
+        return -1;
+    }
+}
+
+// Streaming needs the executors to see tasks appended to the host arrays;
+// the device image is only uploaded at launch here
+int init_streaming_runtime(RuntimeHandle runtime, int max_tasks, int max_args, int max_edges) {
+    (void)runtime;
+    (void)max_tasks;
+    (void)max_args;
+    (void)max_edges;
+    std::cerr << "Error: streaming orchestration is only available in simulation\n";
+    return -1;
+}
+
+int stream_orchestration(RuntimeHandle runtime,
+                         const uint8_t* orch_so_binary,
+                         size_t orch_so_size,
+                         const char* orch_func_name,
+                         uint64_t* func_args,
+                         int func_args_count) {
+    (void)runtime;
+    (void)orch_so_binary;
+    (void)orch_so_size;
+    (void)orch_func_name;
+    (void)func_args;
+    (void)func_args_count;
+    std::cerr << "Error: streaming orchestration is only available in simulation\n";
+    return -1;
+}
+
+int save_runtime_graph(RuntimeHandle runtime, const char* path) {
+    if (runtime == NULL || path == NULL) {
+        return -1;
+    }
+    try {
+        // Tensor slots are the runtime's allocations, in allocation order
+        Runtime* r = static_cast<Runtime*>(runtime);
+        std::vector<GraphTensor> tensors;
+        for (const auto& tensor : DeviceRunner::get(runtime_device(r)).arena_tensors(runtime_arena(r))) {
+            tensors.push_back(GraphTensor{reinterpret_cast<uint64_t>(tensor.first), tensor.second});
+        }
+        return save_graph_impl(r, path, tensors.data(), static_cast<int>(tensors.size()));
+    } catch (...) {
+        return -1;
+    }
+}
+
+int load_runtime_graph(RuntimeHandle runtime, const char* path, const uint64_t* host_tensors, int host_tensor_count) {
+    if (runtime == NULL || path == NULL) {
+        return -1;
+    }
+    try {
+        Runtime* r = construct_runtime(runtime);
+        DeviceRunner& runner = DeviceRunner::get();
+        runner.set_current_arena(runtime_arena(r));
+        int rc = load_graph_impl(r, path, host_tensors, host_tensor_count);
+        runner.set_current_arena(0);
+        return rc;
     } catch (...) {
         return -1;
     }
@@ -90,6 +268,12 @@ void* device_malloc(size_t size) {
     }
 }
 
+void* device_malloc_host(void* host_ptr, size_t size) {
+    // Device memory is separate from host memory; the caller copies
+    (void)host_ptr;
+    return device_malloc(size);
+}
+
 void device_free(void* dev_ptr) {
     if (dev_ptr == NULL) {
         return;
@@ -126,6 +310,60 @@ int copy_from_device(void* host_ptr, const void* dev_ptr, size_t size) {
     }
 }
 
+void* host_malloc_pinned(size_t size) {
+    try {
+        DeviceRunner& runner = DeviceRunner::get();
+        return runner.allocate_pinned(size);
+    } catch (...) {
+        return NULL;
+    }
+}
+
+void host_free_pinned(void* host_ptr) {
+    if (host_ptr == NULL) {
+        return;
+    }
+    try {
+        DeviceRunner& runner = DeviceRunner::get();
+        runner.free_pinned(host_ptr);
+    } catch (...) {
+        // Ignore errors during free
+    }
+}
+
+int copy_to_device_async(void* dev_ptr, const void* host_ptr, size_t size) {
+    if (dev_ptr == NULL || host_ptr == NULL) {
+        return -1;
+    }
+    try {
+        DeviceRunner& runner = DeviceRunner::get();
+        return runner.copy_to_device_async(dev_ptr, host_ptr, size);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int copy_from_device_async(void* host_ptr, const void* dev_ptr, size_t size) {
+    if (host_ptr == NULL || dev_ptr == NULL) {
+        return -1;
+    }
+    try {
+        DeviceRunner& runner = DeviceRunner::get();
+        return runner.copy_from_device_async(host_ptr, dev_ptr, size);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int sync_transfers(void) {
+    try {
+        DeviceRunner& runner = DeviceRunner::get();
+        return runner.sync_transfers();
+    } catch (...) {
+        return -1;
+    }
+}
+
 int launch_runtime(RuntimeHandle runtime,
     int aicpu_thread_num,
     int block_dim,
@@ -141,15 +379,180 @@ int launch_runtime(RuntimeHandle runtime,
         return -1;
     }
     try {
-        DeviceRunner& runner = DeviceRunner::get();
+        Runtime* r = static_cast<Runtime*>(runtime);
+        DeviceRunner* runner = launch_runner(r, device_id);
+        if (runner == nullptr) {
+            return -1;
+        }
 
         // Convert to vectors for run()
         std::vector<uint8_t> aicpu_vec(aicpu_binary, aicpu_binary + aicpu_size);
         std::vector<uint8_t> aicore_vec(aicore_binary, aicore_binary + aicore_size);
 
         // Run the runtime (device initialization is handled internally)
+        return runner->run(*r, block_dim, device_id, aicpu_vec, aicore_vec, aicpu_thread_num);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int launch_runtime_async(RuntimeHandle runtime,
+    int aicpu_thread_num,
+    int block_dim,
+    int device_id,
+    const uint8_t* aicpu_binary,
+    size_t aicpu_size,
+    const uint8_t* aicore_binary,
+    size_t aicore_size,
+    LaunchHandle* launch) {
+    if (runtime == NULL || launch == NULL) {
+        return -1;
+    }
+    *launch = NULL;
+    if (aicpu_binary == NULL || aicpu_size == 0 || aicore_binary == NULL || aicore_size == 0) {
+        return -1;
+    }
+    try {
+        Runtime* r = static_cast<Runtime*>(runtime);
+        DeviceRunner* runner = launch_runner(r, device_id);
+        if (runner == nullptr) {
+            return -1;
+        }
+
+        std::vector<uint8_t> aicpu_vec(aicpu_binary, aicpu_binary + aicpu_size);
+        std::vector<uint8_t> aicore_vec(aicore_binary, aicore_binary + aicore_size);
+
+        LaunchRecord* record = nullptr;
+        int rc = runner->run_async(*r, block_dim, device_id, aicpu_vec, aicore_vec, aicpu_thread_num, &record);
+        *launch = record;
+        return rc;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int wait_runtime(LaunchHandle launch) {
+    if (launch == NULL) {
+        return -1;
+    }
+    try {
+        LaunchRecord* record = static_cast<LaunchRecord*>(launch);
+        return record->runner->wait_launch(record);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int start_persistent_executor(int aicpu_thread_num,
+    int block_dim,
+    int device_id,
+    const uint8_t* aicpu_binary,
+    size_t aicpu_size,
+    const uint8_t* aicore_binary,
+    size_t aicore_size) {
+    if (!valid_device(device_id)) {
+        return -1;
+    }
+    try {
+        DeviceRunner& runner = DeviceRunner::get(device_id);
+
+        std::vector<uint8_t> aicpu_vec;
+        std::vector<uint8_t> aicore_vec;
+
+        if (aicpu_binary != NULL && aicpu_size > 0) {
+            aicpu_vec.assign(aicpu_binary, aicpu_binary + aicpu_size);
+        }
+        if (aicore_binary != NULL && aicore_size > 0) {
+            aicore_vec.assign(aicore_binary, aicore_binary + aicore_size);
+        }
+
+        return runner.start_persistent(block_dim, device_id, aicpu_vec, aicore_vec, aicpu_thread_num);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int stop_persistent_executor(int device_id) {
+    if (!valid_device(device_id)) {
+        return -1;
+    }
+    try {
+        return DeviceRunner::get(device_id).stop_persistent();
+    } catch (...) {
+        return -1;
+    }
+}
+
+int set_task_arg(RuntimeHandle runtime, int task_id, int arg_idx, uint64_t value) {
+    if (runtime == NULL) {
+        return -1;
+    }
+    try {
+        Runtime* r = static_cast<Runtime*>(runtime);
+        return r->set_task_arg(task_id, arg_idx, value);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int fuse_task_chains(RuntimeHandle runtime) {
+    if (runtime == NULL) {
+        return -1;
+    }
+    try {
+        return static_cast<Runtime*>(runtime)->fuse_chains();
+    } catch (...) {
+        return -1;
+    }
+}
+
+int set_profiling(RuntimeHandle runtime, int enable) {
+    if (runtime == NULL) {
+        return -1;
+    }
+    static_cast<Runtime*>(runtime)->profiling_enabled = enable ? 1 : 0;
+    return 0;
+}
+
+int export_trace(RuntimeHandle runtime, const char* path) {
+    if (runtime == NULL || path == NULL) {
+        return -1;
+    }
+    try {
         Runtime* r = static_cast<Runtime*>(runtime);
-        return runner.run(*r, block_dim, device_id, aicpu_vec, aicore_vec, aicpu_thread_num);
+        int rc = DeviceRunner::get(runtime_device(r)).fetch_task_timing(*r);
+        if (rc != 0) {
+            return rc;
+        }
+        return export_trace_impl(r, path, DeviceRunner::SYS_CNT_TICKS_PER_US);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int get_runtime_stats(RuntimeHandle runtime, RuntimeStats* stats) {
+    if (runtime == NULL || stats == NULL) {
+        return -1;
+    }
+    try {
+        Runtime* r = static_cast<Runtime*>(runtime);
+        int rc = DeviceRunner::get(runtime_device(r)).fetch_scheduler_stats(*r);
+        if (rc != 0) {
+            return rc;
+        }
+        return get_runtime_stats_impl(r, stats, DeviceRunner::SYS_CNT_TICKS_PER_US);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int predict_runtime(RuntimeHandle runtime, int aicpu_thread_num, int block_dim, const CostModel* model,
+    RuntimePrediction* prediction) {
+    if (runtime == NULL || model == NULL || prediction == NULL) {
+        return -1;
+    }
+    try {
+        return predict_runtime_impl(static_cast<Runtime*>(runtime), aicpu_thread_num, block_dim, model, prediction);
     } catch (...) {
         return -1;
     }
@@ -161,7 +564,15 @@ int finalize_runtime(RuntimeHandle runtime) {
     }
     try {
         Runtime* r = static_cast<Runtime*>(runtime);
+        // Copy-back and tensor frees go to the runtime's own device
+        CurrentDeviceScope scope(runtime_device(r));
         int rc = validate_runtime_impl(r);
+        // Drop the runtime's device copy before the address can be reused
+        DeviceRunner::get().release_runtime(*r);
+        {
+            std::lock_guard<std::mutex> lock(g_runtime_device_mutex);
+            g_runtime_device.erase(r);
+        }
         // Call destructor (user will call free())
         r->~Runtime();
         return rc;
@@ -170,15 +581,54 @@ int finalize_runtime(RuntimeHandle runtime) {
     }
 }
 
-int set_device(int device_id) {
+int set_device(int device_id) { return open_device(device_id) != NULL ? 0 : -1; }
+
+DeviceHandle open_device(int device_id) {
+    if (!valid_device(device_id)) {
+        std::cerr << "Error: invalid device_id " << device_id << '\n';
+        return NULL;
+    }
+    try {
+        DeviceRunner& runner = DeviceRunner::get(device_id);
+        if (runner.ensure_device_set(device_id) != 0) {
+            return NULL;
+        }
+        DeviceRunner::set_current_device(device_id);
+        return &runner;
+    } catch (...) {
+        return NULL;
+    }
+}
+
+int close_device(DeviceHandle device) {
+    if (device == NULL) {
+        return -1;
+    }
     try {
-        DeviceRunner& runner = DeviceRunner::get();
-        return runner.ensure_device_set(device_id);
+        return static_cast<DeviceRunner*>(device)->finalize();
     } catch (...) {
         return -1;
     }
 }
 
+int set_host_aliasing(int device_id, int enable) {
+    (void)device_id;
+    if (enable == 0) {
+        return 0;
+    }
+    std::cerr << "Error: host aliasing is only available in simulation\n";
+    return -1;
+}
+
+int set_device_partitioning(int device_id, int device_blocks) {
+    (void)device_id;
+    if (device_blocks == 0) {
+        return 0;
+    }
+    std::cerr << "Error: device partitioning is only available in simulation\n";
+    return -1;
+}
+
 int register_kernel(int func_id, const uint8_t* bin_data, size_t bin_size) {
     if (bin_data == NULL || bin_size == 0) {
         return -1;
@@ -191,4 +641,55 @@ int register_kernel(int func_id, const uint8_t* bin_data, size_t bin_size) {
     }
 }
 
+int register_kernels(int count, const int* func_ids, const uint8_t* const* bin_data, const size_t* bin_sizes) {
+    if (count < 0 || (count > 0 && (func_ids == NULL || bin_data == NULL || bin_sizes == NULL))) {
+        return -1;
+    }
+    try {
+        DeviceRunner& runner = DeviceRunner::get();
+        return runner.register_kernels(func_ids, bin_data, bin_sizes, count);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int get_device_memory_stats(int device_id, DeviceMemoryStats* stats) {
+    if (stats == NULL || !valid_device(device_id)) {
+        return -1;
+    }
+    try {
+        MemoryStats pool = DeviceRunner::get(device_id).get_memory_stats();
+        stats->bytes_in_use = pool.bytes_in_use;
+        stats->peak_bytes = pool.peak_bytes;
+        stats->bytes_reserved = pool.bytes_reserved;
+        stats->alloc_count = pool.alloc_count;
+        stats->cache_hits = pool.cache_hits;
+        return 0;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int enable_device_log(int device_id, uint32_t records_per_thread) {
+    if (!valid_device(device_id)) {
+        return -1;
+    }
+    try {
+        return DeviceRunner::get(device_id).enable_device_log(records_per_thread);
+    } catch (...) {
+        return -1;
+    }
+}
+
+int dump_device_log(int device_id, const char* path) {
+    if (!valid_device(device_id)) {
+        return -1;
+    }
+    try {
+        return DeviceRunner::get(device_id).dump_device_log(path);
+    } catch (...) {
+        return -1;
+    }
+}
+
 } /* extern "C" */
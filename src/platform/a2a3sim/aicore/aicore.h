@@ -8,6 +8,10 @@
 #ifndef AICORE_SIM_H
 #define AICORE_SIM_H
 
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
 // Empty qualifiers - no special memory spaces on host
 #ifndef __gm__
 #define __gm__
@@ -31,7 +35,20 @@
 
 // Cache coherency - no-op on host (unified memory)
 #define ENTIRE_DATA_CACHE 0
+#define SINGLE_CACHE_LINE 0
 #define CACHELINE_OUT 0
 #define dcci(addr, mode, opt) ((void)0)
 
+// System counter - steady_clock nanoseconds, shared with the simulated AICPU
+inline uint64_t get_sys_cnt() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Idle hint of the polling loops - a simulated core shares the host CPU
+// with all the others, so an idle one gives up its time slice
+inline void core_idle() {
+    std::this_thread::yield();
+}
+
 #endif  // AICORE_SIM_H
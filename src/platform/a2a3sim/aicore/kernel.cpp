@@ -1,7 +1,8 @@
 /**
  * AICore Kernel Wrapper for Simulation
  *
- * Provides a wrapper around aicore_execute for dlsym lookup.
+ * Provides wrappers around aicore_execute, aicore_execute_persistent and
+ * aicore_poll for dlsym lookup.
  * This allows adding pre/post processing around kernel execution.
  */
 
@@ -10,8 +11,18 @@
 
 // Declare the original function (defined in aicore_executor.cpp with weak linkage)
 void aicore_execute(__gm__ Runtime* runtime, int block_idx, int core_type);
+void aicore_execute_persistent(__gm__ ExecutorDoorbell* doorbell, int block_idx, int core_type);
+int aicore_poll(__gm__ Runtime* runtime, int block_idx, int core_type);
 
 // Wrapper with extern "C" for dlsym lookup
 extern "C" void aicore_execute_wrapper(__gm__ Runtime* runtime, int block_idx, int core_type) {
     aicore_execute(runtime, block_idx, core_type);
 }
+
+extern "C" void aicore_execute_persistent_wrapper(__gm__ ExecutorDoorbell* doorbell, int block_idx, int core_type) {
+    aicore_execute_persistent(doorbell, block_idx, core_type);
+}
+
+extern "C" int aicore_poll_wrapper(__gm__ Runtime* runtime, int block_idx, int core_type) {
+    return aicore_poll(runtime, block_idx, core_type);
+}
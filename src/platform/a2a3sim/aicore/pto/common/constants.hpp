@@ -0,0 +1,38 @@
+/**
+ * PTO Constants (Simulation)
+ *
+ * Pipe and event identifiers of the PTO synchronization primitives. On the
+ * host every tile instruction completes before it returns, so there is
+ * nothing to synchronize: set_flag() and wait_flag() are no-ops that only
+ * keep kernel sources identical to their a2a3 versions.
+ */
+
+#ifndef PTO_SIM_COMMON_CONSTANTS_HPP
+#define PTO_SIM_COMMON_CONSTANTS_HPP
+
+enum pipe_t {
+    PIPE_S = 0,
+    PIPE_V,
+    PIPE_M,
+    PIPE_MTE1,
+    PIPE_MTE2,
+    PIPE_MTE3,
+    PIPE_ALL,
+};
+
+enum event_t {
+    EVENT_ID0 = 0,
+    EVENT_ID1,
+    EVENT_ID2,
+    EVENT_ID3,
+    EVENT_ID4,
+    EVENT_ID5,
+    EVENT_ID6,
+    EVENT_ID7,
+};
+
+inline __attribute__((always_inline)) void set_flag(pipe_t, pipe_t, event_t) {}
+inline __attribute__((always_inline)) void wait_flag(pipe_t, pipe_t, event_t) {}
+inline __attribute__((always_inline)) void pipe_barrier(pipe_t) {}
+
+#endif  // PTO_SIM_COMMON_CONSTANTS_HPP
@@ -0,0 +1,376 @@
+/**
+ * PTO Tile Instructions (Simulation)
+ *
+ * Host implementation of the subset of the PTO-ISA tile interface used by
+ * the vector kernels: GlobalTensor, Tile, TASSIGN, TLOAD, TSTORE and the
+ * element-wise TADD/TSUB/TMUL/TDIV/TADDS/TMULS instructions. A kernel
+ * written against <pto/pto-inst.hpp> compiles unchanged with ccec for
+ * a2a3 and with g++ for a2a3sim (compile_incore_sim puts this directory on
+ * the include path).
+ *
+ * The element-wise loops use explicit SIMD for float tiles, selected from
+ * the target flags: AVX-512F, AVX/AVX2 or AArch64 NEON, with a scalar loop
+ * for other element types and targets.
+ *
+ * Simulation kernels run as the raw .text section of their object file, so
+ * nothing here may need a relocation: every function is forced inline,
+ * tiles live on the kernel's stack and no constant is read from .rodata.
+ * TASSIGN only records the Unified Buffer address; tiles never alias.
+ */
+
+#ifndef PTO_SIM_PTO_INST_HPP
+#define PTO_SIM_PTO_INST_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "pto/common/constants.hpp"
+
+// Memory-space and kernel qualifiers of the device compiler
+#ifndef __gm__
+#define __gm__
+#endif
+
+#ifndef __aicore__
+#define __aicore__
+#endif
+
+#define PTO_SIM_INLINE inline __attribute__((always_inline))
+
+namespace pto {
+
+constexpr int DYNAMIC = -1;
+
+enum class TileType { Vec, Mat, Left, Right, Acc };
+
+enum class BLayout { RowMajor, ColMajor };
+
+template <int N0, int N1, int N2, int N3, int N4>
+struct Shape {
+    static constexpr int dim[5] = {N0, N1, N2, N3, N4};
+};
+
+template <int S0, int S1, int S2, int S3, int S4>
+struct Stride {
+    static constexpr int dim[5] = {S0, S1, S2, S3, S4};
+};
+
+/**
+ * View of a tensor in global memory
+ *
+ * Dimensions 0-3 are folded into tile rows, dimension 4 is the row.
+ */
+template <typename T, typename ShapeT, typename StrideT>
+class GlobalTensor {
+public:
+    using DType = T;
+    using ShapeType = ShapeT;
+    using StrideType = StrideT;
+
+    PTO_SIM_INLINE explicit GlobalTensor(__gm__ T* data) : data_(data) {}
+
+    PTO_SIM_INLINE __gm__ T* data() const { return data_; }
+
+private:
+    __gm__ T* data_;
+};
+
+/**
+ * Tile in the Unified Buffer
+ *
+ * ValidRows/ValidCols give the region the instructions operate on; -1
+ * (DYNAMIC) takes it from the constructor instead.
+ */
+template <TileType Type, typename T, int Rows, int Cols, BLayout Layout = BLayout::RowMajor, int ValidRows = Rows,
+    int ValidCols = Cols>
+class Tile {
+    static_assert(Layout == BLayout::RowMajor, "Simulation tiles are row-major");
+    static_assert(ValidRows <= Rows && ValidCols <= Cols, "Valid region exceeds the tile");
+
+public:
+    using DType = T;
+    static constexpr int kRows = Rows;
+    static constexpr int kCols = Cols;
+
+    PTO_SIM_INLINE Tile() : valid_rows_(ValidRows), valid_cols_(ValidCols) {
+        static_assert(ValidRows != DYNAMIC && ValidCols != DYNAMIC, "Dynamic tiles need their valid shape");
+    }
+
+    PTO_SIM_INLINE Tile(int valid_rows, int valid_cols)
+        : valid_rows_(ValidRows == DYNAMIC ? valid_rows : ValidRows),
+          valid_cols_(ValidCols == DYNAMIC ? valid_cols : ValidCols) {}
+
+    Tile(const Tile&) = delete;
+    Tile& operator=(const Tile&) = delete;
+
+    PTO_SIM_INLINE T* data() { return data_; }
+    PTO_SIM_INLINE const T* data() const { return data_; }
+    PTO_SIM_INLINE int GetValidRow() const { return valid_rows_; }
+    PTO_SIM_INLINE int GetValidCol() const { return valid_cols_; }
+    PTO_SIM_INLINE void SetAddr(uint64_t addr) { addr_ = addr; }
+
+private:
+    alignas(64) T data_[Rows * Cols];
+    int valid_rows_;
+    int valid_cols_;
+    uint64_t addr_{0};
+};
+
+namespace detail {
+
+// ============================================================================
+// Float SIMD backends
+// ============================================================================
+
+#if defined(__AVX512F__)
+#define PTO_SIM_SIMD_F32 1
+struct SimdF32 {
+    using Reg = __m512;
+    static constexpr int kWidth = 16;
+    static PTO_SIM_INLINE Reg load(const float* p) { return _mm512_loadu_ps(p); }
+    static PTO_SIM_INLINE void store(float* p, Reg v) { _mm512_storeu_ps(p, v); }
+    static PTO_SIM_INLINE Reg dup(float s) { return _mm512_set1_ps(s); }
+    static PTO_SIM_INLINE Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+    static PTO_SIM_INLINE Reg sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+    static PTO_SIM_INLINE Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+    static PTO_SIM_INLINE Reg div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+};
+#elif defined(__AVX__)
+#define PTO_SIM_SIMD_F32 1
+struct SimdF32 {
+    using Reg = __m256;
+    static constexpr int kWidth = 8;
+    static PTO_SIM_INLINE Reg load(const float* p) { return _mm256_loadu_ps(p); }
+    static PTO_SIM_INLINE void store(float* p, Reg v) { _mm256_storeu_ps(p, v); }
+    static PTO_SIM_INLINE Reg dup(float s) { return _mm256_set1_ps(s); }
+    static PTO_SIM_INLINE Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+    static PTO_SIM_INLINE Reg sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+    static PTO_SIM_INLINE Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+    static PTO_SIM_INLINE Reg div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+};
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define PTO_SIM_SIMD_F32 1
+struct SimdF32 {
+    using Reg = float32x4_t;
+    static constexpr int kWidth = 4;
+    static PTO_SIM_INLINE Reg load(const float* p) { return vld1q_f32(p); }
+    static PTO_SIM_INLINE void store(float* p, Reg v) { vst1q_f32(p, v); }
+    static PTO_SIM_INLINE Reg dup(float s) { return vdupq_n_f32(s); }
+    static PTO_SIM_INLINE Reg add(Reg a, Reg b) { return vaddq_f32(a, b); }
+    static PTO_SIM_INLINE Reg sub(Reg a, Reg b) { return vsubq_f32(a, b); }
+    static PTO_SIM_INLINE Reg mul(Reg a, Reg b) { return vmulq_f32(a, b); }
+    static PTO_SIM_INLINE Reg div(Reg a, Reg b) { return vdivq_f32(a, b); }
+};
+#endif
+
+// Element-wise operations, on scalars and (with PTO_SIM_SIMD_F32) float registers
+struct OpAdd {
+    template <typename T>
+    static PTO_SIM_INLINE T apply(T a, T b) { return a + b; }
+#ifdef PTO_SIM_SIMD_F32
+    static PTO_SIM_INLINE SimdF32::Reg apply(SimdF32::Reg a, SimdF32::Reg b) { return SimdF32::add(a, b); }
+#endif
+};
+
+struct OpSub {
+    template <typename T>
+    static PTO_SIM_INLINE T apply(T a, T b) { return a - b; }
+#ifdef PTO_SIM_SIMD_F32
+    static PTO_SIM_INLINE SimdF32::Reg apply(SimdF32::Reg a, SimdF32::Reg b) { return SimdF32::sub(a, b); }
+#endif
+};
+
+struct OpMul {
+    template <typename T>
+    static PTO_SIM_INLINE T apply(T a, T b) { return a * b; }
+#ifdef PTO_SIM_SIMD_F32
+    static PTO_SIM_INLINE SimdF32::Reg apply(SimdF32::Reg a, SimdF32::Reg b) { return SimdF32::mul(a, b); }
+#endif
+};
+
+struct OpDiv {
+    template <typename T>
+    static PTO_SIM_INLINE T apply(T a, T b) { return a / b; }
+#ifdef PTO_SIM_SIMD_F32
+    static PTO_SIM_INLINE SimdF32::Reg apply(SimdF32::Reg a, SimdF32::Reg b) { return SimdF32::div(a, b); }
+#endif
+};
+
+// ============================================================================
+// Row kernels (n contiguous elements)
+// ============================================================================
+
+template <typename T>
+PTO_SIM_INLINE void copy_row(T* dst, const T* src, int n) {
+    int i = 0;
+#ifdef PTO_SIM_SIMD_F32
+    if constexpr (std::is_same<T, float>::value) {
+        for (; i + SimdF32::kWidth <= n; i += SimdF32::kWidth) {
+            SimdF32::store(dst + i, SimdF32::load(src + i));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = src[i];
+    }
+}
+
+template <typename Op, typename T>
+PTO_SIM_INLINE void binary_row(T* dst, const T* a, const T* b, int n) {
+    int i = 0;
+#ifdef PTO_SIM_SIMD_F32
+    if constexpr (std::is_same<T, float>::value) {
+        for (; i + SimdF32::kWidth <= n; i += SimdF32::kWidth) {
+            SimdF32::store(dst + i, Op::apply(SimdF32::load(a + i), SimdF32::load(b + i)));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = Op::apply(a[i], b[i]);
+    }
+}
+
+template <typename Op, typename T>
+PTO_SIM_INLINE void scalar_row(T* dst, const T* a, T s, int n) {
+    int i = 0;
+#ifdef PTO_SIM_SIMD_F32
+    if constexpr (std::is_same<T, float>::value) {
+        SimdF32::Reg vs = SimdF32::dup(s);
+        for (; i + SimdF32::kWidth <= n; i += SimdF32::kWidth) {
+            SimdF32::store(dst + i, Op::apply(SimdF32::load(a + i), vs));
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = Op::apply(a[i], s);
+    }
+}
+
+// Valid region of a tile as runs of contiguous elements: one run when its
+// rows are full, otherwise one per row
+template <typename TileT>
+PTO_SIM_INLINE void tile_runs(const TileT& tile, int& runs, int& run_length) {
+    runs = tile.GetValidRow();
+    run_length = tile.GetValidCol();
+    if (run_length == TileT::kCols) {
+        run_length *= runs;
+        runs = 1;
+    }
+}
+
+template <typename Op, typename TileD, typename TileS0, typename TileS1>
+PTO_SIM_INLINE void binary_tile(TileD& dst, const TileS0& src0, const TileS1& src1) {
+    static_assert(TileD::kCols == TileS0::kCols && TileD::kCols == TileS1::kCols, "Tile row pitches differ");
+    int runs;
+    int n;
+    tile_runs(dst, runs, n);
+    for (int r = 0; r < runs; r++) {
+        int offset = r * TileD::kCols;
+        binary_row<Op>(dst.data() + offset, src0.data() + offset, src1.data() + offset, n);
+    }
+}
+
+template <typename Op, typename TileD, typename TileS>
+PTO_SIM_INLINE void scalar_tile(TileD& dst, const TileS& src, typename TileD::DType s) {
+    static_assert(TileD::kCols == TileS::kCols, "Tile row pitches differ");
+    int runs;
+    int n;
+    tile_runs(dst, runs, n);
+    for (int r = 0; r < runs; r++) {
+        int offset = r * TileD::kCols;
+        scalar_row<Op>(dst.data() + offset, src.data() + offset, s, n);
+    }
+}
+
+// Copies between a tile's valid region and a global tensor. The rows of
+// dimensions 0-3 follow each other in the tile; the copy stops at the
+// smaller of the tile's valid shape and the tensor's shape.
+template <bool kLoad, typename TileT, typename GlobalT>
+PTO_SIM_INLINE void transfer(TileT& tile, const GlobalT& global) {
+    using ShapeT = typename GlobalT::ShapeType;
+    using StrideT = typename GlobalT::StrideType;
+    static_assert(StrideT::dim[4] == 1, "Global tensor rows must be contiguous");
+    int cols = tile.GetValidCol() < ShapeT::dim[4] ? tile.GetValidCol() : ShapeT::dim[4];
+    int rows_left = tile.GetValidRow();
+    typename TileT::DType* t = tile.data();
+    for (int i0 = 0; i0 < ShapeT::dim[0]; i0++) {
+        for (int i1 = 0; i1 < ShapeT::dim[1]; i1++) {
+            for (int i2 = 0; i2 < ShapeT::dim[2]; i2++) {
+                for (int i3 = 0; i3 < ShapeT::dim[3]; i3++) {
+                    if (rows_left-- <= 0) {
+                        return;
+                    }
+                    __gm__ typename TileT::DType* g = global.data() + i0 * StrideT::dim[0] + i1 * StrideT::dim[1] +
+                                                      i2 * StrideT::dim[2] + i3 * StrideT::dim[3];
+                    if constexpr (kLoad) {
+                        copy_row(t, g, cols);
+                    } else {
+                        copy_row(g, t, cols);
+                    }
+                    t += TileT::kCols;
+                }
+            }
+        }
+    }
+}
+
+}  // namespace detail
+
+// ============================================================================
+// Instructions
+// ============================================================================
+
+template <typename TileT>
+PTO_SIM_INLINE void TASSIGN(TileT& tile, uint64_t addr) {
+    tile.SetAddr(addr);
+}
+
+template <typename TileT, typename GlobalT>
+PTO_SIM_INLINE void TLOAD(TileT& dst, const GlobalT& src) {
+    detail::transfer<true>(dst, src);
+}
+
+template <typename GlobalT, typename TileT>
+PTO_SIM_INLINE void TSTORE(GlobalT& dst, TileT& src) {
+    detail::transfer<false>(src, dst);
+}
+
+template <typename TileD, typename TileS0, typename TileS1>
+PTO_SIM_INLINE void TADD(TileD& dst, const TileS0& src0, const TileS1& src1) {
+    detail::binary_tile<detail::OpAdd>(dst, src0, src1);
+}
+
+template <typename TileD, typename TileS0, typename TileS1>
+PTO_SIM_INLINE void TSUB(TileD& dst, const TileS0& src0, const TileS1& src1) {
+    detail::binary_tile<detail::OpSub>(dst, src0, src1);
+}
+
+template <typename TileD, typename TileS0, typename TileS1>
+PTO_SIM_INLINE void TMUL(TileD& dst, const TileS0& src0, const TileS1& src1) {
+    detail::binary_tile<detail::OpMul>(dst, src0, src1);
+}
+
+template <typename TileD, typename TileS0, typename TileS1>
+PTO_SIM_INLINE void TDIV(TileD& dst, const TileS0& src0, const TileS1& src1) {
+    detail::binary_tile<detail::OpDiv>(dst, src0, src1);
+}
+
+template <typename TileD, typename TileS>
+PTO_SIM_INLINE void TADDS(TileD& dst, const TileS& src, typename TileD::DType scalar) {
+    detail::scalar_tile<detail::OpAdd>(dst, src, scalar);
+}
+
+template <typename TileD, typename TileS>
+PTO_SIM_INLINE void TMULS(TileD& dst, const TileS& src, typename TileD::DType scalar) {
+    detail::scalar_tile<detail::OpMul>(dst, src, scalar);
+}
+
+}  // namespace pto
+
+#endif  // PTO_SIM_PTO_INST_HPP
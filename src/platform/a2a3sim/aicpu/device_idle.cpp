@@ -0,0 +1,22 @@
+/**
+ * Idle hook of the simulated AICPU
+ */
+
+#include "device_idle.h"
+
+thread_local void (*g_aicpu_idle_hook)(void*) = nullptr;
+thread_local void* g_aicpu_idle_ctx = nullptr;
+
+/**
+ * Install the function aicpu_idle() calls instead of yielding
+ *
+ * Applies to the calling AICPU thread only, so launches running side by
+ * side each step their own cores.
+ *
+ * @param hook  Idle function, or nullptr to yield again
+ * @param ctx   Argument passed to hook
+ */
+extern "C" void aicpu_set_idle_hook(void (*hook)(void*), void* ctx) {
+    g_aicpu_idle_ctx = ctx;
+    g_aicpu_idle_hook = hook;
+}
@@ -0,0 +1,26 @@
+/**
+ * Idle Hint for AICPU Simulation
+ *
+ * The scheduler calls aicpu_idle() whenever a polling pass found nothing to
+ * do. On the host the simulated AICPU shares the CPU with every simulated
+ * AICore, so instead of spinning it yields, or runs the idle hook that the
+ * simulation runner installed for the calling thread (see
+ * aicpu_set_idle_hook; the inline engine executes posted AICore tasks from
+ * it).
+ */
+
+#pragma once
+
+#include <thread>
+
+extern thread_local void (*g_aicpu_idle_hook)(void*);
+extern thread_local void* g_aicpu_idle_ctx;
+
+static inline void aicpu_idle() {
+    void (*hook)(void*) = g_aicpu_idle_hook;
+    if (hook != nullptr) {
+        hook(g_aicpu_idle_ctx);
+    } else {
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,16 @@
+/**
+ * Device Timestamp Header for AICPU Simulation
+ *
+ * Uses std::chrono::steady_clock in nanoseconds, the same clock as
+ * get_sys_cnt() in the simulated AICore, so both share one time base.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+static inline uint64_t get_sys_cnt_aicpu() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -14,6 +14,7 @@
 
 // Forward declaration
 class Runtime;
+struct ExecutorDoorbell;
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +33,7 @@ extern "C" {
  */
 struct KernelArgs {
     Runtime* runtime_args{nullptr};    // Task runtime pointer
+    ExecutorDoorbell* doorbell{nullptr};  // Persistent executor doorbell (unused in simulation)
 };
 
 #ifdef __cplusplus
@@ -5,8 +5,11 @@
  * It provides the same API as the real a2a3 implementation but uses
  * std::thread instead of CANN runtime APIs.
  *
- * aicpu_execute and aicore_execute_wrapper are loaded dynamically via dlopen from
- * the binaries passed to launch_runtime.
+ * aicpu_execute and aicore_execute_wrapper are loaded dynamically (from memory) from
+ * the binaries passed to launch_runtime, together with their persistent
+ * counterparts aicpu_execute_persistent and aicore_execute_persistent_wrapper.
+ * The optional aicore_poll_wrapper and aicpu_set_idle_hook let a launch run
+ * its simulated cores on fewer threads (see SimEngine).
  *
  * Cross-platform notes:
  * - Linux: Uses MAP_ANONYMOUS for anonymous memory mapping
@@ -15,13 +18,19 @@
  */
 
 #include "device_runner.h"
+#include "host/device_log_decoder.h"
+#include "host/memory_so_loader.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <dlfcn.h>
 #include <errno.h>
-#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <set>
 #include <thread>
 #include <unistd.h>
 #include <vector>
@@ -55,9 +64,33 @@ typedef void (*aicore_execute_func_t)(Runtime* runtime, int block_idx, int core_
 // DeviceRunner Implementation
 // =============================================================================
 
+namespace {
+// Current device of each host thread, see DeviceRunner::set_current_device()
+thread_local int t_current_device = 0;
+}  // namespace
+
 DeviceRunner& DeviceRunner::get() {
-    static DeviceRunner runner;
-    return runner;
+    return get(t_current_device);
+}
+
+DeviceRunner& DeviceRunner::get(int device_id) {
+    static std::mutex registry_mutex;
+    static std::unique_ptr<DeviceRunner> registry[MAX_DEVICES];
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::unique_ptr<DeviceRunner>& runner = registry[device_id];
+    if (!runner) {
+        runner.reset(new DeviceRunner(device_id));
+    }
+    return *runner;
+}
+
+void DeviceRunner::set_current_device(int device_id) {
+    t_current_device = device_id;
+}
+
+int DeviceRunner::current_device() {
+    return t_current_device;
 }
 
 DeviceRunner::~DeviceRunner() {
@@ -67,6 +100,10 @@ DeviceRunner::~DeviceRunner() {
 int DeviceRunner::ensure_device_initialized(int device_id,
                                             const std::vector<uint8_t>& aicpu_so_binary,
                                             const std::vector<uint8_t>& aicore_kernel_binary) {
+    if (device_id != registry_id_) {
+        std::cerr << "Error: device " << device_id << " requested from the runner of device " << registry_id_ << '\n';
+        return -1;
+    }
     device_id_ = device_id;
     return ensure_binaries_loaded(aicpu_so_binary, aicore_kernel_binary);
 }
@@ -78,20 +115,16 @@ int DeviceRunner::ensure_binaries_loaded(const std::vector<uint8_t>& aicpu_so_bi
         return 0;
     }
 
-    // Write AICPU binary to temp file and dlopen
-    if (!aicpu_so_binary.empty() && aicpu_execute_func_ == nullptr) {
-        aicpu_so_path_ = "/tmp/aicpu_sim_" + std::to_string(getpid()) + ".so";
-        std::ofstream ofs(aicpu_so_path_, std::ios::binary);
-        if (!ofs) {
-            std::cerr << "Error: Failed to create temp file for AICPU SO: " << aicpu_so_path_ << '\n';
-            return -1;
-        }
-        ofs.write(reinterpret_cast<const char*>(aicpu_so_binary.data()), aicpu_so_binary.size());
-        ofs.close();
+    // Every device gets its own RTLD_LOCAL copy of each executor library:
+    // the executors keep their state in globals, and a shared copy would
+    // make concurrent launches on different devices race on it. Loading
+    // from memory gives a distinct copy per call without temp files.
 
-        aicpu_so_handle_ = dlopen(aicpu_so_path_.c_str(), RTLD_NOW | RTLD_GLOBAL);
+    // Load AICPU binary from memory
+    if (!aicpu_so_binary.empty() && aicpu_execute_func_ == nullptr) {
+        aicpu_so_handle_ = dlopen_from_memory(aicpu_so_binary.data(), aicpu_so_binary.size(),
+                                              "aicpu_sim", RTLD_NOW | RTLD_LOCAL, &aicpu_so_fd_);
         if (aicpu_so_handle_ == nullptr) {
-            std::cerr << "Error: dlopen failed for AICPU SO: " << dlerror() << '\n';
             return -1;
         }
 
@@ -100,23 +133,20 @@ int DeviceRunner::ensure_binaries_loaded(const std::vector<uint8_t>& aicpu_so_bi
             std::cerr << "Error: dlsym failed for aicpu_execute: " << dlerror() << '\n';
             return -1;
         }
-        std::cout << "DeviceRunner(sim): Loaded aicpu_execute from " << aicpu_so_path_ << '\n';
+        // Optional: only needed by start_persistent()
+        aicpu_execute_persistent_func_ = reinterpret_cast<int(*)(ExecutorDoorbell*)>(
+            dlsym(aicpu_so_handle_, "aicpu_execute_persistent"));
+        aicpu_set_idle_hook_func_ = reinterpret_cast<void(*)(void (*)(void*), void*)>(
+            dlsym(aicpu_so_handle_, "aicpu_set_idle_hook"));
+        aicpu_so_binary_ = aicpu_so_binary;
+        std::cout << "DeviceRunner(sim): Loaded aicpu_execute for device " << registry_id_ << '\n';
     }
 
-    // Write AICore binary to temp file and dlopen
+    // Load AICore binary from memory
     if (!aicore_kernel_binary.empty() && aicore_execute_func_ == nullptr) {
-        aicore_so_path_ = "/tmp/aicore_sim_" + std::to_string(getpid()) + ".so";
-        std::ofstream ofs(aicore_so_path_, std::ios::binary);
-        if (!ofs) {
-            std::cerr << "Error: Failed to create temp file for AICore SO: " << aicore_so_path_ << '\n';
-            return -1;
-        }
-        ofs.write(reinterpret_cast<const char*>(aicore_kernel_binary.data()), aicore_kernel_binary.size());
-        ofs.close();
-
-        aicore_so_handle_ = dlopen(aicore_so_path_.c_str(), RTLD_NOW | RTLD_GLOBAL);
+        aicore_so_handle_ = dlopen_from_memory(aicore_kernel_binary.data(), aicore_kernel_binary.size(),
+                                               "aicore_sim", RTLD_NOW | RTLD_LOCAL, &aicore_so_fd_);
         if (aicore_so_handle_ == nullptr) {
-            std::cerr << "Error: dlopen failed for AICore SO: " << dlerror() << '\n';
             return -1;
         }
 
@@ -125,7 +155,11 @@ int DeviceRunner::ensure_binaries_loaded(const std::vector<uint8_t>& aicpu_so_bi
             std::cerr << "Error: dlsym failed for aicore_execute_wrapper: " << dlerror() << '\n';
             return -1;
         }
-        std::cout << "DeviceRunner(sim): Loaded aicore_execute_wrapper from " << aicore_so_path_ << '\n';
+        aicore_execute_persistent_func_ = reinterpret_cast<void(*)(ExecutorDoorbell*, int, int)>(
+            dlsym(aicore_so_handle_, "aicore_execute_persistent_wrapper"));
+        aicore_poll_func_ = reinterpret_cast<int(*)(Runtime*, int, int)>(
+            dlsym(aicore_so_handle_, "aicore_poll_wrapper"));
+        std::cout << "DeviceRunner(sim): Loaded aicore_execute_wrapper for device " << registry_id_ << '\n';
     }
 
     return 0;
@@ -135,6 +169,13 @@ void* DeviceRunner::allocate_tensor(size_t bytes) {
     return mem_alloc_.alloc(bytes);
 }
 
+void* DeviceRunner::allocate_host_tensor(void* host_ptr, size_t bytes) {
+    if (host_aliasing_ && host_ptr != nullptr) {
+        return mem_alloc_.adopt(host_ptr, bytes);
+    }
+    return mem_alloc_.alloc(bytes);
+}
+
 void DeviceRunner::free_tensor(void* dev_ptr) {
     if (dev_ptr != nullptr) {
         mem_alloc_.free(dev_ptr);
@@ -142,13 +183,19 @@ void DeviceRunner::free_tensor(void* dev_ptr) {
 }
 
 int DeviceRunner::copy_to_device(void* dev_ptr, const void* host_ptr, size_t bytes) {
-    // In simulation, this is just a memcpy
+    // In simulation, this is just a memcpy (nothing when the tensor aliases the host buffer)
+    if (dev_ptr == host_ptr) {
+        return 0;
+    }
     std::memcpy(dev_ptr, host_ptr, bytes);
     return 0;
 }
 
 int DeviceRunner::copy_from_device(void* host_ptr, const void* dev_ptr, size_t bytes) {
-    // In simulation, this is just a memcpy
+    // In simulation, this is just a memcpy (nothing when the tensor aliases the host buffer)
+    if (dev_ptr == host_ptr) {
+        return 0;
+    }
     std::memcpy(host_ptr, dev_ptr, bytes);
     return 0;
 }
@@ -159,6 +206,34 @@ int DeviceRunner::run(Runtime& runtime,
                       const std::vector<uint8_t>& aicpu_so_binary,
                       const std::vector<uint8_t>& aicore_kernel_binary,
                       int launch_aicpu_num) {
+    LaunchRecord* launch = nullptr;
+    int rc = run_async(runtime, block_dim, device_id, aicpu_so_binary, aicore_kernel_binary, launch_aicpu_num,
+                       &launch);
+    if (rc != 0) {
+        return rc;
+    }
+    return wait_launch(launch);
+}
+
+int DeviceRunner::run_async(Runtime& runtime,
+                            int block_dim,
+                            int device_id,
+                            const std::vector<uint8_t>& aicpu_so_binary,
+                            const std::vector<uint8_t>& aicore_kernel_binary,
+                            int launch_aicpu_num,
+                            LaunchRecord** launch) {
+    *launch = nullptr;
+    for (const LaunchRecord& pending : pending_launches_) {
+        if (pending.runtime == &runtime) {
+            std::cerr << "Error: runtime is still in flight; wait for its previous launch first\n";
+            return -1;
+        }
+    }
+    // Fail unsupported configurations before any core is started
+    if (runtime.check_launch() != 0) {
+        return -1;
+    }
+
     // Ensure device is initialized
     int rc = ensure_device_initialized(device_id, aicpu_so_binary, aicore_kernel_binary);
     if (rc != 0) {
@@ -166,6 +241,17 @@ int DeviceRunner::run(Runtime& runtime,
         return rc;
     }
 
+    launch_aicpu_num = resolve_aicpu_num(launch_aicpu_num, block_dim);
+    if (launch_aicpu_num < 0) {
+        return -1;
+    }
+
+    if (doorbell_ != nullptr && (block_dim != persistent_block_dim_ || launch_aicpu_num != persistent_aicpu_num_)) {
+        std::cerr << "Error: persistent executor was started with block_dim=" << persistent_block_dim_
+                  << " and " << persistent_aicpu_num_ << " AICPU thread(s)\n";
+        return -1;
+    }
+
     // Calculate execution parameters
     block_dim_ = block_dim;
     int num_cores = block_dim * cores_per_blockdim_;
@@ -175,12 +261,21 @@ int DeviceRunner::run(Runtime& runtime,
                   << RUNTIME_MAX_WORKER << ")\n";
         return -1;
     }
+    bool partitioned = partitions_.device_blocks() > 0;
+    if (partitioned && block_dim > partitions_.device_blocks()) {
+        std::cerr << "Error: block_dim " << block_dim << " exceeds the " << partitions_.device_blocks()
+                  << " blocks of the partitioned device\n";
+        return -1;
+    }
 
     // Initialize handshake buffers
     runtime.worker_count = num_cores;
     worker_count_ = num_cores;
     runtime.block_dim = block_dim;
     runtime.sche_cpu_num = launch_aicpu_num;
+    runtime.partition = 0;
+    runtime.block_offset = 0;
+    runtime.device_log_buffer = reinterpret_cast<uint64_t>(log_buffer_);
 
     // Calculate number of AIC cores
     int num_aic = block_dim;
@@ -189,8 +284,13 @@ int DeviceRunner::run(Runtime& runtime,
         runtime.workers[i].aicpu_ready = 0;
         runtime.workers[i].aicore_done = 0;
         runtime.workers[i].control = 0;
-        runtime.workers[i].task = 0;
-        runtime.workers[i].task_status = 0;
+        runtime.workers[i].dispatch_seq = 0;
+        runtime.workers[i].complete_seq = 0;
+        runtime.workers[i].completion_slot = -1;
+        runtime.completion_board[i] = 0;
+        for (int s = 0; s < RUNTIME_HANDSHAKE_SLOTS; s++) {
+            runtime.workers[i].slot_task[s] = 0;
+        }
         // First 1/3 are AIC (0), remaining 2/3 are AIV (1)
         runtime.workers[i].core_type = (i < num_aic) ? 0 : 1;
     }
@@ -208,6 +308,10 @@ int DeviceRunner::run(Runtime& runtime,
     }
     std::cout << '\n';
 
+    // Executors use the host runtime directly, so pending arg updates are
+    // already visible to them
+    runtime.clear_dirty_args();
+
     // Store runtime pointer for print_handshake_results
     last_runtime_ = &runtime;
 
@@ -217,23 +321,226 @@ int DeviceRunner::run(Runtime& runtime,
         return -1;
     }
 
-    // Launch AICPU threads
+    if (doorbell_ != nullptr) {
+        return submit_persistent(runtime, launch);
+    }
+
+    pending_launches_.emplace_back();
+    LaunchRecord& record = pending_launches_.back();
+    record.runner = this;
+    record.runtime = &runtime;
+    std::promise<int> finished;
+    record.done = finished.get_future().share();
+    std::shared_future<int> previous;
+    uint64_t ticket = 0;
+    if (partitioned) {
+        ticket = partitions_.take_ticket();
+    } else {
+        previous = last_launch_done_;
+        last_launch_done_ = record.done;
+    }
+
+    record.worker = std::thread([this, &runtime, previous, partitioned, ticket, block_dim, num_cores,
+                                 launch_aicpu_num, finished = std::move(finished)]() mutable {
+        if (partitioned) {
+            // Each partition has its own scheduler state in the AICPU
+            // library, so the launch runs alongside the other partitions
+            int first_block = 0;
+            int slot = partitions_.admit(ticket, block_dim, &first_block);
+            runtime.partition = slot;
+            runtime.block_offset = first_block;
+            std::cout << "=== Partition " << slot << ": blocks [" << first_block << "-"
+                      << first_block + block_dim - 1 << "] ===" << '\n';
+            execute_launch(runtime, num_cores, launch_aicpu_num);
+            partitions_.release(slot);
+        } else {
+            // Launches share one scheduler state, so they take turns in
+            // submission order like kernels on a device stream
+            if (previous.valid()) {
+                previous.wait();
+            }
+            execute_launch(runtime, num_cores, launch_aicpu_num);
+        }
+        std::cout << "=== All threads completed ===" << '\n';
+        finished.set_value(0);
+    });
+
+    *launch = &record;
+    return 0;
+}
+
+/**
+ * Scheduler threads of a launch
+ *
+ * 0 asks for one thread per available AICPU (PTO_SIM_AICPUS, default: one
+ * per host CPU), at most one per block and RUNTIME_MAX_SCHED_THREADS.
+ *
+ * @return Thread count, or -1 if launch_aicpu_num is out of range
+ */
+int DeviceRunner::resolve_aicpu_num(int launch_aicpu_num, int block_dim) const {
+    if (launch_aicpu_num < 0 || launch_aicpu_num > RUNTIME_MAX_SCHED_THREADS) {
+        std::cerr << "Error: aicpu_thread_num " << launch_aicpu_num << " is out of range (0-"
+                  << RUNTIME_MAX_SCHED_THREADS << ")\n";
+        return -1;
+    }
+    if (launch_aicpu_num > 0) {
+        return launch_aicpu_num;
+    }
+    const char* value = getenv("PTO_SIM_AICPUS");
+    int available = value != nullptr ? atoi(value) : static_cast<int>(std::thread::hardware_concurrency());
+    if (available < 1) available = 1;
+    if (block_dim > 0 && available > block_dim) available = block_dim;
+    return available < RUNTIME_MAX_SCHED_THREADS ? available : RUNTIME_MAX_SCHED_THREADS;
+}
+
+namespace {
+
+SimEngine sim_engine_from_env() {
+    const char* name = getenv("PTO_SIM_ENGINE");
+    if (name == nullptr || name[0] == '\0' || strcmp(name, "threads") == 0) {
+        return SimEngine::THREADS;
+    }
+    if (strcmp(name, "pool") == 0) {
+        return SimEngine::POOL;
+    }
+    if (strcmp(name, "inline") == 0) {
+        return SimEngine::INLINE;
+    }
+    std::cerr << "Warning: unknown PTO_SIM_ENGINE '" << name << "', using threads\n";
+    return SimEngine::THREADS;
+}
+
+int sim_pool_workers(int num_cores) {
+    const char* value = getenv("PTO_SIM_WORKERS");
+    int workers = value != nullptr ? atoi(value) : static_cast<int>(std::thread::hardware_concurrency());
+    if (workers < 1) workers = 1;
+    return workers < num_cores ? workers : num_cores;
+}
+
+/**
+ * State of SimEngine::INLINE, handed to the AICPU idle hook
+ */
+struct InlineCores {
+    Runtime* runtime;
+    int (*poll)(Runtime*, int, int);
+    int num_cores;
+    std::atomic<int> next_core{0};
+    std::atomic_flag stepping[RUNTIME_MAX_WORKER];  // Core being stepped by some AICPU thread
+};
+
+/**
+ * AICPU idle hook of SimEngine::INLINE: step every core no other AICPU
+ * thread is stepping, starting at a rotating core so concurrent callers
+ * spread out. Yields if none of them had anything to do.
+ */
+void inline_cores_idle(void* ctx) {
+    InlineCores* cores = static_cast<InlineCores*>(ctx);
+    int start = cores->next_core.fetch_add(1, std::memory_order_relaxed) % cores->num_cores;
+    bool progress = false;
+    for (int n = 0; n < cores->num_cores; n++) {
+        int i = (start + n) % cores->num_cores;
+        if (cores->stepping[i].test_and_set(std::memory_order_acquire)) {
+            continue;
+        }
+        int result = cores->poll(cores->runtime, i, cores->runtime->workers[i].core_type);
+        cores->stepping[i].clear(std::memory_order_release);
+        progress = progress || result == AICORE_POLL_PROGRESS;
+    }
+    if (!progress) {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * SimEngine::POOL worker: step cores worker, worker + workers, ... in turn
+ * until each has seen the quit signal
+ */
+void pool_worker(Runtime* runtime, int (*poll)(Runtime*, int, int), int num_cores, int worker, int workers) {
+    std::vector<int> cores;
+    for (int i = worker; i < num_cores; i += workers) {
+        cores.push_back(i);
+    }
+    while (!cores.empty()) {
+        bool progress = false;
+        for (size_t k = 0; k < cores.size();) {
+            int result = poll(runtime, cores[k], runtime->workers[cores[k]].core_type);
+            if (result == AICORE_POLL_EXIT) {
+                cores[k] = cores.back();
+                cores.pop_back();
+                continue;
+            }
+            progress = progress || result == AICORE_POLL_PROGRESS;
+            k++;
+        }
+        if (!progress) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+}  // namespace
+
+/**
+ * Run one launch to completion on the calling thread's behalf
+ *
+ * Starts the AICPU threads and, depending on PTO_SIM_ENGINE, one thread per
+ * AICore, a bounded pool of threads stepping the AICores, or no AICore
+ * threads at all, and joins them.
+ */
+void DeviceRunner::execute_launch(Runtime& runtime, int num_cores, int launch_aicpu_num) {
+    SimEngine engine = sim_engine_from_env();
+    if (engine != SimEngine::THREADS && aicore_poll_func_ == nullptr) {
+        std::cerr << "Warning: AICore library has no aicore_poll_wrapper, using one thread per core\n";
+        engine = SimEngine::THREADS;
+    }
+    if (engine == SimEngine::INLINE && aicpu_set_idle_hook_func_ == nullptr) {
+        std::cerr << "Warning: AICPU library has no aicpu_set_idle_hook, using one thread per core\n";
+        engine = SimEngine::THREADS;
+    }
+
+    std::unique_ptr<InlineCores> inline_cores;
+    if (engine == SimEngine::INLINE) {
+        inline_cores.reset(new InlineCores());
+        inline_cores->runtime = &runtime;
+        inline_cores->poll = aicore_poll_func_;
+        inline_cores->num_cores = num_cores;
+        for (int i = 0; i < num_cores; i++) {
+            inline_cores->stepping[i].clear();
+        }
+    }
+
+    // Launch AICPU threads. The idle hook is per thread, so concurrent
+    // launches each step only their own cores.
     std::cout << "=== Launching " << launch_aicpu_num << " AICPU thread(s) ===" << '\n';
     std::vector<std::thread> aicpu_threads;
     for (int i = 0; i < launch_aicpu_num; i++) {
-        aicpu_threads.emplace_back([this, &runtime]() {
+        aicpu_threads.emplace_back([this, &runtime, cores = inline_cores.get()]() {
+            if (cores != nullptr) {
+                aicpu_set_idle_hook_func_(inline_cores_idle, cores);
+            }
             aicpu_execute_func_(&runtime);
         });
     }
 
     // Launch AICore threads
-    std::cout << "=== Launching " << num_cores << " AICore thread(s) ===" << '\n';
     std::vector<std::thread> aicore_threads;
-    for (int i = 0; i < num_cores; i++) {
-        int core_type = runtime.workers[i].core_type;
-        aicore_threads.emplace_back([this, &runtime, i, core_type]() {
-            aicore_execute_func_(&runtime, i, core_type);
-        });
+    if (engine == SimEngine::THREADS) {
+        std::cout << "=== Launching " << num_cores << " AICore thread(s) ===" << '\n';
+        for (int i = 0; i < num_cores; i++) {
+            int core_type = runtime.workers[i].core_type;
+            aicore_threads.emplace_back([this, &runtime, i, core_type]() {
+                aicore_execute_func_(&runtime, i, core_type);
+            });
+        }
+    } else if (engine == SimEngine::POOL) {
+        int workers = sim_pool_workers(num_cores);
+        std::cout << "=== Launching " << workers << " AICore pool thread(s) for " << num_cores
+                  << " core(s) ===" << '\n';
+        for (int w = 0; w < workers; w++) {
+            aicore_threads.emplace_back(pool_worker, &runtime, aicore_poll_func_, num_cores, w, workers);
+        }
+    } else {
+        std::cout << "=== Running " << num_cores << " AICore(s) on the AICPU threads ===" << '\n';
     }
 
     // Wait for all threads to complete
@@ -244,11 +551,326 @@ int DeviceRunner::run(Runtime& runtime,
     for (auto& t : aicore_threads) {
         t.join();
     }
+}
+
+int DeviceRunner::wait_launch(LaunchRecord* launch) {
+    if (launch == nullptr) {
+        return -1;
+    }
+    auto it = pending_launches_.begin();
+    while (it != pending_launches_.end() && &*it != launch) {
+        ++it;
+    }
+    if (it == pending_launches_.end()) {
+        std::cerr << "Error: unknown or already completed launch handle\n";
+        return -1;
+    }
+
+    int rc;
+    if (it->submit_seq != 0) {
+        if (!it->retired) {
+            wait_persistent_done(it->submit_seq);
+            it->status = doorbell_->status;
+        }
+        rc = it->status;
+    } else {
+        it->worker.join();
+        rc = it->done.get();
+    }
+    pending_launches_.erase(it);
+    return rc;
+}
+
+// =============================================================================
+// Partitioned Launches
+// =============================================================================
+
+void PartitionTable::configure(int device_blocks) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    block_owner_.assign(device_blocks, -1);
+    for (int s = 0; s < RUNTIME_MAX_PARTITIONS; s++) {
+        slot_busy_[s] = false;
+    }
+    next_ticket_ = 0;
+    serving_ = 0;
+}
 
-    std::cout << "=== All threads completed ===" << '\n';
+uint64_t PartitionTable::take_ticket() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_ticket_++;
+}
+
+int PartitionTable::place(int block_dim, int* first_block) {
+    int slot = 0;
+    while (slot < RUNTIME_MAX_PARTITIONS && slot_busy_[slot]) {
+        slot++;
+    }
+    if (slot == RUNTIME_MAX_PARTITIONS) {
+        return -1;
+    }
+
+    // First fit: the lowest range of block_dim consecutive free blocks
+    int run = 0;
+    for (int b = 0; b < static_cast<int>(block_owner_.size()); b++) {
+        run = block_owner_[b] < 0 ? run + 1 : 0;
+        if (run == block_dim) {
+            *first_block = b - block_dim + 1;
+            std::fill(block_owner_.begin() + *first_block, block_owner_.begin() + b + 1, slot);
+            slot_busy_[slot] = true;
+            return slot;
+        }
+    }
+    return -1;
+}
+
+int PartitionTable::admit(uint64_t ticket, int block_dim, int* first_block) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    int slot = -1;
+    released_.wait(lock, [&]() { return ticket == serving_ && (slot = place(block_dim, first_block)) >= 0; });
+
+    // The next launch in line may fit into what is still free
+    serving_++;
+    released_.notify_all();
+    return slot;
+}
+
+void PartitionTable::release(int slot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::replace(block_owner_.begin(), block_owner_.end(), slot, -1);
+        slot_busy_[slot] = false;
+    }
+    released_.notify_all();
+}
+
+int DeviceRunner::set_partitioning(int device_blocks) {
+    if (device_blocks < 0) {
+        std::cerr << "Error: invalid number of device blocks " << device_blocks << '\n';
+        return -1;
+    }
+    if (doorbell_ != nullptr) {
+        std::cerr << "Error: cannot partition a device while the persistent executor is running\n";
+        return -1;
+    }
+    if (!pending_launches_.empty()) {
+        std::cerr << "Error: cannot change partitioning while launches are in flight\n";
+        return -1;
+    }
+    partitions_.configure(device_blocks);
+    last_launch_done_ = std::shared_future<int>();
+    return 0;
+}
+
+// =============================================================================
+// Persistent Executors
+// =============================================================================
+
+int DeviceRunner::start_persistent(int block_dim,
+                                   int device_id,
+                                   const std::vector<uint8_t>& aicpu_so_binary,
+                                   const std::vector<uint8_t>& aicore_kernel_binary,
+                                   int launch_aicpu_num) {
+    if (doorbell_ != nullptr) {
+        std::cerr << "Error: persistent executor is already running\n";
+        return -1;
+    }
+    int num_cores = block_dim * cores_per_blockdim_;
+    if (block_dim <= 0 || num_cores > RUNTIME_MAX_WORKER || launch_aicpu_num < 0) {
+        std::cerr << "Error: invalid persistent executor configuration (block_dim=" << block_dim
+                  << ", aicpu_thread_num=" << launch_aicpu_num << ")\n";
+        return -1;
+    }
+
+    int rc = ensure_device_initialized(device_id, aicpu_so_binary, aicore_kernel_binary);
+    if (rc != 0) {
+        std::cerr << "Error: ensure_device_initialized failed: " << rc << '\n';
+        return rc;
+    }
+    if (aicpu_execute_persistent_func_ == nullptr || aicore_execute_persistent_func_ == nullptr) {
+        std::cerr << "Error: executor binaries do not provide persistent entry points\n";
+        return -1;
+    }
+    if (partitions_.device_blocks() > 0) {
+        std::cerr << "Error: persistent executor cannot run on a partitioned device\n";
+        return -1;
+    }
+    launch_aicpu_num = resolve_aicpu_num(launch_aicpu_num, block_dim);
+    if (launch_aicpu_num < 0) {
+        return -1;
+    }
+
+    // Executors are process-wide singletons; let per-launch threads finish
+    while (!pending_launches_.empty()) {
+        wait_launch(&pending_launches_.front());
+    }
+    last_launch_done_ = std::shared_future<int>();
+
+    doorbell_ = new ExecutorDoorbell();
+    persistent_block_dim_ = block_dim;
+    persistent_aicpu_num_ = launch_aicpu_num;
+    persistent_submitted_ = 0;
+
+    std::cout << "=== Starting persistent executor: " << launch_aicpu_num << " AICPU thread(s), " << num_cores
+              << " AICore thread(s) ===" << '\n';
+    ExecutorDoorbell* doorbell = doorbell_;
+    for (int i = 0; i < launch_aicpu_num; i++) {
+        persistent_threads_.emplace_back([this, doorbell]() {
+            aicpu_execute_persistent_func_(doorbell);
+        });
+    }
+    for (int i = 0; i < num_cores; i++) {
+        int core_type = (i < block_dim) ? 0 : 1;
+        persistent_threads_.emplace_back([this, doorbell, i, core_type]() {
+            aicore_execute_persistent_func_(doorbell, i, core_type);
+        });
+    }
+    return 0;
+}
+
+int DeviceRunner::stop_persistent() {
+    if (doorbell_ == nullptr) {
+        return 0;
+    }
+
+    wait_persistent_done(persistent_submitted_);
+    doorbell_->shutdown = 1;
+    for (auto& t : persistent_threads_) {
+        t.join();
+    }
+    persistent_threads_.clear();
+
+    // Launches that were never waited for keep their status
+    for (LaunchRecord& pending : pending_launches_) {
+        if (pending.submit_seq != 0 && !pending.retired) {
+            pending.status = doorbell_->status;
+            pending.retired = true;
+        }
+    }
+
+    delete doorbell_;
+    doorbell_ = nullptr;
+    persistent_block_dim_ = 0;
+    persistent_aicpu_num_ = 0;
+    std::cout << "=== Persistent executor stopped after " << persistent_submitted_ << " graph(s) ===" << '\n';
+    return 0;
+}
+
+int DeviceRunner::submit_persistent(Runtime& runtime, LaunchRecord** launch) {
+    // One submission at a time: the doorbell has a single runtime slot
+    wait_persistent_done(persistent_submitted_);
+    for (LaunchRecord& pending : pending_launches_) {
+        if (pending.submit_seq == persistent_submitted_ && !pending.retired) {
+            pending.status = doorbell_->status;
+            pending.retired = true;
+        }
+    }
+
+    pending_launches_.emplace_back();
+    LaunchRecord& record = pending_launches_.back();
+    record.runner = this;
+    record.runtime = &runtime;
+    record.submit_seq = persistent_submitted_ + 1;
+
+    doorbell_->runtime = reinterpret_cast<uint64_t>(&runtime);
+    doorbell_->status = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    doorbell_->submit_seq = ++persistent_submitted_;
+
+    *launch = &record;
+    return 0;
+}
+
+void DeviceRunner::wait_persistent_done(uint32_t seq) {
+    while (static_cast<int32_t>(doorbell_->done_seq - seq) < 0) {
+        std::this_thread::yield();
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+void DeviceRunner::release_runtime(const Runtime& runtime) {
+    if (last_runtime_ == &runtime) {
+        last_runtime_ = nullptr;
+    }
+}
+
+int DeviceRunner::fetch_task_timing(Runtime& runtime) {
+    for (const LaunchRecord& pending : pending_launches_) {
+        if (pending.runtime == &runtime) {
+            std::cerr << "Error: runtime is still in flight; wait for its launch first\n";
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int DeviceRunner::fetch_scheduler_stats(Runtime& runtime) {
+    // Same precondition as the timestamps: executors write the host runtime
+    return fetch_task_timing(runtime);
+}
+
+int DeviceRunner::enable_device_log(uint32_t records_per_thread) {
+    if (!pending_launches_.empty()) {
+        std::cerr << "Error: cannot change the device log while launches are in flight\n";
+        return -1;
+    }
+    if (log_buffer_ != nullptr) {
+        mem_alloc_.free(log_buffer_);
+        log_buffer_ = nullptr;
+        log_records_per_thread_ = 0;
+    }
+    if (records_per_thread == 0) {
+        return 0;
+    }
+
+    size_t size = device_log_buffer_size(records_per_thread);
+    log_buffer_ = mem_alloc_.alloc(size);
+    if (log_buffer_ == nullptr) {
+        std::cerr << "Error: Failed to allocate the device log buffer (" << size << " bytes)\n";
+        return -1;
+    }
+    memset(log_buffer_, 0, size);
+    DeviceLogRing* rings = static_cast<DeviceLogRing*>(log_buffer_);
+    for (int t = 0; t < DEVICE_LOG_MAX_THREADS; t++) {
+        rings[t].capacity = records_per_thread;
+    }
+    log_records_per_thread_ = records_per_thread;
     return 0;
 }
 
+int DeviceRunner::dump_device_log(const char* path) {
+    if (log_buffer_ == nullptr) {
+        std::cerr << "Error: device log is not enabled\n";
+        return -1;
+    }
+    if (!pending_launches_.empty()) {
+        std::cerr << "Error: launches are still in flight; wait for them first\n";
+        return -1;
+    }
+    if (aicpu_so_binary_.empty()) {
+        std::cerr << "Error: no AICPU library loaded to decode the device log\n";
+        return -1;
+    }
+
+    FILE* out = path != nullptr ? fopen(path, "w") : stdout;
+    if (out == nullptr) {
+        std::cerr << "Error: Failed to open device log file " << path << '\n';
+        return -1;
+    }
+    int count = decode_device_log(aicpu_so_binary_.data(), aicpu_so_binary_.size(), log_buffer_,
+                                  SYS_CNT_TICKS_PER_US, out);
+    if (path != nullptr) {
+        fclose(out);
+    } else {
+        fflush(out);
+    }
+
+    DeviceLogRing* rings = static_cast<DeviceLogRing*>(log_buffer_);
+    for (int t = 0; t < DEVICE_LOG_MAX_THREADS; t++) {
+        rings[t].head = 0;
+    }
+    return count;
+}
+
 void DeviceRunner::print_handshake_results() {
     if (worker_count_ == 0 || last_runtime_ == nullptr) {
         return;
@@ -260,7 +882,8 @@ void DeviceRunner::print_handshake_results() {
                   << ": aicore_done=" << last_runtime_->workers[i].aicore_done
                   << " aicpu_ready=" << last_runtime_->workers[i].aicpu_ready
                   << " control=" << last_runtime_->workers[i].control
-                  << " task=" << last_runtime_->workers[i].task << std::endl;
+                  << " dispatched=" << last_runtime_->workers[i].dispatch_seq
+                  << " completed=" << last_runtime_->workers[i].complete_seq << std::endl;
     }
 }
 
@@ -270,6 +893,14 @@ int DeviceRunner::finalize() {
         return 0;
     }
 
+    // Stop resident executors, then drain launches that were never waited for
+    stop_persistent();
+    while (!pending_launches_.empty()) {
+        wait_launch(&pending_launches_.front());
+    }
+    last_launch_done_ = std::shared_future<int>();
+    partitions_.configure(0);
+
     // Print handshake results before cleanup
     print_handshake_results();
 
@@ -284,30 +915,41 @@ int DeviceRunner::finalize() {
         }
     }
     func_id_to_addr_.clear();
+    for (MappedKernel& image : kernel_images_) {
+        munmap(image.exec_mem, image.size);
+    }
+    kernel_images_.clear();
 
-    // Close dynamically loaded libraries and remove temp files
+    // Close dynamically loaded libraries
     if (aicpu_so_handle_ != nullptr) {
-        dlclose(aicpu_so_handle_);
+        dlclose_from_memory(aicpu_so_handle_, aicpu_so_fd_);
         aicpu_so_handle_ = nullptr;
+        aicpu_so_fd_ = -1;
+        aicpu_so_binary_.clear();
         aicpu_execute_func_ = nullptr;
-    }
-    if (!aicpu_so_path_.empty()) {
-        std::remove(aicpu_so_path_.c_str());
-        aicpu_so_path_.clear();
+        aicpu_execute_persistent_func_ = nullptr;
+        aicpu_set_idle_hook_func_ = nullptr;
     }
 
     if (aicore_so_handle_ != nullptr) {
-        dlclose(aicore_so_handle_);
+        dlclose_from_memory(aicore_so_handle_, aicore_so_fd_);
         aicore_so_handle_ = nullptr;
+        aicore_so_fd_ = -1;
         aicore_execute_func_ = nullptr;
-    }
-    if (!aicore_so_path_.empty()) {
-        std::remove(aicore_so_path_.c_str());
-        aicore_so_path_.clear();
+        aicore_execute_persistent_func_ = nullptr;
+        aicore_poll_func_ = nullptr;
     }
 
     // Free all remaining allocations
+    MemoryStats stats = mem_alloc_.get_stats();
+    if (stats.alloc_count > 0) {
+        std::cout << "Memory pool: peak " << stats.peak_bytes << " bytes, " << stats.cache_hits << "/"
+                  << stats.alloc_count << " allocations served from cache\n";
+    }
+    log_buffer_ = nullptr;
+    log_records_per_thread_ = 0;
     mem_alloc_.finalize();
+    pinned_pool_.finalize();
 
     device_id_ = -1;
     worker_count_ = 0;
@@ -385,6 +1027,86 @@ int DeviceRunner::register_kernel(int func_id, const uint8_t* bin_data, size_t b
     return 0;
 }
 
+int DeviceRunner::register_kernels(const int* func_ids,
+                                   const uint8_t* const* bin_data,
+                                   const size_t* bin_sizes,
+                                   int count) {
+    if (count < 0 || (count > 0 && (func_ids == nullptr || bin_data == nullptr || bin_sizes == nullptr))) {
+        std::cerr << "Error: Invalid kernel batch\n";
+        return -1;
+    }
+
+    // Keep the first occurrence of every func_id that is not registered yet
+    std::vector<int> ids;
+    std::vector<const uint8_t*> bins;
+    std::vector<size_t> sizes;
+    std::set<int> batch;
+    for (int i = 0; i < count; i++) {
+        if (bin_data[i] == nullptr || bin_sizes[i] == 0) {
+            std::cerr << "Error: Invalid kernel data for func_id=" << func_ids[i] << '\n';
+            return -1;
+        }
+        if (func_id_to_addr_.find(func_ids[i]) != func_id_to_addr_.end() || !batch.insert(func_ids[i]).second) {
+            std::cout << "Kernel func_id=" << func_ids[i] << " already registered, skipping\n";
+            continue;
+        }
+        if (bin_sizes[i] == sizeof(uint64_t)) {
+            // Function pointer entry: nothing to map
+            int rc = register_kernel(func_ids[i], bin_data[i], bin_sizes[i]);
+            if (rc != 0) {
+                return rc;
+            }
+            continue;
+        }
+        ids.push_back(func_ids[i]);
+        bins.push_back(bin_data[i]);
+        sizes.push_back(bin_sizes[i]);
+    }
+    if (ids.empty()) {
+        return 0;
+    }
+
+    std::vector<uint8_t> image;
+    pack_core_function_bins(bins.data(), sizes.data(), ids.size(), &image);
+
+    // One mapping for the whole image (see register_kernel() for MAP_JIT)
+    void* exec_mem = mmap(nullptr, image.size(),
+                          PROT_READ | PROT_WRITE | PROT_EXEC,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_JIT, -1, 0);
+    if (exec_mem == MAP_FAILED) {
+        std::cerr << "Error: mmap failed for " << ids.size() << " kernels"
+                  << " (errno=" << errno << ": " << strerror(errno) << ")\n";
+        return -1;
+    }
+
+#ifdef __APPLE__
+    pthread_jit_write_protect_np(false);
+#endif
+    std::memcpy(exec_mem, image.data(), image.size());
+#ifdef __APPLE__
+    pthread_jit_write_protect_np(true);
+    sys_icache_invalidate(exec_mem, image.size());
+#endif
+
+    MappedKernel mapping;
+    mapping.exec_mem = exec_mem;
+    mapping.size = image.size();
+    mapping.func_addr = reinterpret_cast<uint64_t>(exec_mem);
+    kernel_images_.push_back(mapping);
+
+    CoreFunctionBinCache* cache = reinterpret_cast<CoreFunctionBinCache*>(image.data());
+    for (size_t i = 0; i < ids.size(); i++) {
+        MappedKernel kernel;
+        kernel.func_addr = mapping.func_addr + (cache->get_kernel(i)->data - image.data());
+        func_id_to_addr_[ids[i]] = kernel;
+    }
+
+    std::cout << "Registered " << ids.size() << " kernels (binary) in one "
+              << image.size() << "-byte mapping at 0x" << std::hex
+              << mapping.func_addr << std::dec << '\n';
+    return 0;
+}
+
 uint64_t DeviceRunner::get_function_bin_addr(int func_id) {
     auto it = func_id_to_addr_.find(func_id);
     if (it == func_id_to_addr_.end()) {
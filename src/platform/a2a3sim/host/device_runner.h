@@ -14,9 +14,14 @@
 #ifndef RUNTIME_DEVICERUNNER_H
 #define RUNTIME_DEVICERUNNER_H
 
+#include <condition_variable>
 #include <cstdint>
+#include <future>
+#include <list>
 #include <map>
-#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "function_cache.h"
@@ -38,24 +43,139 @@ struct MappedKernel {
 };
 
 /**
- * Device runner singleton for simulated kernel execution
+ * How a launch maps its simulated AICores onto host threads
+ *
+ * Chosen per launch from PTO_SIM_ENGINE (threads, pool or inline). The
+ * persistent executor (start_persistent) always uses THREADS.
+ */
+enum class SimEngine {
+    THREADS,  // One thread per core, yielding while idle (default)
+    POOL,     // Cores stepped round-robin by PTO_SIM_WORKERS threads (default: host CPUs)
+    INLINE,   // No AICore threads: idle AICPU threads run the posted tasks themselves
+};
+
+/**
+ * Admission of concurrent launches into disjoint block ranges of a device
+ *
+ * Every admitted launch holds a contiguous range of device blocks and one
+ * of the RUNTIME_MAX_PARTITIONS AICPU scheduler slots until it is released.
+ * Launches are admitted in the order they took their ticket: the oldest
+ * waiting launch starts as soon as a large enough range is free, and later
+ * ones queue behind it so a wide graph is never starved by narrow ones.
+ */
+class PartitionTable {
+public:
+    /**
+     * Set the number of blocks the device offers
+     *
+     * No launch may hold or wait for a partition.
+     *
+     * @param device_blocks  Total device blocks, 0 = partitioning disabled
+     */
+    void configure(int device_blocks);
+
+    /**
+     * Get the number of blocks the device offers (0 = disabled)
+     */
+    int device_blocks() const { return static_cast<int>(block_owner_.size()); }
+
+    /**
+     * Take the next place in the admission order
+     */
+    uint64_t take_ticket();
+
+    /**
+     * Wait until a launch is admitted and reserve its partition
+     *
+     * @param ticket       Value returned by take_ticket()
+     * @param block_dim    Blocks the launch needs (at most device_blocks())
+     * @param first_block  Output: first device block of the partition
+     * @return Scheduler slot of the partition, to pass to release()
+     */
+    int admit(uint64_t ticket, int block_dim, int* first_block);
+
+    /**
+     * Return the blocks and the scheduler slot of a finished launch
+     *
+     * @param slot  Value returned by admit()
+     */
+    void release(int slot);
+
+private:
+    // Reserve block_dim contiguous free blocks and a free slot, -1 if none
+    int place(int block_dim, int* first_block);
+
+    std::mutex mutex_;
+    std::condition_variable released_;
+    std::vector<int> block_owner_;                   // Slot holding each device block, -1 = free
+    bool slot_busy_[RUNTIME_MAX_PARTITIONS] = {};
+    uint64_t next_ticket_{0};                        // Handed to the next launch
+    uint64_t serving_{0};                            // Ticket allowed to be admitted next
+};
+
+/**
+ * Launch in flight, returned by DeviceRunner::run_async()
+ *
+ * The simulated AICPU/AICore threads of a launch are driven by one worker
+ * thread; done becomes ready when all of them have exited. Launches handed
+ * to the persistent executor have no worker and are identified by their
+ * doorbell submission number instead.
+ */
+class DeviceRunner;
+
+struct LaunchRecord {
+    DeviceRunner* runner{nullptr};  // Device the launch was queued on
+    Runtime* runtime{nullptr};
+    std::thread worker;
+    std::shared_future<int> done;
+    uint32_t submit_seq{0};   // Doorbell submission number, 0 = not persistent
+    bool retired{false};      // Persistent only: status below is final
+    int status{0};            // Persistent only: AICPU status of the submission
+};
+
+/**
+ * Per-device runner for simulated kernel execution
  *
  * This class provides the SAME interface as the real a2a3 DeviceRunner,
  * but implements execution using host threads instead of actual device
- * kernel launches.
+ * kernel launches. One instance exists per simulated device.
  *
  * Key simulation features:
  * - Memory operations use host memory (malloc/free/memcpy)
  * - Kernel execution uses std::thread
  * - Kernel .text binaries are loaded into mmap'd executable memory
+ * - Each device loads its own copy of the executor libraries, so the
+ *   executors' process-wide state is not shared between devices
  */
 class DeviceRunner {
 public:
+    static constexpr int MAX_DEVICES = 16;
+    static constexpr double SYS_CNT_TICKS_PER_US = 1000.0;  // Timestamps are steady_clock ns
+
     /**
-     * Get singleton instance
+     * Get the runner of the calling thread's current device (default 0)
      */
     static DeviceRunner& get();
 
+    /**
+     * Get the runner of a device, creating it on first use
+     *
+     * @param device_id  Device ID (0 to MAX_DEVICES - 1)
+     */
+    static DeviceRunner& get(int device_id);
+
+    /**
+     * Select the device used by get() on the calling thread
+     *
+     * @param device_id  Device ID (0 to MAX_DEVICES - 1)
+     */
+    static void set_current_device(int device_id);
+
+    /**
+     * Get the calling thread's current device
+     */
+    static int current_device();
+
     /**
      * Allocate tensor memory (host memory in simulation)
      *
@@ -64,6 +184,28 @@ public:
      */
     void* allocate_tensor(size_t bytes);
 
+    /**
+     * Allocate the device copy of a host buffer
+     *
+     * With host aliasing enabled the host buffer itself is adopted as the
+     * tensor (it joins the current arena but is never freed), so copies
+     * between the two are no-ops. Otherwise same as allocate_tensor().
+     *
+     * @param host_ptr  Host buffer, must outlive the tensor when aliased
+     * @param bytes     Size of tensor in bytes
+     * @return Pointer on success, nullptr on failure
+     */
+    void* allocate_host_tensor(void* host_ptr, size_t bytes);
+
+    /**
+     * Let allocate_host_tensor() alias host buffers instead of copying them
+     *
+     * Affects tensors allocated afterwards; no runtime may be initializing.
+     *
+     * @param enable  true to alias, false to allocate and copy
+     */
+    void set_host_aliasing(bool enable) { host_aliasing_ = enable; }
+
     /**
      * Free tensor memory
      *
@@ -72,7 +214,7 @@ public:
     void free_tensor(void* dev_ptr);
 
     /**
-     * Copy data (memcpy in simulation)
+     * Copy data (memcpy in simulation, nothing for an aliased pair)
      *
      * @param dev_ptr   Destination pointer
      * @param host_ptr  Source pointer
@@ -82,7 +224,7 @@ public:
     int copy_to_device(void* dev_ptr, const void* host_ptr, size_t bytes);
 
     /**
-     * Copy data (memcpy in simulation)
+     * Copy data (memcpy in simulation, nothing for an aliased pair)
      *
      * @param host_ptr  Destination pointer
      * @param dev_ptr   Source pointer
@@ -91,6 +233,52 @@ public:
      */
     int copy_from_device(void* host_ptr, const void* dev_ptr, size_t bytes);
 
+    /**
+     * Allocate host staging memory (see PinnedHostPool)
+     *
+     * @param bytes  Size in bytes
+     * @return Pointer on success, nullptr on failure
+     */
+    void* allocate_pinned(size_t bytes) { return pinned_pool_.alloc(bytes); }
+
+    /**
+     * Free host memory returned by allocate_pinned()
+     *
+     * @param host_ptr  Pointer returned by allocate_pinned()
+     */
+    void free_pinned(void* host_ptr) { pinned_pool_.free(host_ptr); }
+
+    /**
+     * Queue a copy to the device (memcpy right away in simulation)
+     *
+     * @param dev_ptr   Destination pointer
+     * @param host_ptr  Source pointer
+     * @param bytes     Number of bytes to copy
+     * @return 0 on success
+     */
+    int copy_to_device_async(void* dev_ptr, const void* host_ptr, size_t bytes) {
+        return copy_to_device(dev_ptr, host_ptr, bytes);
+    }
+
+    /**
+     * Queue a copy from the device (memcpy right away in simulation)
+     *
+     * @param host_ptr  Destination pointer
+     * @param dev_ptr   Source pointer
+     * @param bytes     Number of bytes to copy
+     * @return 0 on success
+     */
+    int copy_from_device_async(void* host_ptr, const void* dev_ptr, size_t bytes) {
+        return copy_from_device(host_ptr, dev_ptr, bytes);
+    }
+
+    /**
+     * Wait for every queued transfer (all complete when queued in simulation)
+     *
+     * @return 0
+     */
+    int sync_transfers() { return 0; }
+
     /**
      * Execute a runtime using threads
      *
@@ -106,7 +294,7 @@ public:
      * @param device_id            Device ID (ignored in simulation)
      * @param aicpu_so_binary      AICPU binary (ignored in simulation)
      * @param aicore_kernel_binary AICore binary (ignored in simulation)
-     * @param launch_aicpu_num     Number of AICPU threads
+     * @param launch_aicpu_num     Number of AICPU threads, 0 = one per available AICPU
      * @return 0 on success
      */
     int run(Runtime& runtime,
@@ -116,6 +304,172 @@ public:
             const std::vector<uint8_t>& aicore_kernel_binary,
             int launch_aicpu_num = 1);
 
+    /**
+     * Start executing a runtime without waiting for it to finish
+     *
+     * Prepares the runtime like run() and hands the AICPU/AICore threads
+     * to a worker thread. Launches execute one after another in submission
+     * order, mirroring stream ordering on the device, unless partitioning
+     * is enabled (see set_partitioning()). A runtime cannot be launched
+     * again until its previous launch has been waited for.
+     *
+     * @param runtime              Runtime to execute
+     * @param block_dim            Number of blocks (1 block = 1 AIC + 2 AIV)
+     * @param device_id            Device ID (ignored in simulation)
+     * @param aicpu_so_binary      AICPU binary
+     * @param aicore_kernel_binary AICore binary
+     * @param launch_aicpu_num     Number of AICPU threads, 0 = one per available AICPU
+     * @param launch               Output: handle to pass to wait_launch()
+     * @return 0 on success
+     */
+    int run_async(Runtime& runtime,
+                  int block_dim,
+                  int device_id,
+                  const std::vector<uint8_t>& aicpu_so_binary,
+                  const std::vector<uint8_t>& aicore_kernel_binary,
+                  int launch_aicpu_num,
+                  LaunchRecord** launch);
+
+    /**
+     * Wait for a launch started by run_async() and release its handle
+     *
+     * @param launch  Handle returned by run_async()
+     * @return 0 on success
+     */
+    int wait_launch(LaunchRecord* launch);
+
+    /**
+     * Run later launches concurrently on disjoint block ranges
+     *
+     * The device is treated as device_blocks blocks. Each launch is placed
+     * into a free range of block_dim blocks with its own AICPU scheduler
+     * state and starts right away; when no range is free it waits for
+     * running launches to finish. Launches are admitted in submission
+     * order, but complete in any order. No launch may be in flight and
+     * the persistent executor must not be running.
+     *
+     * @param device_blocks  Blocks of the device, 0 = launches run one after another again
+     * @return 0 on success, -1 on invalid arguments or state
+     */
+    int set_partitioning(int device_blocks);
+
+    /**
+     * Create a simulated device memory arena (see MemoryAllocator::create_arena)
+     *
+     * @return Arena id
+     */
+    int create_arena() { return mem_alloc_.create_arena(); }
+
+    /**
+     * Select the arena that subsequent allocate_tensor() calls of the calling
+     * thread belong to
+     *
+     * @param arena  Arena id, or 0 for none
+     */
+    void set_current_arena(int arena) { mem_alloc_.set_current_arena(arena); }
+
+    /**
+     * Free every tensor of an arena in one call
+     *
+     * @param arena  Arena id
+     * @return Number of tensors freed
+     */
+    size_t release_arena(int arena) { return mem_alloc_.release_arena(arena); }
+
+    /**
+     * List the tensors of an arena in allocation order
+     *
+     * @param arena  Arena id
+     * @return Device address and size of every tensor
+     */
+    std::vector<std::pair<void*, size_t>> arena_tensors(int arena) const { return mem_alloc_.arena_allocations(arena); }
+
+    /**
+     * Get statistics of the simulated device memory pool
+     */
+    MemoryStats get_memory_stats() const { return mem_alloc_.get_stats(); }
+
+    /**
+     * Forget a runtime that is being finalized
+     *
+     * The runtime must not be in flight.
+     *
+     * @param runtime  Runtime being finalized
+     */
+    void release_runtime(const Runtime& runtime);
+
+    /**
+     * Make the DFX timestamps of a runtime's last launch available
+     *
+     * The simulated executors stamp the host tasks directly, so this only
+     * checks that the runtime is not in flight.
+     *
+     * @param runtime  Runtime launched with profiling enabled
+     * @return 0 on success, -1 if a launch of the runtime is pending
+     */
+    int fetch_task_timing(Runtime& runtime);
+
+    /**
+     * Make the scheduler counters of a runtime's last launch available
+     *
+     * Runtime::sched_stats and core_busy_ticks are written by the AICPU
+     * directly into the host runtime in simulation, so this only checks that
+     * the runtime is not in flight.
+     *
+     * @param runtime  Launched runtime
+     * @return 0 on success, error code on failure
+     */
+    int fetch_scheduler_stats(Runtime& runtime);
+
+    /**
+     * Record AICPU log messages in binary rings instead of printing them
+     *
+     * Allocates a device buffer with a ring of records_per_thread records
+     * per AICPU scheduler thread (see common/device_log_ring.h); later
+     * launches on this device log into it. An earlier buffer and its
+     * records are discarded. No launch may be in flight.
+     *
+     * @param records_per_thread  Ring size, 0 = free the buffer and log as text again
+     * @return 0 on success, error code on failure
+     */
+    int enable_device_log(uint32_t records_per_thread);
+
+    /**
+     * Format the recorded AICPU log messages and empty the rings
+     *
+     * @param path  Output file, nullptr = stdout
+     * @return Number of messages written, or -1 on failure
+     */
+    int dump_device_log(const char* path);
+
+    /**
+     * Start resident executor threads that serve later launches
+     *
+     * Spawns the AICPU and AICore threads once. Until stop_persistent(),
+     * run()/run_async() only prepare the runtime and ring the executor
+     * doorbell instead of spawning threads per launch. Launches must use
+     * the block_dim and AICPU thread count given here.
+     *
+     * @param block_dim            Number of blocks (1 block = 1 AIC + 2 AIV)
+     * @param device_id            Device ID (ignored in simulation)
+     * @param aicpu_so_binary      AICPU binary
+     * @param aicore_kernel_binary AICore binary
+     * @param launch_aicpu_num     Number of AICPU threads, 0 = one per available AICPU
+     * @return 0 on success
+     */
+    int start_persistent(int block_dim,
+                         int device_id,
+                         const std::vector<uint8_t>& aicpu_so_binary,
+                         const std::vector<uint8_t>& aicore_kernel_binary,
+                         int launch_aicpu_num);
+
+    /**
+     * Wait for outstanding submissions and stop the resident executors
+     *
+     * @return 0 on success (also when no executor is running)
+     */
+    int stop_persistent();
+
     /**
      * Print handshake results
      */
@@ -142,6 +496,26 @@ public:
      */
     int register_kernel(int func_id, const uint8_t* bin_data, size_t bin_size);
 
+    /**
+     * Register a batch of kernels with one executable mapping
+     *
+     * Packs the .text sections into a single CoreFunctionBinCache image
+     * inside one mmap'd region and resolves each func_id from the image
+     * offsets. func_ids that are already registered (or repeated within
+     * the batch) are skipped; function pointer entries (8-byte binaries)
+     * are registered as in register_kernel().
+     *
+     * @param func_ids   Function identifier of each kernel
+     * @param bin_data   Kernel .text section binary data of each kernel
+     * @param bin_sizes  Size of each binary in bytes
+     * @param count      Number of kernels
+     * @return 0 on success
+     */
+    int register_kernels(const int* func_ids,
+                         const uint8_t* const* bin_data,
+                         const size_t* bin_sizes,
+                         int count);
+
     /**
      * Get function_bin_addr for a given func_id
      *
@@ -151,10 +525,12 @@ public:
     uint64_t get_function_bin_addr(int func_id);
 
 private:
-    DeviceRunner() = default;
+    friend struct std::default_delete<DeviceRunner>;
+    explicit DeviceRunner(int registry_id) : registry_id_(registry_id) {}
     ~DeviceRunner();
 
     // Configuration
+    int registry_id_;  // Device this runner was created for
     int device_id_{-1};
     int block_dim_{0};
     int cores_per_blockdim_{3};
@@ -162,23 +538,54 @@ private:
 
     // Memory management
     MemoryAllocator mem_alloc_;
+    PinnedHostPool pinned_pool_;
+    bool host_aliasing_{false};  // allocate_host_tensor() adopts host buffers
 
     // Simulation state (no actual device resources)
     KernelArgs kernel_args_;
 
+    // AICPU log rings (enable_device_log) and the image of the AICPU
+    // library, whose format section decodes them
+    void* log_buffer_{nullptr};
+    uint32_t log_records_per_thread_{0};
+    std::vector<uint8_t> aicpu_so_binary_;
+
     // Kernel binary mapping (func_id -> executable memory)
     std::map<int, MappedKernel> func_id_to_addr_;
 
+    // Mappings holding batches from register_kernels(); their kernels have
+    // a null exec_mem in func_id_to_addr_
+    std::vector<MappedKernel> kernel_images_;
+
     // Runtime pointer for print_handshake_results
     Runtime* last_runtime_{nullptr};
 
+    // Launches not yet waited for, and completion of the newest one
+    std::list<LaunchRecord> pending_launches_;
+    std::shared_future<int> last_launch_done_;
+
+    // Block ranges of concurrent launches (set_partitioning)
+    PartitionTable partitions_;
+
+    // Resident executors (start_persistent), nullptr doorbell when inactive
+    ExecutorDoorbell* doorbell_{nullptr};
+    std::vector<std::thread> persistent_threads_;
+    int persistent_block_dim_{0};
+    int persistent_aicpu_num_{0};
+    uint32_t persistent_submitted_{0};
+
     // Dynamically loaded executor libraries and function pointers
     void* aicpu_so_handle_{nullptr};
     void* aicore_so_handle_{nullptr};
+    int aicpu_so_fd_{-1};   // memfd backing aicpu_so_handle_
+    int aicore_so_fd_{-1};  // memfd backing aicore_so_handle_
     int (*aicpu_execute_func_)(Runtime*){nullptr};
     void (*aicore_execute_func_)(Runtime*, int, int){nullptr};
-    std::string aicpu_so_path_;
-    std::string aicore_so_path_;
+    int (*aicpu_execute_persistent_func_)(ExecutorDoorbell*){nullptr};
+    void (*aicore_execute_persistent_func_)(ExecutorDoorbell*, int, int){nullptr};
+    // Optional: needed by SimEngine::POOL and SimEngine::INLINE
+    int (*aicore_poll_func_)(Runtime*, int, int){nullptr};
+    void (*aicpu_set_idle_hook_func_)(void (*)(void*), void*){nullptr};
 
     // Private helper methods
     int ensure_device_initialized(int device_id,
@@ -186,6 +593,10 @@ private:
                                   const std::vector<uint8_t>& aicore_kernel_binary);
     int ensure_binaries_loaded(const std::vector<uint8_t>& aicpu_so_binary,
                                const std::vector<uint8_t>& aicore_kernel_binary);
+    int resolve_aicpu_num(int launch_aicpu_num, int block_dim) const;
+    int submit_persistent(Runtime& runtime, LaunchRecord** launch);
+    void execute_launch(Runtime& runtime, int num_cores, int launch_aicpu_num);
+    void wait_persistent_done(uint32_t seq);
 };
 
 #endif  // RUNTIME_DEVICERUNNER_H
@@ -1,25 +1,63 @@
 /**
- * Memory Allocator - Host Memory Management (Simulation)
+ * Memory Allocator - Centralized Memory Management (Simulation)
  *
- * This module provides host memory management that simulates device memory.
- * Instead of using CANN runtime APIs (rtMalloc/rtFree), we use standard
- * malloc/free with tracking for cleanup.
+ * Same caching pool as the a2a3 MemoryAllocator, backed by host malloc
+ * instead of rtMalloc so that simulated runs exercise the same allocation
+ * behavior (size classes, caching, arenas, statistics).
+ *
+ * Key Features:
+ * - Caching pool: small blocks are carved from 2 MB malloc slabs in
+ *   power-of-two size classes, larger blocks are malloc'd individually;
+ *   freed blocks are kept for reuse instead of being returned to the driver
+ * - O(1) alloc/free (hash lookup plus free-list push/pop)
+ * - Optional arenas: blocks allocated while an arena is current can be
+ *   released together with release_arena()
+ * - Adopted host buffers: adopt() tracks caller-owned memory as a block
+ *   (arena membership included) without ever freeing it
+ * - Statistics (bytes in use, peak, reserved, cache hit rate)
+ * - Automatic cleanup via destructor (RAII pattern)
+ * - Idempotent finalize() for explicit cleanup with error checking
+ * - PinnedHostPool: cached host staging memory for asynchronous transfers
  */
 
 #ifndef RUNTIME_MEMORYALLOCATOR_H
 #define RUNTIME_MEMORYALLOCATOR_H
 
 #include <cstddef>
-#include <set>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * Allocation statistics of a MemoryAllocator
+ */
+struct MemoryStats {
+    uint64_t bytes_in_use{0};    // Bytes of live blocks (rounded to their size class)
+    uint64_t peak_bytes{0};      // High-water mark of bytes_in_use
+    uint64_t bytes_reserved{0};  // Bytes currently held from malloc
+    uint64_t alloc_count{0};     // Successful alloc() calls
+    uint64_t cache_hits{0};      // alloc() calls served without a malloc
+};
 
 /**
- * MemoryAllocator class for managing host memory (simulating device memory)
+ * MemoryAllocator class for managing simulated device memory
  *
- * This class wraps standard malloc/free and provides automatic tracking
- * of allocations to prevent memory leaks. Uses RAII pattern for cleanup.
+ * Wraps malloc/free with a caching pool and tracks all allocations so they
+ * are released on finalize(). Uses RAII pattern for automatic cleanup.
+ *
+ * Thread-safe: allocations of one device may come from any host thread.
  */
 class MemoryAllocator {
 public:
+    static constexpr size_t SLAB_SIZE = 2ULL << 20;  // Backing allocation for small classes
+    static constexpr size_t MIN_BLOCK = 512;         // Smallest size class (also the alignment)
+    static constexpr int NUM_SMALL_CLASSES = 13;     // 512 B .. 2 MB
+
     MemoryAllocator() = default;
     ~MemoryAllocator();
 
@@ -30,36 +68,199 @@ public:
     /**
      * Allocate memory and track the pointer
      *
+     * Serves the request from the cache of its size class if possible,
+     * otherwise carves a new slab (small classes) or calls malloc (large
+     * blocks, rounded up to a multiple of SLAB_SIZE). If the host is out
+     * of memory, cached large blocks are released and the call retried.
+     *
      * @param size  Size in bytes to allocate
      * @return Pointer on success, nullptr on failure
      */
     void* alloc(size_t size);
 
     /**
-     * Free memory if tracked
+     * Track a caller-owned host buffer as a block
+     *
+     * The buffer joins the calling thread's current arena like an alloc()
+     * block, but free(), release_arena() and finalize() only forget it.
+     * It does not count towards the pool statistics. Adopting a buffer
+     * that is already tracked does nothing.
+     *
+     * @param ptr   Host buffer, must stay valid until it is freed
+     * @param size  Size of the buffer in bytes
+     * @return ptr on success, nullptr if ptr is nullptr
+     */
+    void* adopt(void* ptr, size_t size);
+
+    /**
+     * Return memory to the pool if tracked
+     *
+     * Safe to call with nullptr or untracked pointers.
      *
      * @param ptr  Pointer to free
-     * @return 0 on success
+     * @return 0 on success, 0 if ptr not tracked
      */
     int free(void* ptr);
 
     /**
-     * Free all remaining tracked allocations
+     * Create an arena for grouping allocations
+     *
+     * @return Arena id (> 0)
+     */
+    int create_arena();
+
+    /**
+     * Select the arena that subsequent alloc() calls of the calling
+     * thread belong to
+     *
+     * @param arena  Arena id from create_arena(), or 0 for none
+     */
+    void set_current_arena(int arena);
+
+    /**
+     * Return every live block of an arena to the pool in one call
+     *
+     * @param arena  Arena id from create_arena()
+     * @return Number of blocks released
+     */
+    size_t release_arena(int arena);
+
+    /**
+     * List the live blocks of an arena in allocation order
      *
-     * @return 0 on success
+     * @param arena  Arena id from create_arena()
+     * @return Pointer and requested size of every block
+     */
+    std::vector<std::pair<void*, size_t>> arena_allocations(int arena) const;
+
+    /**
+     * Release cached blocks that can be handed back to the driver
+     *
+     * Frees cached large blocks. Small-class slabs stay reserved until
+     * finalize().
+     *
+     * @return 0 on success, error code if any free failed
+     */
+    int trim();
+
+    /**
+     * Free all backing allocations
+     *
+     * Frees every slab and large block, including blocks still in use, and
+     * resets the pool. Can be called explicitly for error checking, or
+     * automatically via destructor. Idempotent - safe to call multiple
+     * times.
+     *
+     * @return 0 on success, error code if any frees failed
      */
     int finalize();
 
     /**
      * Get number of tracked allocations
      *
-     * @return Number of currently tracked pointers
+     * @return Number of live blocks
      */
-    size_t get_allocation_count() const { return ptr_set_.size(); }
+    size_t get_allocation_count() const;
+
+    /**
+     * Get pool statistics
+     */
+    MemoryStats get_stats() const;
 
 private:
-    std::set<void*> ptr_set_;
-    bool finalized_{false};
+    struct Block {
+        size_t size;       // Rounded block size
+        int size_class;    // Small class index, -1 for a large block, ADOPTED_CLASS for a host buffer
+        int arena;         // Owning arena, 0 = none
+        size_t arena_pos;  // Index in arena_blocks_[arena]
+        size_t requested;  // Size asked for by the caller
+        uint64_t seq;      // Allocation order
+    };
+
+    static constexpr int ADOPTED_CLASS = -2;
+
+    int backend_alloc(void** ptr, size_t size);
+    int backend_free(void* ptr);
+    void* take_block(size_t size, int size_class, size_t* rounded, int* rc);
+    void track_block(void* ptr, const Block& block);
+    void release_block(void* ptr, Block& block);
+    void detach_from_arena(Block& block);
+    int trim_locked();
+
+    mutable std::mutex mutex_;
+    std::unordered_map<void*, Block> live_;                      // Blocks handed out
+    std::vector<void*> small_free_[NUM_SMALL_CLASSES];           // Cached small blocks
+    std::unordered_map<size_t, std::vector<void*>> large_free_;  // Cached large blocks by size
+    std::vector<void*> slabs_;                                   // Small-class backing slabs
+    std::unordered_set<void*> large_blocks_;                     // All large blocks (live or cached)
+    std::unordered_map<int, std::vector<void*>> arena_blocks_;   // Live blocks per arena
+    std::unordered_map<std::thread::id, int> current_arena_;     // Arena selected by each thread
+    int next_arena_{1};
+    uint64_t next_seq_{0};
+    MemoryStats stats_;
+};
+
+/**
+ * Caching pool of host memory for transfer staging (Simulation)
+ *
+ * Same interface as the a2a3 PinnedHostPool. Device memory is host memory
+ * in simulation, so blocks are plain page-aligned allocations; nothing is
+ * page-locked.
+ *
+ * Thread-safe.
+ */
+class PinnedHostPool {
+public:
+    static constexpr size_t MIN_BLOCK = 64 << 10;  // Smallest block (also the alignment)
+
+    PinnedHostPool() = default;
+    ~PinnedHostPool();
+
+    // Prevent copying
+    PinnedHostPool(const PinnedHostPool&) = delete;
+    PinnedHostPool& operator=(const PinnedHostPool&) = delete;
+
+    /**
+     * Allocate a block, from the cache if one of its size is free
+     *
+     * @param size  Size in bytes
+     * @return Host pointer on success, nullptr on failure
+     */
+    void* alloc(size_t size);
+
+    /**
+     * Return a block to the cache
+     *
+     * Safe to call with nullptr or untracked pointers.
+     *
+     * @param ptr  Pointer returned by alloc()
+     */
+    void free(void* ptr);
+
+    /**
+     * Check whether a host range lies inside one live block
+     *
+     * @param ptr   Start of the range
+     * @param size  Length of the range in bytes
+     */
+    bool contains(const void* ptr, size_t size) const;
+
+    /**
+     * Free every block, live or cached
+     *
+     * Idempotent - safe to call multiple times.
+     *
+     * @return 0 on success, error code if any free failed
+     */
+    int finalize();
+
+private:
+    int backend_alloc(void** ptr, size_t size);
+    int backend_free(void* ptr);
+
+    mutable std::mutex mutex_;
+    std::map<uintptr_t, size_t> live_;                     // Block address -> size, ordered for contains()
+    std::unordered_map<size_t, std::vector<void*>> free_;  // Cached blocks by size
 };
 
 #endif  // RUNTIME_MEMORYALLOCATOR_H
@@ -0,0 +1,201 @@
+/**
+ * Device Log Ring - Binary AICPU Log Records
+ *
+ * Layout shared by the AICPU logging macros (device_log.h) and the host
+ * decoder (host/device_log_decoder.h).
+ *
+ * Formatting a message on the device costs microseconds per call, which is
+ * more than a scheduling decision. When the host has enabled a log buffer
+ * (see DeviceRunner::enable_device_log), every AICPU scheduler thread
+ * instead appends fixed-size records to a ring of its own: a timestamp, the
+ * level, the id of the format string and the raw argument values. Each
+ * ring has a single writer, so appending is a few stores and one release
+ * store of the head; no lock, no atomic read-modify-write. When a ring is
+ * full the oldest records are overwritten.
+ *
+ * Format strings are placed in the DEVICE_LOG_FORMAT_SECTION section of the
+ * AICPU library and identified by their offset in it. The host reads the
+ * section from the library image it uploaded and formats the records after
+ * the run.
+ *
+ * Launches running side by side on different AICPU partitions share the
+ * buffer; each partition has a group of DEVICE_LOG_THREADS_PER_PARTITION
+ * rings.
+ *
+ * Buffer layout (records_per_thread from the host):
+ *   DeviceLogRing  rings[DEVICE_LOG_MAX_THREADS]
+ *   DeviceLogRecord records[DEVICE_LOG_MAX_THREADS][records_per_thread]
+ */
+
+#ifndef PTO_DEVICE_LOG_RING_H
+#define PTO_DEVICE_LOG_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Levels, also used for compile-time stripping (PTO_DEVICE_LOG_LEVEL)
+#define DEVICE_LOG_LEVEL_DEBUG 0
+#define DEVICE_LOG_LEVEL_INFO 1
+#define DEVICE_LOG_LEVEL_WARN 2
+#define DEVICE_LOG_LEVEL_ERROR 3
+#define DEVICE_LOG_LEVEL_NONE 4
+
+// Messages below this level are compiled out of the AICPU library
+#ifndef PTO_DEVICE_LOG_LEVEL
+#define PTO_DEVICE_LOG_LEVEL DEVICE_LOG_LEVEL_INFO
+#endif
+
+// Must match RUNTIME_MAX_PARTITIONS and cover RUNTIME_MAX_SCHED_THREADS of
+// the runtime (checked where both are visible)
+#define DEVICE_LOG_MAX_PARTITIONS 8
+#define DEVICE_LOG_THREADS_PER_PARTITION 16
+#define DEVICE_LOG_MAX_THREADS (DEVICE_LOG_MAX_PARTITIONS * DEVICE_LOG_THREADS_PER_PARTITION)
+#define DEVICE_LOG_MAX_ARGS 8
+#define DEVICE_LOG_FORMAT_SECTION "pto_log_fmt"
+
+/**
+ * One log message (80 bytes)
+ */
+struct DeviceLogRecord {
+    uint64_t timestamp;   // get_sys_cnt_aicpu() at the call
+    uint32_t format_id;   // Offset of the format string in DEVICE_LOG_FORMAT_SECTION
+    uint8_t level;        // DEVICE_LOG_LEVEL_*
+    uint8_t arg_count;    // Valid entries of args
+    uint16_t reserved;
+    uint64_t args[DEVICE_LOG_MAX_ARGS];  // Integers widened, pointers as addresses, doubles as bits
+};
+
+/**
+ * Per-thread ring header (one cache line)
+ */
+struct DeviceLogRing {
+    volatile uint64_t head;   // Records ever written; record n lives in slot n % capacity
+    uint64_t format_base;     // Run-time address of DEVICE_LOG_FORMAT_SECTION (set by the writer)
+    uint32_t capacity;        // Records per thread (set by the host)
+    uint32_t reserved;
+    uint8_t pad[40];
+};
+
+static_assert(sizeof(DeviceLogRing) == 64, "DeviceLogRing must be one cache line");
+
+inline size_t device_log_buffer_size(uint32_t records_per_thread) {
+    return DEVICE_LOG_MAX_THREADS * (sizeof(DeviceLogRing) + records_per_thread * sizeof(DeviceLogRecord));
+}
+
+inline DeviceLogRecord* device_log_records(void* buffer, int thread, uint32_t records_per_thread) {
+    char* base = static_cast<char*>(buffer) + DEVICE_LOG_MAX_THREADS * sizeof(DeviceLogRing);
+    return reinterpret_cast<DeviceLogRecord*>(base) + static_cast<size_t>(thread) * records_per_thread;
+}
+
+// ============================================================================
+// Writer (AICPU side)
+// ============================================================================
+
+// Start of the format section, provided by the linker (weak: the section
+// is absent when every message is compiled out)
+extern "C" const char __start_pto_log_fmt[] __attribute__((weak, visibility("hidden")));
+
+// Ring of the calling thread, nullptr = log as text
+inline thread_local DeviceLogRing* t_device_log_ring = nullptr;
+inline thread_local DeviceLogRecord* t_device_log_records = nullptr;
+
+/**
+ * Route the calling thread's log messages to its ring of a log buffer
+ *
+ * @param buffer     Log buffer from the host, or nullptr to log as text again
+ * @param partition  AICPU partition of the launch
+ * @param thread     Scheduler thread index within the partition (threads
+ *                   beyond DEVICE_LOG_THREADS_PER_PARTITION log as text)
+ */
+inline void device_log_bind(void* buffer, int partition, int thread) {
+    if (buffer == nullptr || partition < 0 || partition >= DEVICE_LOG_MAX_PARTITIONS || thread < 0 ||
+        thread >= DEVICE_LOG_THREADS_PER_PARTITION) {
+        t_device_log_ring = nullptr;
+        t_device_log_records = nullptr;
+        return;
+    }
+    thread += partition * DEVICE_LOG_THREADS_PER_PARTITION;
+    DeviceLogRing* ring = static_cast<DeviceLogRing*>(buffer) + thread;
+    ring->format_base = reinterpret_cast<uint64_t>(__start_pto_log_fmt);
+    t_device_log_records = device_log_records(buffer, thread, ring->capacity);
+    t_device_log_ring = ring;
+}
+
+inline bool device_log_ring_bound() { return t_device_log_ring != nullptr; }
+
+/**
+ * Binds the calling thread to its ring for the lifetime of the scope
+ */
+struct DeviceLogScope {
+    DeviceLogScope(void* buffer, int partition, int thread) { device_log_bind(buffer, partition, thread); }
+    ~DeviceLogScope() { device_log_bind(nullptr, 0, 0); }
+    DeviceLogScope(const DeviceLogScope&) = delete;
+    DeviceLogScope& operator=(const DeviceLogScope&) = delete;
+};
+
+template <typename T>
+inline uint64_t device_log_arg(T value) {
+    if constexpr (std::is_floating_point<T>::value) {
+        double d = static_cast<double>(value);
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        return bits;
+    } else if constexpr (std::is_pointer<T>::value) {
+        return reinterpret_cast<uint64_t>(value);
+    } else if constexpr (std::is_signed<T>::value) {
+        return static_cast<uint64_t>(static_cast<int64_t>(value));
+    } else {
+        return static_cast<uint64_t>(value);
+    }
+}
+
+/**
+ * Append a record to the calling thread's ring (must be bound)
+ *
+ * @param level      DEVICE_LOG_LEVEL_*
+ * @param format     Format string placed in DEVICE_LOG_FORMAT_SECTION
+ * @param timestamp  Device timestamp
+ * @param args       Up to DEVICE_LOG_MAX_ARGS scalar arguments
+ */
+template <typename... Args>
+inline void device_log_write(int level, const char* format, uint64_t timestamp, Args... args) {
+    static_assert(sizeof...(Args) <= DEVICE_LOG_MAX_ARGS, "Too many arguments for a device log record");
+    DeviceLogRing* ring = t_device_log_ring;
+    uint64_t head = ring->head;
+    DeviceLogRecord* record = t_device_log_records + head % ring->capacity;
+    record->timestamp = timestamp;
+    record->format_id = static_cast<uint32_t>(format - __start_pto_log_fmt);
+    record->level = static_cast<uint8_t>(level);
+    record->arg_count = static_cast<uint8_t>(sizeof...(Args));
+    uint64_t values[] = {device_log_arg(args)..., 0};
+    for (size_t i = 0; i < sizeof...(Args); i++) {
+        record->args[i] = values[i];
+    }
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Record a message in the bound ring. fmt must be a string literal; it is
+ * copied into the format section so the host can find it.
+ */
+#define DEVICE_LOG_RING_WRITE(level, timestamp, fmt, ...)                                                    \
+    do {                                                                                                     \
+        static const char pto_log_format_[] __attribute__((section(DEVICE_LOG_FORMAT_SECTION), used)) = fmt; \
+        device_log_write(level, pto_log_format_, timestamp, ##__VA_ARGS__);                                  \
+    } while (false)
+
+// Stands in for compiled-out messages: type-checks the arguments without
+// evaluating them
+static inline void device_log_discard(const char*, ...) __attribute__((format(printf, 1, 2)));
+static inline void device_log_discard(const char*, ...) {}
+
+#define DEVICE_LOG_STRIPPED(fmt, ...)               \
+    do {                                            \
+        if (false) {                                \
+            device_log_discard(fmt, ##__VA_ARGS__); \
+        }                                           \
+    } while (false)
+
+#endif  // PTO_DEVICE_LOG_RING_H
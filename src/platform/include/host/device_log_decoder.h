@@ -0,0 +1,276 @@
+/**
+ * Device Log Decoder
+ *
+ * Formats the binary records of an AICPU log buffer (see
+ * common/device_log_ring.h) on the host. Format strings are looked up by
+ * id in the DEVICE_LOG_FORMAT_SECTION section of the AICPU library image
+ * that wrote them. %s arguments pointing into the library's loaded
+ * sections (string literals) are resolved through the same image; other
+ * strings print as their address.
+ *
+ * Header-only so that both platform runners can use it. Needs an ELF
+ * image, so only Linux builds can decode.
+ */
+
+#ifndef PTO_DEVICE_LOG_DECODER_H
+#define PTO_DEVICE_LOG_DECODER_H
+
+#ifdef __linux__
+#include <elf.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common/device_log_ring.h"
+
+namespace device_log_decoder {
+
+struct Section {
+    uint64_t addr;    // Link-time address
+    uint64_t offset;  // File offset in the image
+    uint64_t size;
+};
+
+/**
+ * Loaded sections of an ELF64 image and its format section
+ */
+struct Image {
+    const char* data{nullptr};
+    size_t size{0};
+    Section formats{0, 0, 0};
+    std::vector<Section> loaded;
+
+    bool parse(const uint8_t* image, size_t image_size) {
+        data = reinterpret_cast<const char*>(image);
+        size = image_size;
+#ifndef __linux__
+        return false;
+#else
+        if (image_size < sizeof(Elf64_Ehdr) || memcmp(image, ELFMAG, SELFMAG) != 0 ||
+            image[EI_CLASS] != ELFCLASS64) {
+            return false;
+        }
+        const Elf64_Ehdr* ehdr = reinterpret_cast<const Elf64_Ehdr*>(image);
+        if (ehdr->e_shoff + static_cast<uint64_t>(ehdr->e_shnum) * sizeof(Elf64_Shdr) > image_size ||
+            ehdr->e_shstrndx >= ehdr->e_shnum) {
+            return false;
+        }
+        const Elf64_Shdr* shdrs = reinterpret_cast<const Elf64_Shdr*>(data + ehdr->e_shoff);
+        const Elf64_Shdr& names = shdrs[ehdr->e_shstrndx];
+        bool found = false;
+        for (int i = 0; i < ehdr->e_shnum; i++) {
+            const Elf64_Shdr& sh = shdrs[i];
+            if (sh.sh_type != SHT_PROGBITS || (sh.sh_flags & SHF_ALLOC) == 0 || sh.sh_offset + sh.sh_size > size) {
+                continue;
+            }
+            Section section{sh.sh_addr, sh.sh_offset, sh.sh_size};
+            loaded.push_back(section);
+            if (sh.sh_name < names.sh_size &&
+                strcmp(data + names.sh_offset + sh.sh_name, DEVICE_LOG_FORMAT_SECTION) == 0) {
+                formats = section;
+                found = true;
+            }
+        }
+        return found;
+#endif
+    }
+
+    // NUL-terminated string at a section offset, nullptr if out of bounds
+    const char* string_at(const Section& section, uint64_t pos) const {
+        if (pos >= section.size) {
+            return nullptr;
+        }
+        const char* begin = data + section.offset + pos;
+        const char* end = data + section.offset + section.size;
+        return std::find(begin, end, '\0') != end ? begin : nullptr;
+    }
+
+    // String literal at a link-time address, nullptr if not in the image
+    const char* string_at_addr(uint64_t addr) const {
+        for (const Section& section : loaded) {
+            if (addr >= section.addr && addr < section.addr + section.size) {
+                return string_at(section, addr - section.addr);
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * printf() a record's format with its raw arguments
+ *
+ * @param format  Format string
+ * @param record  Record holding the arguments
+ * @param image   Library image, for %s arguments
+ * @param bias    Run-time minus link-time address of the library
+ */
+inline std::string format_record(const char* format, const DeviceLogRecord& record, const Image& image,
+                                 uint64_t bias) {
+    std::string out;
+    int next_arg = 0;
+    char buf[512];
+    const char* p = format;
+    while (*p != '\0') {
+        if (*p != '%') {
+            out += *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out += '%';
+            p += 2;
+            continue;
+        }
+
+        // Keep flags, width and precision; the length is implied by the
+        // 64-bit argument slots
+        const char* spec_begin = p++;
+        while (*p != '\0' && strchr("-+ #0", *p) != nullptr) p++;
+        while (isdigit(static_cast<unsigned char>(*p)) || *p == '.') p++;
+        std::string spec(spec_begin, p);
+        bool wide = false;
+        while (*p != '\0' && strchr("hlLqjzt", *p) != nullptr) {
+            wide = wide || *p == 'l' || *p == 'L' || *p == 'q' || *p == 'j' || *p == 'z' || *p == 't';
+            p++;
+        }
+        if (*p == '\0') {
+            out += spec;
+            break;
+        }
+        char conv = *p++;
+        uint64_t value = next_arg < record.arg_count ? record.args[next_arg] : 0;
+        next_arg++;
+
+        switch (conv) {
+            case 'd':
+            case 'i': {
+                long long v = wide ? static_cast<long long>(value) : static_cast<int32_t>(value);
+                snprintf(buf, sizeof(buf), (spec + "lld").c_str(), v);
+                break;
+            }
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X': {
+                unsigned long long v = wide ? value : static_cast<uint32_t>(value);
+                snprintf(buf, sizeof(buf), (spec + "ll" + conv).c_str(), v);
+                break;
+            }
+            case 'c':
+                snprintf(buf, sizeof(buf), (spec + "c").c_str(), static_cast<int>(value));
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                double v;
+                memcpy(&v, &value, sizeof(v));
+                snprintf(buf, sizeof(buf), (spec + conv).c_str(), v);
+                break;
+            }
+            case 'p':
+                snprintf(buf, sizeof(buf), "0x%llx", static_cast<unsigned long long>(value));
+                break;
+            case 's': {
+                const char* str = image.string_at_addr(value - bias);
+                if (str != nullptr) {
+                    snprintf(buf, sizeof(buf), (spec + "s").c_str(), str);
+                } else {
+                    snprintf(buf, sizeof(buf), "(string@0x%llx)", static_cast<unsigned long long>(value));
+                }
+                break;
+            }
+            default:
+                snprintf(buf, sizeof(buf), "%s%c", spec.c_str(), conv);
+                break;
+        }
+        out += buf;
+    }
+    return out;
+}
+
+inline const char* level_name(int level) {
+    switch (level) {
+        case DEVICE_LOG_LEVEL_DEBUG:
+            return "DEBUG";
+        case DEVICE_LOG_LEVEL_INFO:
+            return "INFO";
+        case DEVICE_LOG_LEVEL_WARN:
+            return "WARN";
+        default:
+            return "ERROR";
+    }
+}
+
+}  // namespace device_log_decoder
+
+/**
+ * Write the records of a log buffer as text, oldest first
+ *
+ * Records of all threads are merged by timestamp; times are relative to
+ * the oldest record.
+ *
+ * @param image         AICPU library image that wrote the records
+ * @param image_size    Size of the image in bytes
+ * @param buffer        Host copy of the log buffer
+ * @param ticks_per_us  Timestamp ticks per microsecond
+ * @param out           Output file
+ * @return Number of records written, or -1 if the image has no format section
+ */
+inline int decode_device_log(const uint8_t* image, size_t image_size, const void* buffer, double ticks_per_us,
+                             FILE* out) {
+    using namespace device_log_decoder;
+    Image elf;
+    if (!elf.parse(image, image_size)) {
+        std::cerr << "Error: AICPU library has no " << DEVICE_LOG_FORMAT_SECTION << " section\n";
+        return -1;
+    }
+
+    struct Entry {
+        const DeviceLogRecord* record;
+        int thread;
+    };
+    std::vector<Entry> entries;
+    const DeviceLogRing* rings = static_cast<const DeviceLogRing*>(buffer);
+    uint32_t capacity = rings[0].capacity;
+    void* records_base = const_cast<void*>(buffer);
+    for (int t = 0; t < DEVICE_LOG_MAX_THREADS; t++) {
+        uint64_t head = rings[t].head;
+        uint64_t first = head > capacity ? head - capacity : 0;
+        if (first > 0) {
+            fprintf(out, "[P%d T%d] %llu older records overwritten\n", t / DEVICE_LOG_THREADS_PER_PARTITION,
+                t % DEVICE_LOG_THREADS_PER_PARTITION, static_cast<unsigned long long>(first));
+        }
+        const DeviceLogRecord* records = device_log_records(records_base, t, capacity);
+        for (uint64_t n = first; n < head; n++) {
+            entries.push_back({&records[n % capacity], t});
+        }
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) { return a.record->timestamp < b.record->timestamp; });
+
+    uint64_t origin = entries.empty() ? 0 : entries.front().record->timestamp;
+    for (const Entry& entry : entries) {
+        const DeviceLogRecord& record = *entry.record;
+        uint64_t bias = rings[entry.thread].format_base - elf.formats.addr;
+        const char* format = elf.string_at(elf.formats, record.format_id);
+        std::string text = format != nullptr ? format_record(format, record, elf, bias)
+                                             : "(unknown format " + std::to_string(record.format_id) + ")";
+        fprintf(out, "[%12.3f us][P%d T%d][%s] %s\n", (record.timestamp - origin) / ticks_per_us,
+            entry.thread / DEVICE_LOG_THREADS_PER_PARTITION, entry.thread % DEVICE_LOG_THREADS_PER_PARTITION,
+            level_name(record.level), text.c_str());
+    }
+    return static_cast<int>(entries.size());
+}
+
+#endif  // PTO_DEVICE_LOG_DECODER_H
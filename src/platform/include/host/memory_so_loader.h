@@ -0,0 +1,129 @@
+/**
+ * In-Memory Shared Library Loading
+ *
+ * Loads a shared library from a buffer without leaving a file behind. On
+ * Linux the bytes go to an anonymous memfd_create() file that is opened
+ * through /proc/self/fd, so nothing touches the filesystem and concurrent
+ * loads never share a path. Other systems fall back to a uniquely named
+ * temp file that is unlinked right after dlopen().
+ *
+ * The dynamic loader recognizes already-loaded libraries by path, so the
+ * memfd stays open for as long as the library is loaded: a recycled fd
+ * number would otherwise alias a new image to an old one. Unload with
+ * dlclose_from_memory().
+ *
+ * Every call produces a separate copy of the library (its own globals),
+ * even for identical bytes, because each load is a distinct file.
+ *
+ * Header-only so that both the platform runners and the runtime maker can
+ * use it.
+ */
+
+#ifndef PTO_MEMORY_SO_LOADER_H
+#define PTO_MEMORY_SO_LOADER_H
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/**
+ * Write a whole buffer to a file descriptor
+ *
+ * @return true if every byte was written
+ */
+inline bool write_all_to_fd(int fd, const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, p, size);
+        if (written <= 0) {
+            return false;
+        }
+        p += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * dlopen() a shared library held in memory
+ *
+ * @param data   Shared library image
+ * @param size   Size of the image in bytes
+ * @param name   Name used for the memfd and in error messages
+ * @param flags  dlopen() flags (e.g. RTLD_NOW | RTLD_LOCAL)
+ * @param fd_out Receives the fd backing the library (-1 if none); pass it
+ *               to dlclose_from_memory()
+ * @return dlopen() handle, or nullptr on failure (error printed)
+ */
+inline void* dlopen_from_memory(const void* data, size_t size, const char* name, int flags, int* fd_out) {
+    char path[128];
+    int fd = -1;
+    bool unlink_after = false;
+    *fd_out = -1;
+
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    fd = memfd_create(name, MFD_CLOEXEC);
+    if (fd >= 0) {
+        snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    }
+#endif
+    if (fd < 0) {
+        snprintf(path, sizeof(path), "/tmp/%s_XXXXXX", name);
+        fd = mkstemp(path);
+        unlink_after = true;
+    }
+    if (fd < 0) {
+        std::cerr << "Error: Failed to create a file for " << name << '\n';
+        return nullptr;
+    }
+
+    if (!write_all_to_fd(fd, data, size)) {
+        std::cerr << "Error: Failed to write " << name << " (" << size << " bytes)\n";
+        close(fd);
+        if (unlink_after) {
+            unlink(path);
+        }
+        return nullptr;
+    }
+
+    void* handle = dlopen(path, flags);
+    if (handle == nullptr) {
+        std::cerr << "Error: dlopen failed for " << name << ": " << dlerror() << '\n';
+    }
+    if (unlink_after) {
+        // The temp file name is unique, so only the mapping has to stay
+        close(fd);
+        unlink(path);
+    } else if (handle != nullptr) {
+        *fd_out = fd;
+    } else {
+        close(fd);
+    }
+    return handle;
+}
+
+/**
+ * Unload a library loaded by dlopen_from_memory()
+ *
+ * @param handle  dlopen() handle (may be nullptr)
+ * @param fd      fd returned through fd_out (may be -1)
+ */
+inline void dlclose_from_memory(void* handle, int fd) {
+    if (handle != nullptr) {
+        dlclose(handle);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+#endif  // PTO_MEMORY_SO_LOADER_H
@@ -12,6 +12,10 @@
  * - Opaque pointers hide C++ implementation details
  * - Error codes: 0 = success, negative = error
  * - Memory management: User allocates Runtime with malloc(get_runtime_size())
+ * - Devices: every device has its own context (streams, allocator, kernel
+ *   registry). Memory, kernel and init calls act on the calling thread's
+ *   current device, chosen with set_device(); a runtime is launched and
+ *   finalized on the device it was initialized on.
  */
 
 #ifndef PTO_RUNTIME_C_API_H
@@ -29,6 +33,98 @@ extern "C" {
  * These hide the C++ class implementations.
  */
 typedef void* RuntimeHandle;
+typedef void* LaunchHandle;
+typedef void* DeviceHandle;
+
+/**
+ * Device memory pool statistics (see get_device_memory_stats()).
+ */
+typedef struct {
+    uint64_t bytes_in_use;    /* Bytes of live tensors, rounded to their size class */
+    uint64_t peak_bytes;      /* High-water mark of bytes_in_use */
+    uint64_t bytes_reserved;  /* Bytes currently held from the driver */
+    uint64_t alloc_count;     /* Successful allocations */
+    uint64_t cache_hits;      /* Allocations served from the pool's cache */
+} DeviceMemoryStats;
+
+/* Cores covered by RuntimeStats::core_busy_fraction */
+#define PTO_RUNTIME_STATS_MAX_CORES 72
+
+/**
+ * Scheduler counters of a runtime's last launch (see get_runtime_stats()).
+ *
+ * Times are in microseconds. Counts are summed over all AICPU scheduler
+ * threads. A run whose cores are busy close to run_us is kernel-bound; high
+ * dispatch latency or idle cores with ready work point at the scheduler.
+ */
+typedef struct {
+    int thread_count;                 /* AICPU scheduler threads */
+    int core_count;                   /* AICores */
+    double run_us;                    /* Longest scheduler loop wall time */
+    uint64_t loop_iterations;         /* Scheduler loop passes */
+    uint64_t idle_iterations;         /* Passes that neither retired nor dispatched a task */
+    uint64_t tasks_dispatched;        /* Tasks posted to cores (a gang task counts once) */
+    uint64_t tasks_completed;         /* Tasks retired */
+    uint64_t blocks_migrated;         /* Blocks moved to another thread during the run (dynamic partitioning) */
+    double avg_dispatch_latency_us;   /* Mean time from ready to posted to a core */
+    double max_dispatch_latency_us;   /* Longest time from ready to posted */
+    double queue_op_us;               /* Time spent in ready queue push/pop (contention), sampled */
+    int max_ready_depth[3];           /* Deepest ready queue: AIC, AIV, BLOCK */
+    double core_busy_fraction[PTO_RUNTIME_STATS_MAX_CORES]; /* Share of run_us with work outstanding */
+} RuntimeStats;
+
+/* func_ids covered by CostModel::kernels (RUNTIME_MAX_FUNC_ID) */
+#define PTO_COST_MODEL_MAX_FUNCS 64
+
+/* AICPU threads covered by RuntimePrediction::thread_busy_fraction */
+#define PTO_PREDICTION_MAX_THREADS 16
+
+/**
+ * Latency of one kernel: base_us + us_per_byte * (argument bytes_arg).
+ */
+typedef struct {
+    int defined;         /* Nonzero: use this entry, otherwise CostModel::default_us */
+    int bytes_arg;       /* Task argument holding a byte count, -1 = none */
+    double base_us;      /* Latency of every call */
+    double us_per_byte;  /* Added per byte of argument bytes_arg */
+} KernelCostModel;
+
+/**
+ * Timing assumptions for predict_runtime().
+ *
+ * Kernel latencies are indexed by func_id. The scheduler costs model the
+ * AICPU executor: every retire and dispatch occupies its scheduler thread,
+ * and every post and completion crosses the handshake once.
+ */
+typedef struct {
+    KernelCostModel kernels[PTO_COST_MODEL_MAX_FUNCS];
+    double default_us;       /* Latency of kernels without an entry */
+    double dispatch_us;      /* AICPU time to dequeue a task and post it to a core */
+    double complete_us;      /* AICPU time to retire a task and release its successors */
+    double handshake_us;     /* One-way AICPU <-> AICore handshake latency */
+    int ready_queue_policy;  /* ReadyQueuePolicy to predict, -1 = the runtime's */
+    int handshake_depth;     /* Tasks in flight per core to predict, 0 = the runtime's */
+} CostModel;
+
+/**
+ * Predicted execution of a runtime's graph (see predict_runtime()).
+ *
+ * Times are in microseconds of the modelled device. A makespan close to
+ * critical_path_us is latency-bound; one close to total_work_us divided by
+ * the core count is throughput-bound; busy scheduler threads point at
+ * dispatch overhead.
+ */
+typedef struct {
+    int thread_count;            /* AICPU scheduler threads */
+    int core_count;              /* AICores */
+    int task_count;              /* Tasks executed */
+    double makespan_us;          /* Time until the last completion was retired */
+    double critical_path_us;     /* Longest dependency chain of kernel latencies */
+    double total_work_us;        /* Kernel time summed over all cores */
+    double avg_ready_wait_us;    /* Mean time from ready to kernel start */
+    double thread_busy_fraction[PTO_PREDICTION_MAX_THREADS];  /* Share of makespan retiring/dispatching */
+    double core_busy_fraction[PTO_RUNTIME_STATS_MAX_CORES];   /* Share of makespan running kernels */
+} RuntimePrediction;
 
 /* ===========================================================================
  * Runtime API
@@ -47,7 +143,8 @@ size_t get_runtime_size(void);
 /**
  * Initialize a runtime with dynamic orchestration.
  *
- * Uses placement new to construct Runtime in user-allocated memory.
+ * Uses placement new to construct Runtime in user-allocated memory. The
+ * runtime belongs to the calling thread's current device.
  * Loads the orchestration shared library from binary data, resolves the
  * specified function, and calls it to build the task graph.
  * The orchestration function is responsible for device memory management.
@@ -67,19 +164,111 @@ int init_runtime(RuntimeHandle runtime,
                 uint64_t* func_args,
                 int func_args_count);
 
+/**
+ * Initialize an empty runtime for streaming orchestration.
+ *
+ * Like init_runtime(), but no orchestration runs yet: the runtime reserves
+ * room for max_tasks tasks (see Runtime::begin_streaming()) and can be
+ * launched right away with launch_runtime_async(). stream_orchestration()
+ * then builds the graph while the launch executes the tasks published so
+ * far. Available in simulation only.
+ *
+ * @param runtime    User-allocated memory of size get_runtime_size()
+ * @param max_tasks  Task limit
+ * @param max_args   Args pool limit (0 = max_tasks * RUNTIME_MAX_ARGS)
+ * @param max_edges  Edge limit (0 = max_tasks * RUNTIME_STREAM_EDGES_PER_TASK)
+ * @return 0 on success, -1 on failure
+ */
+int init_streaming_runtime(RuntimeHandle runtime, int max_tasks, int max_args, int max_edges);
+
+/**
+ * Run the orchestration of a streaming runtime.
+ *
+ * Calls the orchestration function like init_runtime() does. Each
+ * Runtime::publish_tasks() call in it hands the tasks added so far to the
+ * running launch; when the function returns, the rest are published and
+ * the graph is sealed, which lets the launch finish. The graph is sealed
+ * on failure too, so the launch still completes and can be waited for.
+ *
+ * @param runtime           Runtime initialized with init_streaming_runtime()
+ * @param orch_so_binary    Orchestration shared library binary data
+ * @param orch_so_size      Size of orchestration SO binary in bytes
+ * @param orch_func_name    Name of the orchestration function to call
+ * @param func_args         Arguments for orchestration (host pointers, sizes, etc.)
+ * @param func_args_count   Number of arguments
+ * @return 0 on success, -1 on failure
+ */
+int stream_orchestration(RuntimeHandle runtime,
+                         const uint8_t* orch_so_binary,
+                         size_t orch_so_size,
+                         const char* orch_func_name,
+                         uint64_t* func_args,
+                         int func_args_count);
+
+/**
+ * Save an initialized runtime's graph to a file.
+ *
+ * Writes the task headers, CSR edges, args and kernel table in a versioned
+ * binary format. Args that point into a device allocation of the runtime
+ * become relocations against a tensor slot; slot k is the k-th allocation
+ * its orchestration made (in order of device_malloc / device_malloc_host
+ * calls, the planned buffer arena last). Recorded output tensors are
+ * flagged so that a loaded graph copies them back. Tensor contents are not
+ * saved. Streaming runtimes cannot be saved.
+ *
+ * @param runtime  Initialized runtime handle (not in flight)
+ * @param path     Output file path
+ * @return 0 on success, -1 on failure
+ */
+int save_runtime_graph(RuntimeHandle runtime, const char* path);
+
+/**
+ * Initialize a runtime from a graph file instead of an orchestration.
+ *
+ * Maps the file and runs the graph in place (see Runtime::attach_graph()),
+ * so no orchestration runs and nothing is parsed. Tensor slot k is bound to
+ * host_tensors[k]: the buffer is copied to (or, with host aliasing, used
+ * as) a new device tensor, and output slots are copied back to it by
+ * finalize_runtime(). Slots without a buffer (index >= host_tensor_count or
+ * a 0 entry) get uninitialized device memory, as planned intermediates
+ * need. The graph's structure is read-only; set_task_arg() still works.
+ *
+ * @param runtime            User-allocated memory of size get_runtime_size()
+ * @param path               Graph file written by save_runtime_graph()
+ * @param host_tensors       Host buffers by tensor slot (may be NULL)
+ * @param host_tensor_count  Number of entries in host_tensors
+ * @return 0 on success, -1 on failure
+ */
+int load_runtime_graph(RuntimeHandle runtime, const char* path, const uint64_t* host_tensors, int host_tensor_count);
+
 /* ===========================================================================
  * Device Memory API (for use by orchestration functions)
  * ===========================================================================
  */
 
 /**
- * Allocate device memory.
+ * Allocate device memory on the calling thread's current device.
  *
  * @param size  Size in bytes to allocate
  * @return Device pointer on success, NULL on failure
  */
 void* device_malloc(size_t size);
 
+/**
+ * Allocate the device copy of a host buffer on the calling thread's
+ * current device.
+ *
+ * On a device with host aliasing enabled (see set_host_aliasing()) the
+ * host buffer itself becomes the device tensor: the pointer returned is
+ * host_ptr, and copy_to_device()/copy_from_device() between the two do
+ * nothing. Otherwise same as device_malloc(size).
+ *
+ * @param host_ptr  Host buffer the tensor mirrors
+ * @param size      Size in bytes to allocate
+ * @return Device pointer on success, NULL on failure
+ */
+void* device_malloc_host(void* host_ptr, size_t size);
+
 /**
  * Free device memory.
  *
@@ -107,6 +296,62 @@ int copy_to_device(void* dev_ptr, const void* host_ptr, size_t size);
  */
 int copy_from_device(void* host_ptr, const void* dev_ptr, size_t size);
 
+/**
+ * Allocate page-locked host memory on the calling thread's current device.
+ *
+ * Asynchronous copies from and to pinned memory go straight to the DMA
+ * engine instead of through a staging block. Blocks are cached by size
+ * and reused; on a2a3sim they are ordinary aligned host memory.
+ *
+ * @param size  Size in bytes to allocate
+ * @return Host pointer on success, NULL on failure
+ */
+void* host_malloc_pinned(size_t size);
+
+/**
+ * Free host memory returned by host_malloc_pinned().
+ *
+ * @param host_ptr  Pinned host pointer
+ */
+void host_free_pinned(void* host_ptr);
+
+/**
+ * Queue a copy from host to device and return without waiting for it.
+ *
+ * Copies are queued on the device's transfer stream and complete by the
+ * next sync_transfers(). A pageable source is staged into pinned memory,
+ * so it may be reused right away; a pinned source must stay unchanged
+ * until the sync. On a2a3sim the copy is done before the call returns.
+ *
+ * @param dev_ptr   Device destination pointer
+ * @param host_ptr  Host source pointer
+ * @param size      Size in bytes to copy
+ * @return 0 on success, error code if the copy could not be queued
+ */
+int copy_to_device_async(void* dev_ptr, const void* host_ptr, size_t size);
+
+/**
+ * Queue a copy from device to host and return without waiting for it.
+ *
+ * The host buffer holds the data once sync_transfers() has returned.
+ *
+ * @param host_ptr  Host destination pointer
+ * @param dev_ptr   Device source pointer
+ * @param size      Size in bytes to copy
+ * @return 0 on success, error code if the copy could not be queued
+ */
+int copy_from_device_async(void* host_ptr, const void* dev_ptr, size_t size);
+
+/**
+ * Wait for every copy queued on the calling thread's current device.
+ *
+ * One synchronization covers the whole batch. launch_runtime() and
+ * launch_runtime_async() sync before they start.
+ *
+ * @return 0 on success, the first error of a queued copy otherwise
+ */
+int sync_transfers(void);
+
 /**
  * Execute a runtime on the device.
  *
@@ -114,10 +359,14 @@ int copy_from_device(void* host_ptr, const void* dev_ptr, size_t size);
  * addresses, copies runtime to device, launches kernels, synchronizes,
  * and copies runtime back from device.
  *
+ * May be called repeatedly on the same runtime to replay its graph without
+ * re-running orchestration. Execution state is reset on the device, and the
+ * graph is only re-uploaded if it changed since the previous launch.
+ *
  * @param runtime         Initialized runtime handle
- * @param aicpu_thread_num Number of AICPU scheduler threads
+ * @param aicpu_thread_num Number of AICPU scheduler threads, 0 = one per available AICPU
  * @param block_dim        Number of blocks (1 block = 1 AIC + 2 AIV)
- * @param device_id        Device ID (0-15)
+ * @param device_id        Device ID (0-15), must be the runtime's device
  * @param aicpu_binary     AICPU shared object binary data
  * @param aicpu_size       Size of AICPU binary in bytes
  * @param aicore_binary    AICore kernel binary data
@@ -133,6 +382,179 @@ int launch_runtime(RuntimeHandle runtime,
     const uint8_t* aicore_binary,
     size_t aicore_size);
 
+/**
+ * Start executing a runtime on the device without waiting for completion.
+ *
+ * Same as launch_runtime(), but returns as soon as the kernels are queued.
+ * Each runtime has its own device copy, so the host may build and launch
+ * further runtimes while this one executes; launches complete in
+ * submission order on each device (unless the device is partitioned, see
+ * set_device_partitioning()); launches on different devices run
+ * concurrently. A runtime must not be launched again, modified or
+ * finalized until wait_runtime() has returned for its launch.
+ *
+ * @param runtime         Initialized runtime handle
+ * @param aicpu_thread_num Number of AICPU scheduler threads, 0 = one per available AICPU
+ * @param block_dim        Number of blocks (1 block = 1 AIC + 2 AIV)
+ * @param device_id        Device ID (0-15)
+ * @param aicpu_binary     AICPU shared object binary data
+ * @param aicpu_size       Size of AICPU binary in bytes
+ * @param aicore_binary    AICore kernel binary data
+ * @param aicore_size      Size of AICore binary in bytes
+ * @param launch           Output: launch handle for wait_runtime()
+ * @return 0 on success, error code on failure
+ */
+int launch_runtime_async(RuntimeHandle runtime,
+    int aicpu_thread_num,
+    int block_dim,
+    int device_id,
+    const uint8_t* aicpu_binary,
+    size_t aicpu_size,
+    const uint8_t* aicore_binary,
+    size_t aicore_size,
+    LaunchHandle* launch);
+
+/**
+ * Wait for a launch started by launch_runtime_async() to finish.
+ *
+ * Releases the launch handle; each handle must be waited for exactly once.
+ *
+ * @param launch  Handle returned by launch_runtime_async()
+ * @return 0 on success, error code on failure
+ */
+int wait_runtime(LaunchHandle launch);
+
+/**
+ * Start AICPU and AICore executors that stay resident across launches.
+ *
+ * The executor kernels are launched once. Until stop_persistent_executor(),
+ * launch_runtime() and launch_runtime_async() only upload the runtime and
+ * ring a doorbell in device memory, so no kernels are launched per graph.
+ * Submissions run one at a time in order. Launches must use the same
+ * aicpu_thread_num and block_dim as given here.
+ *
+ * @param aicpu_thread_num Number of AICPU scheduler threads, 0 = one per available AICPU
+ * @param block_dim        Number of blocks (1 block = 1 AIC + 2 AIV)
+ * @param device_id        Device ID (0-15)
+ * @param aicpu_binary     AICPU shared object binary data
+ * @param aicpu_size       Size of AICPU binary in bytes
+ * @param aicore_binary    AICore kernel binary data
+ * @param aicore_size      Size of AICore binary in bytes
+ * @return 0 on success, error code on failure
+ */
+int start_persistent_executor(int aicpu_thread_num,
+    int block_dim,
+    int device_id,
+    const uint8_t* aicpu_binary,
+    size_t aicpu_size,
+    const uint8_t* aicore_binary,
+    size_t aicore_size);
+
+/**
+ * Wait for outstanding submissions and stop the resident executors.
+ *
+ * Later launches launch their own kernels again. Does nothing when no
+ * persistent executor is running on the device.
+ *
+ * @param device_id  Device ID (0-15)
+ * @return 0 on success, error code on failure
+ */
+int stop_persistent_executor(int device_id);
+
+/**
+ * Replace one argument of a task in an initialized runtime.
+ *
+ * Intended for rebinding tensor base pointers between replays of the same
+ * graph. The change is uploaded by the next launch_runtime().
+ *
+ * @param runtime  Initialized runtime handle
+ * @param task_id  Task ID returned by add_task() during orchestration
+ * @param arg_idx  Argument index within the task
+ * @param value    New argument value
+ * @return 0 on success, -1 on failure
+ */
+int set_task_arg(RuntimeHandle runtime, int task_id, int arg_idx, uint64_t value);
+
+/**
+ * Fuse linear chains of tasks in an initialized runtime.
+ *
+ * A task that is the only successor of its only predecessor, on the same
+ * core type and with the same affinity, runs on that predecessor's core
+ * right after it instead of being dispatched on its own. Chains of any
+ * length collapse into one scheduled task. Task IDs are unchanged.
+ * Intended to be called once after init_runtime(), before the first launch.
+ *
+ * @param runtime  Initialized runtime handle (not in flight)
+ * @return Number of tasks absorbed into chains (>= 0), -1 on failure
+ */
+int fuse_task_chains(RuntimeHandle runtime);
+
+/**
+ * Enable or disable per-task timestamps for later launches of a runtime.
+ *
+ * While enabled, the AICore executor records when each kernel starts and
+ * ends and on which core, and the AICPU scheduler records when it
+ * dispatched each task and observed its completion. Off by default.
+ *
+ * @param runtime  Initialized runtime handle (not in flight)
+ * @param enable   Nonzero to record timestamps
+ * @return 0 on success, -1 on failure
+ */
+int set_profiling(RuntimeHandle runtime, int enable);
+
+/**
+ * Write the timestamps of a runtime's last launch as a Chrome trace.
+ *
+ * Copies the timestamps back from the device and writes a Chrome trace
+ * event JSON file (open with chrome://tracing or ui.perfetto.dev) with one
+ * track per core, the scheduler's dispatch/complete instants and flow
+ * arrows along the dependencies. The runtime must have been launched with
+ * profiling enabled, must not be in flight and must not be finalized yet.
+ *
+ * @param runtime  Launched runtime handle
+ * @param path     Output file path
+ * @return 0 on success, error code on failure
+ */
+int export_trace(RuntimeHandle runtime, const char* path);
+
+/**
+ * Get the scheduler counters of a runtime's last launch.
+ *
+ * The counters are always collected by the AICPU scheduler and copied back
+ * from the device by this call. The runtime must have been launched, must
+ * not be in flight and must not be finalized yet. With AICore pull
+ * scheduling only run_us is recorded.
+ *
+ * @param runtime  Launched runtime handle
+ * @param stats    Output statistics
+ * @return 0 on success, error code on failure
+ */
+int get_runtime_stats(RuntimeHandle runtime, RuntimeStats* stats);
+
+/**
+ * Predict the execution of a runtime's graph without running it.
+ *
+ * Replays the graph in a discrete-event model of the device: every AICore
+ * has a virtual clock that advances by the modelled kernel latencies, and
+ * the AICPU scheduler threads own their blocks' cores, retire, release and
+ * dispatch tasks with the runtime's ready queue policy, handshake depth and
+ * scheduling mode, paying the modelled overheads. Gang tasks wait for a
+ * fully idle block. Affinity dispatch and gang block reservation are not
+ * modelled. With AICore pull scheduling each core claims its own tasks,
+ * paying handshake_us per claim and complete_us per release.
+ *
+ * Needs no device. The runtime must be initialized and not in flight.
+ *
+ * @param runtime          Initialized runtime handle
+ * @param aicpu_thread_num Number of AICPU scheduler threads to model
+ * @param block_dim        Number of blocks to model (1 block = 1 AIC + 2 AIV)
+ * @param model            Timing assumptions
+ * @param prediction       Output prediction
+ * @return 0 on success, -1 on invalid parameters or a graph that cannot finish
+ */
+int predict_runtime(RuntimeHandle runtime, int aicpu_thread_num, int block_dim, const CostModel* model,
+    RuntimePrediction* prediction);
+
 /**
  * Finalize and cleanup a runtime instance.
  *
@@ -148,11 +570,14 @@ int finalize_runtime(RuntimeHandle runtime);
  * Set device and create streams for memory operations.
  *
  * Must be called before init_runtime() to enable device tensor allocation.
- * Only performs minimal initialization:
+ * Makes device_id the calling thread's current device and, on first use,
+ * performs minimal initialization of its context:
  * - rtSetDevice(device_id)
  * - Create AICPU and AICore streams
  *
- * Binary loading happens later in launch_runtime().
+ * Binary loading happens later in launch_runtime(). To drive several
+ * devices concurrently, use one host thread per device and call
+ * set_device() on each.
  *
  * @param device_id  Device ID (0-15)
  * @return 0 on success, error code on failure
@@ -160,9 +585,65 @@ int finalize_runtime(RuntimeHandle runtime);
 int set_device(int device_id);
 
 /**
- * Register a kernel binary for a func_id.
+ * Get the context of a device and make it current, like set_device().
+ *
+ * @param device_id  Device ID (0-15)
+ * @return Device handle on success, NULL on failure
+ */
+DeviceHandle open_device(int device_id);
+
+/**
+ * Release all resources of a device context.
+ *
+ * Waits for outstanding launches, frees the device's memory and kernels
+ * and destroys its streams. The context is re-created by the next
+ * set_device() or open_device() for that device.
+ *
+ * @param device  Handle returned by open_device()
+ * @return 0 on success, error code on failure
+ */
+int close_device(DeviceHandle device);
+
+/**
+ * Let a device use host buffers as tensors instead of copying them.
+ *
+ * Simulation only (a2a3sim, where device memory is host memory). Tensors
+ * that orchestration allocates with device_malloc_host() afterwards alias
+ * their host buffers: inputs are read and outputs written in place, so
+ * there is nothing to copy in or back. The host buffers must stay valid
+ * and unmodified by the caller until the runtime is finalized.
+ *
+ * @param device_id  Device ID (0-15)
+ * @param enable     1 to alias host buffers, 0 to copy them
+ * @return 0 on success, error code on failure or if the platform cannot
+ *         alias host memory
+ */
+int set_host_aliasing(int device_id, int enable);
+
+/**
+ * Run later launches of a device concurrently on disjoint block ranges.
+ *
+ * Simulation only (a2a3sim). The device is treated as device_blocks
+ * blocks; each launch is placed into a free range of block_dim of them
+ * with its own AICPU scheduler state and handshakes, so several small
+ * graphs execute at once instead of one after another. A launch that does
+ * not fit waits until running launches release enough blocks. Launches are
+ * admitted in submission order but may complete in any order. At most
+ * RUNTIME_MAX_PARTITIONS launches run at the same time. No launch may be
+ * in flight and no persistent executor may be running on the device.
+ *
+ * @param device_id      Device ID (0-15)
+ * @param device_blocks  Blocks of the device, 0 = run launches in order again
+ * @return 0 on success, error code on failure or if the platform cannot
+ *         partition the device
+ */
+int set_device_partitioning(int device_id, int device_blocks);
+
+/**
+ * Register a kernel binary for a func_id on the current device.
  *
- * IMPORTANT: set_device() MUST be called before this function.
+ * IMPORTANT: set_device() MUST be called before this function. Each
+ * device keeps its own kernel registry.
  * Kernels are immediately copied to device memory.
  *
  * Receives pre-extracted .text section binary data from Python,
@@ -176,6 +657,59 @@ int set_device(int device_id);
  */
 int register_kernel(int func_id, const uint8_t* bin_data, size_t bin_size);
 
+/**
+ * Register a batch of kernel binaries on the current device.
+ *
+ * Same as calling register_kernel() for every entry, but the binaries are
+ * packed into one image and uploaded with a single allocation and copy.
+ * func_ids that are already registered are skipped.
+ *
+ * @param count      Number of kernels
+ * @param func_ids   Function identifier of each kernel
+ * @param bin_data   Kernel .text section binary data of each kernel
+ * @param bin_sizes  Size of each binary in bytes
+ * @return 0 on success, error code on failure
+ */
+int register_kernels(int count, const int* func_ids, const uint8_t* const* bin_data, const size_t* bin_sizes);
+
+/**
+ * Get the memory pool statistics of a device.
+ *
+ * Device memory is served from a caching pool; tensors allocated by a
+ * runtime's orchestration are freed together when it is finalized.
+ *
+ * @param device_id  Device ID (0-15)
+ * @param stats      Output statistics
+ * @return 0 on success, error code on failure
+ */
+int get_device_memory_stats(int device_id, DeviceMemoryStats* stats);
+
+/**
+ * Record AICPU log messages of a device in binary rings.
+ *
+ * Later launches on the device append their log messages as raw records
+ * (format id plus arguments) to a ring per AICPU scheduler thread instead
+ * of formatting them on the device; dump_device_log() formats them. When a
+ * ring is full its oldest records are overwritten. Messages below the
+ * compile-time level (PTO_DEVICE_LOG_LEVEL) are not in the AICPU library
+ * at all. No launch may be in flight.
+ *
+ * @param device_id           Device ID (0-15)
+ * @param records_per_thread  Ring size, 0 = log as text again
+ * @return 0 on success, error code on failure
+ */
+int enable_device_log(int device_id, uint32_t records_per_thread);
+
+/**
+ * Format the AICPU log messages recorded since the last dump and empty the
+ * rings. Wait for the device's launches first.
+ *
+ * @param device_id  Device ID (0-15)
+ * @param path       Output file, NULL = stdout
+ * @return Number of messages written, or -1 on failure
+ */
+int dump_device_log(int device_id, const char* path);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
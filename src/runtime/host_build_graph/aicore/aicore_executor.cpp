@@ -17,7 +17,7 @@ typedef void (*UnifiedKernelFunc)(__gm__ int64_t*);
  * - function_bin_addr points to compiled kernel code in device GM memory
  * - The address is cast to a function pointer: UnifiedKernelFunc kernel =
  * (UnifiedKernelFunc)function_bin_addr
- * - The kernel is invoked: kernel(task->args)
+ * - The kernel is invoked with the task's slice of the runtime args pool
  *
  * This is the KEY difference from compile-time linking:
  * - OLD: extern "C" declarations, resolved at link time
@@ -26,9 +26,10 @@ typedef void (*UnifiedKernelFunc)(__gm__ int64_t*);
  * With unified kernel signature, no switch statement is needed.
  * All kernels unpack their own arguments from the args array.
  *
+ * @param runtime Pointer to runtime in global memory (owns the args pool)
  * @param task Pointer to task in global memory (null during initialization)
  */
-__aicore__ __attribute__((always_inline)) static void execute_task(__gm__ Task* task) {
+__aicore__ __attribute__((always_inline)) static void execute_task(__gm__ Runtime* runtime, __gm__ Task* task) {
     // Null task pointer indicates no work assigned (initialization state)
     if (task == nullptr) {
         return;
@@ -43,22 +44,169 @@ __aicore__ __attribute__((always_inline)) static void execute_task(__gm__ Task*
     // Cast function_bin_addr to unified function pointer and invoke
     // All kernels have signature: void kernel(__gm__ int64_t* args)
     UnifiedKernelFunc kernel = (UnifiedKernelFunc)task->function_bin_addr;
-    kernel(reinterpret_cast<__gm__ int64_t*>(task->args));
+    __gm__ int64_t* args_pool = reinterpret_cast<__gm__ int64_t*>(reinterpret_cast<uint64_t>(runtime->task_args));
+    kernel(args_pool + task->args_offset);
+}
+
+/**
+ * Execute a task, stamping its DFX fields when profiling is enabled
+ *
+ * The head of a fused chain runs every member kernel in order, each stamped
+ * on its own. Only the AIC of a gang task stamps it, so its three cores do
+ * not race on the same fields. The stamps reach global memory with the data
+ * cache write-back that follows every completion.
+ *
+ * @param runtime   Pointer to runtime in global memory
+ * @param task      Task to run (may be null)
+ * @param block_idx Index of the executing core
+ * @param core_type Type of the executing core (0=AIC, 1=AIV)
+ * @param profile   Whether Runtime::profiling_enabled is set
+ */
+__aicore__ static void run_task(
+    __gm__ Runtime* runtime, __gm__ Task* task, int block_idx, int core_type, bool profile) {
+    __gm__ Task* tasks = reinterpret_cast<__gm__ Task*>(reinterpret_cast<uint64_t>(runtime->tasks));
+    while (task != nullptr) {
+        if (!profile || (task->core_type == static_cast<int>(CoreType::BLOCK) && core_type != 0)) {
+            execute_task(runtime, task);
+        } else {
+            task->exec_core = block_idx;
+            task->start_time = get_sys_cnt();
+            execute_task(runtime, task);
+            task->end_time = get_sys_cnt();
+        }
+        task = task->fused_next >= 0 ? &tasks[task->fused_next] : nullptr;
+    }
+}
+
+/**
+ * Claim the oldest ready task of a core type from the device-global pull queue
+ *
+ * The scalar cache is not kept coherent with global memory (the a2a3 build
+ * disables automatic dcci insertion), so the ring slots are invalidated
+ * while waiting for a producer and written back after every store.
+ *
+ * @param runtime   Pointer to runtime in global memory
+ * @param core_type Queue to claim from (0=AIC, 1=AIV)
+ * @return Task ID, or -1 if the queue is currently empty
+ */
+__aicore__ static int pull_claim(__gm__ Runtime* runtime, int core_type) {
+    __gm__ PullQueue* queue = &runtime->pull_queues[core_type];
+    __gm__ volatile int* ring = reinterpret_cast<__gm__ volatile int*>(reinterpret_cast<uint64_t>(runtime->pull_ring));
+
+    dcci(queue, SINGLE_CACHE_LINE, CACHELINE_OUT);
+    int head = queue->head.load(std::memory_order_acquire);
+    while (head < queue->tail.load(std::memory_order_acquire)) {
+        if (queue->head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel)) {
+            // The producer reserved this slot before writing it
+            __gm__ volatile int* entry = &ring[queue->base + head];
+            int task_id;
+            while ((task_id = *entry) < 0) {
+                dcci((__gm__ int*)entry, SINGLE_CACHE_LINE, CACHELINE_OUT);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return task_id;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Resolve the successors of a finished task and publish the newly ready ones
+ *
+ * @param runtime Pointer to runtime in global memory
+ * @param task    Task that just finished executing
+ */
+__aicore__ static void pull_release(__gm__ Runtime* runtime, __gm__ Task* task) {
+    __gm__ Task* tasks = reinterpret_cast<__gm__ Task*>(reinterpret_cast<uint64_t>(runtime->tasks));
+    __gm__ int* fanout = reinterpret_cast<__gm__ int*>(reinterpret_cast<uint64_t>(runtime->fanout_edges));
+    __gm__ volatile int* ring = reinterpret_cast<__gm__ volatile int*>(reinterpret_cast<uint64_t>(runtime->pull_ring));
+
+    for (int j = 0; j < task->fanout_count; j++) {
+        __gm__ Task* dep = &tasks[fanout[task->fanout_offset + j]];
+        if (dep->fanin.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            __gm__ PullQueue* queue = &runtime->pull_queues[dep->core_type];
+            int slot = queue->tail.fetch_add(1, std::memory_order_acq_rel);
+            __gm__ volatile int* entry = &ring[queue->base + slot];
+            *entry = dep->task_id;
+            dcci((__gm__ int*)entry, SINGLE_CACHE_LINE, CACHELINE_OUT);
+        }
+    }
+}
+
+/**
+ * Claim and run one ready task (SCHEDULE_AICORE_PULL)
+ *
+ * The core claims ready tasks of its own type, runs them and releases their
+ * successors without an AICPU round trip. complete_seq still counts finished
+ * tasks so the AICPU can report progress per core.
+ *
+ * @param completed Tasks this core finished so far, advanced in place
+ * @return Whether a task ran
+ */
+__aicore__ static bool pull_step(__gm__ Runtime* runtime, __gm__ Handshake* my_hank, int block_idx, int core_type,
+    bool profile, uint32_t& completed) {
+    int task_id = pull_claim(runtime, core_type);
+    if (task_id < 0) {
+        return false;
+    }
+    __gm__ Task* task = reinterpret_cast<__gm__ Task*>(reinterpret_cast<uint64_t>(runtime->tasks)) + task_id;
+    run_task(runtime, task, block_idx, core_type, profile);
+    pull_release(runtime, task);
+
+    completed++;
+    my_hank->complete_seq = completed;
+    dcci(my_hank, ENTIRE_DATA_CACHE, CACHELINE_OUT);
+    runtime->pull_completed.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Run every task posted to the core's handshake (SCHEDULE_AICPU)
+ *
+ * Drains the whole ring; the AICPU may queue the next task while the
+ * current one runs.
+ *
+ * @param completed Tasks this core finished so far, advanced in place
+ * @return Whether any task ran
+ */
+__aicore__ static bool drain_posted(__gm__ Runtime* runtime, __gm__ Handshake* my_hank, int block_idx, int core_type,
+    bool profile, uint32_t& completed) {
+    bool ran = false;
+    while (my_hank->dispatch_seq != completed) {
+        uint64_t task = my_hank->slot_task[completed % RUNTIME_HANDSHAKE_SLOTS];
+        run_task(runtime, reinterpret_cast<__gm__ Task*>(task), block_idx, core_type, profile);
+        completed++;
+        my_hank->complete_seq = completed;
+        int32_t board_slot = my_hank->completion_slot;
+        if (board_slot >= 0) {
+            runtime->completion_board[board_slot] = completed;
+        }
+        dcci(my_hank, ENTIRE_DATA_CACHE, CACHELINE_OUT);
+        ran = true;
+    }
+    return ran;
 }
 
 __aicore__ __attribute__((weak)) void aicore_execute(__gm__ Runtime* runtime, int block_idx, int core_type) {
-    (void)core_type;
     __gm__ Handshake* my_hank = (__gm__ Handshake*)(&runtime->workers[block_idx]);
 
     // Phase 1: Wait for AICPU initialization signal
     while (my_hank->aicpu_ready == 0) {
         dcci(my_hank, ENTIRE_DATA_CACHE, CACHELINE_OUT);
+        core_idle();
     }
 
     // Phase 2: Signal AICore is ready (use core_id + 1 to avoid 0)
     my_hank->aicore_done = block_idx + 1;
 
+    bool pull = runtime->scheduling_mode == SCHEDULE_AICORE_PULL;
+    if (pull) {
+        core_type = my_hank->core_type;
+    }
+    bool profile = runtime->profiling_enabled != 0;
+
     // Phase 3: Main execution loop - poll for tasks until quit signal
+    uint32_t completed = 0;
     while (true) {
         dcci(my_hank, ENTIRE_DATA_CACHE, CACHELINE_OUT);
 
@@ -67,12 +215,77 @@ __aicore__ __attribute__((weak)) void aicore_execute(__gm__ Runtime* runtime, in
             break;  // Exit kernel
         }
 
-        // Execute task if assigned (task != 0 means valid Task* pointer)
-        if (my_hank->task_status == 1 && my_hank->task != 0) {
-            __gm__ Task* task_ptr = reinterpret_cast<__gm__ Task*>(my_hank->task);
-            execute_task(task_ptr);
-            // Mark task as complete (task_status: 0=idle, 1=busy)
-            my_hank->task_status = 0;
+        bool ran = pull ? pull_step(runtime, my_hank, block_idx, core_type, profile, completed)
+                        : drain_posted(runtime, my_hank, block_idx, core_type, profile, completed);
+        if (!ran) {
+            core_idle();
+        }
+    }
+}
+
+/**
+ * Advance a core by one non-blocking step of aicore_execute()
+ *
+ * For simulators that run many cores on fewer threads: instead of a thread
+ * looping in aicore_execute() per core, a scheduler calls this for each of
+ * its cores in turn until it returns AICORE_POLL_EXIT. A step completes the
+ * start handshake, or runs every task posted so far. All progress is kept
+ * in the handshake, so consecutive steps of a core may come from different
+ * threads, but never two at once.
+ *
+ * @param runtime   Pointer to runtime in global memory
+ * @param block_idx Core index (handshake slot)
+ * @param core_type 0=AIC, 1=AIV
+ * @return AicorePollResult
+ */
+__aicore__ __attribute__((weak)) int aicore_poll(__gm__ Runtime* runtime, int block_idx, int core_type) {
+    __gm__ Handshake* my_hank = (__gm__ Handshake*)(&runtime->workers[block_idx]);
+    dcci(my_hank, ENTIRE_DATA_CACHE, CACHELINE_OUT);
+
+    if (my_hank->aicore_done == 0) {
+        if (my_hank->aicpu_ready == 0) {
+            return AICORE_POLL_IDLE;
+        }
+        my_hank->aicore_done = block_idx + 1;
+        return AICORE_POLL_PROGRESS;
+    }
+    if (my_hank->control == 1) {
+        return AICORE_POLL_EXIT;
+    }
+
+    bool profile = runtime->profiling_enabled != 0;
+    uint32_t completed = my_hank->complete_seq;
+    bool ran = runtime->scheduling_mode == SCHEDULE_AICORE_PULL
+                   ? pull_step(runtime, my_hank, block_idx, my_hank->core_type, profile, completed)
+                   : drain_posted(runtime, my_hank, block_idx, core_type, profile, completed);
+    return ran ? AICORE_POLL_PROGRESS : AICORE_POLL_IDLE;
+}
+
+/**
+ * Persistent AICore loop
+ *
+ * Runs every graph submitted through the doorbell with aicore_execute()
+ * and acknowledges it in core_seq[block_idx], until shutdown is requested.
+ *
+ * @param doorbell  Doorbell in global memory
+ * @param block_idx Core index (handshake slot)
+ * @param core_type 0=AIC, 1=AIV
+ */
+__aicore__ __attribute__((weak)) void aicore_execute_persistent(
+    __gm__ ExecutorDoorbell* doorbell, int block_idx, int core_type) {
+    uint32_t seen = 0;
+    while (true) {
+        dcci(doorbell, ENTIRE_DATA_CACHE, CACHELINE_OUT);
+        if (doorbell->submit_seq != seen) {
+            seen++;
+            __gm__ Runtime* runtime = reinterpret_cast<__gm__ Runtime*>(doorbell->runtime);
+            aicore_execute(runtime, block_idx, core_type);
+            doorbell->core_seq[block_idx] = seen;
+            continue;
+        }
+        if (doorbell->shutdown == 1) {
+            break;
         }
+        core_idle();
     }
 }
@@ -1,14 +1,26 @@
 #include <atomic>
 #include <cstdint>
-#include <mutex>
 
+#include "device_idle.h"
 #include "device_log.h"
+#include "device_time.h"
+#include "ready_queue.h"
 #include "runtime.h"
 
-constexpr int MAX_AICPU_THREADS = 4;
+constexpr int MAX_AICPU_THREADS = RUNTIME_MAX_SCHED_THREADS;
 constexpr int MAX_AIC_PER_THREAD = 24;
 constexpr int MAX_AIV_PER_THREAD = 48;
 constexpr int MAX_CORES_PER_THREAD = MAX_AIC_PER_THREAD + MAX_AIV_PER_THREAD;
+constexpr int MAX_BLOCKS = MAX_AIC_PER_THREAD;
+constexpr int BLOCK_TASK = static_cast<int>(CoreType::BLOCK);
+constexpr int BLOCK_UNCLAIMED = -1;  // block_owner_: not handshaked yet (CORE_PARTITION_DYNAMIC)
+constexpr int BLOCK_RELEASED = -2;   // block_owner_: handed off by a busy thread, free to take
+constexpr int STREAM_OPEN = INT32_MAX;       // Task count of a streaming run until the host seals it
+constexpr int STREAM_ADMIT_BATCH = 64;       // Published tasks a thread claims for admission at once
+static_assert((RUNTIME_QUEUE_TIMING_SAMPLE & (RUNTIME_QUEUE_TIMING_SAMPLE - 1)) == 0,
+    "RUNTIME_QUEUE_TIMING_SAMPLE must be a power of two");
+static_assert(DEVICE_LOG_MAX_PARTITIONS == RUNTIME_MAX_PARTITIONS, "Every partition needs its group of log rings");
+static_assert(DEVICE_LOG_THREADS_PER_PARTITION >= RUNTIME_MAX_SCHED_THREADS, "Every scheduler thread needs a log ring");
 
 struct AicpuExecutor {
     // ===== Thread management state =====
@@ -16,40 +28,110 @@ struct AicpuExecutor {
     std::atomic<bool> initialized_{false};
     std::atomic<bool> init_done_{false};
     std::atomic<bool> init_failed_{false};
-    std::atomic<bool> finished_{false};
 
-    int thread_num_{0};
+    int thread_num_{0};      // Threads that manage blocks (at most block_dim)
+    int launched_num_{0};    // Threads that call aicpu_execute (Runtime::sche_cpu_num)
     int cores_total_num_{0};
     int blockdim_cores_num_{3};
-    int thread_cores_num_{0};
-    int core_assignments_[MAX_AICPU_THREADS][MAX_CORES_PER_THREAD];
 
-    // ===== Task queue state =====
-    std::mutex ready_queue_aic_mutex_;
-    int ready_queue_aic_[RUNTIME_MAX_TASKS];
-    std::atomic<int> ready_count_aic_{0};
+    // ===== Core partitioning (Runtime::core_partitioning) =====
+    // A thread's lists are only touched by the thread itself. Blocks change
+    // hands through block_owner_: the release store of the old owner
+    // publishes the block's handshake ring state to the acquiring thread.
+    bool dynamic_partition_{false};
+    int thread_blocks_[MAX_AICPU_THREADS][MAX_BLOCKS];
+    int thread_block_num_[MAX_AICPU_THREADS];
+    int core_assignments_[MAX_AICPU_THREADS][MAX_CORES_PER_THREAD];  // AICs, then AIVs of thread_blocks_
+    int thread_cores_num_[MAX_AICPU_THREADS];
+    std::atomic<int> block_owner_[MAX_BLOCKS];  // Thread, BLOCK_UNCLAIMED or BLOCK_RELEASED
+    std::atomic<int> claim_cursor_{0};          // Next block nobody has handshaked yet
+    std::atomic<int> released_blocks_{0};       // Blocks in state BLOCK_RELEASED
+    std::atomic<int> hungry_threads_{0};        // Threads whose cores have drained
+    bool hungry_[MAX_AICPU_THREADS];
+
+    // ===== Handshake ring state (each core is owned by one thread) =====
+    int handshake_depth_{1};
+    uint32_t dispatched_[RUNTIME_MAX_WORKER];  // Tasks posted to each core
+    uint32_t retired_[RUNTIME_MAX_WORKER];     // Completed tasks already processed
+    int core_type_[RUNTIME_MAX_WORKER];        // Cached Handshake::core_type
+    bool use_completion_board_{false};
+    bool profiling_{false};  // Stamp Task::dispatch_time / complete_time
+
+    // ===== Locality-aware dispatch =====
+    bool affinity_dispatch_{false};
+    int block_dim_{0};
+    int core_block_[RUNTIME_MAX_WORKER];  // Block that owns each core
+
+    // ===== Gang (CoreType::BLOCK) tasks =====
+    ReadyQueue ready_queue_block_;                  // Shared by all policies
+    int gang_pending_[RUNTIME_MAX_WORKER];          // Per block: cores yet to finish its gang task
+    int reserved_block_[MAX_AICPU_THREADS];         // Per thread: block held back for a gang (-1 = none)
 
-    std::mutex ready_queue_aiv_mutex_;
-    int ready_queue_aiv_[RUNTIME_MAX_TASKS];
-    std::atomic<int> ready_count_aiv_{0};
+    // ===== Task queue state =====
+    // Lock-free, sized from the task count in init()
+    int ready_queue_policy_{READY_QUEUE_LIFO};
+    ReadyQueue ready_queue_aic_;
+    ReadyQueue ready_queue_aiv_;
+
+    // READY_QUEUE_STEALING: one deque per scheduler thread and core type
+    WorkStealingDeque local_queue_aic_[MAX_AICPU_THREADS];
+    WorkStealingDeque local_queue_aiv_[MAX_AICPU_THREADS];
+
+    // READY_QUEUE_PRIORITY: bucketed by Task::priority
+    PriorityReadyQueue priority_queue_aic_;
+    PriorityReadyQueue priority_queue_aiv_;
+    int max_priority_{0};
+
+    // ===== Scheduler statistics (Runtime::sched_stats / core_busy_ticks) =====
+    SchedulerStats* stats_[MAX_AICPU_THREADS];  // Each thread's block in the runtime
+    uint64_t* core_busy_ticks_{nullptr};
+    uint64_t busy_since_[RUNTIME_MAX_WORKER];   // When each core last went from idle to busy
+    std::atomic<int> ready_depth_[3];           // Ready tasks by core type (AIC, AIV, BLOCK)
+
+    // ===== Streaming orchestration (Runtime::streaming) =====
+    bool streaming_{false};
+    std::atomic<int> stream_admitted_{0};  // Published tasks claimed for admission so far
 
     // Task execution tracking
     std::atomic<int> completed_tasks_{0};
     std::atomic<int> total_tasks_{0};
-    std::atomic<int> finished_count_{0};
+    std::atomic<int> finished_count_{0};  // Threads that left aicpu_execute(), also after a failure
 
     // ===== Methods =====
     int init(Runtime* runtime);
-    int hank_aicore(Runtime* runtime, int thread_idx, const int* cur_thread_cores);
-    int resolve_and_dispatch(Runtime& runtime, int thread_idx, const int* cur_thread_cores, int core_num);
-    int shutdown_aicore(Runtime* runtime, int thread_idx, const int* cur_thread_cores);
+    int hank_aicore(Runtime* runtime, int thread_idx, const int* cores, int core_num);
+    int resolve_and_dispatch(Runtime& runtime, int thread_idx);
+    int init_pull_queues(Runtime* runtime);
+    int wait_pull_completion(Runtime& runtime, int thread_idx, const int* cur_thread_cores, int core_num);
+    int shutdown_aicore(Runtime* runtime, int thread_idx, const int* cores, int core_num);
+    void release_aicore(Runtime* runtime);
+    void assign_cores(int thread_idx);
+    int claim_block(Runtime* runtime, int thread_idx);
+    void release_block(int thread_idx);
+    void set_hungry(int thread_idx, bool hungry);
+    int tasks_in_flight(int thread_idx) const;
     int run(Runtime* runtime);
     void deinit();
+    int priority_bucket(const Task* task) const;
+    void enqueue_ready(int thread_idx, Task* task);
+    void release_successors(Runtime& runtime, int thread_idx, int core_id, Task* task);
+    int admit_published(Runtime& runtime, int thread_idx);
+    void admit_task(Runtime& runtime, int thread_idx, Task* task);
+    bool dequeue_ready(int thread_idx, int core_type, int* task_id);
+    bool sample_queue_op(SchedulerStats* stats);
+    int ready_count(int core_type);
+    int pick_core(int thread_idx, const Task* task, int default_core, int max_in_flight) const;
+    void post_task(Handshake* hank, int core_id, Task* task);
+    void note_dispatch(int thread_idx, const Task* task);
+    bool block_idle(int block) const;
+    int dispatch_block_tasks(Runtime& runtime, int thread_idx, Handshake* hank);
     void diagnose_stuck_state(Runtime& runtime, int thread_idx, const int* cur_thread_cores,
                               int core_num, Handshake* hank);
 };
 
-static AicpuExecutor g_aicpu_executor;
+// One executor per partition, so runtimes launched on disjoint block ranges
+// of a device are scheduled concurrently (see Runtime::partition)
+static AicpuExecutor g_aicpu_executors[RUNTIME_MAX_PARTITIONS];
 
 // ===== AicpuExecutor Method Implementations =====
 
@@ -68,61 +150,60 @@ int AicpuExecutor::init(Runtime* runtime) {
     }
 
     // Read execution parameters from runtime
-    thread_num_ = runtime->sche_cpu_num;
-    if (thread_num_ == 0) thread_num_ = 1;
+    launched_num_ = runtime->sche_cpu_num;
+    if (launched_num_ == 0) launched_num_ = 1;
 
-    if (thread_num_ < 1 || thread_num_ > MAX_AICPU_THREADS) {
-        DEV_ERROR("Invalid thread_num: %d", thread_num_);
+    if (launched_num_ < 1 || launched_num_ > MAX_AICPU_THREADS) {
+        DEV_ERROR("Invalid thread_num: %d (max %d)", launched_num_, MAX_AICPU_THREADS);
         init_failed_.store(true, std::memory_order_release);
         return -1;
     }
 
     cores_total_num_ = runtime->block_dim * blockdim_cores_num_;
-    thread_cores_num_ = cores_total_num_ / thread_num_;
 
-    if (cores_total_num_ > MAX_CORES_PER_THREAD) {
+    if (runtime->block_dim < 1 || cores_total_num_ > MAX_CORES_PER_THREAD) {
         DEV_ERROR("Total cores %d exceeds maximum %d", cores_total_num_, MAX_CORES_PER_THREAD);
         init_failed_.store(true, std::memory_order_release);
         return -1;
     }
 
-    DEV_INFO("Config: threads=%d, cores=%d, cores_per_thread=%d", thread_num_, cores_total_num_, thread_cores_num_);
+    // Every managing thread needs at least one block; the others only
+    // check in and leave
+    thread_num_ = launched_num_ < runtime->block_dim ? launched_num_ : runtime->block_dim;
+    dynamic_partition_ = runtime->core_partitioning == CORE_PARTITION_DYNAMIC &&
+                         runtime->scheduling_mode != SCHEDULE_AICORE_PULL;
 
-    // Pre-compute core assignments for each thread
-    // Each thread manages blocks_per_thread blocks
-    // For each block b: AIC is core b, AIVs are cores (nrAic + b*2) and (nrAic
-    // + b*2 + 1)
-    int num_aic = runtime->block_dim;  // Total AIC cores (= block_dim)
-    int blocks_per_thread = runtime->block_dim / thread_num_;
+    DEV_INFO("Config: threads=%d (of %d launched), cores=%d, partitioning=%s", thread_num_, launched_num_,
+        cores_total_num_, dynamic_partition_ ? "dynamic" : "static");
+    DEV_INFO("Config: partition %d, device blocks [%d-%d]", runtime->partition, runtime->block_offset,
+        runtime->block_offset + runtime->block_dim - 1);
 
-    // Validate block distribution
-    if (runtime->block_dim % thread_num_ != 0) {
-        DEV_ERROR("block_dim (%d) must be divisible by thread_num (%d)", runtime->block_dim, thread_num_);
-        init_failed_.store(true, std::memory_order_release);
-        return -1;
+    // For each block b: AIC is core b, AIVs are cores (nrAic + b*2) and
+    // (nrAic + b*2 + 1)
+    int num_aic = runtime->block_dim;  // Total AIC cores (= block_dim)
+    block_dim_ = runtime->block_dim;
+    for (int b = 0; b < num_aic; b++) {
+        core_block_[b] = b;
+        core_block_[num_aic + b * 2] = b;
+        core_block_[num_aic + b * 2 + 1] = b;
     }
 
-    DEV_INFO("Block assignment: %d blocks, %d threads, %d blocks per thread",
-        runtime->block_dim,
-        thread_num_,
-        blocks_per_thread);
-
-    for (int t = 0; t < thread_num_; t++) {
-        int start_block = t * blocks_per_thread;
-        int end_block = (t + 1) * blocks_per_thread;
-        int core_idx = 0;
-
-        // Assign AIC cores for all blocks managed by this thread
-        for (int b = start_block; b < end_block; b++) {
-            core_assignments_[t][core_idx++] = b;  // AIC core ID = block ID
-        }
-
-        // Assign AIV cores for all blocks managed by this thread
+    // Static: thread t manages a contiguous range of blocks, the ranges
+    // differ in size by at most one. Dynamic: threads claim blocks once
+    // they run (see claim_block)
+    for (int t = 0; t < MAX_AICPU_THREADS; t++) {
+        thread_block_num_[t] = 0;
+        thread_cores_num_[t] = 0;
+        hungry_[t] = false;
+    }
+    for (int t = 0; t < thread_num_ && !dynamic_partition_; t++) {
+        int start_block = sched_thread_first_block(t, num_aic, thread_num_);
+        int end_block = sched_thread_first_block(t + 1, num_aic, thread_num_);
         for (int b = start_block; b < end_block; b++) {
-            int aiv_base = num_aic;                                   // AIV cores start after all AIC cores
-            core_assignments_[t][core_idx++] = aiv_base + b * 2;      // First AIV of block b
-            core_assignments_[t][core_idx++] = aiv_base + b * 2 + 1;  // Second AIV of block b
+            thread_blocks_[t][thread_block_num_[t]++] = b;
+            block_owner_[b].store(t, std::memory_order_relaxed);
         }
+        assign_cores(t);
 
         DEV_INFO(
             "Thread %d: manages blockDims [%d-%d], cores: AIC[%d-%d] "
@@ -135,59 +216,666 @@ int AicpuExecutor::init(Runtime* runtime) {
             num_aic + start_block * 2,
             num_aic + (end_block - 1) * 2 + 1);
     }
-
-    // Initialize runtime execution state
-    total_tasks_.store(runtime->get_task_count(), std::memory_order_release);
+    for (int b = 0; b < num_aic && dynamic_partition_; b++) {
+        block_owner_[b].store(BLOCK_UNCLAIMED, std::memory_order_relaxed);
+    }
+    claim_cursor_.store(dynamic_partition_ ? 0 : num_aic, std::memory_order_relaxed);
+    released_blocks_.store(0, std::memory_order_relaxed);
+    hungry_threads_.store(0, std::memory_order_relaxed);
+
+    handshake_depth_ = runtime->handshake_depth;
+    if (handshake_depth_ < 1) handshake_depth_ = 1;
+    if (handshake_depth_ > RUNTIME_HANDSHAKE_SLOTS) handshake_depth_ = RUNTIME_HANDSHAKE_SLOTS;
+    for (int i = 0; i < RUNTIME_MAX_WORKER; i++) {
+        dispatched_[i] = 0;
+        retired_[i] = 0;
+    }
+    use_completion_board_ = (runtime->completion_mode == COMPLETION_BOARD);
+    affinity_dispatch_ = (runtime->affinity_dispatch != 0);
+    profiling_ = (runtime->profiling_enabled != 0);
+    DEV_INFO("Config: handshake depth=%d, completion=%s", handshake_depth_,
+        use_completion_board_ ? "board" : "poll");
+
+    // Initialize runtime execution state. Tasks absorbed into fused chains
+    // run as part of their head and are never dispatched or counted. A
+    // streaming run learns its task count when the host seals the graph,
+    // and queues are sized for the runtime's task limit.
+    streaming_ = (runtime->streaming != 0);
+    int task_count = streaming_ ? runtime->stream_capacity : runtime->get_task_count();
+    total_tasks_.store(streaming_ ? STREAM_OPEN : runtime->get_scheduled_task_count(), std::memory_order_release);
     completed_tasks_.store(0, std::memory_order_release);
+    stream_admitted_.store(0, std::memory_order_release);
 
-    int initial_ready[RUNTIME_MAX_TASKS];
-    int initial_count = runtime->get_initial_ready_tasks(initial_ready);
+    // Fanin is consumed in place during execution; restore it so that a
+    // resident graph can be launched again without re-uploading it
+    runtime->reset_execution_state();
 
-    DEV_INFO("Init: Found %d initially ready tasks", initial_count);
+    // Start every run with fresh counters
+    for (int t = 0; t < MAX_AICPU_THREADS; t++) {
+        SchedulerStats* stats = &runtime->sched_stats[t];
+        *stats = SchedulerStats();
+        stats_[t] = stats;
+    }
+    core_busy_ticks_ = runtime->core_busy_ticks;
+    for (int i = 0; i < RUNTIME_MAX_WORKER; i++) {
+        core_busy_ticks_[i] = 0;
+    }
+    for (int c = 0; c < 3; c++) {
+        ready_depth_[c].store(0, std::memory_order_relaxed);
+    }
 
+    if (streaming_ && runtime->scheduling_mode == SCHEDULE_AICORE_PULL) {
+        DEV_ERROR("Pull scheduling is not supported with streaming orchestration");
+        init_failed_.store(true, std::memory_order_release);
+        return -1;
+    }
+
+    // In pull mode the AICores schedule themselves; only seed their queues
+    if (runtime->scheduling_mode == SCHEDULE_AICORE_PULL) {
+        if (init_pull_queues(runtime) != 0) {
+            init_failed_.store(true, std::memory_order_release);
+            return -1;
+        }
+        init_done_.store(true, std::memory_order_release);
+        DEV_INFO("AicpuExecutor: Init complete (AICore pull scheduling)");
+        return 0;
+    }
+
+    // Each task is enqueued at most once, so task_count bounds every queue.
+    // Priorities of streamed tasks are not known while they are admitted.
+    ready_queue_policy_ = runtime->ready_queue_policy;
+    if (streaming_ && ready_queue_policy_ == READY_QUEUE_PRIORITY) {
+        DEV_WARN("Priority ready queue is not available with streaming orchestration, using FIFO");
+        ready_queue_policy_ = READY_QUEUE_FIFO;
+    }
+    if (ready_queue_policy_ == READY_QUEUE_STEALING) {
+        for (int t = 0; t < thread_num_; t++) {
+            local_queue_aic_[t].init(task_count);
+            local_queue_aiv_[t].init(task_count);
+        }
+    } else if (ready_queue_policy_ == READY_QUEUE_PRIORITY) {
+        max_priority_ = 0;
+        for (int i = 0; i < task_count; i++) {
+            int priority = runtime->get_task(i)->priority;
+            if (priority > max_priority_) max_priority_ = priority;
+        }
+        int aic_buckets[READY_QUEUE_PRIORITY_BUCKETS] = {0};
+        int aiv_buckets[READY_QUEUE_PRIORITY_BUCKETS] = {0};
+        for (int i = 0; i < task_count; i++) {
+            Task* task = runtime->get_task(i);
+            if (task->core_type == BLOCK_TASK) continue;
+            int* buckets = (task->core_type == 0) ? aic_buckets : aiv_buckets;
+            buckets[priority_bucket(task)]++;
+        }
+        priority_queue_aic_.init(aic_buckets);
+        priority_queue_aiv_.init(aiv_buckets);
+    } else {
+        ready_queue_aic_.init(task_count, ready_queue_policy_);
+        ready_queue_aiv_.init(task_count, ready_queue_policy_);
+    }
+    ready_queue_block_.init(task_count, ready_queue_policy_ == READY_QUEUE_LIFO ? READY_QUEUE_LIFO : READY_QUEUE_FIFO);
+    for (int b = 0; b < RUNTIME_MAX_WORKER; b++) {
+        gang_pending_[b] = 0;
+    }
+    for (int t = 0; t < MAX_AICPU_THREADS; t++) {
+        reserved_block_[t] = -1;
+    }
+
+    // Seed the ready queues with tasks that have no predecessors. With local
+    // queues they are dealt round-robin so every thread starts with work.
+    // Streamed tasks are admitted by the scheduler loop instead.
     int aic_count = 0;
     int aiv_count = 0;
-    for (int i = 0; i < initial_count; i++) {
-        Task* task = runtime->get_task(initial_ready[i]);
-        if (task->core_type == 0) {  // AIC
-            ready_queue_aic_[aic_count++] = initial_ready[i];
+    int block_count = 0;
+    for (int i = 0; i < task_count && !streaming_; i++) {
+        Task* task = runtime->get_task(i);
+        if (task->fanin.load(std::memory_order_relaxed) != 0 || task->fused_head >= 0) {
+            continue;
+        }
+        if (task->core_type == BLOCK_TASK) {
+            enqueue_ready(0, task);
+            block_count++;
+        } else if (task->core_type == 0) {  // AIC
+            enqueue_ready(aic_count % thread_num_, task);
+            aic_count++;
         } else {  // AIV
-            ready_queue_aiv_[aiv_count++] = initial_ready[i];
+            enqueue_ready(aiv_count % thread_num_, task);
+            aiv_count++;
         }
     }
-    ready_count_aic_.store(aic_count, std::memory_order_release);
-    ready_count_aiv_.store(aiv_count, std::memory_order_release);
 
-    DEV_INFO("Init: Initial ready tasks: AIC=%d, AIV=%d", aic_count, aiv_count);
+    DEV_INFO("Init: Found %d initially ready tasks", aic_count + aiv_count + block_count);
 
-    finished_count_.store(0, std::memory_order_release);
+    DEV_INFO("Init: Initial ready tasks: AIC=%d, AIV=%d, BLOCK=%d", aic_count, aiv_count, block_count);
 
     init_done_.store(true, std::memory_order_release);
     DEV_INFO("AicpuExecutor: Init complete");
     return 0;
 }
 
+/**
+ * Reset the device-global pull queues and seed them with the initially
+ * ready tasks (SCHEDULE_AICORE_PULL)
+ *
+ * Each core type gets a slice of Runtime::pull_ring large enough for all of
+ * its tasks, since every task is pushed exactly once per run.
+ */
+int AicpuExecutor::init_pull_queues(Runtime* runtime) {
+    int task_count = runtime->get_task_count();
+    if (task_count > 0 && runtime->pull_ring == nullptr) {
+        DEV_ERROR("Pull scheduling requested but the pull ring is not allocated");
+        return -1;
+    }
+
+    int aic_tasks = 0;
+    for (int i = 0; i < task_count; i++) {
+        int core_type = runtime->get_task(i)->core_type;
+        if (core_type == BLOCK_TASK) {
+            DEV_ERROR("Task %d: block tasks are not supported with pull scheduling", i);
+            return -1;
+        }
+        if (core_type == 0) aic_tasks++;
+    }
+    runtime->pull_queues[0].base = 0;
+    runtime->pull_queues[0].capacity = aic_tasks;
+    runtime->pull_queues[1].base = aic_tasks;
+    runtime->pull_queues[1].capacity = task_count - aic_tasks;
+
+    for (int i = 0; i < task_count; i++) {
+        runtime->pull_ring[i] = -1;
+    }
+
+    int seeded[2] = {0, 0};
+    for (int i = 0; i < task_count; i++) {
+        Task* task = runtime->get_task(i);
+        if (task->fanin.load(std::memory_order_relaxed) != 0 || task->fused_head >= 0) {
+            continue;
+        }
+        int type = (task->core_type == 0) ? 0 : 1;
+        runtime->pull_ring[runtime->pull_queues[type].base + seeded[type]++] = task->task_id;
+    }
+    for (int type = 0; type < 2; type++) {
+        runtime->pull_queues[type].head.store(0, std::memory_order_relaxed);
+        runtime->pull_queues[type].tail.store(seeded[type], std::memory_order_relaxed);
+    }
+    runtime->pull_completed.store(0, std::memory_order_release);
+
+    DEV_INFO("Init: Pull queues seeded: AIC=%d/%d, AIV=%d/%d",
+        seeded[0], aic_tasks, seeded[1], task_count - aic_tasks);
+    return 0;
+}
+
+/**
+ * Wait for the AICores to finish a pull-scheduled run
+ *
+ * The AICPU takes no part in dispatch here; it only watches the completion
+ * counter and reports the queue state if progress stalls.
+ *
+ * @return Number of tasks completed, or -1 on timeout
+ */
+int AicpuExecutor::wait_pull_completion(Runtime& runtime, int thread_idx, const int* cur_thread_cores, int core_num) {
+    int task_count = total_tasks_.load(std::memory_order_acquire);
+    const int MAX_IDLE_ITERATIONS = 1000000;
+    int idle_iterations = 0;
+    int last_completed = -1;
+    uint64_t run_start = get_sys_cnt_aicpu();
+
+    while (true) {
+        int completed = runtime.pull_completed.load(std::memory_order_acquire);
+        if (completed >= task_count) {
+            // The AICores schedule themselves; only the wall time is known here
+            stats_[thread_idx]->run_ticks = get_sys_cnt_aicpu() - run_start;
+            completed_tasks_.store(completed, std::memory_order_release);
+            return completed;
+        }
+        if (completed != last_completed) {
+            last_completed = completed;
+            idle_iterations = 0;
+            continue;
+        }
+        aicpu_idle();
+        if (++idle_iterations > MAX_IDLE_ITERATIONS) {
+            DEV_ERROR("Thread %d: Pull scheduling stalled at %d/%d tasks", thread_idx, completed, task_count);
+            for (int type = 0; type < 2; type++) {
+                PullQueue* queue = &runtime.pull_queues[type];
+                DEV_ERROR("  %s queue: head=%d tail=%d capacity=%d", type == 0 ? "AIC" : "AIV",
+                    queue->head.load(std::memory_order_acquire), queue->tail.load(std::memory_order_acquire),
+                    queue->capacity);
+            }
+            for (int i = 0; i < core_num; i++) {
+                int core_id = cur_thread_cores[i];
+                DEV_ERROR("  Core %d: completed=%u", core_id, runtime.workers[core_id].complete_seq);
+            }
+            return -1;
+        }
+    }
+}
+
+/**
+ * Map a task's priority onto a priority queue bucket
+ *
+ * Priorities are used as-is while they fit, otherwise scaled linearly.
+ */
+int AicpuExecutor::priority_bucket(const Task* task) const {
+    int priority = task->priority < 0 ? 0 : task->priority;
+    if (max_priority_ < READY_QUEUE_PRIORITY_BUCKETS) {
+        return priority;
+    }
+    return static_cast<int>(static_cast<int64_t>(priority) * (READY_QUEUE_PRIORITY_BUCKETS - 1) / max_priority_);
+}
+
+/**
+ * Make a task available for dispatch
+ *
+ * With READY_QUEUE_STEALING the task goes to the releasing thread's own
+ * deque, so producer-consumer chains stay on the cores that thread manages.
+ * With READY_QUEUE_PRIORITY it goes to its priority bucket. Otherwise it goes
+ * to the shared queue for its core type.
+ */
+void AicpuExecutor::enqueue_ready(int thread_idx, Task* task) {
+    SchedulerStats* stats = stats_[thread_idx];
+    bool timed = sample_queue_op(stats);
+    uint64_t start = get_sys_cnt_aicpu();
+    task->ready_time = start;
+    int task_id = task->task_id;
+    int core_type = task->core_type;
+    if (core_type == BLOCK_TASK) {
+        ready_queue_block_.push(task_id);
+    } else if (ready_queue_policy_ == READY_QUEUE_PRIORITY) {
+        PriorityReadyQueue& queue = (core_type == 0) ? priority_queue_aic_ : priority_queue_aiv_;
+        queue.push(task_id, priority_bucket(task));
+    } else if (ready_queue_policy_ == READY_QUEUE_STEALING) {
+        WorkStealingDeque& local = (core_type == 0) ? local_queue_aic_[thread_idx] : local_queue_aiv_[thread_idx];
+        local.push(task_id);
+    } else if (core_type == 0) {
+        ready_queue_aic_.push(task_id);
+    } else {
+        ready_queue_aiv_.push(task_id);
+    }
+
+    int depth = ready_depth_[core_type].fetch_add(1, std::memory_order_relaxed) + 1;
+    if (depth > stats->max_ready_depth[core_type]) {
+        stats->max_ready_depth[core_type] = depth;
+    }
+    if (timed) {
+        stats->queue_op_ticks += (get_sys_cnt_aicpu() - start) * RUNTIME_QUEUE_TIMING_SAMPLE;
+    }
+}
+
+/**
+ * Take the next task for an idle core of the given type
+ *
+ * With READY_QUEUE_STEALING the thread drains its own deque first and then
+ * tries to steal from the other threads, starting with its neighbour.
+ *
+ * Returns right away while the ready count of the core type is zero, so
+ * idle scheduler passes neither touch the shared queues nor pay for the
+ * queue timing.
+ */
+bool AicpuExecutor::dequeue_ready(int thread_idx, int core_type, int* task_id) {
+    if (ready_depth_[core_type].load(std::memory_order_relaxed) <= 0) {
+        return false;
+    }
+    SchedulerStats* stats = stats_[thread_idx];
+    bool timed = sample_queue_op(stats);
+    uint64_t start = timed ? get_sys_cnt_aicpu() : 0;
+    bool found = false;
+    if (ready_queue_policy_ == READY_QUEUE_PRIORITY) {
+        found = (core_type == 0) ? priority_queue_aic_.pop(task_id) : priority_queue_aiv_.pop(task_id);
+    } else if (ready_queue_policy_ != READY_QUEUE_STEALING) {
+        found = (core_type == 0) ? ready_queue_aic_.pop(task_id) : ready_queue_aiv_.pop(task_id);
+    } else {
+        WorkStealingDeque* locals = (core_type == 0) ? local_queue_aic_ : local_queue_aiv_;
+        found = locals[thread_idx].take(task_id);
+        for (int i = 1; i < thread_num_ && !found; i++) {
+            int victim = (thread_idx + i) % thread_num_;
+            found = locals[victim].steal(task_id);
+        }
+    }
+
+    if (found) {
+        ready_depth_[core_type].fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (timed) {
+        stats->queue_op_ticks += (get_sys_cnt_aicpu() - start) * RUNTIME_QUEUE_TIMING_SAMPLE;
+    }
+    return found;
+}
+
+/**
+ * Count a ready queue operation and decide whether to time it
+ *
+ * Reading the system counter twice per push and pop is measurable in the
+ * scheduler loop, so queue_op_ticks is extrapolated from one operation in
+ * RUNTIME_QUEUE_TIMING_SAMPLE.
+ */
+bool AicpuExecutor::sample_queue_op(SchedulerStats* stats) {
+    return (stats->queue_ops++ & (RUNTIME_QUEUE_TIMING_SAMPLE - 1)) == 0;
+}
+
+/**
+ * Release the successors of a finished task
+ *
+ * Each successor's fanin is decremented; the one that reaches zero is made
+ * ready, hinted at the block of the core that ran its last predecessor.
+ * Successors come from the CSR arrays, or in a streaming run from the list
+ * the admitted successors have registered on; closing that list makes
+ * successors admitted later skip this task.
+ */
+void AicpuExecutor::release_successors(Runtime& runtime, int thread_idx, int core_id, Task* task) {
+    if (!streaming_) {
+        int* fanout = runtime.get_fanout(task);
+        for (int j = 0; j < task->fanout_count; j++) {
+            Task* dep = runtime.get_task(fanout[j]);
+            if (dep->fanin.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (affinity_dispatch_) {
+                    dep->hint_block = core_block_[core_id];
+                }
+                enqueue_ready(thread_idx, dep);
+                DEV_DEBUG("Thread %d: Task %d became ready -> %s queue",
+                    thread_idx, fanout[j], dep->core_type == 0 ? "AIC" : (dep->core_type == 1 ? "AIV" : "BLOCK"));
+            }
+        }
+        return;
+    }
+
+    int link = task->succ_head.exchange(STREAM_LIST_CLOSED, std::memory_order_acq_rel);
+    while (link >= 0) {
+        const StreamLink* entry = &runtime.stream_links[link];
+        Task* dep = &runtime.tasks[entry->task];
+        link = entry->next;
+        if (dep->fanin.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (affinity_dispatch_) {
+                dep->hint_block = core_block_[core_id];
+            }
+            enqueue_ready(thread_idx, dep);
+            DEV_DEBUG("Thread %d: Streamed task %d became ready", thread_idx, dep->task_id);
+        }
+    }
+}
+
+/**
+ * Admit tasks the host has published since the last pass (streaming runs)
+ *
+ * Threads claim batches of STREAM_ADMIT_BATCH published tasks with a CAS,
+ * so every task is admitted exactly once.
+ *
+ * @return Number of tasks admitted by this thread
+ */
+int AicpuExecutor::admit_published(Runtime& runtime, int thread_idx) {
+    int published = runtime.published_count.load(std::memory_order_acquire);
+    int begin = stream_admitted_.load(std::memory_order_relaxed);
+    int admitted = 0;
+    while (begin < published) {
+        int end = published - begin > STREAM_ADMIT_BATCH ? begin + STREAM_ADMIT_BATCH : published;
+        if (!stream_admitted_.compare_exchange_weak(begin, end, std::memory_order_relaxed)) {
+            continue;
+        }
+        for (int i = begin; i < end; i++) {
+            admit_task(runtime, thread_idx, &runtime.tasks[i]);
+        }
+        admitted += end - begin;
+        begin = end;
+    }
+    return admitted;
+}
+
+/**
+ * Register a published task with its predecessors
+ *
+ * The task pushes its link onto the successor list of every predecessor
+ * that has not finished yet; a closed list means that predecessor is done.
+ * Fanin starts one above the predecessor count, and that extra reference
+ * is dropped last, so a predecessor finishing meanwhile cannot make the
+ * task ready before all of its links are in place.
+ */
+void AicpuExecutor::admit_task(Runtime& runtime, int thread_idx, Task* task) {
+    int pred_count = task->initial_fanin;
+    task->fanin.store(pred_count + 1, std::memory_order_relaxed);
+
+    int resolved = 1;
+    for (int i = 0; i < pred_count; i++) {
+        int link = task->pred_offset + i;
+        Task* pred = &runtime.tasks[runtime.stream_preds[link]];
+        runtime.stream_links[link].task = task->task_id;
+        int head = pred->succ_head.load(std::memory_order_acquire);
+        while (true) {
+            if (head == STREAM_LIST_CLOSED) {
+                resolved++;
+                break;
+            }
+            runtime.stream_links[link].next = head;
+            if (pred->succ_head.compare_exchange_weak(head, link, std::memory_order_release,
+                    std::memory_order_acquire)) {
+                break;
+            }
+        }
+    }
+
+    if (task->fanin.fetch_sub(resolved, std::memory_order_acq_rel) == resolved) {
+        enqueue_ready(thread_idx, task);
+    }
+}
+
+/**
+ * Approximate number of ready tasks of the given core type (diagnostics only)
+ */
+int AicpuExecutor::ready_count(int core_type) {
+    if (core_type == BLOCK_TASK) {
+        return ready_queue_block_.approx_size();
+    }
+    if (ready_queue_policy_ == READY_QUEUE_PRIORITY) {
+        return (core_type == 0) ? priority_queue_aic_.approx_size() : priority_queue_aiv_.approx_size();
+    }
+    if (ready_queue_policy_ != READY_QUEUE_STEALING) {
+        return (core_type == 0) ? ready_queue_aic_.approx_size() : ready_queue_aiv_.approx_size();
+    }
+    WorkStealingDeque* locals = (core_type == 0) ? local_queue_aic_ : local_queue_aiv_;
+    int count = 0;
+    for (int t = 0; t < thread_num_; t++) {
+        count += locals[t].approx_size();
+    }
+    return count;
+}
+
+/**
+ * Choose the core a dequeued task is posted to
+ *
+ * With affinity dispatch enabled, a task whose affinity block (or, failing
+ * that, the block of the producer that released it) is managed by this
+ * thread goes to a core of that block when one has fewer than
+ * max_in_flight tasks queued. Otherwise the task stays on default_core.
+ *
+ * @param thread_idx    Calling scheduler thread
+ * @param task          Task about to be dispatched
+ * @param default_core  Core the task was dequeued for
+ * @param max_in_flight Slot limit of the current dispatch pass
+ * @return Core ID to dispatch to
+ */
+int AicpuExecutor::pick_core(int thread_idx, const Task* task, int default_core, int max_in_flight) const {
+    if (!affinity_dispatch_) {
+        return default_core;
+    }
+    int block = (task->affinity_block >= 0) ? task->affinity_block : task->hint_block;
+    if (block < 0 || block >= block_dim_ || block == core_block_[default_core] ||
+        block_owner_[block].load(std::memory_order_relaxed) != thread_idx) {
+        return default_core;
+    }
+
+    int candidates[2];
+    int num_candidates = 0;
+    if (task->core_type == 0) {
+        candidates[num_candidates++] = block;
+    } else {
+        candidates[num_candidates++] = block_dim_ + block * 2;
+        candidates[num_candidates++] = block_dim_ + block * 2 + 1;
+    }
+    for (int i = 0; i < num_candidates; i++) {
+        int core_id = candidates[i];
+        if (dispatched_[core_id] - retired_[core_id] < static_cast<uint32_t>(max_in_flight)) {
+            return core_id;
+        }
+    }
+    return default_core;
+}
+
+/**
+ * Post a task into the next free handshake slot of a core
+ */
+void AicpuExecutor::post_task(Handshake* hank, int core_id, Task* task) {
+    Handshake* h = &hank[core_id];
+    if (dispatched_[core_id] == retired_[core_id] || profiling_) {
+        uint64_t now = get_sys_cnt_aicpu();
+        if (dispatched_[core_id] == retired_[core_id]) {
+            busy_since_[core_id] = now;
+        }
+        if (profiling_) {
+            task->dispatch_time = now;
+        }
+    }
+    // Publish the slot before the sequence number that exposes it
+    h->slot_task[dispatched_[core_id] % RUNTIME_HANDSHAKE_SLOTS] = reinterpret_cast<uint64_t>(task);
+    std::atomic_thread_fence(std::memory_order_release);
+    dispatched_[core_id]++;
+    h->dispatch_seq = dispatched_[core_id];
+}
+
+/**
+ * Count a dispatched task and its ready -> posted latency
+ */
+void AicpuExecutor::note_dispatch(int thread_idx, const Task* task) {
+    SchedulerStats* stats = stats_[thread_idx];
+    uint64_t latency = get_sys_cnt_aicpu() - task->ready_time;
+    stats->tasks_dispatched++;
+    stats->dispatch_latency_ticks += latency;
+    if (latency > stats->max_dispatch_latency_ticks) {
+        stats->max_dispatch_latency_ticks = latency;
+    }
+}
+
+/**
+ * Check whether the AIC and both AIVs of a block have nothing in flight
+ */
+bool AicpuExecutor::block_idle(int block) const {
+    int cores[3] = {block, block_dim_ + block * 2, block_dim_ + block * 2 + 1};
+    for (int core_id : cores) {
+        if (dispatched_[core_id] != retired_[core_id]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Dispatch ready block tasks to fully idle blocks managed by this thread
+ *
+ * A gang task is posted to all three cores of one block in the same pass,
+ * so they start together. If no block is idle while gang tasks wait, the
+ * least loaded block is reserved: Phase 2 stops feeding it single-core
+ * tasks until it drains, which keeps gang tasks from starving.
+ *
+ * @return Number of handshake slots filled (three per gang task)
+ */
+int AicpuExecutor::dispatch_block_tasks(Runtime& runtime, int thread_idx, Handshake* hank) {
+    const int* blocks = thread_blocks_[thread_idx];
+    int block_num = thread_block_num_[thread_idx];
+    int posted = 0;
+
+    if (ready_queue_block_.approx_size() == 0) {
+        reserved_block_[thread_idx] = -1;
+        return 0;
+    }
+
+    while (ready_queue_block_.approx_size() > 0) {
+        int block = -1;
+        for (int i = 0; i < block_num; i++) {
+            if (block_idle(blocks[i])) {
+                block = blocks[i];
+                break;
+            }
+        }
+        if (block < 0) {
+            if (reserved_block_[thread_idx] < 0) {
+                uint32_t best_load = UINT32_MAX;
+                for (int i = 0; i < block_num; i++) {
+                    int b = blocks[i];
+                    uint32_t load = 0;
+                    int cores[3] = {b, block_dim_ + b * 2, block_dim_ + b * 2 + 1};
+                    for (int core_id : cores) {
+                        load += dispatched_[core_id] - retired_[core_id];
+                    }
+                    if (load < best_load) {
+                        best_load = load;
+                        reserved_block_[thread_idx] = b;
+                    }
+                }
+            }
+            break;
+        }
+
+        int task_id;
+        bool timed = sample_queue_op(stats_[thread_idx]);
+        uint64_t pop_start = timed ? get_sys_cnt_aicpu() : 0;
+        bool popped = ready_queue_block_.pop(&task_id);
+        if (timed) {
+            stats_[thread_idx]->queue_op_ticks += (get_sys_cnt_aicpu() - pop_start) * RUNTIME_QUEUE_TIMING_SAMPLE;
+        }
+        if (!popped) {
+            break;
+        }
+        ready_depth_[BLOCK_TASK].fetch_sub(1, std::memory_order_relaxed);
+        Task* task = runtime.get_task(task_id);
+        int preferred = (task->affinity_block >= 0) ? task->affinity_block : task->hint_block;
+        if (affinity_dispatch_ && preferred >= 0 && preferred < block_dim_ &&
+            block_owner_[preferred].load(std::memory_order_relaxed) == thread_idx && block_idle(preferred)) {
+            block = preferred;
+        }
+
+        DEV_DEBUG("Thread %d: Dispatching BLOCK task %d to block %d", thread_idx, task_id, block);
+        gang_pending_[block] = 3;
+        post_task(hank, block, task);
+        post_task(hank, block_dim_ + block * 2, task);
+        post_task(hank, block_dim_ + block * 2 + 1, task);
+        note_dispatch(thread_idx, task);
+        if (reserved_block_[thread_idx] == block) {
+            reserved_block_[thread_idx] = -1;
+        }
+        posted += 3;
+    }
+    return posted;
+}
+
 /**
  * Handshake AICore - Initialize and synchronize with AICore kernels
  */
-int AicpuExecutor::hank_aicore(Runtime* runtime, int thread_idx, const int* cur_thread_cores) {
+int AicpuExecutor::hank_aicore(Runtime* runtime, int thread_idx, const int* cores, int core_num) {
     Handshake* all_hanks = (Handshake*)runtime->workers;
 
-    DEV_INFO("Thread %d: Handshaking with %d cores", thread_idx, thread_cores_num_);
+    DEV_INFO("Thread %d: Handshaking with %d cores", thread_idx, core_num);
 
-    for (int i = 0; i < thread_cores_num_; i++) {
-        int core_id = cur_thread_cores[i];
+    for (int i = 0; i < core_num; i++) {
+        int core_id = cores[i];
         Handshake* hank = &all_hanks[core_id];
-        DEV_INFO("Thread %d: AICPU hank addr = 0x%lx", thread_idx, (uint64_t)hank);
+        DEV_DEBUG("Thread %d: AICPU hank addr = 0x%lx", thread_idx, (uint64_t)hank);
+        core_type_[core_id] = hank->core_type;
+        // Board entries are indexed by core, so they stay valid when the
+        // core moves to another thread
+        if (use_completion_board_) {
+            runtime->completion_board[core_id] = 0;
+            hank->completion_slot = core_id;
+        } else {
+            hank->completion_slot = -1;
+        }
         hank->aicpu_ready = 1;
     }
 
-    for (int i = 0; i < thread_cores_num_; i++) {
-        int core_id = cur_thread_cores[i];
+    for (int i = 0; i < core_num; i++) {
+        int core_id = cores[i];
         Handshake* hank = &all_hanks[core_id];
         while (hank->aicore_done == 0) {
+            aicpu_idle();
         }
-        DEV_INFO("Thread %d: success hank->aicore_done = %u", thread_idx, hank->aicore_done);
+        DEV_DEBUG("Thread %d: success hank->aicore_done = %u", thread_idx, hank->aicore_done);
     }
     return 0;
 }
@@ -195,27 +883,153 @@ int AicpuExecutor::hank_aicore(Runtime* runtime, int thread_idx, const int* cur_
 /**
  * Shutdown AICore - Send quit signal to all AICore kernels
  */
-int AicpuExecutor::shutdown_aicore(Runtime* runtime, int thread_idx, const int* cur_thread_cores) {
+int AicpuExecutor::shutdown_aicore(Runtime* runtime, int thread_idx, const int* cores, int core_num) {
     Handshake* all_hanks = (Handshake*)runtime->workers;
 
-    DEV_INFO("Thread %d: Shutting down %d cores", thread_idx, thread_cores_num_);
+    DEV_INFO("Thread %d: Shutting down %d cores", thread_idx, core_num);
 
-    for (int i = 0; i < thread_cores_num_; i++) {
-        int core_id = cur_thread_cores[i];
+    for (int i = 0; i < core_num; i++) {
+        int core_id = cores[i];
         Handshake* hank = &all_hanks[core_id];
-        DEV_INFO("Thread %d: AICPU hank addr = 0x%lx", thread_idx, (uint64_t)hank);
+        DEV_DEBUG("Thread %d: AICPU hank addr = 0x%lx", thread_idx, (uint64_t)hank);
         hank->control = 1;
     }
     DEV_INFO("Thread %d: Shutdown complete", thread_idx);
     return 0;
 }
 
+/**
+ * Release every core of a failed launch
+ *
+ * The AICores pass the start handshake and then see the quit signal, so
+ * their kernels return (and acknowledge the graph in persistent mode) even
+ * though no thread handshakes with them or shuts them down.
+ */
+void AicpuExecutor::release_aicore(Runtime* runtime) {
+    Handshake* all_hanks = (Handshake*)runtime->workers;
+    for (int i = 0; i < runtime->worker_count; i++) {
+        all_hanks[i].control = 1;
+        all_hanks[i].aicpu_ready = 1;
+    }
+    DEV_WARN("Released %d cores of the failed launch", runtime->worker_count);
+}
+
+/**
+ * Rebuild a thread's core list from its blocks: all AICs, then all AIVs
+ */
+void AicpuExecutor::assign_cores(int thread_idx) {
+    const int* blocks = thread_blocks_[thread_idx];
+    int block_num = thread_block_num_[thread_idx];
+    int* cores = core_assignments_[thread_idx];
+    int core_idx = 0;
+    for (int i = 0; i < block_num; i++) {
+        cores[core_idx++] = blocks[i];
+    }
+    for (int i = 0; i < block_num; i++) {
+        cores[core_idx++] = block_dim_ + blocks[i] * 2;
+        cores[core_idx++] = block_dim_ + blocks[i] * 2 + 1;
+    }
+    thread_cores_num_[thread_idx] = core_idx;
+}
+
+/**
+ * Take over one more block (CORE_PARTITION_DYNAMIC)
+ *
+ * A block handed off by a busy thread is preferred; its in-flight tasks
+ * come along and are retired here. Otherwise the next block nobody has
+ * claimed yet is taken and its cores are handshaked first.
+ *
+ * @return Block taken, or -1 if none is left
+ */
+int AicpuExecutor::claim_block(Runtime* runtime, int thread_idx) {
+    int block = -1;
+    for (int b = 0; b < block_dim_ && released_blocks_.load(std::memory_order_relaxed) > 0; b++) {
+        int expected = BLOCK_RELEASED;
+        if (block_owner_[b].compare_exchange_strong(expected, thread_idx, std::memory_order_acquire,
+                std::memory_order_relaxed)) {
+            released_blocks_.fetch_sub(1, std::memory_order_relaxed);
+            stats_[thread_idx]->blocks_migrated++;
+            block = b;
+            break;
+        }
+    }
+    if (block < 0 && claim_cursor_.load(std::memory_order_relaxed) < block_dim_) {
+        int b = claim_cursor_.fetch_add(1, std::memory_order_relaxed);
+        if (b < block_dim_) {
+            block_owner_[b].store(thread_idx, std::memory_order_relaxed);
+            int cores[3] = {b, block_dim_ + b * 2, block_dim_ + b * 2 + 1};
+            hank_aicore(runtime, thread_idx, cores, 3);
+            block = b;
+        }
+    }
+    if (block < 0) {
+        return -1;
+    }
+
+    thread_blocks_[thread_idx][thread_block_num_[thread_idx]++] = block;
+    assign_cores(thread_idx);
+    set_hungry(thread_idx, false);
+    DEV_DEBUG("Thread %d: Claimed block %d, now managing %d blocks", thread_idx, block,
+        thread_block_num_[thread_idx]);
+    return block;
+}
+
+/**
+ * Hand the newest block that is not reserved for a gang task to another
+ * thread (CORE_PARTITION_DYNAMIC); the thread keeps at least one block
+ */
+void AicpuExecutor::release_block(int thread_idx) {
+    int* blocks = thread_blocks_[thread_idx];
+    int block_num = thread_block_num_[thread_idx];
+    for (int i = block_num - 1; i >= 0 && block_num > 1; i--) {
+        int block = blocks[i];
+        if (block == reserved_block_[thread_idx]) {
+            continue;
+        }
+        blocks[i] = blocks[block_num - 1];
+        thread_block_num_[thread_idx]--;
+        assign_cores(thread_idx);
+        // Publishes dispatched_/retired_/busy_since_/gang_pending_ of the block
+        block_owner_[block].store(BLOCK_RELEASED, std::memory_order_release);
+        released_blocks_.fetch_add(1, std::memory_order_relaxed);
+        DEV_DEBUG("Thread %d: Released block %d", thread_idx, block);
+        return;
+    }
+}
+
+/**
+ * Mark whether a thread's cores have drained (CORE_PARTITION_DYNAMIC)
+ */
+void AicpuExecutor::set_hungry(int thread_idx, bool hungry) {
+    if (hungry_[thread_idx] != hungry) {
+        hungry_[thread_idx] = hungry;
+        hungry_threads_.fetch_add(hungry ? 1 : -1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Tasks posted but not yet retired on the cores a thread manages
+ */
+int AicpuExecutor::tasks_in_flight(int thread_idx) const {
+    int in_flight = 0;
+    for (int i = 0; i < thread_cores_num_[thread_idx]; i++) {
+        int core_id = core_assignments_[thread_idx][i];
+        in_flight += static_cast<int>(dispatched_[core_id] - retired_[core_id]);
+    }
+    return in_flight;
+}
+
 /**
  * Resolve dependencies and dispatch tasks using polling-based dispatch to
  * AICore
  */
-int AicpuExecutor::resolve_and_dispatch(Runtime& runtime, int thread_idx, const int* cur_thread_cores, int core_num) {
+int AicpuExecutor::resolve_and_dispatch(Runtime& runtime, int thread_idx) {
     Handshake* hank = (Handshake*)runtime.workers;
+    // Indexed by core (see hank_aicore)
+    volatile uint32_t* board = runtime.completion_board;
+    // Changes when blocks move between threads (CORE_PARTITION_DYNAMIC)
+    const int* cur_thread_cores = core_assignments_[thread_idx];
+    int core_num = thread_cores_num_[thread_idx];
 
     DEV_INFO("Thread %d: Starting execution with %d cores", thread_idx, core_num);
 
@@ -232,23 +1046,41 @@ int AicpuExecutor::resolve_and_dispatch(Runtime& runtime, int thread_idx, const
     int verification_warning_count = 0;
     const int MAX_VERIFICATION_WARNINGS = 10;
 
+    SchedulerStats* stats = stats_[thread_idx];
+    uint64_t run_start = get_sys_cnt_aicpu();
+
     // Execute tasks using polling-based dispatch with integrated verification
     while (true) {
+        // Streaming: the task count is final once the host has sealed the
+        // graph; published_count is stored before the seal
+        if (task_count == STREAM_OPEN && runtime.stream_sealed.load(std::memory_order_acquire) != 0) {
+            task_count = runtime.published_count.load(std::memory_order_acquire);
+            total_tasks_.store(task_count, std::memory_order_release);
+        }
+
         // Double verification: check counter reached AND all cores truly idle
         if (completed_tasks_.load(std::memory_order_acquire) >= task_count) {
+            // Take over every block still without a thread, so that its
+            // cores are shut down too
+            if (dynamic_partition_) {
+                while (claim_block(&runtime, thread_idx) >= 0) {
+                }
+                core_num = thread_cores_num_[thread_idx];
+            }
             bool all_cores_idle = true;
 
             for (int i = 0; i < core_num; i++) {
                 int core_id = cur_thread_cores[i];
                 Handshake* h = &hank[core_id];
 
-                if (h->task_status != 0 || h->task != 0) {
+                if (retired_[core_id] != dispatched_[core_id] || h->complete_seq != dispatched_[core_id]) {
                     all_cores_idle = false;
 
                     if (verification_warning_count == 0) {
-                        DEV_WARN("Thread %d: Counter reached %d/%d but core %d still has work (status=%d, task=%p)",
+                        DEV_WARN("Thread %d: Counter reached %d/%d but core %d still has work (dispatched=%u, "
+                                 "completed=%u, retired=%u)",
                                 thread_idx, completed_tasks_.load(std::memory_order_acquire), task_count,
-                                core_id, h->task_status, (void*)h->task);
+                                core_id, dispatched_[core_id], h->complete_seq, retired_[core_id]);
                     }
                     break;
                 }
@@ -256,11 +1088,12 @@ int AicpuExecutor::resolve_and_dispatch(Runtime& runtime, int thread_idx, const
 
             if (all_cores_idle) {
                 // Truly complete: counter reached and all cores idle
-                int aic_remaining = ready_count_aic_.load(std::memory_order_acquire);
-                int aiv_remaining = ready_count_aiv_.load(std::memory_order_acquire);
-                if (aic_remaining > 0 || aiv_remaining > 0) {
-                    DEV_WARN("Thread %d: Queues not empty after completion! AIC=%d, AIV=%d",
-                            thread_idx, aic_remaining, aiv_remaining);
+                int aic_remaining = ready_count(0);
+                int aiv_remaining = ready_count(1);
+                int block_remaining = ready_count(BLOCK_TASK);
+                if (aic_remaining > 0 || aiv_remaining > 0 || block_remaining > 0) {
+                    DEV_WARN("Thread %d: Queues not empty after completion! AIC=%d, AIV=%d, BLOCK=%d",
+                            thread_idx, aic_remaining, aiv_remaining, block_remaining);
                 }
                 break;  // Exit main loop
             }
@@ -276,166 +1109,201 @@ int AicpuExecutor::resolve_and_dispatch(Runtime& runtime, int thread_idx, const
         }
 
         made_progress = false;
+        stats->loop_iterations++;
+
+        // Phase 0: Admit the tasks the host has published meanwhile
+        if (streaming_ && admit_published(runtime, thread_idx) > 0) {
+            made_progress = true;
+        }
 
         // Phase 1: Process completed tasks on my managed cores
         for (int i = 0; i < core_num; i++) {
             int core_id = cur_thread_cores[i];
             Handshake* h = &hank[core_id];
 
-            // Core finished a task (idle + task not null)
-            if (h->task_status == 0 && h->task != 0) {
-                // Get completed task and immediately clear the pointer to prevent duplicate detection
-                Task* task = reinterpret_cast<Task*>(h->task);
-                h->task = 0;  // Clear immediately to minimize race condition window
+            // Retire every task the core finished since the last pass. In
+            // board mode idle cores are skipped without reading their handshake.
+            uint32_t core_completed = use_completion_board_ ? board[core_id] : h->complete_seq;
+            if (core_completed == retired_[core_id]) {
+                continue;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t now = get_sys_cnt_aicpu();
+            while (retired_[core_id] != core_completed) {
+                Task* task = reinterpret_cast<Task*>(h->slot_task[retired_[core_id] % RUNTIME_HANDSHAKE_SLOTS]);
+                retired_[core_id]++;
+                cur_thread_tasks_in_flight--;
+                made_progress = true;
+                if (retired_[core_id] == dispatched_[core_id]) {
+                    core_busy_ticks_[core_id] += now - busy_since_[core_id];
+                }
 
-                int task_id = task->task_id;
+                // A gang task completes when the last of its three cores does
+                if (task->core_type == BLOCK_TASK && --gang_pending_[core_block_[core_id]] > 0) {
+                    continue;
+                }
 
-                DEV_INFO("Thread %d: Core %d completed task %d", thread_idx, core_id, task_id);
-
-                // Update fanin of successors atomically and add to appropriate
-                // shared ready queue
-                for (int j = 0; j < task->fanout_count; j++) {
-                    int dep_id = task->fanout[j];
-                    Task* dep = runtime.get_task(dep_id);
-
-                    // Atomic decrement fanin
-                    int prev_fanin = dep->fanin.fetch_sub(1, std::memory_order_acq_rel);
-
-                    // Dependency resolved, add to appropriate shared ready
-                    // queue
-                    if (prev_fanin == 1) {
-                        if (dep->core_type == 0) {  // AIC task
-                            std::lock_guard<std::mutex> lock(ready_queue_aic_mutex_);
-                            int idx = ready_count_aic_.load(std::memory_order_relaxed);
-                            ready_queue_aic_[idx] = dep_id;
-                            ready_count_aic_.fetch_add(1, std::memory_order_release);
-                            DEV_INFO("Thread %d: Task %d became ready -> AIC queue", thread_idx, dep_id);
-                        } else {  // AIV task
-                            std::lock_guard<std::mutex> lock(ready_queue_aiv_mutex_);
-                            int idx = ready_count_aiv_.load(std::memory_order_relaxed);
-                            ready_queue_aiv_[idx] = dep_id;
-                            ready_count_aiv_.fetch_add(1, std::memory_order_release);
-                            DEV_INFO("Thread %d: Task %d became ready -> AIV queue", thread_idx, dep_id);
-                        }
-                    }
+                int task_id = task->task_id;
+                if (profiling_) {
+                    task->complete_time = now;
                 }
 
+                DEV_DEBUG("Thread %d: Core %d completed task %d", thread_idx, core_id, task_id);
+
+                // Update fanin of successors atomically and add to the
+                // appropriate ready queue
+                release_successors(runtime, thread_idx, core_id, task);
+
                 // Update counters
-                cur_thread_tasks_in_flight--;
                 cur_thread_completed++;
-                made_progress = true;
                 completed_tasks_.fetch_add(1, std::memory_order_release);
             }
         }
 
-        // Load balancing: Skip dispatch if all my cores are busy
-        if (cur_thread_tasks_in_flight < core_num) {
-            // Phase 2: Dispatch new tasks from matching ready queue to idle cores
-            for (int i = 0; i < core_num; i++) {
-                int core_id = cur_thread_cores[i];
-                Handshake* h = &hank[core_id];
+        // Phase 2a: Gang tasks claim whole idle blocks before single-core
+        // tasks fill the remaining slots
+        int gang_posted = dispatch_block_tasks(runtime, thread_idx, hank);
+        if (gang_posted > 0) {
+            cur_thread_tasks_in_flight += gang_posted;
+            made_progress = true;
+        }
+        int reserved = reserved_block_[thread_idx];
+
+        // Load balancing: Skip dispatch if all my cores' slots are full
+        if (cur_thread_tasks_in_flight < core_num * handshake_depth_) {
+            // Phase 2: Dispatch new tasks from matching ready queue to cores
+            // with a free slot. Idle cores are filled first so prefetching
+            // never delays a task that could start right away.
+            for (int depth = 1; depth <= handshake_depth_; depth++) {
+                for (int i = 0; i < core_num; i++) {
+                    int core_id = cur_thread_cores[i];
+
+                    if (dispatched_[core_id] - retired_[core_id] >= static_cast<uint32_t>(depth) ||
+                        core_block_[core_id] == reserved) {
+                        continue;
+                    }
 
-                // Core is idle and available (idle + task is null)
-                if (h->task_status == 0 && h->task == 0) {
                     // Dispatch from matching queue based on core type
-                    if (h->core_type == 0) {  // AIC core
-                        if (ready_count_aic_.load(std::memory_order_acquire) > 0) {
-                            std::lock_guard<std::mutex> lock(ready_queue_aic_mutex_);
-                            int count = ready_count_aic_.load(std::memory_order_relaxed);
-                            if (count > 0) {
-                                ready_count_aic_.fetch_sub(1, std::memory_order_release);
-                                int task_id = ready_queue_aic_[count - 1];
-                                Task* task = runtime.get_task(task_id);
-
-                                DEV_INFO("Thread %d: Dispatching AIC task %d to core %d", thread_idx, task_id, core_id);
-
-                                h->task = reinterpret_cast<uint64_t>(task);
-                                h->task_status = 1;  // Mark as busy
-                                cur_thread_tasks_in_flight++;
-                                made_progress = true;
-                            }
-                        }
-                    } else if (h->core_type == 1) {  // AIV core
-                        if (ready_count_aiv_.load(std::memory_order_acquire) > 0) {
-                            std::lock_guard<std::mutex> lock(ready_queue_aiv_mutex_);
-                            int count = ready_count_aiv_.load(std::memory_order_relaxed);
-                            if (count > 0) {
-                                ready_count_aiv_.fetch_sub(1, std::memory_order_release);
-                                int task_id = ready_queue_aiv_[count - 1];
-                                Task* task = runtime.get_task(task_id);
-
-                                DEV_INFO("Thread %d: Dispatching AIV task %d to core %d", thread_idx, task_id, core_id);
-
-                                h->task = reinterpret_cast<uint64_t>(task);
-                                h->task_status = 1;  // Mark as busy
-                                cur_thread_tasks_in_flight++;
-                                made_progress = true;
-                            }
+                    int core_type = core_type_[core_id];
+                    int task_id;
+                    if ((core_type == 0 || core_type == 1) && dequeue_ready(thread_idx, core_type, &task_id)) {
+                        Task* task = runtime.get_task(task_id);
+                        int target = pick_core(thread_idx, task, core_id, depth);
+                        if (core_block_[target] == reserved) {
+                            target = core_id;
                         }
+
+                        DEV_DEBUG("Thread %d: Dispatching %s task %d to core %d",
+                            thread_idx, core_type == 0 ? "AIC" : "AIV", task_id, target);
+
+                        post_task(hank, target, task);
+                        note_dispatch(thread_idx, task);
+                        cur_thread_tasks_in_flight++;
+                        made_progress = true;
                     }
                 }
             }
         }
 
-        // Timeout detection: track idle iterations when no progress
-        if (!made_progress) {
-            idle_iterations++;
-            if (idle_iterations % WARN_INTERVAL == 0) {
-                int current = completed_tasks_.load(std::memory_order_acquire);
-                DEV_WARN("Thread %d: %d idle iterations, progress %d/%d tasks",
-                        thread_idx, idle_iterations, current, task_count);
+        // Phase 3 (CORE_PARTITION_DYNAMIC): a thread whose cores have
+        // drained takes over a block, either one nobody has claimed yet or
+        // one handed off by a thread whose slots are all full. A handed-off
+        // block nobody is hungry for anymore goes to whoever comes first.
+        if (dynamic_partition_) {
+            set_hungry(thread_idx, cur_thread_tasks_in_flight == 0 && !made_progress);
+            int released = released_blocks_.load(std::memory_order_relaxed);
+            int hungry = hungry_threads_.load(std::memory_order_relaxed);
+            bool take = (released > 0 && (hungry_[thread_idx] || hungry == 0)) ||
+                        (hungry_[thread_idx] && claim_cursor_.load(std::memory_order_relaxed) < block_dim_);
+            bool moved = false;
+            if (take && claim_block(&runtime, thread_idx) >= 0) {
+                made_progress = true;
+                moved = true;
+            } else if (!hungry_[thread_idx] && hungry > released && thread_block_num_[thread_idx] > 1 &&
+                       cur_thread_tasks_in_flight >= core_num * handshake_depth_) {
+                release_block(thread_idx);
+                moved = true;
             }
-            if (idle_iterations > MAX_IDLE_ITERATIONS) {
-                DEV_ERROR("Thread %d: Timeout after %d idle iterations!", thread_idx, idle_iterations);
-                diagnose_stuck_state(runtime, thread_idx, cur_thread_cores, core_num, hank);
-                return -1;
+            if (moved) {
+                core_num = thread_cores_num_[thread_idx];
+                cur_thread_tasks_in_flight = tasks_in_flight(thread_idx);
+            }
+        }
+
+        // Timeout detection: track idle iterations when no progress. Waiting
+        // for the host to publish more tasks is not a stall.
+        if (!made_progress) {
+            aicpu_idle();
+            stats->idle_iterations++;
+            if (task_count != STREAM_OPEN) {
+                idle_iterations++;
+                if (idle_iterations % WARN_INTERVAL == 0) {
+                    int current = completed_tasks_.load(std::memory_order_acquire);
+                    DEV_WARN("Thread %d: %d idle iterations, progress %d/%d tasks",
+                            thread_idx, idle_iterations, current, task_count);
+                }
+                if (idle_iterations > MAX_IDLE_ITERATIONS) {
+                    DEV_ERROR("Thread %d: Timeout after %d idle iterations!", thread_idx, idle_iterations);
+                    diagnose_stuck_state(runtime, thread_idx, cur_thread_cores, core_num, hank);
+                    return -1;
+                }
             }
         } else {
             idle_iterations = 0;
         }
     }
 
+    stats->run_ticks = get_sys_cnt_aicpu() - run_start;
+    stats->tasks_completed = cur_thread_completed;
     DEV_INFO("Thread %d: Execution complete, completed %d tasks", thread_idx, cur_thread_completed);
     return cur_thread_completed;
 }
 
 int AicpuExecutor::run(Runtime* runtime) {
     int thread_idx = thread_idx_++;
+    // Each partition logs into its own group of rings
+    DeviceLogScope log_scope(reinterpret_cast<void*>(runtime->device_log_buffer), runtime->partition, thread_idx);
 
     DEV_INFO("Thread %d: Start", thread_idx);
 
-    const int* cur_thread_cores = core_assignments_[thread_idx];
-
-    auto rc = hank_aicore(runtime, thread_idx, cur_thread_cores);
-    if (rc != 0) {
-        return rc;
-    }
-
-    DEV_INFO("Thread %d: Runtime has %d tasks", thread_idx, runtime->get_task_count());
-    int completed = resolve_and_dispatch(*runtime, thread_idx, cur_thread_cores, thread_cores_num_);
-    DEV_INFO("Thread %d: Executed %d tasks from runtime", thread_idx, completed);
+    if (thread_idx < thread_num_) {
+        // Dynamic: claim this thread's share of the blocks still free; the
+        // rest of the split follows the load during the run
+        if (dynamic_partition_) {
+            int share = sched_thread_first_block(thread_idx + 1, block_dim_, thread_num_) -
+                        sched_thread_first_block(thread_idx, block_dim_, thread_num_);
+            for (int i = 0; i < share && claim_block(runtime, thread_idx) >= 0; i++) {
+            }
+        } else {
+            auto rc = hank_aicore(runtime, thread_idx, core_assignments_[thread_idx], thread_cores_num_[thread_idx]);
+            if (rc != 0) {
+                return rc;
+            }
+        }
 
-    rc = shutdown_aicore(runtime, thread_idx, cur_thread_cores);
-    if (rc != 0) {
-        return rc;
+        DEV_INFO("Thread %d: Runtime has %d tasks", thread_idx, runtime->get_task_count());
+        int completed =
+            (runtime->scheduling_mode == SCHEDULE_AICORE_PULL)
+                ? wait_pull_completion(*runtime, thread_idx, core_assignments_[thread_idx],
+                      thread_cores_num_[thread_idx])
+                : resolve_and_dispatch(*runtime, thread_idx);
+        DEV_INFO("Thread %d: Executed %d tasks from runtime", thread_idx, completed);
+        set_hungry(thread_idx, false);
+
+        auto rc = shutdown_aicore(runtime, thread_idx, core_assignments_[thread_idx], thread_cores_num_[thread_idx]);
+        if (rc != 0) {
+            return rc;
+        }
+    } else {
+        DEV_INFO("Thread %d: No blocks left for this thread (block_dim=%d)", thread_idx, block_dim_);
     }
 
     DEV_INFO("Thread %d: Completed", thread_idx);
-
-    // Check if this is the last thread to finish
-    int prev_finished = finished_count_.fetch_add(1, std::memory_order_acq_rel);
-    if (prev_finished + 1 == thread_num_) {
-        finished_.store(true, std::memory_order_release);
-        DEV_INFO("Thread %d: Last thread, marking executor finished", thread_idx);
-    }
-
     return 0;
 }
 
 void AicpuExecutor::deinit() {
     // Cleanup runtime execution state
-    ready_count_aic_.store(0, std::memory_order_release);
-    ready_count_aiv_.store(0, std::memory_order_release);
     completed_tasks_.store(0, std::memory_order_release);
     total_tasks_.store(0, std::memory_order_release);
     finished_count_.store(0, std::memory_order_release);
@@ -446,7 +1314,6 @@ void AicpuExecutor::deinit() {
     init_done_.store(false, std::memory_order_release);
     init_failed_.store(false, std::memory_order_release);
     thread_idx_.store(0, std::memory_order_release);
-    finished_.store(false, std::memory_order_release);
 
     DEV_INFO("DeInit: AicpuExecutor reset complete");
 }
@@ -461,9 +1328,10 @@ void AicpuExecutor::diagnose_stuck_state(Runtime& runtime, int thread_idx,
     DEV_ERROR("Progress: %d/%d tasks (%.1f%%)",
              completed, total, total > 0 ? completed * 100.0 / total : 0.0);
 
-    int aic_ready = ready_count_aic_.load(std::memory_order_acquire);
-    int aiv_ready = ready_count_aiv_.load(std::memory_order_acquire);
-    DEV_ERROR("Ready Queues: AIC=%d, AIV=%d", aic_ready, aiv_ready);
+    int aic_ready = ready_count(0);
+    int aiv_ready = ready_count(1);
+    int block_ready = ready_count(BLOCK_TASK);
+    DEV_ERROR("Ready Queues: AIC=%d, AIV=%d, BLOCK=%d", aic_ready, aiv_ready, block_ready);
 
     int busy_cores = 0;
     int idle_cores = 0;
@@ -475,19 +1343,22 @@ void AicpuExecutor::diagnose_stuck_state(Runtime& runtime, int thread_idx,
         Handshake* h = &hank[core_id];
 
         const char* core_type_str = (h->core_type == 0) ? "AIC" : "AIV";
+        uint32_t core_completed = h->complete_seq;
 
-        if (h->task != 0) {
-            Task* task = reinterpret_cast<Task*>(h->task);
+        if (core_completed - retired_[core_id] > dispatched_[core_id] - retired_[core_id]) {
+            anomaly_cores++;
+            DEV_ERROR("  Core %d [%s, ANOMALY]: completed=%u beyond dispatched=%u",
+                     core_id, core_type_str, core_completed, dispatched_[core_id]);
+        } else if (retired_[core_id] != dispatched_[core_id]) {
+            Task* task = reinterpret_cast<Task*>(h->slot_task[retired_[core_id] % RUNTIME_HANDSHAKE_SLOTS]);
             busy_cores++;
 
-            DEV_ERROR("  Core %d [%s, BUSY]: task_id=%d, func_id=%d, fanin=%d, fanout=%d",
+            DEV_ERROR("  Core %d [%s, BUSY]: task_id=%d, func_id=%d, fanin=%d, fanout=%d, queued=%u",
                      core_id, core_type_str,
                      task->task_id, task->func_id,
                      task->fanin.load(std::memory_order_acquire),
-                     task->fanout_count);
-        } else if (h->task_status != 0) {
-            anomaly_cores++;
-            DEV_ERROR("  Core %d [%s, ANOMALY]: status=BUSY but task=NULL", core_id, core_type_str);
+                     task->fanout_count,
+                     dispatched_[core_id] - retired_[core_id]);
         } else {
             idle_cores++;
         }
@@ -496,7 +1367,7 @@ void AicpuExecutor::diagnose_stuck_state(Runtime& runtime, int thread_idx,
     DEV_ERROR("Summary: %d busy, %d idle, %d anomaly", busy_cores, idle_cores, anomaly_cores);
 
     // Diagnose deadlock vs livelock
-    if (busy_cores == 0 && aic_ready == 0 && aiv_ready == 0 && completed < total) {
+    if (busy_cores == 0 && aic_ready == 0 && aiv_ready == 0 && block_ready == 0 && completed < total) {
         DEV_ERROR("*** DEADLOCK DETECTED ***");
         DEV_ERROR("All cores idle, no ready tasks, but %d tasks incomplete", total - completed);
 
@@ -528,14 +1399,18 @@ void AicpuExecutor::diagnose_stuck_state(Runtime& runtime, int thread_idx,
  *
  * This is called by DynTileFwkBackendKernelServer in kernel.cpp.
  * Orchestrates the complete task runtime execution:
- * 1. Initialize executor (thread-safe, first thread only)
+ * 1. Initialize the executor of the runtime's partition (thread-safe, first
+ *    thread only)
  * 2. Wait for initialization to complete
  * 3. Execute tasks on managed cores
- * 4. Cleanup when last thread finishes
+ * 4. Cleanup when the last thread leaves, also after a failure; a failed
+ *    launch releases all cores first so that the AICore kernels return
  *
  * @param runtime Pointer to Runtime structure containing:
  *                - workers[]: handshake buffers for AICPU-AICore communication
  *                - block_dim, sche_cpu_num: execution parameters
+ *                - partition: executor slot, distinct for runtimes that
+ *                  execute at the same time
  *                - tasks[]: task runtime to execute
  * @return 0 on success, non-zero on error
  */
@@ -545,29 +1420,103 @@ extern "C" int aicpu_execute(Runtime* runtime) {
         return -1;
     }
 
+    if (runtime->partition < 0 || runtime->partition >= RUNTIME_MAX_PARTITIONS) {
+        DEV_ERROR("Invalid partition %d (max %d)", runtime->partition, RUNTIME_MAX_PARTITIONS);
+        return -1;
+    }
+
     DEV_INFO("%s", "aicpu_execute: Starting AICPU kernel execution");
 
-    g_aicpu_executor.init(runtime);
+    AicpuExecutor& executor = g_aicpu_executors[runtime->partition];
+    executor.init(runtime);
 
-    while (!g_aicpu_executor.init_done_.load(std::memory_order_acquire)) {
-        if (g_aicpu_executor.init_failed_.load(std::memory_order_acquire)) {
+    int rc = 0;
+    while (!executor.init_done_.load(std::memory_order_acquire)) {
+        if (executor.init_failed_.load(std::memory_order_acquire)) {
             DEV_ERROR("%s", "aicpu_execute: Initialization failed, aborting execution");
-            return -1;
+            rc = -1;
+            break;
         }
+        aicpu_idle();
     }
 
-    int rc = g_aicpu_executor.run(runtime);
+    if (rc == 0) {
+        rc = executor.run(runtime);
+        if (rc != 0) {
+            DEV_ERROR("aicpu_execute: Thread execution failed with rc=%d", rc);
+        }
+    }
     if (rc != 0) {
-        DEV_ERROR("aicpu_execute: Thread execution failed with rc=%d", rc);
-        return rc;
+        executor.release_aicore(runtime);
     }
 
-    // Last thread cleans up
-    if (g_aicpu_executor.finished_.load(std::memory_order_acquire)) {
+    // Last thread to leave cleans up, so the next launch initializes afresh
+    int launched = runtime->sche_cpu_num > 0 ? runtime->sche_cpu_num : 1;
+    if (executor.finished_count_.fetch_add(1, std::memory_order_acq_rel) + 1 == launched) {
         DEV_INFO("aicpu_execute: Last thread finished, cleaning up");
-        g_aicpu_executor.deinit();
+        executor.deinit();
     }
 
-    DEV_INFO("%s", "aicpu_execute: Kernel execution completed successfully");
-    return 0;
+    if (rc == 0) {
+        DEV_INFO("%s", "aicpu_execute: Kernel execution completed successfully");
+    }
+    return rc;
+}
+
+// Persistent mode: AICPU threads that finished the current submission
+static std::atomic<int> g_persistent_finished{0};
+
+/**
+ * Persistent AICPU scheduler loop
+ *
+ * Every launched AICPU thread calls this once. Each submission rung on the
+ * doorbell is executed with aicpu_execute(). The last thread to finish
+ * waits for all AICores to acknowledge the graph and then publishes
+ * done_seq. Returns when shutdown is requested while idle.
+ *
+ * @param doorbell  Doorbell in device memory
+ * @return 0 on success, non-zero if any submitted graph failed
+ */
+extern "C" int aicpu_execute_persistent(ExecutorDoorbell* doorbell) {
+    if (doorbell == nullptr) {
+        DEV_ERROR("%s", "Invalid doorbell argument: null pointer");
+        return -1;
+    }
+
+    uint32_t seen = 0;
+    int result = 0;
+    while (true) {
+        if (doorbell->submit_seq == seen) {
+            if (doorbell->shutdown == 1) {
+                break;
+            }
+            aicpu_idle();
+            continue;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        seen++;
+
+        Runtime* runtime = reinterpret_cast<Runtime*>(doorbell->runtime);
+        int rc = aicpu_execute(runtime);
+        if (rc != 0) {
+            doorbell->status = rc;
+            result = rc;
+        }
+
+        int thread_num = runtime->sche_cpu_num;
+        if (g_persistent_finished.fetch_add(1, std::memory_order_acq_rel) + 1 == thread_num) {
+            g_persistent_finished.store(0, std::memory_order_relaxed);
+            for (int i = 0; i < runtime->worker_count; i++) {
+                while (doorbell->core_seq[i] != seen) {
+                    aicpu_idle();
+                }
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            doorbell->done_seq = seen;
+            DEV_INFO("aicpu_execute_persistent: Submission %u done", seen);
+        }
+    }
+
+    DEV_INFO("%s", "aicpu_execute_persistent: Shutdown");
+    return result;
 }
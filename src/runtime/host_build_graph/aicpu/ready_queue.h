@@ -0,0 +1,377 @@
+/**
+ * Lock-free Ready Queue for AICPU Scheduler Threads
+ *
+ * Bounded multi-producer/multi-consumer queue of task IDs, shared by all
+ * AICPU scheduler threads of one core type. Two orderings are supported and
+ * selected at init():
+ *
+ * - READY_QUEUE_LIFO: Treiber stack. Nodes are the task IDs themselves and
+ *   links live in a per-task next[] array; the head carries an update tag in
+ *   its upper 32 bits to rule out ABA.
+ * - READY_QUEUE_FIFO: ticketed ring buffer (one sequence number per cell).
+ *   Producers and consumers take tickets with a CAS on separate cache lines.
+ *
+ * Both variants rely on each task being pushed at most once per launch, so a
+ * capacity of task_count is always sufficient and push() cannot fail in
+ * practice.
+ *
+ * WorkStealingDeque is the per-thread queue used by READY_QUEUE_STEALING: a
+ * bounded Chase-Lev deque whose owner pushes and takes at the bottom while
+ * other scheduler threads steal from the top.
+ *
+ * PriorityReadyQueue backs READY_QUEUE_PRIORITY: task priorities are mapped
+ * onto a fixed number of buckets, each a FIFO ring, and a bitmap of
+ * non-empty buckets lets pop() find the highest one with a single load.
+ */
+
+#ifndef READY_QUEUE_H
+#define READY_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "runtime.h"
+
+class ReadyQueue {
+public:
+    /**
+     * Prepare the queue for a launch
+     *
+     * Not thread-safe: must complete before any thread calls push()/pop().
+     * Storage is kept across launches and only grows.
+     *
+     * @param capacity  Maximum number of task IDs (the launch's task count)
+     * @param policy    READY_QUEUE_LIFO or READY_QUEUE_FIFO
+     */
+    void init(int capacity, int policy) {
+        policy_ = policy;
+
+        int ring_size = 1;
+        while (ring_size < capacity) {
+            ring_size <<= 1;
+        }
+        if (ring_size > capacity_) {
+            cells_.reset(new Cell[ring_size]);
+            next_.reset(new std::atomic<int>[ring_size]);
+            capacity_ = ring_size;
+        }
+        mask_ = static_cast<uint64_t>(ring_size - 1);
+
+        for (int i = 0; i < ring_size; i++) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos_.store(0, std::memory_order_relaxed);
+        dequeue_pos_.store(0, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_release);
+    }
+
+    /**
+     * Add a ready task
+     *
+     * @param task_id  Task ID in [0, capacity)
+     * @return true on success, false if the queue is full
+     */
+    bool push(int task_id) { return policy_ == READY_QUEUE_FIFO ? ring_push(task_id) : stack_push(task_id); }
+
+    /**
+     * Take a ready task
+     *
+     * @param task_id  Output: dequeued task ID
+     * @return true if a task was dequeued, false if the queue is empty
+     */
+    bool pop(int* task_id) { return policy_ == READY_QUEUE_FIFO ? ring_pop(task_id) : stack_pop(task_id); }
+
+    /**
+     * Approximate number of queued tasks (diagnostics only)
+     *
+     * Exact when no other thread is pushing or popping concurrently.
+     */
+    int approx_size() const {
+        if (policy_ == READY_QUEUE_FIFO) {
+            return static_cast<int>(enqueue_pos_.load(std::memory_order_acquire) -
+                                    dequeue_pos_.load(std::memory_order_acquire));
+        }
+        int count = 0;
+        int idx = static_cast<int>(head_.load(std::memory_order_acquire) & 0xFFFFFFFFu) - 1;
+        while (idx >= 0 && count < capacity_) {
+            count++;
+            idx = next_[idx].load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> seq;
+        int task_id;
+    };
+
+    // ===== FIFO: ticketed ring =====
+
+    bool ring_push(int task_id) {
+        uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            uint64_t seq = cell->seq.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->task_id = task_id;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool ring_pop(int* task_id) {
+        uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            uint64_t seq = cell->seq.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        *task_id = cell->task_id;
+        cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ===== LIFO: tagged Treiber stack =====
+    // head_ = (tag << 32) | (task_id + 1); low half 0 means empty
+
+    bool stack_push(int task_id) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        uint64_t node;
+        do {
+            next_[task_id].store(static_cast<int>(head & 0xFFFFFFFFu) - 1, std::memory_order_relaxed);
+            node = (((head >> 32) + 1) << 32) | static_cast<uint32_t>(task_id + 1);
+        } while (!head_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+        return true;
+    }
+
+    bool stack_pop(int* task_id) {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t node;
+        int idx;
+        do {
+            idx = static_cast<int>(head & 0xFFFFFFFFu) - 1;
+            if (idx < 0) {
+                return false;  // Empty
+            }
+            int next = next_[idx].load(std::memory_order_relaxed);
+            node = (((head >> 32) + 1) << 32) | static_cast<uint32_t>(next + 1);
+        } while (!head_.compare_exchange_weak(head, node, std::memory_order_acquire, std::memory_order_acquire));
+        *task_id = idx;
+        return true;
+    }
+
+    int policy_{READY_QUEUE_LIFO};
+    int capacity_{0};
+    uint64_t mask_{0};
+    std::unique_ptr<Cell[]> cells_;
+    std::unique_ptr<std::atomic<int>[]> next_;
+
+    // Producer and consumer positions on separate cache lines
+    alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+    alignas(64) std::atomic<uint64_t> dequeue_pos_{0};
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+
+class WorkStealingDeque {
+public:
+    /**
+     * Prepare the deque for a launch
+     *
+     * Not thread-safe: must complete before any thread uses the deque.
+     *
+     * @param capacity  Maximum number of task IDs held at once
+     */
+    void init(int capacity) {
+        int size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        if (size > capacity_) {
+            buffer_.reset(new std::atomic<int>[size]);
+            capacity_ = size;
+        }
+        mask_ = size - 1;
+        top_.store(0, std::memory_order_relaxed);
+        bottom_.store(0, std::memory_order_release);
+    }
+
+    /**
+     * Owner only: add a task at the bottom
+     *
+     * @return true on success, false if the deque is full
+     */
+    bool push(int task_id) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t > mask_) {
+            return false;
+        }
+        buffer_[b & mask_].store(task_id, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * Owner only: take the most recently pushed task
+     *
+     * @return true if a task was taken, false if the deque is empty
+     */
+    bool take(int* task_id) {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;  // Empty
+        }
+        int value = buffer_[b & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last element: race against thieves
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (!won) {
+                return false;
+            }
+        }
+        *task_id = value;
+        return true;
+    }
+
+    /**
+     * Any thread: take the oldest task
+     *
+     * @return true if a task was stolen, false if empty or the race was lost
+     */
+    bool steal(int* task_id) {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;  // Empty
+        }
+        int value = buffer_[t & mask_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        *task_id = value;
+        return true;
+    }
+
+    /**
+     * Approximate number of queued tasks (diagnostics only)
+     */
+    int approx_size() const {
+        int64_t size = bottom_.load(std::memory_order_acquire) - top_.load(std::memory_order_acquire);
+        return size > 0 ? static_cast<int>(size) : 0;
+    }
+
+private:
+    int capacity_{0};
+    int64_t mask_{0};
+    std::unique_ptr<std::atomic<int>[]> buffer_;
+
+    // Thieves hit top_, the owner hits bottom_; keep them apart
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+};
+
+constexpr int READY_QUEUE_PRIORITY_BUCKETS = 64;
+
+class PriorityReadyQueue {
+public:
+    /**
+     * Prepare the queue for a launch
+     *
+     * Not thread-safe: must complete before any thread calls push()/pop().
+     *
+     * @param bucket_capacity  Number of tasks mapped to each bucket
+     */
+    void init(const int* bucket_capacity) {
+        for (int b = 0; b < READY_QUEUE_PRIORITY_BUCKETS; b++) {
+            buckets_[b].init(bucket_capacity[b], READY_QUEUE_FIFO);
+        }
+        non_empty_.store(0, std::memory_order_release);
+    }
+
+    /**
+     * Add a ready task to a bucket
+     *
+     * @param task_id  Task ID
+     * @param bucket   Bucket index; higher buckets are dispatched first
+     * @return true on success, false if the bucket is full
+     */
+    bool push(int task_id, int bucket) {
+        if (!buckets_[bucket].push(task_id)) {
+            return false;
+        }
+        non_empty_.fetch_or(1ULL << bucket, std::memory_order_seq_cst);
+        return true;
+    }
+
+    /**
+     * Take a task from the highest non-empty bucket
+     *
+     * @param task_id  Output: dequeued task ID
+     * @return true if a task was dequeued, false if all buckets are empty
+     */
+    bool pop(int* task_id) {
+        uint64_t mask = non_empty_.load(std::memory_order_acquire);
+        while (mask != 0) {
+            int bucket = 63 - __builtin_clzll(mask);
+            if (buckets_[bucket].pop(task_id)) {
+                return true;
+            }
+
+            // Bucket looked empty: clear its bit, then re-check so a push that
+            // raced with the clear is not hidden
+            uint64_t bit = 1ULL << bucket;
+            non_empty_.fetch_and(~bit, std::memory_order_seq_cst);
+            if (buckets_[bucket].approx_size() > 0) {
+                non_empty_.fetch_or(bit, std::memory_order_seq_cst);
+            }
+            mask = non_empty_.load(std::memory_order_acquire) & (bit - 1);
+        }
+        return false;
+    }
+
+    /**
+     * Approximate number of queued tasks (diagnostics only)
+     */
+    int approx_size() const {
+        int count = 0;
+        for (int b = 0; b < READY_QUEUE_PRIORITY_BUCKETS; b++) {
+            count += buckets_[b].approx_size();
+        }
+        return count;
+    }
+
+private:
+    ReadyQueue buckets_[READY_QUEUE_PRIORITY_BUCKETS];
+    alignas(64) std::atomic<uint64_t> non_empty_{0};
+};
+
+#endif  // READY_QUEUE_H
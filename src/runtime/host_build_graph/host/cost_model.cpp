@@ -0,0 +1,542 @@
+/**
+ * Cost Model - Offline Performance Prediction
+ *
+ * Provides predict_runtime_impl, which replays a built task graph in a
+ * discrete-event model of the device instead of running it:
+ *   - Every AICore has a virtual clock. A posted task starts once it has
+ *     crossed the handshake and the core finished everything posted
+ *     before it, and runs for its modelled kernel latency.
+ *   - Every AICPU scheduler thread is a serial agent that owns the cores
+ *     of its blocks like AicpuExecutor: it retires visible completions
+ *     first, then posts gang tasks to fully idle blocks, then fills free
+ *     handshake slots (idle cores first). Each retire and dispatch
+ *     occupies the thread for its modelled cost.
+ *   - Ready queues follow the runtime's ReadyQueuePolicy.
+ *
+ * Agents are advanced in virtual time order, and the effects of an
+ * operation (posting a task, releasing successors) take place when the
+ * operation ends, so no agent observes an event before it happened.
+ */
+
+#include "runtime.h"
+#include "host/pto_runtime_c_api.h"
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const int GANG = static_cast<int>(CoreType::BLOCK);
+const double NEVER = std::numeric_limits<double>::infinity();
+
+/**
+ * Ready queues of the modelled scheduler, ordered like AicpuExecutor's
+ */
+class ModelReadyQueues {
+public:
+    ModelReadyQueues(const Runtime* runtime, int policy, int thread_count)
+        : runtime_(runtime), policy_(policy), thread_count_(thread_count) {}
+
+    void push(int thread, int task_id) {
+        int core_type = runtime_->tasks[task_id].core_type;
+        count_[core_type]++;
+        if (core_type == GANG || (policy_ != READY_QUEUE_STEALING && policy_ != READY_QUEUE_PRIORITY)) {
+            shared_[core_type].push_back(task_id);
+        } else if (policy_ == READY_QUEUE_PRIORITY) {
+            int64_t order = static_cast<int64_t>(priority_ids_[core_type].size());
+            priority_[core_type].push(std::make_pair(runtime_->tasks[task_id].priority, -order));
+            priority_ids_[core_type].push_back(task_id);
+        } else {
+            local_[thread][core_type].push_back(task_id);
+        }
+    }
+
+    bool pop(int thread, int core_type, int* task_id) {
+        if (count_[core_type] == 0) {
+            return false;
+        }
+        count_[core_type]--;
+        if (core_type == GANG || (policy_ != READY_QUEUE_STEALING && policy_ != READY_QUEUE_PRIORITY)) {
+            // The gang queue is LIFO only under READY_QUEUE_LIFO
+            std::deque<int>& queue = shared_[core_type];
+            bool lifo = core_type == GANG ? policy_ == READY_QUEUE_LIFO : policy_ != READY_QUEUE_FIFO;
+            *task_id = lifo ? queue.back() : queue.front();
+            lifo ? queue.pop_back() : queue.pop_front();
+            return true;
+        }
+        if (policy_ == READY_QUEUE_PRIORITY) {
+            // Highest priority first, oldest first among equals
+            *task_id = priority_ids_[core_type][static_cast<size_t>(-priority_[core_type].top().second)];
+            priority_[core_type].pop();
+            return true;
+        }
+        // Own deque newest first, then steal the oldest task of a neighbour
+        if (!local_[thread][core_type].empty()) {
+            *task_id = local_[thread][core_type].back();
+            local_[thread][core_type].pop_back();
+            return true;
+        }
+        for (int i = 1; i < thread_count_; i++) {
+            std::deque<int>& victim = local_[(thread + i) % thread_count_][core_type];
+            if (!victim.empty()) {
+                *task_id = victim.front();
+                victim.pop_front();
+                return true;
+            }
+        }
+        count_[core_type]++;
+        return false;
+    }
+
+    int count(int core_type) const { return count_[core_type]; }
+
+private:
+    const Runtime* runtime_;
+    int policy_;
+    int thread_count_;
+    int count_[3] = {0, 0, 0};
+    std::deque<int> shared_[3];
+    std::deque<int> local_[RUNTIME_MAX_SCHED_THREADS][2];
+    std::priority_queue<std::pair<int, int64_t>> priority_[2];  // (priority, -push order)
+    std::vector<int> priority_ids_[2];                          // Task of each push order
+};
+
+struct ModelCore {
+    int core_type;
+    int block;
+    double free_at = 0;   // End of the last posted task
+    double busy = 0;      // Kernel time
+    int in_flight = 0;    // Posted but not yet retired (the AICPU's view)
+    std::deque<std::pair<double, int>> done;  // (visible to the AICPU at, task) in completion order
+};
+
+// Operation of an agent whose effect is applied when it ends
+enum ModelOp { OP_NONE, OP_RETIRE, OP_DISPATCH, OP_GANG, OP_PULL };
+
+struct ModelAgent {
+    double clock = 0;     // End of the current operation, or when it next looks for work
+    bool waiting = false; // Idle until a completion on its cores or a ready push
+    double wake = NEVER;  // While waiting: next completion on its cores
+    double busy = 0;
+    ModelOp op = OP_NONE;
+    int op_core = -1;
+    int op_task = -1;
+    std::vector<int> cores;
+};
+
+/**
+ * Discrete-event replay of one graph
+ */
+class GraphModel {
+public:
+    GraphModel(Runtime* runtime, const CostModel* model, int thread_count, int block_dim)
+        : runtime_(runtime), model_(model), block_dim_(block_dim),
+          queues_(runtime, model->ready_queue_policy >= 0 ? model->ready_queue_policy : runtime->ready_queue_policy,
+              thread_count) {
+        task_count_ = runtime->get_task_count();
+        scheduled_count_ = runtime->get_scheduled_task_count();
+        depth_ = model->handshake_depth > 0 ? model->handshake_depth : runtime->handshake_depth;
+        if (depth_ < 1) depth_ = 1;
+        if (depth_ > RUNTIME_HANDSHAKE_SLOTS) depth_ = RUNTIME_HANDSHAKE_SLOTS;
+        pull_ = runtime->scheduling_mode == SCHEDULE_AICORE_PULL;
+
+        cores_.resize(block_dim * 3);
+        for (int b = 0; b < block_dim; b++) {
+            cores_[b].core_type = 0;
+            cores_[b].block = b;
+            for (int k = 0; k < 2; k++) {
+                cores_[block_dim + b * 2 + k].core_type = 1;
+                cores_[block_dim + b * 2 + k].block = b;
+            }
+        }
+
+        // Each scheduler thread owns the AICs, then the AIVs of its static
+        // block range (CORE_PARTITION_DYNAMIC is modelled the same way); in
+        // pull mode every core is an agent of its own
+        agents_.resize(pull_ ? cores_.size() : thread_count);
+        for (size_t a = 0; a < agents_.size(); a++) {
+            if (pull_) {
+                agents_[a].cores.push_back(static_cast<int>(a));
+                continue;
+            }
+            int t = static_cast<int>(a);
+            int start_block = sched_thread_first_block(t, block_dim, thread_count);
+            int end_block = sched_thread_first_block(t + 1, block_dim, thread_count);
+            for (int b = start_block; b < end_block; b++) {
+                agents_[a].cores.push_back(b);
+            }
+            for (int b = start_block; b < end_block; b++) {
+                agents_[a].cores.push_back(block_dim + b * 2);
+                agents_[a].cores.push_back(block_dim + b * 2 + 1);
+            }
+        }
+
+        fanin_.resize(task_count_);
+        ready_at_.assign(task_count_, 0.0);
+        gang_left_.assign(task_count_, 0);
+    }
+
+    int validate() const {
+        for (int i = 0; i < task_count_; i++) {
+            const Task* task = runtime_->get_task(i);
+            if (pull_ && task->core_type == GANG) {
+                std::cerr << "Error: Task " << i << ": block tasks are not supported with pull scheduling\n";
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    int run(RuntimePrediction* out) {
+        // Seed like AicpuExecutor::init: roots dealt round-robin per core type
+        int dealt[3] = {0, 0, 0};
+        for (int i = 0; i < task_count_; i++) {
+            const Task* task = runtime_->get_task(i);
+            fanin_[i] = task->initial_fanin;
+            if (task->fused_head >= 0) {
+                continue;  // Runs inside its chain head
+            }
+            total_work_ += latency(task) * (task->core_type == GANG ? 3 : 1);
+            if (fanin_[i] == 0) {
+                int thread = pull_ || task->core_type == GANG ? 0 : dealt[task->core_type]++ % agent_count();
+                queues_.push(thread, i);
+            }
+        }
+
+        int completed = 0;
+        while (completed < scheduled_count_) {
+            size_t next = pick_agent();
+            if (next == agents_.size()) {
+                std::cerr << "Error: Prediction stalled at " << completed << "/" << scheduled_count_
+                          << " tasks (cyclic graph or unplaceable tasks)\n";
+                return -1;
+            }
+            ModelAgent& agent = agents_[next];
+            if (agent.waiting) {
+                agent.clock = agent.wake;
+                agent.waiting = false;
+            }
+            completed += apply(static_cast<int>(next));
+            if (completed < scheduled_count_) {
+                choose(static_cast<int>(next));
+            }
+        }
+
+        out->task_count = scheduled_count_;
+        out->makespan_us = makespan_;
+        out->total_work_us = total_work_;
+        out->critical_path_us = critical_path();
+        if (scheduled_count_ > 0) {
+            out->avg_ready_wait_us = ready_wait_ / scheduled_count_;
+        }
+        for (size_t a = 0; a < agents_.size() && !pull_ && a < PTO_PREDICTION_MAX_THREADS; a++) {
+            out->thread_busy_fraction[a] = makespan_ > 0 ? agents_[a].busy / makespan_ : 0;
+        }
+        for (size_t c = 0; c < cores_.size() && c < PTO_RUNTIME_STATS_MAX_CORES; c++) {
+            out->core_busy_fraction[c] = makespan_ > 0 ? cores_[c].busy / makespan_ : 0;
+        }
+        return 0;
+    }
+
+private:
+    Runtime* runtime_;
+    const CostModel* model_;
+    int block_dim_;
+    int task_count_;
+    int scheduled_count_;  // Without the tasks absorbed into fused chains
+    int depth_;
+    bool pull_;
+    ModelReadyQueues queues_;
+    std::vector<ModelCore> cores_;
+    std::vector<ModelAgent> agents_;
+    std::vector<int> fanin_;
+    std::vector<double> ready_at_;
+    std::vector<int> gang_left_;  // Cores of a posted gang task not yet retired
+    double makespan_ = 0;
+    double total_work_ = 0;
+    double ready_wait_ = 0;
+
+    int agent_count() const { return static_cast<int>(agents_.size()); }
+
+    // Modelled time of a scheduled task: its kernel, plus those of the
+    // members of its fused chain
+    double latency(const Task* task) const {
+        double us = 0;
+        while (true) {
+            us += kernel_latency(task);
+            if (task->fused_next < 0) {
+                return us;
+            }
+            task = runtime_->get_task(task->fused_next);
+        }
+    }
+
+    double kernel_latency(const Task* task) const {
+        if (task->func_id < 0 || task->func_id >= PTO_COST_MODEL_MAX_FUNCS || !model_->kernels[task->func_id].defined) {
+            return model_->default_us;
+        }
+        const KernelCostModel& kernel = model_->kernels[task->func_id];
+        double us = kernel.base_us;
+        if (kernel.bytes_arg >= 0 && kernel.bytes_arg < task->num_args) {
+            us += kernel.us_per_byte * static_cast<double>(runtime_->task_args[task->args_offset + kernel.bytes_arg]);
+        }
+        return us > 0 ? us : 0;
+    }
+
+    // Agent with the earliest next action, agents_.size() if all wait forever
+    size_t pick_agent() const {
+        size_t best = agents_.size();
+        double best_time = NEVER;
+        for (size_t a = 0; a < agents_.size(); a++) {
+            double t = agents_[a].waiting ? agents_[a].wake : agents_[a].clock;
+            if (t < best_time) {
+                best_time = t;
+                best = a;
+            }
+        }
+        return best;
+    }
+
+    // A task became ready: waiting agents look for it now
+    void release(int agent, int task_id, double now) {
+        ready_at_[task_id] = now;
+        queues_.push(pull_ ? 0 : agent, task_id);
+        for (ModelAgent& other : agents_) {
+            if (other.waiting && other.wake > now) {
+                other.wake = now;
+            }
+        }
+    }
+
+    // Retire a finished task and release its successors; returns 1 when the
+    // task is complete
+    int finish(int agent, int task_id, double now) {
+        makespan_ = now > makespan_ ? now : makespan_;
+        Task* task = runtime_->get_task(task_id);
+        int* fanout = runtime_->get_fanout(task);
+        for (int j = 0; j < task->fanout_count; j++) {
+            if (--fanin_[fanout[j]] == 0) {
+                release(agent, fanout[j], now);
+            }
+        }
+        return 1;
+    }
+
+    // Post a task to some cores at `now`; they start it together
+    void post(const int* core_ids, int n, int task_id, double now) {
+        double start = now + model_->handshake_us;
+        for (int k = 0; k < n; k++) {
+            if (cores_[core_ids[k]].free_at > start) start = cores_[core_ids[k]].free_at;
+        }
+        double end = start + latency(runtime_->get_task(task_id));
+        ready_wait_ += start - ready_at_[task_id];
+        for (int k = 0; k < n; k++) {
+            ModelCore& core = cores_[core_ids[k]];
+            core.busy += end - start;
+            core.free_at = end;
+            core.done.push_back(std::make_pair(end + model_->handshake_us, task_id));
+        }
+    }
+
+    // Apply the effect of the agent's finished operation
+    int apply(int a) {
+        ModelAgent& agent = agents_[a];
+        ModelOp op = agent.op;
+        agent.op = OP_NONE;
+        switch (op) {
+            case OP_RETIRE: {
+                ModelCore& core = cores_[agent.op_core];
+                core.in_flight--;
+                if (runtime_->get_task(agent.op_task)->core_type == GANG && --gang_left_[agent.op_task] > 0) {
+                    return 0;
+                }
+                return finish(a, agent.op_task, agent.clock);
+            }
+            case OP_DISPATCH:
+                post(&agent.op_core, 1, agent.op_task, agent.clock);
+                return 0;
+            case OP_GANG: {
+                int block = agent.op_core;
+                int ids[3] = {block, block_dim_ + block * 2, block_dim_ + block * 2 + 1};
+                post(ids, 3, agent.op_task, agent.clock);
+                return 0;
+            }
+            case OP_PULL:
+                return finish(a, agent.op_task, agent.clock);
+            default:
+                return 0;
+        }
+    }
+
+    void start_op(ModelAgent& agent, ModelOp op, int core, int task_id, double cost) {
+        agent.op = op;
+        agent.op_core = core;
+        agent.op_task = task_id;
+        agent.clock += cost;
+        agent.busy += cost;
+    }
+
+    void wait(ModelAgent& agent) {
+        agent.waiting = true;
+        agent.wake = NEVER;
+        for (int core_id : agent.cores) {
+            const ModelCore& core = cores_[core_id];
+            if (!core.done.empty() && core.done.front().first < agent.wake) {
+                agent.wake = core.done.front().first;
+            }
+        }
+    }
+
+    // Start the agent's next operation at its clock, or make it wait
+    void choose(int a) {
+        ModelAgent& agent = agents_[a];
+        double now = agent.clock;
+
+        if (pull_) {
+            // The core claims, runs and releases a task of its own type
+            ModelCore& core = cores_[agent.cores[0]];
+            int task_id;
+            if (!queues_.pop(0, core.core_type, &task_id)) {
+                wait(agent);
+                return;
+            }
+            double start = now + model_->handshake_us;
+            double run = latency(runtime_->get_task(task_id));
+            ready_wait_ += start - ready_at_[task_id];
+            core.busy += run;
+            start_op(agent, OP_PULL, agent.cores[0], task_id, model_->handshake_us + run + model_->complete_us);
+            return;
+        }
+
+        // Retire the earliest visible completion on the thread's cores
+        int retire_core = -1;
+        double retire_at = NEVER;
+        for (int core_id : agent.cores) {
+            const ModelCore& core = cores_[core_id];
+            if (!core.done.empty() && core.done.front().first <= now && core.done.front().first < retire_at) {
+                retire_at = core.done.front().first;
+                retire_core = core_id;
+            }
+        }
+        if (retire_core >= 0) {
+            int task_id = cores_[retire_core].done.front().second;
+            cores_[retire_core].done.pop_front();
+            start_op(agent, OP_RETIRE, retire_core, task_id, model_->complete_us);
+            return;
+        }
+
+        // Gang tasks claim fully idle blocks before single-core tasks
+        if (queues_.count(GANG) > 0) {
+            for (int core_id : agent.cores) {
+                if (cores_[core_id].core_type != 0) {
+                    continue;
+                }
+                int block = cores_[core_id].block;
+                if (cores_[block].in_flight || cores_[block_dim_ + block * 2].in_flight ||
+                    cores_[block_dim_ + block * 2 + 1].in_flight) {
+                    continue;
+                }
+                int task_id;
+                if (queues_.pop(a, GANG, &task_id)) {
+                    cores_[block].in_flight++;
+                    cores_[block_dim_ + block * 2].in_flight++;
+                    cores_[block_dim_ + block * 2 + 1].in_flight++;
+                    gang_left_[task_id] = 3;
+                    start_op(agent, OP_GANG, block, task_id, model_->dispatch_us);
+                    return;
+                }
+                break;
+            }
+        }
+
+        // Fill free handshake slots, idle cores first
+        for (int depth = 1; depth <= depth_; depth++) {
+            for (int core_id : agent.cores) {
+                ModelCore& core = cores_[core_id];
+                int task_id;
+                if (core.in_flight < depth && queues_.pop(a, core.core_type, &task_id)) {
+                    core.in_flight++;
+                    start_op(agent, OP_DISPATCH, core_id, task_id, model_->dispatch_us);
+                    return;
+                }
+            }
+        }
+        wait(agent);
+    }
+
+    // Longest chain of kernel latencies (Kahn order over the CSR edges)
+    double critical_path() const {
+        std::vector<int> fanin(task_count_);
+        std::vector<double> finish(task_count_, 0.0);
+        std::vector<int> order;
+        order.reserve(task_count_);
+        for (int i = 0; i < task_count_; i++) {
+            fanin[i] = runtime_->get_task(i)->initial_fanin;
+            if (fanin[i] == 0 && runtime_->get_task(i)->fused_head < 0) order.push_back(i);
+        }
+        double longest = 0;
+        for (size_t k = 0; k < order.size(); k++) {
+            Task* task = runtime_->get_task(order[k]);
+            finish[order[k]] += latency(task);
+            if (finish[order[k]] > longest) longest = finish[order[k]];
+            int* fanout = runtime_->get_fanout(task);
+            for (int j = 0; j < task->fanout_count; j++) {
+                int succ = fanout[j];
+                if (finish[order[k]] > finish[succ]) finish[succ] = finish[order[k]];
+                if (--fanin[succ] == 0) order.push_back(succ);
+            }
+        }
+        return longest;
+    }
+};
+
+}  // namespace
+
+extern "C" {
+
+/**
+ * Predict the execution of a runtime's graph with a cost model.
+ *
+ * @param runtime       Initialized runtime (graph built)
+ * @param thread_count  AICPU scheduler threads to model
+ * @param block_dim     Blocks to model
+ * @param model         Timing assumptions
+ * @param prediction    Output prediction
+ * @return 0 on success, -1 on invalid parameters or a graph that cannot finish
+ */
+int predict_runtime_impl(Runtime* runtime, int thread_count, int block_dim, const CostModel* model,
+                         RuntimePrediction* prediction) {
+    if (runtime == nullptr || model == nullptr || prediction == nullptr) {
+        std::cerr << "Error: Invalid prediction parameters\n";
+        return -1;
+    }
+    if (thread_count < 1 || thread_count > RUNTIME_MAX_SCHED_THREADS || block_dim < 1 ||
+        block_dim * 3 > RUNTIME_MAX_WORKER) {
+        std::cerr << "Error: Cannot model " << thread_count << " AICPU thread(s) with block_dim " << block_dim
+                  << " (at most " << RUNTIME_MAX_SCHED_THREADS << " threads and " << RUNTIME_MAX_WORKER / 3
+                  << " blocks)\n";
+        return -1;
+    }
+    // Like AicpuExecutor, threads beyond block_dim manage no cores
+    if (thread_count > block_dim) thread_count = block_dim;
+    memset(prediction, 0, sizeof(*prediction));
+    prediction->thread_count = thread_count;
+    prediction->core_count = block_dim * 3;
+
+    if (runtime->build_graph() != 0) {
+        return -1;
+    }
+    GraphModel graph(runtime, model, thread_count, block_dim);
+    if (graph.validate() != 0) {
+        return -1;
+    }
+    return graph.run(prediction);
+}
+
+}  // extern "C"
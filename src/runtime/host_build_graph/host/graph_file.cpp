@@ -0,0 +1,420 @@
+/**
+ * Graph Files - Serialized Task Graphs
+ *
+ * Provides save_graph_impl and load_graph_impl, which store a built runtime
+ * in a versioned binary file and map it back without re-running the
+ * orchestration. A file holds, each section aligned to GRAPH_FILE_ALIGN:
+ *   - GraphFileHeader: magic, version, counts and section offsets
+ *   - Task headers, in the executors' layout with execution state cleared
+ *   - CSR successor IDs
+ *   - Args pool, with tensor addresses zeroed
+ *   - Tensor slots: the device allocations the args point into
+ *   - Relocations: (args pool index, tensor slot, byte offset)
+ *   - Kernel table: the func_ids the tasks call
+ *
+ * Loading maps the file privately and hands its task, edge and args
+ * sections to the runtime in place (Runtime::attach_graph()), so the host
+ * neither parses nor copies the graph; only the relocated args and the
+ * execution state the executors write are copied on write. The file uses
+ * host byte order and the writer's Task layout, so it is only valid for
+ * builds of the same runtime.
+ */
+
+#include "runtime.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char GRAPH_FILE_MAGIC[8] = {'P', 'T', 'O', 'G', 'R', 'A', 'P', 'H'};
+const uint32_t GRAPH_FILE_VERSION = 1;
+const uint64_t GRAPH_FILE_ALIGN = 64;
+
+// Tensor slot flags
+const uint32_t GRAPH_TENSOR_OUTPUT = 1;  // Recorded as a tensor pair: copied back by finalize
+
+struct GraphFileHeader {
+    char magic[8];            // GRAPH_FILE_MAGIC
+    uint32_t version;         // GRAPH_FILE_VERSION
+    uint32_t header_size;     // sizeof(GraphFileHeader)
+    uint32_t task_size;       // sizeof(Task) of the writer
+    int32_t task_count;
+    int32_t edge_count;
+    int32_t arg_count;
+    int32_t fused_count;      // Tasks absorbed into fused chains
+    int32_t tensor_count;
+    int32_t reloc_count;
+    int32_t func_count;
+    uint64_t tasks_offset;    // Task[task_count]
+    uint64_t edges_offset;    // int32_t[edge_count]
+    uint64_t args_offset;     // uint64_t[arg_count]
+    uint64_t tensors_offset;  // GraphFileTensor[tensor_count]
+    uint64_t relocs_offset;   // GraphFileReloc[reloc_count]
+    uint64_t funcs_offset;    // int32_t[func_count]
+    uint64_t file_size;
+};
+
+struct GraphFileTensor {
+    uint64_t size;   // Size in bytes
+    uint32_t flags;  // GRAPH_TENSOR_*
+    uint32_t reserved;
+};
+
+struct GraphFileReloc {
+    int32_t arg;           // Index into the args pool
+    int32_t tensor;        // Tensor slot
+    uint64_t byte_offset;  // Added to the slot's device address
+};
+
+uint64_t align_section(uint64_t offset) {
+    return (offset + GRAPH_FILE_ALIGN - 1) / GRAPH_FILE_ALIGN * GRAPH_FILE_ALIGN;
+}
+
+// Pads the file to the given offset and writes a section there
+bool write_section(FILE* out, uint64_t* pos, uint64_t offset, const void* data, size_t size) {
+    static const char zeros[GRAPH_FILE_ALIGN] = {};
+    while (*pos < offset) {
+        size_t pad = static_cast<size_t>(std::min<uint64_t>(offset - *pos, GRAPH_FILE_ALIGN));
+        if (fwrite(zeros, 1, pad, out) != pad) {
+            return false;
+        }
+        *pos += pad;
+    }
+    if (size > 0 && fwrite(data, 1, size, out) != size) {
+        return false;
+    }
+    *pos += size;
+    return true;
+}
+
+bool section_fits(uint64_t offset, uint64_t count, uint64_t elem_size, uint64_t file_size) {
+    return offset % 8 == 0 && offset <= file_size && count <= (file_size - offset) / elem_size;
+}
+
+}  // namespace
+
+extern "C" {
+
+/**
+ * Write a built runtime to a graph file.
+ *
+ * Every arg that points into one of the given tensors is stored as a
+ * relocation against that tensor's slot; slots keep the order of the
+ * array. Tensors recorded as tensor pairs are flagged as outputs. The file
+ * is written next to path and renamed over it, so processes that have the
+ * old file mapped keep a consistent copy.
+ *
+ * @param runtime       Built (non-streaming) runtime
+ * @param path          Output file
+ * @param tensors       Device allocations args may point into, in slot order
+ * @param tensor_count  Number of tensors
+ * @return 0 on success, -1 on failure
+ */
+int save_graph_impl(Runtime* runtime, const char* path, const GraphTensor* tensors, int tensor_count) {
+    if (runtime == nullptr || path == nullptr || (tensors == nullptr && tensor_count > 0) || tensor_count < 0) {
+        std::cerr << "Error: Invalid graph save parameters\n";
+        return -1;
+    }
+    if (runtime->is_streaming()) {
+        std::cerr << "Error: Streaming runtimes cannot be saved\n";
+        return -1;
+    }
+    if (runtime->build_graph() != 0) {
+        std::cerr << "Error: Failed to build the task graph\n";
+        return -1;
+    }
+
+    int task_count = runtime->get_task_count();
+    int edge_count = runtime->get_edge_count();
+
+    // Tensor lookup by address
+    std::vector<int> by_addr(tensor_count);
+    for (int i = 0; i < tensor_count; i++) {
+        by_addr[i] = i;
+    }
+    std::sort(by_addr.begin(), by_addr.end(),
+        [tensors](int a, int b) { return tensors[a].dev_addr < tensors[b].dev_addr; });
+    auto find_tensor = [&](uint64_t addr) {
+        auto it = std::upper_bound(by_addr.begin(), by_addr.end(), addr,
+            [tensors](uint64_t value, int t) { return value < tensors[t].dev_addr; });
+        if (it == by_addr.begin()) {
+            return -1;
+        }
+        int t = *(it - 1);
+        return addr - tensors[t].dev_addr < tensors[t].size ? t : -1;
+    };
+
+    // Canonical layout: args and successors in task order. Task holds
+    // atomics, so tasks are staged as zeroed bytes (padding included)
+    std::vector<unsigned char> staged_tasks(static_cast<size_t>(task_count) * sizeof(Task), 0);
+    std::vector<int32_t> edges;
+    std::vector<uint64_t> args;
+    std::vector<GraphFileReloc> relocs;
+    std::vector<int32_t> funcs;
+    edges.reserve(edge_count);
+    for (int i = 0; i < task_count; i++) {
+        Task* task = runtime->get_task(i);
+        Task* staged = reinterpret_cast<Task*>(&staged_tasks[static_cast<size_t>(i) * sizeof(Task)]);
+        staged->task_id = task->task_id;
+        staged->func_id = task->func_id;
+        staged->num_args = task->num_args;
+        staged->args_offset = static_cast<int>(args.size());
+        staged->function_bin_addr = 0;
+        staged->core_type = task->core_type;
+        staged->fanin.store(task->initial_fanin, std::memory_order_relaxed);
+        staged->initial_fanin = task->initial_fanin;
+        staged->fanout_offset = static_cast<int>(edges.size());
+        staged->fanout_count = task->fanout_count;
+        staged->priority = task->priority;
+        staged->affinity_block = task->affinity_block;
+        staged->hint_block = -1;
+        staged->fused_next = task->fused_next;
+        staged->fused_head = task->fused_head;
+        staged->pred_offset = 0;
+        staged->succ_head.store(STREAM_LIST_EMPTY, std::memory_order_relaxed);
+        staged->exec_core = -1;
+
+        const uint64_t* task_args = runtime->get_task_args(task);
+        for (int j = 0; j < task->num_args; j++) {
+            int t = find_tensor(task_args[j]);
+            if (t >= 0) {
+                uint64_t offset = task_args[j] - tensors[t].dev_addr;
+                relocs.push_back(GraphFileReloc{static_cast<int32_t>(args.size()), t, offset});
+                args.push_back(0);
+            } else {
+                args.push_back(task_args[j]);
+            }
+        }
+        const int* fanout = runtime->get_fanout(task);
+        edges.insert(edges.end(), fanout, fanout + task->fanout_count);
+        funcs.push_back(task->func_id);
+    }
+    std::sort(funcs.begin(), funcs.end());
+    funcs.erase(std::unique(funcs.begin(), funcs.end()), funcs.end());
+
+    std::vector<GraphFileTensor> slots(tensor_count);
+    TensorPair* pairs = runtime->get_tensor_pairs();
+    for (int i = 0; i < tensor_count; i++) {
+        slots[i] = GraphFileTensor{tensors[i].size, 0, 0};
+    }
+    for (int p = 0; p < runtime->get_tensor_pair_count(); p++) {
+        int t = find_tensor(reinterpret_cast<uint64_t>(pairs[p].dev_ptr));
+        if (t < 0 || tensors[t].dev_addr != reinterpret_cast<uint64_t>(pairs[p].dev_ptr)) {
+            std::cerr << "Warning: output tensor " << p << " is not a saved allocation and will not be copied back\n";
+            continue;
+        }
+        slots[t].flags |= GRAPH_TENSOR_OUTPUT;
+    }
+
+    GraphFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_FILE_VERSION;
+    header.header_size = sizeof(GraphFileHeader);
+    header.task_size = sizeof(Task);
+    header.task_count = task_count;
+    header.edge_count = static_cast<int32_t>(edges.size());
+    header.arg_count = static_cast<int32_t>(args.size());
+    header.fused_count = task_count - runtime->get_scheduled_task_count();
+    header.tensor_count = tensor_count;
+    header.reloc_count = static_cast<int32_t>(relocs.size());
+    header.func_count = static_cast<int32_t>(funcs.size());
+    header.tasks_offset = align_section(sizeof(GraphFileHeader));
+    header.edges_offset = align_section(header.tasks_offset + staged_tasks.size());
+    header.args_offset = align_section(header.edges_offset + edges.size() * sizeof(int32_t));
+    header.tensors_offset = align_section(header.args_offset + args.size() * sizeof(uint64_t));
+    header.relocs_offset = align_section(header.tensors_offset + slots.size() * sizeof(GraphFileTensor));
+    header.funcs_offset = align_section(header.relocs_offset + relocs.size() * sizeof(GraphFileReloc));
+    header.file_size = header.funcs_offset + funcs.size() * sizeof(int32_t);
+
+    std::string tmp_path = std::string(path) + ".tmp";
+    FILE* out = fopen(tmp_path.c_str(), "wb");
+    if (out == nullptr) {
+        std::cerr << "Error: Failed to open graph file " << tmp_path << '\n';
+        return -1;
+    }
+    uint64_t pos = 0;
+    bool ok = write_section(out, &pos, 0, &header, sizeof(header)) &&
+              write_section(out, &pos, header.tasks_offset, staged_tasks.data(), staged_tasks.size()) &&
+              write_section(out, &pos, header.edges_offset, edges.data(), edges.size() * sizeof(int32_t)) &&
+              write_section(out, &pos, header.args_offset, args.data(), args.size() * sizeof(uint64_t)) &&
+              write_section(out, &pos, header.tensors_offset, slots.data(), slots.size() * sizeof(GraphFileTensor)) &&
+              write_section(out, &pos, header.relocs_offset, relocs.data(), relocs.size() * sizeof(GraphFileReloc)) &&
+              write_section(out, &pos, header.funcs_offset, funcs.data(), funcs.size() * sizeof(int32_t));
+    ok = (fclose(out) == 0) && ok;
+    if (!ok || rename(tmp_path.c_str(), path) != 0) {
+        std::cerr << "Error: Failed to write graph file " << path << '\n';
+        remove(tmp_path.c_str());
+        return -1;
+    }
+
+    std::cout << "Saved graph to " << path << ": " << task_count << " tasks, " << edges.size() << " edges, "
+              << tensor_count << " tensor slots, " << relocs.size() << " relocations\n";
+    return 0;
+}
+
+/**
+ * Load a graph file into a freshly constructed runtime.
+ *
+ * Tensor slot k is bound to host_tensors[k] when given (non-zero): the
+ * buffer gets a device copy via host_api.device_malloc_host (the buffer
+ * itself where the platform aliases host memory), and output slots are
+ * recorded as tensor pairs for finalize. Other slots get uninitialized
+ * device memory. The relocated args are then patched and the mapped
+ * sections attached to the runtime, which unmaps them in finalize.
+ *
+ * @param runtime            Empty runtime with host_api set
+ * @param path               Graph file written by save_graph_impl()
+ * @param host_tensors       Host buffers by tensor slot (may be nullptr)
+ * @param host_tensor_count  Number of entries in host_tensors
+ * @return 0 on success, -1 on failure
+ */
+int load_graph_impl(Runtime* runtime, const char* path, const uint64_t* host_tensors, int host_tensor_count) {
+    if (runtime == nullptr || path == nullptr || (host_tensors == nullptr && host_tensor_count > 0)) {
+        std::cerr << "Error: Invalid graph load parameters\n";
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Failed to open graph file " << path << '\n';
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(GraphFileHeader))) {
+        std::cerr << "Error: " << path << " is not a graph file\n";
+        close(fd);
+        return -1;
+    }
+    size_t map_size = static_cast<size_t>(st.st_size);
+    void* map = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        std::cerr << "Error: Failed to map graph file " << path << '\n';
+        return -1;
+    }
+    auto fail = [map, map_size](const char* message) {
+        std::cerr << "Error: " << message << '\n';
+        munmap(map, map_size);
+        return -1;
+    };
+
+    char* base = static_cast<char*>(map);
+    const GraphFileHeader* header = reinterpret_cast<const GraphFileHeader*>(base);
+    if (memcmp(header->magic, GRAPH_FILE_MAGIC, sizeof(header->magic)) != 0) {
+        return fail("Not a graph file");
+    }
+    if (header->version != GRAPH_FILE_VERSION || header->header_size != sizeof(GraphFileHeader) ||
+        header->task_size != sizeof(Task)) {
+        return fail("Graph file was written by an incompatible runtime build");
+    }
+    uint64_t file_size = header->file_size;
+    if (file_size != map_size || header->task_count < 0 || header->edge_count < 0 || header->arg_count < 0 ||
+        header->tensor_count < 0 || header->reloc_count < 0 || header->func_count < 0 ||
+        !section_fits(header->tasks_offset, header->task_count, sizeof(Task), file_size) ||
+        !section_fits(header->edges_offset, header->edge_count, sizeof(int32_t), file_size) ||
+        !section_fits(header->args_offset, header->arg_count, sizeof(uint64_t), file_size) ||
+        !section_fits(header->tensors_offset, header->tensor_count, sizeof(GraphFileTensor), file_size) ||
+        !section_fits(header->relocs_offset, header->reloc_count, sizeof(GraphFileReloc), file_size) ||
+        !section_fits(header->funcs_offset, header->func_count, sizeof(int32_t), file_size)) {
+        return fail("Graph file is truncated or corrupt");
+    }
+    if (host_tensor_count > header->tensor_count) {
+        return fail("More tensors given than the graph file has slots");
+    }
+
+    Task* tasks = reinterpret_cast<Task*>(base + header->tasks_offset);
+    int* edges = reinterpret_cast<int*>(base + header->edges_offset);
+    uint64_t* args = reinterpret_cast<uint64_t*>(base + header->args_offset);
+    const GraphFileTensor* slots = reinterpret_cast<const GraphFileTensor*>(base + header->tensors_offset);
+    const GraphFileReloc* relocs = reinterpret_cast<const GraphFileReloc*>(base + header->relocs_offset);
+
+    // The executors index with these, so reject anything out of range
+    for (int i = 0; i < header->task_count; i++) {
+        const Task& t = tasks[i];
+        if (t.task_id != i || t.num_args < 0 || t.num_args > RUNTIME_MAX_ARGS || t.args_offset < 0 ||
+            t.args_offset > header->arg_count - t.num_args || t.fanout_count < 0 || t.fanout_offset < 0 ||
+            t.fanout_offset > header->edge_count - t.fanout_count || t.core_type < 0 ||
+            t.core_type > static_cast<int>(CoreType::BLOCK) || t.fused_next >= header->task_count ||
+            t.fused_head >= header->task_count) {
+            return fail("Graph file has an invalid task");
+        }
+    }
+    // The schedulers release a task once initial_fanin predecessors finished
+    std::vector<int> in_degree(header->task_count, 0);
+    for (int e = 0; e < header->edge_count; e++) {
+        if (edges[e] < 0 || edges[e] >= header->task_count) {
+            return fail("Graph file has an invalid edge");
+        }
+        in_degree[edges[e]]++;
+    }
+    for (int i = 0; i < header->task_count; i++) {
+        if (tasks[i].initial_fanin != in_degree[i]) {
+            return fail("Graph file has a task whose fanin does not match its edges");
+        }
+    }
+    for (int r = 0; r < header->reloc_count; r++) {
+        if (relocs[r].arg < 0 || relocs[r].arg >= header->arg_count || relocs[r].tensor < 0 ||
+            relocs[r].tensor >= header->tensor_count) {
+            return fail("Graph file has an invalid relocation");
+        }
+    }
+
+    // Tensors are allocated on the runtime's device; finalize frees them
+    runtime->clear_tensor_pairs();
+    std::vector<uint64_t> dev_addrs(header->tensor_count);
+    for (int k = 0; k < header->tensor_count; k++) {
+        void* host = k < host_tensor_count ? reinterpret_cast<void*>(host_tensors[k]) : nullptr;
+        size_t size = static_cast<size_t>(slots[k].size);
+        void* dev = host != nullptr ? runtime->host_api.device_malloc_host(host, size)
+                                    : runtime->host_api.device_malloc(size);
+        if (dev == nullptr) {
+            runtime->clear_tensor_pairs();
+            return fail("Failed to allocate a tensor of the graph file");
+        }
+        if (host != nullptr) {
+            if (runtime->host_api.copy_to_device_async != nullptr) {
+                runtime->host_api.copy_to_device_async(dev, host, size);
+            } else {
+                runtime->host_api.copy_to_device(dev, host, size);
+            }
+            if (slots[k].flags & GRAPH_TENSOR_OUTPUT) {
+                runtime->record_tensor_pair(host, dev, size);
+            }
+        }
+        dev_addrs[k] = reinterpret_cast<uint64_t>(dev);
+    }
+    // One wait for all the uploads queued above
+    if (runtime->host_api.sync_transfers != nullptr && runtime->host_api.sync_transfers() != 0) {
+        runtime->clear_tensor_pairs();
+        return fail("Failed to copy the tensors of the graph file to the device");
+    }
+    for (int r = 0; r < header->reloc_count; r++) {
+        args[relocs[r].arg] = dev_addrs[relocs[r].tensor] + relocs[r].byte_offset;
+    }
+
+    if (runtime->attach_graph(tasks, header->task_count, edges, header->edge_count, args, header->arg_count,
+            header->fused_count, map, map_size) != 0) {
+        runtime->clear_tensor_pairs();
+        munmap(map, map_size);
+        return -1;
+    }
+
+    std::cout << "Loaded graph from " << path << ": " << header->task_count << " tasks, " << header->edge_count
+              << " edges, " << header->tensor_count << " tensor slots (" << host_tensor_count << " bound), "
+              << header->func_count << " kernels\n";
+    return 0;
+}
+
+}  // extern "C"
@@ -7,13 +7,19 @@
  * init_runtime_impl:
  *   - Calls orchestration function to build task graph
  *   - Orchestration is responsible for device memory management
+ *   - Places the intermediate buffers declared with Runtime::add_buffer()
+ *   - Seals the graph of a streaming runtime instead
  *
  * validate_runtime_impl (finalize_runtime_impl):
- *   - Copies recorded tensors back from device to host
- *   - Frees device memory
+ *   - Copies recorded tensors back from device to host, except those that
+ *     alias their host buffer
+ *   - Frees device memory (the runtime's whole arena when the platform
+ *     provides one)
+ *   - Unmaps the graph file of a runtime loaded with load_graph_impl()
  */
 
 #include "runtime.h"
+#include "host/memory_so_loader.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <cstddef>
@@ -21,9 +27,12 @@
 #include <cstdio>
 #include <cstring>
 #include <dlfcn.h>
-#include <fcntl.h>
+#include <sys/mman.h>
 #include <iostream>
-#include <unistd.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 
 /**
  * Orchestration function signature.
@@ -35,6 +44,82 @@
  */
 typedef int (*OrchestrationFunc)(Runtime* runtime, uint64_t* args, int arg_count);
 
+namespace {
+
+/**
+ * Orchestration SO loaded by an earlier init_runtime_impl call
+ *
+ * Handles are kept for the lifetime of the process, so repeat inits with
+ * the same binary resolve their function without loading anything.
+ */
+struct LoadedOrchestration {
+    std::vector<uint8_t> binary;                      // Copy to rule out hash collisions
+    void* handle;                                     // dlopen handle
+    int fd;                                           // memfd backing the handle
+    std::map<std::string, OrchestrationFunc> funcs;  // Resolved functions by name
+};
+
+std::mutex g_orch_mutex;
+std::multimap<uint64_t, LoadedOrchestration> g_orch_cache;  // Keyed by binary hash
+
+// FNV-1a over the SO image
+uint64_t hash_binary(const uint8_t* data, size_t size) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; i++) {
+        h = (h ^ data[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+/**
+ * Load (or find) an orchestration SO and resolve one of its functions
+ *
+ * @return Function pointer, or nullptr on failure (error printed)
+ */
+OrchestrationFunc resolve_orchestration(const uint8_t* binary, size_t size, const char* func_name) {
+    uint64_t key = hash_binary(binary, size);
+    std::lock_guard<std::mutex> lock(g_orch_mutex);
+
+    LoadedOrchestration* so = nullptr;
+    auto range = g_orch_cache.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.binary.size() == size && std::memcmp(it->second.binary.data(), binary, size) == 0) {
+            so = &it->second;
+            break;
+        }
+    }
+    if (so == nullptr) {
+        int fd = -1;
+        void* handle = dlopen_from_memory(binary, size, "orch_so", RTLD_NOW | RTLD_LOCAL, &fd);
+        if (handle == nullptr) {
+            return nullptr;
+        }
+        auto it = g_orch_cache.emplace(
+            key, LoadedOrchestration{std::vector<uint8_t>(binary, binary + size), handle, fd, {}});
+        so = &it->second;
+    } else {
+        auto cached = so->funcs.find(func_name);
+        if (cached != so->funcs.end()) {
+            std::cout << "Reusing loaded orchestration function: " << func_name << "\n";
+            return cached->second;
+        }
+    }
+
+    dlerror();  // Clear any existing error
+    OrchestrationFunc func = reinterpret_cast<OrchestrationFunc>(dlsym(so->handle, func_name));
+    const char* dlsym_error = dlerror();
+    if (dlsym_error != nullptr || func == nullptr) {
+        std::cerr << "Error: dlsym failed for '" << func_name << "': "
+                  << (dlsym_error != nullptr ? dlsym_error : "null symbol") << "\n";
+        return nullptr;
+    }
+    so->funcs[func_name] = func;
+    std::cout << "Loaded orchestration function: " << func_name << "\n";
+    return func;
+}
+
+}  // namespace
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -42,14 +127,26 @@ extern "C" {
 /**
  * Initialize a pre-allocated runtime with dynamic orchestration.
  *
- * This function loads the orchestration SO from binary data via a temp file,
- * resolves the orchestration function via dlsym, then calls it to build the
- * task graph. The orchestration function is responsible for:
- * - Allocating device memory via runtime->host_api.device_malloc()
- * - Copying data to device via runtime->host_api.copy_to_device()
+ * This function loads the orchestration SO from memory (memfd, no temp
+ * file), resolves the orchestration function via dlsym, then calls it to
+ * build the task graph. Loaded SOs are cached by binary hash and resolved
+ * functions by name, so repeat inits with the same orchestration do no I/O
+ * and no linking. The orchestration function is responsible for:
+ * - Allocating device memory via runtime->host_api.device_malloc(), or
+ *   device_malloc_host() for tensors that mirror a host buffer
+ * - Copying data to device via runtime->host_api.copy_to_device(), or
+ *   copy_to_device_async() to batch the uploads; queued copies are
+ *   synchronized once the orchestration returns
  * - Building the task graph
  * - Recording tensor pairs via runtime->record_tensor_pair()
  *
+ * Intermediates declared with runtime->add_buffer() are placed afterwards
+ * by Runtime::plan_buffers().
+ *
+ * On a streaming runtime (Runtime::begin_streaming()) the launch may
+ * already be running; the graph is sealed once the orchestration returns,
+ * whether it succeeded or not, so that the launch can finish.
+ *
  * @param runtime           Pointer to pre-constructed Runtime
  * @param orch_so_binary    Orchestration shared library binary data
  * @param orch_so_size      Size of orchestration SO binary in bytes
@@ -74,44 +171,12 @@ int init_runtime_impl(Runtime *runtime,
         return -1;
     }
 
-    // Load orchestration SO from binary data via temp file
-    char fd_path[128];
-    snprintf(fd_path, sizeof(fd_path), "/tmp/orch_so_%d.so", getpid());
-
-    int fd = open(fd_path, O_WRONLY | O_CREAT | O_TRUNC, 0700);
-    if (fd < 0) {
-        std::cerr << "Error: Failed to create temp SO file\n";
-        return -1;
-    }
-
-    ssize_t written = write(fd, orch_so_binary, orch_so_size);
-    if (written < 0 || static_cast<size_t>(written) != orch_so_size) {
-        std::cerr << "Error: Failed to write orchestration SO to temp file\n";
-        close(fd);
-        unlink(fd_path);
-        return -1;
-    }
-    close(fd);
-
-    void* handle = dlopen(fd_path, RTLD_NOW | RTLD_LOCAL);
-    unlink(fd_path);
-    if (handle == nullptr) {
-        std::cerr << "Error: dlopen failed: " << dlerror() << "\n";
+    // Load the orchestration SO from memory, or reuse an identical one
+    OrchestrationFunc orch_func = resolve_orchestration(orch_so_binary, orch_so_size, orch_func_name);
+    if (orch_func == nullptr) {
         return -1;
     }
 
-    dlerror();  // Clear any existing error
-    OrchestrationFunc orch_func =
-        reinterpret_cast<OrchestrationFunc>(dlsym(handle, orch_func_name));
-    const char* dlsym_error = dlerror();
-    if (dlsym_error != nullptr) {
-        std::cerr << "Error: dlsym failed for '" << orch_func_name << "': " << dlsym_error << "\n";
-        dlclose(handle);
-        return -1;
-    }
-
-    std::cout << "Loaded orchestration function: " << orch_func_name << "\n";
-
     // Clear any previous tensor pairs
     runtime->clear_tensor_pairs();
 
@@ -121,17 +186,38 @@ int init_runtime_impl(Runtime *runtime,
     // Call orchestration function to build task graph
     // The orchestration function handles device memory allocation and copy-to-device
     int rc = orch_func(runtime, func_args, func_args_count);
+    if (runtime->seal_graph() != 0 && rc == 0) {
+        std::cerr << "Error: Failed to publish streamed tasks\n";
+        rc = -1;
+    }
+    if (runtime->host_api.sync_transfers != nullptr) {
+        int sync_rc = runtime->host_api.sync_transfers();
+        if (sync_rc != 0 && rc == 0) {
+            std::cerr << "Error: Failed to copy inputs to device: " << sync_rc << '\n';
+            rc = sync_rc;
+        }
+    }
     if (rc != 0) {
         std::cerr << "Error: Orchestration function failed with code " << rc << '\n';
         runtime->clear_tensor_pairs();
-        dlclose(handle);
         return rc;
     }
 
-    std::cout << "\nRuntime initialized. Ready for execution from Python.\n";
+    // Pack the recorded edges into the CSR layout used by the executors
+    if (runtime->build_graph() != 0) {
+        std::cerr << "Error: Failed to build the task graph\n";
+        runtime->clear_tensor_pairs();
+        return -1;
+    }
+
+    // Pack the declared intermediate buffers and patch their addresses
+    if (runtime->plan_buffers() != 0) {
+        std::cerr << "Error: Failed to plan intermediate buffers\n";
+        runtime->clear_tensor_pairs();
+        return -1;
+    }
 
-    // Note: We intentionally leak the dlopen handle to keep the SO loaded
-    // for the lifetime of the process.
+    std::cout << "\nRuntime initialized. Ready for execution from Python.\n";
 
     return 0;
 }
@@ -140,9 +226,14 @@ int init_runtime_impl(Runtime *runtime,
  * Validate runtime results and cleanup.
  *
  * This function:
- * 1. Copies recorded tensors from device back to host
- * 2. Frees device memory for recorded tensors
- * 3. Clears tensor pair state
+ * 1. Copies recorded tensors from device back to host as one batch of
+ *    asynchronous transfers (tensors that alias their host buffer are
+ *    skipped)
+ * 2. Frees device memory: every allocation made during orchestration when
+ *    host_api.release_runtime_memory is available, otherwise the recorded
+ *    tensors
+ * 3. Unmaps the graph file the runtime was loaded from, if any
+ * 4. Clears tensor pair state
  *
  * @param runtime  Pointer to Runtime
  * @return 0 on success, -1 on failure
@@ -160,10 +251,19 @@ int validate_runtime_impl(Runtime *runtime) {
     // Copy all recorded tensors from device back to host
     TensorPair* tensor_pairs = runtime->get_tensor_pairs();
     int tensor_pair_count = runtime->get_tensor_pair_count();
+    bool batched = runtime->host_api.copy_from_device_async != nullptr &&
+                   runtime->host_api.sync_transfers != nullptr;
 
     for (int i = 0; i < tensor_pair_count; i++) {
         const TensorPair& pair = tensor_pairs[i];
-        int copy_rc = runtime->host_api.copy_from_device(pair.host_ptr, pair.dev_ptr, pair.size);
+        if (pair.dev_ptr == pair.host_ptr) {
+            // Aliased host buffer (device_malloc_host): results are already in place
+            std::cout << "Tensor " << i << ": aliases its host buffer, nothing to copy\n";
+            continue;
+        }
+        // Queue the copies and wait for them together (one sync per batch)
+        int copy_rc = batched ? runtime->host_api.copy_from_device_async(pair.host_ptr, pair.dev_ptr, pair.size)
+                              : runtime->host_api.copy_from_device(pair.host_ptr, pair.dev_ptr, pair.size);
         if (copy_rc != 0) {
             std::cerr << "Error: Failed to copy tensor " << i << " from device: " << copy_rc << '\n';
             rc = copy_rc;
@@ -172,15 +272,39 @@ int validate_runtime_impl(Runtime *runtime) {
             std::cout << "Tensor " << i << ": " << pair.size << " bytes copied to host\n";
         }
     }
+    if (batched) {
+        int sync_rc = runtime->host_api.sync_transfers();
+        if (sync_rc != 0) {
+            std::cerr << "Error: Failed to copy tensors from device: " << sync_rc << '\n';
+            rc = sync_rc;
+        }
+    }
 
     // Note: PrintHandshakeResults is now called in DeviceRunner's destructor
 
     // Cleanup device tensors
     std::cout << "\n=== Cleaning Up ===" << '\n';
-    for (int i = 0; i < tensor_pair_count; i++) {
-        runtime->host_api.device_free(tensor_pairs[i].dev_ptr);
+    if (runtime->host_api.release_runtime_memory != nullptr) {
+        // Also covers intermediates the orchestration never freed
+        runtime->host_api.release_runtime_memory(runtime);
+        std::cout << "Released runtime device memory arena\n";
+    } else {
+        for (int i = 0; i < tensor_pair_count; i++) {
+            runtime->host_api.device_free(tensor_pairs[i].dev_ptr);
+        }
+        if (runtime->get_planned_arena() != nullptr) {
+            runtime->host_api.device_free(runtime->get_planned_arena());
+        }
+        std::cout << "Freed " << tensor_pair_count << " device tensors\n";
+    }
+
+    // The runtime of a loaded graph runs on the mapped file
+    size_t mapping_size = 0;
+    void* mapping = runtime->detach_graph(&mapping_size);
+    if (mapping != nullptr) {
+        munmap(mapping, mapping_size);
+        std::cout << "Unmapped graph file\n";
     }
-    std::cout << "Freed " << tensor_pair_count << " device tensors\n";
 
     // Clear tensor pairs
     runtime->clear_tensor_pairs();
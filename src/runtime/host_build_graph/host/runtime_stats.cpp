@@ -0,0 +1,77 @@
+/**
+ * Runtime Stats - Scheduler Counter Summary
+ *
+ * Provides get_runtime_stats_impl, which folds the per-thread
+ * SchedulerStats blocks and per-core busy times written by the AICPU
+ * scheduler into the RuntimeStats summary of the C API.
+ */
+
+#include "runtime.h"
+#include "host/pto_runtime_c_api.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+extern "C" {
+
+/**
+ * Summarize the scheduler counters of a runtime's last launch.
+ *
+ * The counters must already be on the host (the platform copies them back
+ * before calling this).
+ *
+ * @param runtime       Launched runtime
+ * @param stats         Output statistics
+ * @param ticks_per_us  Timestamp ticks per microsecond
+ * @return 0 on success, -1 on invalid parameters
+ */
+int get_runtime_stats_impl(Runtime* runtime, RuntimeStats* stats, double ticks_per_us) {
+    if (runtime == nullptr || stats == nullptr || ticks_per_us <= 0) {
+        std::cerr << "Error: Invalid runtime stats parameters\n";
+        return -1;
+    }
+    memset(stats, 0, sizeof(*stats));
+
+    int thread_count = runtime->sche_cpu_num;
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > RUNTIME_MAX_SCHED_THREADS) thread_count = RUNTIME_MAX_SCHED_THREADS;
+    stats->thread_count = thread_count;
+    stats->core_count = runtime->worker_count;
+
+    uint64_t run_ticks = 0;
+    uint64_t latency_ticks = 0;
+    uint64_t max_latency_ticks = 0;
+    uint64_t queue_op_ticks = 0;
+    for (int t = 0; t < thread_count; t++) {
+        const SchedulerStats& s = runtime->sched_stats[t];
+        if (s.run_ticks > run_ticks) run_ticks = s.run_ticks;
+        if (s.max_dispatch_latency_ticks > max_latency_ticks) max_latency_ticks = s.max_dispatch_latency_ticks;
+        stats->loop_iterations += s.loop_iterations;
+        stats->idle_iterations += s.idle_iterations;
+        stats->tasks_dispatched += s.tasks_dispatched;
+        stats->tasks_completed += s.tasks_completed;
+        stats->blocks_migrated += s.blocks_migrated;
+        latency_ticks += s.dispatch_latency_ticks;
+        queue_op_ticks += s.queue_op_ticks;
+        for (int c = 0; c < 3; c++) {
+            if (s.max_ready_depth[c] > stats->max_ready_depth[c]) stats->max_ready_depth[c] = s.max_ready_depth[c];
+        }
+    }
+
+    stats->run_us = run_ticks / ticks_per_us;
+    stats->max_dispatch_latency_us = max_latency_ticks / ticks_per_us;
+    stats->queue_op_us = queue_op_ticks / ticks_per_us;
+    if (stats->tasks_dispatched > 0) {
+        stats->avg_dispatch_latency_us = latency_ticks / ticks_per_us / stats->tasks_dispatched;
+    }
+
+    int cores = runtime->worker_count;
+    if (cores > PTO_RUNTIME_STATS_MAX_CORES) cores = PTO_RUNTIME_STATS_MAX_CORES;
+    for (int i = 0; i < cores && run_ticks > 0; i++) {
+        stats->core_busy_fraction[i] = static_cast<double>(runtime->core_busy_ticks[i]) / run_ticks;
+    }
+    return 0;
+}
+
+}  // extern "C"
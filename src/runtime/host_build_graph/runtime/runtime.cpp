@@ -1,12 +1,20 @@
 /**
  * Runtime Class - Implementation
  *
- * Task dependency management with circular ready queue.
+ * Task dependency management with a CSR-packed successor array.
  * Follows patterns from pto_runtime.c for consistency.
  */
 
 #include "runtime.h"
 
+#include <stdlib.h>
+
+#include <new>
+
+// Graph versions are unique across all Runtime instances, so a new runtime
+// constructed at the address of a finalized one never looks resident.
+static std::atomic<uint64_t> g_graph_version{0};
+
 // =============================================================================
 // Constructor
 // =============================================================================
@@ -14,42 +22,191 @@
 Runtime::Runtime() {
     // NOTE: host_api is initialized in InitRuntime() (host-only code)
     // because the CApi functions don't exist when compiled for device.
-
-    // Initialize task array (cannot use memset with atomic members)
-    for (int i = 0; i < RUNTIME_MAX_TASKS; i++) {
-        tasks[i].task_id = 0;
-        tasks[i].func_id = 0;
-        tasks[i].num_args = 0;
-        tasks[i].function_bin_addr = 0;
-        tasks[i].core_type = 0;
-        tasks[i].fanin = 0;
-        tasks[i].fanout_count = 0;
-        tasks[i].start_time = 0;
-        tasks[i].end_time = 0;
-        memset(tasks[i].args, 0, sizeof(tasks[i].args));
-        memset(tasks[i].fanout, 0, sizeof(tasks[i].fanout));
-    }
+    tasks = nullptr;
+    fanout_edges = nullptr;
+    task_args = nullptr;
+    pull_ring = nullptr;
+    streaming = 0;
+    stream_capacity = 0;
+    published_count.store(0, std::memory_order_relaxed);
+    stream_sealed.store(0, std::memory_order_relaxed);
+    stream_preds = nullptr;
+    stream_links = nullptr;
+    stream_edge_capacity = 0;
+    published_edges = 0;
+    publish_failed = false;
+    edge_src = nullptr;
+    edge_dst = nullptr;
+    edge_inferred = nullptr;
+    edge_inferred_capacity = 0;
+    reduced_edge_count = 0;
+    tensor_segments = nullptr;
+    tensor_readers = nullptr;
+    dep_scratch = nullptr;
+    tensor_segment_count = 0;
+    tensor_segment_capacity = 0;
+    tensor_reader_count = 0;
+    tensor_reader_capacity = 0;
+    dep_scratch_capacity = 0;
+    task_capacity = 0;
+    edge_capacity = 0;
+    edge_src_capacity = 0;
+    edge_dst_capacity = 0;
+    arg_capacity = 0;
+    pull_ring_capacity = 0;
     next_task_id = 0;
-    initial_ready_count = 0;
+    edge_count = 0;
+    fused_count = 0;
+    arg_count = 0;
+    graph_built = true;
+    graph_external = false;
+    graph_mapping = nullptr;
+    graph_mapping_size = 0;
+    bump_graph_version();
+    dirty_arg_count = 0;
+    for (int i = 0; i < RUNTIME_MAX_FUNC_ID; i++) {
+        func_cost[i] = 1;
+    }
     worker_count = 0;
     block_dim = 0;
     sche_cpu_num = 1;
+    partition = 0;
+    block_offset = 0;
+    ready_queue_policy = READY_QUEUE_LIFO;
+    handshake_depth = 1;
+    completion_mode = COMPLETION_POLL_HANDSHAKE;
+    affinity_dispatch = 0;
+    scheduling_mode = SCHEDULE_AICPU;
+    core_partitioning = CORE_PARTITION_STATIC;
+    profiling_enabled = 0;
+    device_log_buffer = 0;
     tensor_pair_count = 0;
+    buffers = nullptr;
+    buffer_bindings = nullptr;
+    buffer_count = 0;
+    buffer_binding_count = 0;
+    buffer_capacity = 0;
+    buffer_binding_capacity = 0;
+    planned_arena = nullptr;
+    planned_arena_size = 0;
+
+    reserve_tasks(RUNTIME_INITIAL_TASKS);
+}
+
+Runtime::~Runtime() {
+    if (!graph_external) {
+        delete[] tasks;
+        free(task_args);
+        free(fanout_edges);
+    }
+    free(pull_ring);
+    free(stream_preds);
+    free(stream_links);
+    free(edge_src);
+    free(edge_dst);
+    free(edge_inferred);
+    free(tensor_segments);
+    free(tensor_readers);
+    free(dep_scratch);
+    free(buffers);
+    free(buffer_bindings);
+}
+
+bool Runtime::reserve(void** array, int* capacity, int needed, size_t elem_size) {
+    if (needed <= *capacity) {
+        return true;
+    }
+    int new_capacity = *capacity > 0 ? *capacity : 64;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    void* grown = realloc(*array, static_cast<size_t>(new_capacity) * elem_size);
+    if (grown == nullptr) {
+        return false;
+    }
+    *array = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+bool Runtime::reserve_tasks(int needed) {
+    if (needed <= task_capacity) {
+        return true;
+    }
+    int new_capacity = task_capacity > 0 ? task_capacity : 64;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    // Task holds atomics, so it is moved member by member instead of realloc'ed
+    Task* grown = new (std::nothrow) Task[new_capacity];
+    if (grown == nullptr) {
+        return false;
+    }
+    for (int i = 0; i < next_task_id; i++) {
+        Task* dst = &grown[i];
+        const Task* src = &tasks[i];
+        dst->task_id = src->task_id;
+        dst->func_id = src->func_id;
+        dst->num_args = src->num_args;
+        dst->args_offset = src->args_offset;
+        dst->function_bin_addr = src->function_bin_addr;
+        dst->core_type = src->core_type;
+        dst->fanin.store(src->fanin.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        dst->initial_fanin = src->initial_fanin;
+        dst->fanout_offset = src->fanout_offset;
+        dst->fanout_count = src->fanout_count;
+        dst->priority = src->priority;
+        dst->affinity_block = src->affinity_block;
+        dst->hint_block = src->hint_block;
+        dst->fused_next = src->fused_next;
+        dst->fused_head = src->fused_head;
+        dst->pred_offset = src->pred_offset;
+        dst->succ_head.store(src->succ_head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        dst->ready_time = src->ready_time;
+        dst->start_time = src->start_time;
+        dst->end_time = src->end_time;
+        dst->dispatch_time = src->dispatch_time;
+        dst->complete_time = src->complete_time;
+        dst->exec_core = src->exec_core;
+    }
+    delete[] tasks;
+    tasks = grown;
+    task_capacity = new_capacity;
+    return true;
 }
 
 // =============================================================================
 // Task Management
 // =============================================================================
 
-int Runtime::add_task(uint64_t* args, int num_args, int func_id, int core_type) {
+int Runtime::add_task(uint64_t* args, int num_args, int func_id, int core_type, int affinity_block) {
     // Check bounds
-    if (next_task_id >= RUNTIME_MAX_TASKS) {
-        fprintf(stderr, "[Runtime] ERROR: Task table full (max=%d)\n", RUNTIME_MAX_TASKS);
+    if (num_args > RUNTIME_MAX_ARGS) {
+        fprintf(stderr, "[Runtime] ERROR: Too many args (%d > %d)\n", num_args, RUNTIME_MAX_ARGS);
+        return -1;
+    }
+    if (core_type < 0 || core_type > static_cast<int>(CoreType::BLOCK)) {
+        fprintf(stderr, "[Runtime] ERROR: Invalid core_type %d\n", core_type);
         return -1;
     }
 
-    if (num_args > RUNTIME_MAX_ARGS) {
-        fprintf(stderr, "[Runtime] ERROR: Too many args (%d > %d)\n", num_args, RUNTIME_MAX_ARGS);
+    if (graph_external) {
+        fprintf(stderr, "[Runtime] ERROR: Cannot add tasks to a graph loaded from a file\n");
+        return -1;
+    }
+
+    // The executors of a streaming runtime read the arrays while they run,
+    // so they must not be reallocated
+    if (streaming && (stream_sealed.load(std::memory_order_relaxed) != 0 || next_task_id >= stream_capacity ||
+                         arg_count + num_args > arg_capacity)) {
+        fprintf(stderr, "[Runtime] ERROR: Streaming graph is sealed or full (tasks=%d/%d, args=%d/%d)\n",
+            next_task_id, stream_capacity, arg_count + num_args, arg_capacity);
+        return -1;
+    }
+
+    if (!reserve_tasks(next_task_id + 1) ||
+        !reserve(reinterpret_cast<void**>(&task_args), &arg_capacity, arg_count + num_args, sizeof(uint64_t))) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory growing task table (tasks=%d)\n", next_task_id);
         return -1;
     }
 
@@ -61,43 +218,1250 @@ int Runtime::add_task(uint64_t* args, int num_args, int func_id, int core_type)
     task->task_id = task_id;
     task->func_id = func_id;
     task->num_args = num_args;
+    task->args_offset = arg_count;
     if (args && num_args > 0) {
-        memcpy(task->args, args, num_args * sizeof(uint64_t));
+        memcpy(&task_args[arg_count], args, num_args * sizeof(uint64_t));
     }
+    arg_count += num_args;
     task->function_bin_addr = 0;    // Will be set by host before copying to device
     task->core_type = core_type;    // Set core type (0=AIC, 1=AIV)
     task->fanin = 0;
+    task->initial_fanin = 0;
+    task->fanout_offset = 0;
     task->fanout_count = 0;
-    memset(task->fanout, 0, sizeof(task->fanout));
+    task->priority = 0;
+    task->affinity_block = affinity_block;
+    task->hint_block = -1;
+    task->fused_next = -1;
+    task->fused_head = -1;
+    task->pred_offset = 0;
+    task->succ_head = STREAM_LIST_EMPTY;
+    task->ready_time = 0;
+    task->start_time = 0;
+    task->end_time = 0;
+    task->dispatch_time = 0;
+    task->complete_time = 0;
+    task->exec_core = -1;
+    graph_built = false;
+    bump_graph_version();
+
+    return task_id;
+}
+
+int Runtime::add_task(uint64_t* args, int num_args, int func_id, int core_type, const TensorRegion* inputs,
+    int num_inputs, const TensorRegion* outputs, int num_outputs, int affinity_block) {
+    int task_id = add_task(args, num_args, func_id, core_type, affinity_block);
+    if (task_id < 0) {
+        return -1;
+    }
 
+    // Reads first, so a read-modify-write region depends on its last writer
+    // and then becomes owned by this task
+    int saved_readers = tensor_reader_count;
+    int dep_count = 0;
+    for (int i = 0; i < num_inputs; i++) {
+        if (!track_read(task_id, inputs[i], &dep_count)) {
+            drop_last_task(saved_readers);
+            return -1;
+        }
+    }
+
+    for (int i = 0; i < num_outputs; i++) {
+        if (!collect_write_deps(task_id, outputs[i], &dep_count)) {
+            drop_last_task(saved_readers);
+            return -1;
+        }
+    }
+
+    // Writes overwrite history that cannot be restored, so the room they and
+    // the edges need is secured first: at most two new segments per region
+    if (streaming && edge_count + dep_count > stream_edge_capacity) {
+        fprintf(stderr, "[Runtime] ERROR: Streaming graph is full (edges=%d)\n", edge_count);
+        drop_last_task(saved_readers);
+        return -1;
+    }
+    if (!reserve(reinterpret_cast<void**>(&tensor_segments), &tensor_segment_capacity,
+            tensor_segment_count + 2 * num_outputs, sizeof(TensorSegment)) ||
+        !reserve_edges(edge_count + dep_count)) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory tracking the dependencies of task %d\n", task_id);
+        drop_last_task(saved_readers);
+        return -1;
+    }
+    for (int i = 0; i < num_outputs; i++) {
+        track_write(task_id, outputs[i]);
+    }
+
+    // dep_scratch holds no duplicates (see add_dep)
+    for (int i = 0; i < dep_count; i++) {
+        add_edge(dep_scratch[i], task_id, true);
+    }
     return task_id;
 }
 
-void Runtime::add_successor(int from_task, int to_task) {
+int Runtime::add_parallel_task(uint64_t* args, int num_args, int func_id, int core_type,
+    const ParallelOperand* operands, int num_operands, uint64_t extent, uint64_t tile, int size_arg) {
+    if (num_args < 0 || num_args > RUNTIME_MAX_ARGS || num_operands < 0 || num_operands > RUNTIME_MAX_ARGS) {
+        fprintf(stderr, "[Runtime] ERROR: Too many args or operands for parallel task (%d, %d > %d)\n", num_args,
+            num_operands, RUNTIME_MAX_ARGS);
+        return -1;
+    }
+    if (extent == 0 || tile == 0 || size_arg >= num_args) {
+        fprintf(stderr, "[Runtime] ERROR: Invalid parallel task extent %llu, tile %llu or size arg %d\n",
+            static_cast<unsigned long long>(extent), static_cast<unsigned long long>(tile), size_arg);
+        return -1;
+    }
+    for (int i = 0; i < num_operands; i++) {
+        const ParallelOperand& op = operands[i];
+        if (op.arg_idx < 0 || op.arg_idx >= num_args || op.elem_size <= 0 || (op.access & TENSOR_INOUT) == 0 ||
+            op.buffer_id >= buffer_count) {
+            fprintf(stderr, "[Runtime] ERROR: Invalid operand %d of parallel task (arg %d)\n", i, op.arg_idx);
+            return -1;
+        }
+    }
+
+    // A failing tile unwinds the ones before it. Their writes replaced
+    // segment history that cannot be rebuilt, so the segments are copied
+    TensorSegment* saved_segments = nullptr;
+    int saved_segment_count = tensor_segment_count;
+    if (saved_segment_count > 0) {
+        saved_segments = static_cast<TensorSegment*>(malloc(saved_segment_count * sizeof(TensorSegment)));
+        if (saved_segments == nullptr) {
+            fprintf(stderr, "[Runtime] ERROR: Out of memory adding parallel task\n");
+            return -1;
+        }
+        memcpy(saved_segments, tensor_segments, saved_segment_count * sizeof(TensorSegment));
+    }
+    int first = next_task_id;
+    int saved_readers = tensor_reader_count;
+    int saved_edges = edge_count;
+    int saved_bindings = buffer_binding_count;
+
+    uint64_t tile_args[RUNTIME_MAX_ARGS];
+    TensorRegion inputs[RUNTIME_MAX_ARGS];
+    TensorRegion outputs[RUNTIME_MAX_ARGS];
+    int rc = first;
+    for (uint64_t begin = 0; begin < extent && rc >= 0; begin += tile) {
+        uint64_t count = extent - begin < tile ? extent - begin : tile;
+        if (num_args > 0) {
+            memcpy(tile_args, args, num_args * sizeof(uint64_t));
+        }
+        int num_inputs = 0;
+        int num_outputs = 0;
+        for (int i = 0; i < num_operands; i++) {
+            const ParallelOperand& op = operands[i];
+            TensorRegion region{op.base + begin * op.elem_size, count * op.elem_size, op.buffer_id};
+            tile_args[op.arg_idx] = op.buffer_id < 0 ? region.offset : 0;  // Planned: patched by plan_buffers()
+            if (op.access & TENSOR_IN) {
+                inputs[num_inputs++] = region;
+            }
+            if (op.access & TENSOR_OUT) {
+                outputs[num_outputs++] = region;
+            }
+        }
+        if (size_arg >= 0) {
+            tile_args[size_arg] = count;
+        }
+
+        int task_id = add_task(tile_args, num_args, func_id, core_type, inputs, num_inputs, outputs, num_outputs);
+        if (task_id < 0) {
+            rc = -1;
+        }
+        for (int i = 0; i < num_operands && rc >= 0; i++) {
+            const ParallelOperand& op = operands[i];
+            if (op.buffer_id >= 0 &&
+                bind_buffer(task_id, op.arg_idx, op.buffer_id, op.base + begin * op.elem_size) != 0) {
+                rc = -1;
+            }
+        }
+    }
+    if (rc < 0 && next_task_id > first) {
+        drop_tasks(first, saved_segments, saved_segment_count, saved_readers, saved_edges, saved_bindings);
+    }
+    free(saved_segments);
+    return rc;
+}
+
+void Runtime::add_successor(int from_task, int to_task) { add_edge(from_task, to_task, false); }
+
+bool Runtime::add_edge(int from_task, int to_task, bool inferred) {
     // Validate task IDs
     if (from_task < 0 || from_task >= next_task_id) {
         fprintf(stderr, "[Runtime] ERROR: Invalid from_task ID %d\n", from_task);
-        return;
+        return false;
     }
 
     if (to_task < 0 || to_task >= next_task_id) {
         fprintf(stderr, "[Runtime] ERROR: Invalid to_task ID %d\n", to_task);
+        return false;
+    }
+
+    if (graph_external) {
+        fprintf(stderr, "[Runtime] ERROR: Cannot add edges to a graph loaded from a file\n");
+        return false;
+    }
+
+    if (streaming) {
+        if (to_task < published_count.load(std::memory_order_relaxed)) {
+            fprintf(stderr, "[Runtime] ERROR: Task %d is already published, cannot add edge from %d\n", to_task,
+                from_task);
+            return false;
+        }
+        if (edge_count >= stream_edge_capacity) {
+            fprintf(stderr, "[Runtime] ERROR: Streaming graph is full (edges=%d)\n", edge_count);
+            return false;
+        }
+    }
+
+    if (!reserve_edges(edge_count + 1)) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory growing edge table (edges=%d)\n", edge_count);
+        return false;
+    }
+
+    // Record the edge; build_graph() packs it into from_task's fanout slice
+    edge_src[edge_count] = from_task;
+    edge_dst[edge_count] = to_task;
+    edge_inferred[edge_count] = inferred;
+    edge_count++;
+
+    tasks[from_task].fanout_count++;
+    tasks[to_task].fanin++;
+    tasks[to_task].initial_fanin++;
+    graph_built = false;
+    bump_graph_version();
+    return true;
+}
+
+bool Runtime::reserve_edges(int needed) {
+    return reserve(reinterpret_cast<void**>(&edge_src), &edge_src_capacity, needed, sizeof(int)) &&
+           reserve(reinterpret_cast<void**>(&edge_dst), &edge_dst_capacity, needed, sizeof(int)) &&
+           reserve(reinterpret_cast<void**>(&edge_inferred), &edge_inferred_capacity, needed, sizeof(bool)) &&
+           reserve(reinterpret_cast<void**>(&fanout_edges), &edge_capacity, needed, sizeof(int));
+}
+
+int Runtime::build_graph() {
+    if (graph_built) {
+        return 0;
+    }
+    if (graph_external) {
+        // The CSR arrays are all there is; only the priorities can change
+        compute_priorities();
+        graph_built = true;
+        return 0;
+    }
+
+    pack_edges();
+    int removed = streaming ? 0 : reduce_edges();
+    if (removed > 0) {
+        reduced_edge_count += removed;
+        pack_edges();
+        bump_graph_version();
+    }
+
+    // Workspace for the AICore pull queues (one entry per task)
+    if (!reserve(reinterpret_cast<void**>(&pull_ring), &pull_ring_capacity, next_task_id, sizeof(int))) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory allocating pull queue (tasks=%d)\n", next_task_id);
+        return -1;
+    }
+
+    compute_priorities();
+    graph_built = true;
+    return 0;
+}
+
+void Runtime::pack_edges() {
+    // Prefix sum of fanout counts gives each task's slice in the CSR array
+    int offset = 0;
+    for (int i = 0; i < next_task_id; i++) {
+        tasks[i].fanout_offset = offset;
+        offset += tasks[i].fanout_count;
+    }
+
+    // Scatter edges in insertion order, using fanout_count as the cursor
+    for (int i = 0; i < next_task_id; i++) {
+        tasks[i].fanout_count = 0;
+    }
+    for (int e = 0; e < edge_count; e++) {
+        Task* from = &tasks[edge_src[e]];
+        fanout_edges[from->fanout_offset + from->fanout_count++] = edge_dst[e];
+    }
+}
+
+namespace {
+
+struct SuccessorEntry {
+    int position;  // Topological position of the successor
+    int slot;      // Index in the CSR successor array
+};
+
+int compare_position(const void* a, const void* b) {
+    const SuccessorEntry* ea = static_cast<const SuccessorEntry*>(a);
+    const SuccessorEntry* eb = static_cast<const SuccessorEntry*>(b);
+    if (ea->position != eb->position) {
+        return ea->position < eb->position ? -1 : 1;
+    }
+    return ea->slot < eb->slot ? -1 : (ea->slot > eb->slot ? 1 : 0);
+}
+
+}  // namespace
+
+int Runtime::reduce_edges() {
+    // Hand-wired graphs have nothing to drop; skip the reachability sets
+    bool any_inferred = false;
+    for (int e = 0; e < edge_count && !any_inferred; e++) {
+        any_inferred = edge_inferred[e];
+    }
+    if (!any_inferred) {
+        return 0;
+    }
+    size_t words = (static_cast<size_t>(next_task_id) + 63) / 64;
+    if (static_cast<size_t>(next_task_id) * words > RUNTIME_REDUCE_MAX_REACH_WORDS) {
+        fprintf(stderr, "[Runtime] WARNING: Graph too large for edge reduction, keeping all %d edges\n", edge_count);
+        return 0;
+    }
+
+    int max_fanout = 0;
+    for (int i = 0; i < next_task_id; i++) {
+        if (tasks[i].fanout_count > max_fanout) {
+            max_fanout = tasks[i].fanout_count;
+        }
+    }
+    int* order = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    int* position = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    bool* keep = static_cast<bool*>(malloc(edge_count * sizeof(bool)));
+    SuccessorEntry* succ = static_cast<SuccessorEntry*>(malloc(max_fanout * sizeof(SuccessorEntry)));
+    uint64_t* reach = static_cast<uint64_t*>(calloc(next_task_id * words, sizeof(uint64_t)));
+    int removed = 0;
+    if (order == nullptr || position == nullptr || keep == nullptr || succ == nullptr || reach == nullptr ||
+        topological_order(order) < next_task_id) {
+        // Out of memory keeps every edge; a cycle is reported by compute_priorities()
+        free(order);
+        free(position);
+        free(keep);
+        free(succ);
+        free(reach);
+        return 0;
+    }
+    for (int k = 0; k < next_task_id; k++) {
+        position[order[k]] = k;
+    }
+
+    // keep[slot] first marks the inferred edges, the only ones that may be
+    // dropped; order serves as the slot cursor (see the compaction below)
+    for (int i = 0; i < next_task_id; i++) {
+        order[i] = tasks[i].fanout_offset;
+    }
+    for (int e = 0; e < edge_count; e++) {
+        keep[order[edge_src[e]]++] = edge_inferred[e];
+    }
+    for (int t = 0; t < next_task_id; t++) {
+        order[position[t]] = t;
+    }
+
+    // reach[t]: tasks reachable from t. Visiting successors nearest first
+    // (topological order), an edge is redundant exactly when its target is
+    // already reachable through a successor visited before it.
+    for (int k = next_task_id - 1; k >= 0; k--) {
+        const Task* t = &tasks[order[k]];
+        uint64_t* row = &reach[order[k] * words];
+        for (int j = 0; j < t->fanout_count; j++) {
+            int slot = t->fanout_offset + j;
+            succ[j].position = position[fanout_edges[slot]];
+            succ[j].slot = slot;
+        }
+        qsort(succ, t->fanout_count, sizeof(SuccessorEntry), compare_position);
+        for (int j = 0; j < t->fanout_count; j++) {
+            int slot = succ[j].slot;
+            int v = fanout_edges[slot];
+            uint64_t bit = 1ULL << (v % 64);
+            bool reachable = (row[v / 64] & bit) != 0;
+            if (reachable && keep[slot]) {
+                keep[slot] = false;
+                removed++;
+                continue;
+            }
+            keep[slot] = true;
+            if (!reachable) {
+                row[v / 64] |= bit;
+                const uint64_t* from = &reach[v * words];
+                for (size_t w = 0; w < words; w++) {
+                    row[w] |= from[w];
+                }
+            }
+        }
+    }
+
+    // Compact the edge list; pack_edges() assigned each edge the slot
+    // fanout_offset + (number of earlier edges of the same task)
+    if (removed > 0) {
+        for (int i = 0; i < next_task_id; i++) {
+            order[i] = tasks[i].fanout_offset;
+        }
+        int kept = 0;
+        for (int e = 0; e < edge_count; e++) {
+            int from = edge_src[e];
+            int to = edge_dst[e];
+            if (keep[order[from]++]) {
+                edge_src[kept] = from;
+                edge_dst[kept] = to;
+                edge_inferred[kept] = edge_inferred[e];
+                kept++;
+            } else {
+                tasks[from].fanout_count--;
+                tasks[to].fanin--;
+                tasks[to].initial_fanin--;
+            }
+        }
+        edge_count = kept;
+    }
+
+    free(order);
+    free(position);
+    free(keep);
+    free(succ);
+    free(reach);
+    return removed;
+}
+
+void Runtime::set_func_cost(int func_id, int cost) {
+    if (func_id < 0 || func_id >= RUNTIME_MAX_FUNC_ID) {
+        fprintf(stderr, "[Runtime] ERROR: Invalid func_id %d for cost hint (max=%d)\n", func_id, RUNTIME_MAX_FUNC_ID);
         return;
     }
+    func_cost[func_id] = cost < 1 ? 1 : cost;
+    graph_built = false;
+    bump_graph_version();
+}
+
+int Runtime::topological_order(int* order) const {
+    int* pending = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    if (next_task_id > 0 && pending == nullptr) {
+        return -1;
+    }
 
-    Task* from = &tasks[from_task];
-    Task* to = &tasks[to_task];
+    int tail = 0;
+    for (int i = 0; i < next_task_id; i++) {
+        pending[i] = tasks[i].initial_fanin;
+        if (pending[i] == 0) {
+            order[tail++] = i;
+        }
+    }
+    for (int head = 0; head < tail; head++) {
+        const Task* t = &tasks[order[head]];
+        for (int j = 0; j < t->fanout_count; j++) {
+            int succ = fanout_edges[t->fanout_offset + j];
+            if (--pending[succ] == 0) {
+                order[tail++] = succ;
+            }
+        }
+    }
 
-    // Add to_task to from_task's fanout
-    if (from->fanout_count >= RUNTIME_MAX_FANOUT) {
-        fprintf(stderr, "[Runtime] ERROR: Fanout overflow for task %d (max=%d)\n", from_task, RUNTIME_MAX_FANOUT);
+    free(pending);
+    return tail;
+}
+
+void Runtime::compute_priorities() {
+    // A topological order lets ranks be filled in reverse, so every
+    // successor is final before its predecessors.
+    int* order = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    int tail = (next_task_id == 0 || order != nullptr) ? topological_order(order) : -1;
+    if (tail < 0) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory computing task priorities\n");
+        free(order);
         return;
     }
+    if (tail < next_task_id) {
+        fprintf(stderr, "[Runtime] ERROR: Dependency cycle detected (%d tasks unreachable)\n", next_task_id - tail);
+    }
+
+    // A fused head costs its whole chain
+    for (int i = 0; i < next_task_id; i++) {
+        tasks[i].priority = 0;
+        for (int m = i; m >= 0; m = tasks[m].fused_next) {
+            int func_id = tasks[m].func_id;
+            tasks[i].priority += (func_id >= 0 && func_id < RUNTIME_MAX_FUNC_ID) ? func_cost[func_id] : 1;
+        }
+    }
+    for (int k = tail - 1; k >= 0; k--) {
+        Task* t = &tasks[order[k]];
+        int best = 0;
+        for (int j = 0; j < t->fanout_count; j++) {
+            int succ_priority = tasks[fanout_edges[t->fanout_offset + j]].priority;
+            if (succ_priority > best) {
+                best = succ_priority;
+            }
+        }
+        t->priority += best;
+    }
+
+    free(order);
+}
+
+int Runtime::fuse_chains() {
+    if (streaming || graph_external) {
+        fprintf(stderr, "[Runtime] ERROR: Task chains cannot be fused in a streaming or loaded runtime\n");
+        return -1;
+    }
+    if (build_graph() != 0) {
+        return -1;
+    }
+
+    // pred[v]: the only predecessor of v, when v is also its only successor.
+    // Absorbed tasks have no edges, so both ends are always chain heads.
+    int* pred = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    int* order = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    int* chain_tail = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    if (next_task_id == 0 || pred == nullptr || order == nullptr || chain_tail == nullptr ||
+        topological_order(order) < next_task_id) {
+        int rc = 0;
+        if (next_task_id > 0) {
+            fprintf(stderr, "[Runtime] ERROR: Cannot fuse task chains (out of memory or dependency cycle)\n");
+            rc = -1;
+        }
+        free(pred);
+        free(order);
+        free(chain_tail);
+        return rc;
+    }
+    for (int i = 0; i < next_task_id; i++) {
+        pred[i] = -1;
+    }
+    for (int e = 0; e < edge_count; e++) {
+        const Task* u = &tasks[edge_src[e]];
+        const Task* v = &tasks[edge_dst[e]];
+        if (u->fanout_count == 1 && v->initial_fanin == 1 && u->core_type == v->core_type &&
+            u->core_type != static_cast<int>(CoreType::BLOCK) && u->affinity_block == v->affinity_block) {
+            pred[edge_dst[e]] = edge_src[e];
+        }
+    }
+
+    // In topological order the predecessor's chain is complete when a task
+    // is appended to it; chain_tail[] is only maintained for heads
+    int absorbed = 0;
+    for (int k = 0; k < next_task_id; k++) {
+        int v = order[k];
+        if (tasks[v].fused_head >= 0) {
+            continue;
+        }
+        int tail = v;
+        while (tasks[tail].fused_next >= 0) {
+            tail = tasks[tail].fused_next;
+        }
+        if (pred[v] < 0) {
+            chain_tail[v] = tail;
+            continue;
+        }
+        int head = tasks[pred[v]].fused_head >= 0 ? tasks[pred[v]].fused_head : pred[v];
+        tasks[chain_tail[head]].fused_next = v;
+        chain_tail[head] = tail;
+        for (int m = v; m >= 0; m = tasks[m].fused_next) {
+            tasks[m].fused_head = head;
+            absorbed++;
+        }
+    }
+
+    if (absorbed > 0) {
+        // Drop the edges inside chains and move the edges leaving a chain's
+        // last member to its head
+        for (int i = 0; i < next_task_id; i++) {
+            tasks[i].fanout_count = 0;
+            tasks[i].fanin = 0;
+            tasks[i].initial_fanin = 0;
+        }
+        int kept = 0;
+        for (int e = 0; e < edge_count; e++) {
+            int from = edge_src[e];
+            int to = edge_dst[e];
+            if (pred[to] == from) {
+                continue;
+            }
+            if (tasks[from].fused_head >= 0) {
+                from = tasks[from].fused_head;
+            }
+            edge_src[kept] = from;
+            edge_dst[kept] = to;
+            edge_inferred[kept] = edge_inferred[e];
+            kept++;
+            tasks[from].fanout_count++;
+            tasks[to].fanin++;
+            tasks[to].initial_fanin++;
+        }
+        edge_count = kept;
+        fused_count += absorbed;
+        graph_built = false;
+        bump_graph_version();
+        if (build_graph() != 0) {
+            absorbed = -1;
+        } else {
+            printf("[Runtime] Fused %d tasks into chains (%d tasks scheduled)\n", absorbed, get_scheduled_task_count());
+        }
+    }
 
-    from->fanout[from->fanout_count++] = to_task;
-    to->fanin++;
+    free(pred);
+    free(order);
+    free(chain_tail);
+    return absorbed;
 }
 
+// =============================================================================
+// Streaming Orchestration
+// =============================================================================
+
+int Runtime::begin_streaming(int max_tasks, int max_args, int max_edges) {
+    if (streaming || graph_external || next_task_id > 0 || max_tasks <= 0) {
+        fprintf(stderr, "[Runtime] ERROR: Streaming needs an empty runtime and a task limit (tasks=%d, limit=%d)\n",
+            next_task_id, max_tasks);
+        return -1;
+    }
+    if (max_args <= 0) {
+        max_args = max_tasks * RUNTIME_MAX_ARGS;
+    }
+    if (max_edges <= 0) {
+        max_edges = max_tasks * RUNTIME_STREAM_EDGES_PER_TASK;
+    }
+
+    int link_capacity = 0;
+    if (!reserve_tasks(max_tasks) ||
+        !reserve(reinterpret_cast<void**>(&task_args), &arg_capacity, max_args, sizeof(uint64_t)) ||
+        !reserve(reinterpret_cast<void**>(&stream_preds), &stream_edge_capacity, max_edges, sizeof(int)) ||
+        !reserve(reinterpret_cast<void**>(&stream_links), &link_capacity, max_edges, sizeof(StreamLink))) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory reserving a streaming graph (tasks=%d)\n", max_tasks);
+        return -1;
+    }
+
+    streaming = 1;
+    stream_capacity = max_tasks;
+    stream_edge_capacity = max_edges;
+    published_count.store(0, std::memory_order_relaxed);
+    stream_sealed.store(0, std::memory_order_relaxed);
+    published_edges = 0;
+    return 0;
+}
+
+int Runtime::publish_tasks() {
+    int first = published_count.load(std::memory_order_relaxed);
+    if (publish_failed) {
+        return -1;
+    }
+    if (!streaming || first == next_task_id) {
+        return 0;
+    }
+
+    // Slice stream_preds by the predecessor counts of the new tasks, then
+    // scatter their edges using fanin as the cursor; it ends up equal to
+    // initial_fanin again. Every edge recorded since the last call ends in
+    // one of these tasks (see add_successor()).
+    int offset = published_edges;
+    for (int i = first; i < next_task_id; i++) {
+        tasks[i].pred_offset = offset;
+        tasks[i].fanin.store(0, std::memory_order_relaxed);
+        offset += tasks[i].initial_fanin;
+    }
+    for (int e = published_edges; e < edge_count; e++) {
+        Task* to = &tasks[edge_dst[e]];
+        stream_preds[to->pred_offset + to->fanin.fetch_add(1, std::memory_order_relaxed)] = edge_src[e];
+    }
+    published_edges = edge_count;
+
+    if (host_api.get_function_bin_addr != nullptr) {
+        for (int i = first; i < next_task_id; i++) {
+            tasks[i].function_bin_addr = host_api.get_function_bin_addr(tasks[i].func_id);
+        }
+    }
+
+    // The new tasks may read tensors whose uploads are still queued
+    if (host_api.sync_transfers != nullptr) {
+        int rc = host_api.sync_transfers();
+        if (rc != 0) {
+            fprintf(stderr, "[Runtime] ERROR: Failed to copy the inputs of tasks %d-%d to device: %d\n", first,
+                next_task_id - 1, rc);
+            publish_failed = true;
+            return -1;
+        }
+    }
+
+    published_count.store(next_task_id, std::memory_order_release);
+    return next_task_id - first;
+}
+
+int Runtime::seal_graph() {
+    if (!streaming || stream_sealed.load(std::memory_order_relaxed) != 0) {
+        return publish_failed ? -1 : 0;
+    }
+    int rc = publish_tasks() < 0 ? -1 : 0;
+    stream_sealed.store(1, std::memory_order_release);
+
+    // Only host-side fields of the tasks change from here on
+    build_graph();
+    printf("[Runtime] Sealed streaming graph with %d tasks and %d edges\n", next_task_id, edge_count);
+    return rc;
+}
+
+bool Runtime::is_streaming() const { return streaming != 0; }
+
+int Runtime::check_launch() const {
+    if (scheduling_mode != SCHEDULE_AICORE_PULL) {
+        return 0;
+    }
+    if (streaming) {
+        fprintf(stderr, "[Runtime] ERROR: Pull scheduling is not supported with streaming orchestration\n");
+        return -1;
+    }
+    for (int i = 0; i < next_task_id; i++) {
+        if (tasks[i].core_type == static_cast<int>(CoreType::BLOCK)) {
+            fprintf(stderr, "[Runtime] ERROR: Task %d: block tasks are not supported with pull scheduling\n", i);
+            return -1;
+        }
+    }
+    if (next_task_id > 0 && pull_ring == nullptr) {
+        fprintf(stderr, "[Runtime] ERROR: Pull scheduling requested but the pull ring is not allocated\n");
+        return -1;
+    }
+    return 0;
+}
+
+// =============================================================================
+// Graph Files
+// =============================================================================
+
+int Runtime::attach_graph(Task* graph_tasks, int num_tasks, int* graph_edges, int num_edges, uint64_t* graph_args,
+    int num_args, int fused, void* mapping, size_t mapping_size) {
+    if (next_task_id > 0 || streaming || graph_external || num_tasks < 0 || num_edges < 0 || num_args < 0) {
+        fprintf(stderr, "[Runtime] ERROR: A graph can only be attached to an empty runtime\n");
+        return -1;
+    }
+    if (!reserve(reinterpret_cast<void**>(&pull_ring), &pull_ring_capacity, num_tasks, sizeof(int))) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory allocating pull queue (tasks=%d)\n", num_tasks);
+        return -1;
+    }
+
+    delete[] tasks;
+    free(task_args);
+    free(fanout_edges);
+    tasks = graph_tasks;
+    fanout_edges = graph_edges;
+    task_args = graph_args;
+    task_capacity = num_tasks;
+    edge_capacity = num_edges;
+    arg_capacity = num_args;
+    next_task_id = num_tasks;
+    edge_count = num_edges;
+    arg_count = num_args;
+    fused_count = fused;
+    graph_external = true;
+    graph_mapping = mapping;
+    graph_mapping_size = mapping_size;
+    graph_built = true;
+    bump_graph_version();
+    return 0;
+}
+
+void* Runtime::detach_graph(size_t* size) {
+    void* mapping = graph_mapping;
+    if (size != nullptr) {
+        *size = graph_mapping_size;
+    }
+    if (!graph_external) {
+        return mapping;
+    }
+    tasks = nullptr;
+    fanout_edges = nullptr;
+    task_args = nullptr;
+    task_capacity = 0;
+    edge_capacity = 0;
+    arg_capacity = 0;
+    next_task_id = 0;
+    edge_count = 0;
+    arg_count = 0;
+    fused_count = 0;
+    graph_external = false;
+    graph_mapping = nullptr;
+    graph_mapping_size = 0;
+    graph_built = false;
+    bump_graph_version();
+    return mapping;
+}
+
+// =============================================================================
+// Dependency Inference
+// =============================================================================
+
+int Runtime::find_segment(int space, uint64_t begin) const {
+    // First segment of the space that ends after begin
+    int lo = 0;
+    int hi = tensor_segment_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        const TensorSegment* seg = &tensor_segments[mid];
+        if (seg->space < space || (seg->space == space && seg->end <= begin)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool Runtime::insert_segment(int index, const TensorSegment& segment) {
+    if (!reserve(reinterpret_cast<void**>(&tensor_segments), &tensor_segment_capacity, tensor_segment_count + 1,
+            sizeof(TensorSegment))) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory growing tensor map (segments=%d)\n", tensor_segment_count);
+        return false;
+    }
+    memmove(&tensor_segments[index + 1], &tensor_segments[index],
+        (tensor_segment_count - index) * sizeof(TensorSegment));
+    tensor_segments[index] = segment;
+    tensor_segment_count++;
+    return true;
+}
+
+int Runtime::push_reader(int task_id, int next) {
+    if (!reserve(reinterpret_cast<void**>(&tensor_readers), &tensor_reader_capacity, tensor_reader_count + 1,
+            sizeof(TensorReader))) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory growing tensor map (readers=%d)\n", tensor_reader_count);
+        return -2;
+    }
+    tensor_readers[tensor_reader_count].task_id = task_id;
+    tensor_readers[tensor_reader_count].next = next;
+    return tensor_reader_count++;
+}
+
+void Runtime::drop_last_task(int saved_readers) {
+    // The task's readers are the newest entries of every list; gap segments
+    // its reads created are left with no history and go away entirely.
+    // Segments its reads split keep the same history on both halves.
+    int kept = 0;
+    for (int i = 0; i < tensor_segment_count; i++) {
+        TensorSegment seg = tensor_segments[i];
+        while (seg.readers >= saved_readers) {
+            seg.readers = tensor_readers[seg.readers].next;
+        }
+        if (seg.writer >= 0 || seg.readers >= 0) {
+            tensor_segments[kept++] = seg;
+        }
+    }
+    tensor_segment_count = kept;
+    tensor_reader_count = saved_readers;
+
+    next_task_id--;
+    arg_count -= tasks[next_task_id].num_args;
+    bump_graph_version();
+}
+
+void Runtime::drop_tasks(int first, const TensorSegment* segments, int segment_count, int saved_readers,
+    int saved_edges, int saved_bindings) {
+    // Edges added since the mark all end in dropped tasks
+    for (int e = saved_edges; e < edge_count; e++) {
+        tasks[edge_src[e]].fanout_count--;
+    }
+    edge_count = saved_edges;
+    buffer_binding_count = saved_bindings;
+    if (segment_count > 0) {
+        memcpy(tensor_segments, segments, segment_count * sizeof(TensorSegment));
+    }
+    tensor_segment_count = segment_count;
+    tensor_reader_count = saved_readers;
+
+    arg_count = tasks[first].args_offset;
+    next_task_id = first;
+    bump_graph_version();
+}
+
+bool Runtime::add_dep(int task_id, int pred, int* dep_count) {
+    if (pred < 0 || pred == task_id) {
+        return true;
+    }
+    for (int i = 0; i < *dep_count; i++) {
+        if (dep_scratch[i] == pred) {
+            return true;
+        }
+    }
+    if (!reserve(reinterpret_cast<void**>(&dep_scratch), &dep_scratch_capacity, *dep_count + 1, sizeof(int))) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory collecting dependencies of task %d\n", task_id);
+        return false;
+    }
+    dep_scratch[(*dep_count)++] = pred;
+    return true;
+}
+
+bool Runtime::track_read(int task_id, const TensorRegion& region, int* dep_count) {
+    if (region.size == 0) {
+        return true;
+    }
+    int space = region.buffer_id + 1;
+    uint64_t end = region.offset + region.size;
+    uint64_t cursor = region.offset;
+    int i = find_segment(space, cursor);
+    while (cursor < end) {
+        TensorSegment* seg = &tensor_segments[i];
+        bool overlaps = i < tensor_segment_count && seg->space == space && seg->begin < end;
+        if (!overlaps || seg->begin > cursor) {
+            // Never accessed: only this reader
+            uint64_t gap_end = overlaps ? seg->begin : end;
+            int reader = push_reader(task_id, -1);
+            if (reader < -1 || !insert_segment(i, TensorSegment{space, -1, reader, cursor, gap_end})) {
+                return false;
+            }
+            cursor = gap_end;
+            i++;
+            continue;
+        }
+        if (seg->begin < cursor || seg->end > end) {
+            // Split off the parts outside the region; both halves keep the history
+            TensorSegment tail = *seg;
+            uint64_t cut = seg->begin < cursor ? cursor : end;
+            tail.begin = cut;
+            if (!insert_segment(i + 1, tail)) {
+                return false;
+            }
+            tensor_segments[i].end = cut;
+            if (tensor_segments[i].begin < cursor) {
+                i++;
+            }
+            continue;
+        }
+        if (!add_dep(task_id, seg->writer, dep_count)) {
+            return false;
+        }
+        if (seg->readers < 0 || tensor_readers[seg->readers].task_id != task_id) {
+            int reader = push_reader(task_id, seg->readers);
+            if (reader < -1) {
+                return false;
+            }
+            tensor_segments[i].readers = reader;
+        }
+        cursor = tensor_segments[i].end;
+        i++;
+    }
+    return true;
+}
+
+bool Runtime::collect_write_deps(int task_id, const TensorRegion& region, int* dep_count) {
+    if (region.size == 0) {
+        return true;
+    }
+    int space = region.buffer_id + 1;
+    uint64_t end = region.offset + region.size;
+    for (int i = find_segment(space, region.offset);
+         i < tensor_segment_count && tensor_segments[i].space == space && tensor_segments[i].begin < end; i++) {
+        // Readers since the last write already wait for that writer
+        const TensorSegment* seg = &tensor_segments[i];
+        if (seg->readers >= 0) {
+            for (int r = seg->readers; r >= 0; r = tensor_readers[r].next) {
+                if (!add_dep(task_id, tensor_readers[r].task_id, dep_count)) {
+                    return false;
+                }
+            }
+        } else if (!add_dep(task_id, seg->writer, dep_count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Runtime::track_write(int task_id, const TensorRegion& region) {
+    if (region.size == 0) {
+        return true;
+    }
+    int space = region.buffer_id + 1;
+    uint64_t begin = region.offset;
+    uint64_t end = begin + region.size;
+    int first = find_segment(space, begin);
+    int last = first;
+    while (last < tensor_segment_count && tensor_segments[last].space == space && tensor_segments[last].begin < end) {
+        last++;
+    }
+
+    // Replace the overlapped segments by one owned by this task, keeping the
+    // parts of the outer two that lie outside the region
+    TensorSegment written{space, task_id, -1, begin, end};
+    if (first == last) {
+        return insert_segment(first, written);
+    }
+    TensorSegment head = tensor_segments[first];
+    TensorSegment tail = tensor_segments[last - 1];
+    int at = first;
+    if (head.begin < begin) {
+        head.end = begin;
+        tensor_segments[at++] = head;
+    }
+    if (at < last) {
+        tensor_segments[at] = written;
+    } else if (!insert_segment(at, written)) {
+        return false;
+    } else {
+        last++;
+    }
+    at++;
+    if (tail.end > end) {
+        tail.begin = end;
+        if (at < last) {
+            tensor_segments[at] = tail;
+        } else if (!insert_segment(at, tail)) {
+            return false;
+        } else {
+            last++;
+        }
+        at++;
+    }
+    memmove(&tensor_segments[at], &tensor_segments[last], (tensor_segment_count - last) * sizeof(TensorSegment));
+    tensor_segment_count -= last - at;
+    return true;
+}
+
+// =============================================================================
+// Memory Planning
+// =============================================================================
+
+namespace {
+
+struct PlacementEntry {
+    uint64_t key;  // Size (sort order) or offset (sweep order)
+    int buffer_id;
+};
+
+// Descending key: largest buffers are placed first
+int compare_key_desc(const void* a, const void* b) {
+    uint64_t ka = static_cast<const PlacementEntry*>(a)->key;
+    uint64_t kb = static_cast<const PlacementEntry*>(b)->key;
+    return ka < kb ? 1 : (ka > kb ? -1 : 0);
+}
+
+int compare_key_asc(const void* a, const void* b) { return compare_key_desc(b, a); }
+
+uint64_t align_buffer(uint64_t size) {
+    return (size + RUNTIME_BUFFER_ALIGN - 1) / RUNTIME_BUFFER_ALIGN * RUNTIME_BUFFER_ALIGN;
+}
+
+}  // namespace
+
+int Runtime::add_buffer(size_t size) {
+    if (!reserve(reinterpret_cast<void**>(&buffers), &buffer_capacity, buffer_count + 1, sizeof(PlannedBuffer))) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory growing buffer table (buffers=%d)\n", buffer_count);
+        return -1;
+    }
+    buffers[buffer_count].size = size;
+    buffers[buffer_count].offset = 0;
+    if (streaming) {
+        // Nothing to plan against: the rest of the graph does not exist yet
+        void* mem = host_api.device_malloc != nullptr ? host_api.device_malloc(size) : nullptr;
+        if (mem == nullptr) {
+            fprintf(stderr, "[Runtime] ERROR: Failed to allocate %zu-byte buffer\n", size);
+            return -1;
+        }
+        buffers[buffer_count].offset = reinterpret_cast<uint64_t>(mem);
+    }
+    return buffer_count++;
+}
+
+int Runtime::bind_buffer(int task_id, int arg_idx, int buffer_id, uint64_t byte_offset) {
+    Task* task = get_task(task_id);
+    if (task == nullptr) {
+        fprintf(stderr, "[Runtime] ERROR: Invalid task ID %d\n", task_id);
+        return -1;
+    }
+    if (arg_idx < 0 || arg_idx >= task->num_args) {
+        fprintf(stderr, "[Runtime] ERROR: Invalid arg index %d for task %d (num_args=%d)\n",
+            arg_idx, task_id, task->num_args);
+        return -1;
+    }
+    if (buffer_id < 0 || buffer_id >= buffer_count) {
+        fprintf(stderr, "[Runtime] ERROR: Invalid buffer ID %d\n", buffer_id);
+        return -1;
+    }
+    if (streaming) {
+        if (task_id < published_count.load(std::memory_order_relaxed)) {
+            fprintf(stderr, "[Runtime] ERROR: Task %d is already published, cannot bind buffer %d\n", task_id,
+                buffer_id);
+            return -1;
+        }
+        return set_task_arg(task_id, arg_idx, buffers[buffer_id].offset + byte_offset);
+    }
+    if (!reserve(reinterpret_cast<void**>(&buffer_bindings), &buffer_binding_capacity, buffer_binding_count + 1,
+            sizeof(BufferBinding))) {
+        fprintf(stderr, "[Runtime] ERROR: Out of memory growing buffer bindings (bindings=%d)\n",
+            buffer_binding_count);
+        return -1;
+    }
+    BufferBinding* binding = &buffer_bindings[buffer_binding_count++];
+    binding->task_id = task_id;
+    binding->arg_idx = arg_idx;
+    binding->buffer_id = buffer_id;
+    binding->byte_offset = byte_offset;
+    return 0;
+}
+
+int Runtime::plan_buffers() {
+    if (buffer_count == 0 || planned_arena != nullptr || streaming) {
+        return 0;
+    }
+    if (host_api.device_malloc == nullptr) {
+        fprintf(stderr, "[Runtime] ERROR: No device allocator to place planned buffers\n");
+        return -1;
+    }
+    if (build_graph() != 0) {
+        return -1;
+    }
+
+    int* order = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    int* user_index = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    int* user_task = static_cast<int*>(malloc(next_task_id * sizeof(int)));
+    PlacementEntry* by_size = static_cast<PlacementEntry*>(malloc(buffer_count * sizeof(PlacementEntry)));
+    PlacementEntry* placed = static_cast<PlacementEntry*>(malloc(buffer_count * sizeof(PlacementEntry)));
+    int tail = -1;
+    if ((next_task_id == 0 || (order && user_index && user_task)) && by_size && placed) {
+        tail = topological_order(order);
+    }
+    if (tail < next_task_id) {
+        if (tail < 0) {
+            fprintf(stderr, "[Runtime] ERROR: Out of memory planning buffers\n");
+        } else {
+            fprintf(stderr, "[Runtime] ERROR: Dependency cycle detected, cannot plan buffers\n");
+        }
+        free(order);
+        free(user_index);
+        free(user_task);
+        free(by_size);
+        free(placed);
+        return -1;
+    }
+
+    // Number the tasks that use a planned buffer; reachability is only
+    // tracked between those
+    int user_count = 0;
+    for (int i = 0; i < next_task_id; i++) {
+        user_index[i] = -1;
+    }
+    for (int b = 0; b < buffer_binding_count; b++) {
+        int t = buffer_bindings[b].task_id;
+        if (user_index[t] < 0) {
+            user_task[user_count] = t;
+            user_index[t] = user_count++;
+        }
+    }
+    size_t words = (user_count + 63) / 64;
+
+    // ancestors[t]: users that are strict ancestors of task t
+    // buffer_users[b]: users bound to buffer b
+    uint64_t* ancestors = nullptr;
+    uint64_t* buffer_users = nullptr;
+    if ((static_cast<size_t>(next_task_id) + buffer_count) * words <= RUNTIME_PLANNER_MAX_REACH_WORDS) {
+        ancestors = static_cast<uint64_t*>(calloc(next_task_id * words + 1, sizeof(uint64_t)));
+        buffer_users = static_cast<uint64_t*>(calloc(buffer_count * words + 1, sizeof(uint64_t)));
+    }
+    bool reuse = ancestors != nullptr && buffer_users != nullptr;
+    if (reuse) {
+        for (int k = 0; k < next_task_id; k++) {
+            int t = order[k];
+            const uint64_t* from = &ancestors[t * words];
+            const Task* task = &tasks[t];
+            for (int j = 0; j < task->fanout_count; j++) {
+                uint64_t* to = &ancestors[fanout_edges[task->fanout_offset + j] * words];
+                for (size_t w = 0; w < words; w++) {
+                    to[w] |= from[w];
+                }
+                if (user_index[t] >= 0) {
+                    to[user_index[t] / 64] |= 1ULL << (user_index[t] % 64);
+                }
+            }
+        }
+        for (int b = 0; b < buffer_binding_count; b++) {
+            int u = user_index[buffer_bindings[b].task_id];
+            buffer_users[buffer_bindings[b].buffer_id * words + u / 64] |= 1ULL << (u % 64);
+        }
+    } else {
+        fprintf(stderr, "[Runtime] WARNING: Graph too large for buffer reuse, placing %d buffers back to back\n",
+            buffer_count);
+    }
+
+    // before(a, b): every user of a is a strict ancestor of every user of b
+    auto before = [&](int a, int b) {
+        const uint64_t* users_a = &buffer_users[a * words];
+        const uint64_t* users_b = &buffer_users[b * words];
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t bits = users_b[w]; bits != 0; bits &= bits - 1) {
+                const uint64_t* anc = &ancestors[user_task[w * 64 + __builtin_ctzll(bits)] * words];
+                for (size_t x = 0; x < words; x++) {
+                    if (users_a[x] & ~anc[x]) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+
+    for (int b = 0; b < buffer_count; b++) {
+        by_size[b].key = buffers[b].size;
+        by_size[b].buffer_id = b;
+    }
+    qsort(by_size, buffer_count, sizeof(PlacementEntry), compare_key_desc);
+
+    // First fit: sweep the conflicting buffers in offset order and take the
+    // first gap that is large enough
+    uint64_t arena_size = 0;
+    uint64_t total_size = 0;
+    for (int i = 0; i < buffer_count; i++) {
+        int b = by_size[i].buffer_id;
+        uint64_t size = align_buffer(buffers[b].size);
+        int conflicts = 0;
+        for (int j = 0; j < i; j++) {
+            int other = by_size[j].buffer_id;
+            if (!reuse || !(before(other, b) || before(b, other))) {
+                placed[conflicts].key = buffers[other].offset;
+                placed[conflicts].buffer_id = other;
+                conflicts++;
+            }
+        }
+        qsort(placed, conflicts, sizeof(PlacementEntry), compare_key_asc);
+        uint64_t offset = 0;
+        for (int j = 0; j < conflicts; j++) {
+            if (placed[j].key >= offset + size) {
+                break;
+            }
+            uint64_t end = placed[j].key + align_buffer(buffers[placed[j].buffer_id].size);
+            if (end > offset) {
+                offset = end;
+            }
+        }
+        buffers[b].offset = offset;
+        if (offset + size > arena_size) {
+            arena_size = offset + size;
+        }
+        total_size += size;
+    }
+
+    free(order);
+    free(user_index);
+    free(user_task);
+    free(by_size);
+    free(placed);
+    free(ancestors);
+    free(buffer_users);
+
+    planned_arena = host_api.device_malloc(arena_size);
+    if (planned_arena == nullptr) {
+        fprintf(stderr, "[Runtime] ERROR: Failed to allocate %llu-byte buffer arena\n",
+            static_cast<unsigned long long>(arena_size));
+        return -1;
+    }
+    planned_arena_size = arena_size;
+
+    uint64_t base = reinterpret_cast<uint64_t>(planned_arena);
+    for (int b = 0; b < buffer_binding_count; b++) {
+        const BufferBinding* binding = &buffer_bindings[b];
+        set_task_arg(binding->task_id, binding->arg_idx,
+            base + buffers[binding->buffer_id].offset + binding->byte_offset);
+    }
+
+    printf("[Runtime] Planned %d buffers (%llu bytes) into a %llu-byte arena\n", buffer_count,
+        static_cast<unsigned long long>(total_size), static_cast<unsigned long long>(arena_size));
+    return 0;
+}
+
+void* Runtime::get_planned_arena() const { return planned_arena; }
+
+size_t Runtime::get_planned_arena_size() const { return planned_arena_size; }
+
 // =============================================================================
 // Query Methods
 // =============================================================================
@@ -111,18 +1475,164 @@ Task* Runtime::get_task(int task_id) {
 
 int Runtime::get_task_count() const { return next_task_id; }
 
+int Runtime::get_scheduled_task_count() const { return next_task_id - fused_count; }
+
+int Runtime::get_edge_count() const { return edge_count; }
+
+int* Runtime::get_fanout(Task* task) { return &fanout_edges[task->fanout_offset]; }
+
+uint64_t* Runtime::get_task_args(Task* task) { return &task_args[task->args_offset]; }
+
+int Runtime::set_task_arg(int task_id, int arg_idx, uint64_t value) {
+    Task* task = get_task(task_id);
+    if (task == nullptr) {
+        fprintf(stderr, "[Runtime] ERROR: Invalid task ID %d\n", task_id);
+        return -1;
+    }
+    if (arg_idx < 0 || arg_idx >= task->num_args) {
+        fprintf(stderr, "[Runtime] ERROR: Invalid arg index %d for task %d (num_args=%d)\n",
+            arg_idx, task_id, task->num_args);
+        return -1;
+    }
+    int index = task->args_offset + arg_idx;
+    if (task_args[index] != value) {
+        task_args[index] = value;
+        mark_arg_dirty(index);
+    }
+    return 0;
+}
+
+void Runtime::reset_execution_state() {
+    // A streaming launch may start while the host is still adding tasks;
+    // only the published ones have run before, later ones start out clean
+    int count = streaming ? published_count.load(std::memory_order_acquire) : next_task_id;
+    for (int i = 0; i < count; i++) {
+        tasks[i].fanin.store(tasks[i].initial_fanin, std::memory_order_relaxed);
+        tasks[i].succ_head.store(STREAM_LIST_EMPTY, std::memory_order_relaxed);
+        tasks[i].hint_block = -1;
+        tasks[i].ready_time = 0;
+        tasks[i].start_time = 0;
+        tasks[i].end_time = 0;
+        tasks[i].dispatch_time = 0;
+        tasks[i].complete_time = 0;
+        tasks[i].exec_core = -1;
+    }
+}
+
+uint64_t Runtime::get_graph_version() const { return graph_version; }
+
+void Runtime::invalidate_graph() { bump_graph_version(); }
+
+const ArgRange* Runtime::get_dirty_arg_ranges(int* count) const {
+    *count = dirty_arg_count;
+    return dirty_args;
+}
+
+void Runtime::clear_dirty_args() { dirty_arg_count = 0; }
+
+void Runtime::mark_arg_dirty(int index) {
+    // Extend a range that already covers or nearly touches the index
+    for (int i = 0; i < dirty_arg_count; i++) {
+        ArgRange* r = &dirty_args[i];
+        if (index >= r->begin - RUNTIME_DIRTY_MERGE_GAP && index < r->end + RUNTIME_DIRTY_MERGE_GAP) {
+            if (index < r->begin) r->begin = index;
+            if (index >= r->end) r->end = index + 1;
+
+            // Growing this range may have brought it next to another one
+            for (int j = 0; j < dirty_arg_count; j++) {
+                ArgRange* o = &dirty_args[j];
+                if (j != i && o->begin <= r->end + RUNTIME_DIRTY_MERGE_GAP &&
+                    r->begin <= o->end + RUNTIME_DIRTY_MERGE_GAP) {
+                    if (o->begin < r->begin) r->begin = o->begin;
+                    if (o->end > r->end) r->end = o->end;
+                    *o = dirty_args[--dirty_arg_count];
+                    break;
+                }
+            }
+            return;
+        }
+    }
+
+    if (dirty_arg_count < RUNTIME_MAX_DIRTY_RANGES) {
+        dirty_args[dirty_arg_count].begin = index;
+        dirty_args[dirty_arg_count].end = index + 1;
+        dirty_arg_count++;
+        return;
+    }
+
+    // Out of range slots: collapse everything into one covering range
+    ArgRange all = dirty_args[0];
+    for (int i = 1; i < dirty_arg_count; i++) {
+        if (dirty_args[i].begin < all.begin) all.begin = dirty_args[i].begin;
+        if (dirty_args[i].end > all.end) all.end = dirty_args[i].end;
+    }
+    if (index < all.begin) all.begin = index;
+    if (index >= all.end) all.end = index + 1;
+    dirty_args[0] = all;
+    dirty_arg_count = 1;
+}
+
+void Runtime::bump_graph_version() { graph_version = g_graph_version.fetch_add(1, std::memory_order_relaxed) + 1; }
+
 int Runtime::get_initial_ready_tasks(int* ready_tasks) {
-    initial_ready_count = 0;
+    int ready_count = 0;
     for (int i = 0; i < next_task_id; i++) {
-        if (tasks[i].fanin == 0) {
-            initial_ready_tasks[initial_ready_count] = i;
+        if (tasks[i].initial_fanin == 0 && tasks[i].fused_head < 0) {
             if (ready_tasks != nullptr) {
-                ready_tasks[initial_ready_count] = i;
+                ready_tasks[ready_count] = i;
             }
-            initial_ready_count++;
+            ready_count++;
         }
     }
-    return initial_ready_count;
+    return ready_count;
+}
+
+// =============================================================================
+// Device Image
+// =============================================================================
+
+// Sections are 8-byte aligned so that the uint64_t args pool stays aligned
+// after the int edge array.
+static size_t align_up_8(size_t size) { return (size + 7) & ~static_cast<size_t>(7); }
+
+size_t Runtime::get_device_header_size() const {
+    return align_up_8(reinterpret_cast<const char*>(&task_capacity) - reinterpret_cast<const char*>(this));
+}
+
+size_t Runtime::get_device_image_size() const {
+    // The trailing pull ring is device scratch: reserved, never written here
+    return get_device_args_offset() + arg_count * sizeof(uint64_t) + next_task_id * sizeof(int);
+}
+
+size_t Runtime::get_device_args_offset() const {
+    return get_device_header_size() + align_up_8(next_task_id * sizeof(Task)) + align_up_8(edge_count * sizeof(int));
+}
+
+void Runtime::write_device_header(void* dst, uint64_t dev_base) const {
+    size_t tasks_offset = get_device_header_size();
+    size_t edges_offset = tasks_offset + align_up_8(next_task_id * sizeof(Task));
+    size_t args_offset = edges_offset + align_up_8(edge_count * sizeof(int));
+
+    memcpy(dst, this, tasks_offset);
+
+    // Rebase graph pointers to the device copy
+    Runtime* image = reinterpret_cast<Runtime*>(dst);
+    image->tasks = reinterpret_cast<Task*>(dev_base + tasks_offset);
+    image->fanout_edges = reinterpret_cast<int*>(dev_base + edges_offset);
+    image->task_args = reinterpret_cast<uint64_t*>(dev_base + args_offset);
+    image->pull_ring = reinterpret_cast<int*>(dev_base + args_offset + arg_count * sizeof(uint64_t));
+}
+
+void Runtime::write_device_image(void* dst, uint64_t dev_base) const {
+    char* out = static_cast<char*>(dst);
+    size_t tasks_offset = get_device_header_size();
+    size_t edges_offset = tasks_offset + align_up_8(next_task_id * sizeof(Task));
+    size_t args_offset = edges_offset + align_up_8(edge_count * sizeof(int));
+
+    write_device_header(out, dev_base);
+    memcpy(out + tasks_offset, tasks, next_task_id * sizeof(Task));
+    memcpy(out + edges_offset, fanout_edges, edge_count * sizeof(int));
+    memcpy(out + args_offset, task_args, arg_count * sizeof(uint64_t));
 }
 
 // =============================================================================
@@ -138,16 +1648,23 @@ void Runtime::print_runtime() const {
         "======================================================================"
         "==========\n");
     printf("  Total tasks: %d\n", next_task_id);
+    if (fused_count > 0) {
+        printf("  Scheduled tasks: %d (%d fused into chains)\n", get_scheduled_task_count(), fused_count);
+    }
+    printf("  Total edges: %d\n", edge_count);
+    if (reduced_edge_count > 0) {
+        printf("  Redundant inferred edges dropped: %d\n", reduced_edge_count);
+    }
 
     // Print initially ready tasks
-    printf("\nInitially Ready Tasks (fanin==0):\n");
+    printf("\nInitially Ready Tasks (initial_fanin==0):\n");
     printf(
         "----------------------------------------------------------------------"
         "----------\n");
     printf("  ");
     int ready_count = 0;
     for (int i = 0; i < next_task_id; i++) {
-        if (tasks[i].fanin.load() == 0) {
+        if (tasks[i].initial_fanin == 0 && tasks[i].fused_head < 0) {
             if (ready_count > 0) printf(", ");
             printf("%d", i);
             ready_count++;
@@ -166,18 +1683,35 @@ void Runtime::print_runtime() const {
     for (int i = 0; i < next_task_id; i++) {
         const Task* t = &tasks[i];
 
-        printf("  Task %d: func_id=%d, fanin=%d, fanout=%d, args=%d [",
-            i,
-            t->func_id,
-            t->fanin.load(),
+        // Priorities are only known once build_graph() has run
+        if (graph_built) {
+            printf("  Task %d: func_id=%d, priority=%d, ", i, t->func_id, t->priority);
+        } else {
+            printf("  Task %d: func_id=%d, ", i, t->func_id);
+        }
+        printf("fanin=%d, fanout=%d, args=%d [",
+            t->initial_fanin,
             t->fanout_count,
             t->num_args);
 
-        // Print fanout list
-        for (int j = 0; j < t->fanout_count; j++) {
-            printf("%d%s", t->fanout[j], j < t->fanout_count - 1 ? "," : "");
+        // Print fanout list (from the CSR array once built, else from the edge list)
+        if (graph_built) {
+            for (int j = 0; j < t->fanout_count; j++) {
+                printf("%d%s", fanout_edges[t->fanout_offset + j], j < t->fanout_count - 1 ? "," : "");
+            }
+        } else {
+            int printed = 0;
+            for (int e = 0; e < edge_count; e++) {
+                if (edge_src[e] == i) {
+                    printf("%s%d", printed++ > 0 ? "," : "", edge_dst[e]);
+                }
+            }
+        }
+        printf("]");
+        if (t->fused_head >= 0) {
+            printf(" fused into task %d", t->fused_head);
         }
-        printf("]\n");
+        printf("\n");
     }
 
     printf(
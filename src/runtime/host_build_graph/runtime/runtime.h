@@ -2,14 +2,16 @@
  * Runtime Class - Task Dependency Runtime Management
  *
  * This is a simplified, standalone runtime class for managing task
- * dependencies. Tasks are stored in a fixed-size array with compile-time
- * configurable bounds. Each task has:
+ * dependencies. Tasks are stored in a dense, heap-backed array that grows
+ * on demand. Each task has:
  * - Unique ID (array index)
- * - Arguments (uint64_t array)
+ * - Arguments (a slice of the shared args pool)
  * - Fanin (predecessor count)
- * - Fanout (array of successor task IDs)
+ * - Fanout (a slice of the shared CSR successor array)
  *
- * The runtime maintains a ready queue for tasks with fanin == 0.
+ * Edges are collected while the orchestration function runs and packed
+ * into CSR form by build_graph() once it finishes, so the graph that is
+ * uploaded to the device only contains the real tasks, edges and args.
  *
  * Based on patterns from pto_runtime.h/c but simplified for educational
  * and lightweight scheduling use cases.
@@ -29,26 +31,74 @@
 // Configuration Macros
 // =============================================================================
 
-#ifndef RUNTIME_MAX_TASKS
-#define RUNTIME_MAX_TASKS 1024
+#ifndef RUNTIME_INITIAL_TASKS
+#define RUNTIME_INITIAL_TASKS 1024
 #endif
 
 #ifndef RUNTIME_MAX_ARGS
 #define RUNTIME_MAX_ARGS 16
 #endif
 
-#ifndef RUNTIME_MAX_FANOUT
-#define RUNTIME_MAX_FANOUT 512
+#ifndef RUNTIME_MAX_FUNC_ID
+#define RUNTIME_MAX_FUNC_ID 64
+#endif
+
+#ifndef RUNTIME_MAX_DIRTY_RANGES
+#define RUNTIME_MAX_DIRTY_RANGES 64
+#endif
+
+// Dirty argument updates closer than this many args are merged into one copy
+#ifndef RUNTIME_DIRTY_MERGE_GAP
+#define RUNTIME_DIRTY_MERGE_GAP 8
 #endif
 
 #ifndef RUNTIME_MAX_WORKER
 #define RUNTIME_MAX_WORKER 72  // 24 AIC + 48 AIV cores
 #endif
 
+// Maximum number of AICPU scheduler threads with their own stats block
+#ifndef RUNTIME_MAX_SCHED_THREADS
+#define RUNTIME_MAX_SCHED_THREADS 16
+#endif
+
+// Maximum number of runtimes one device executes at once, each on its own
+// block range with its own AICPU scheduler state (see Runtime::partition)
+#ifndef RUNTIME_MAX_PARTITIONS
+#define RUNTIME_MAX_PARTITIONS 8
+#endif
+
+// Only one ready queue operation in this many is timed for
+// SchedulerStats::queue_op_ticks, which scales it up (power of two)
+#ifndef RUNTIME_QUEUE_TIMING_SAMPLE
+#define RUNTIME_QUEUE_TIMING_SAMPLE 16
+#endif
+
 #ifndef RUNTIME_MAX_TENSOR_PAIRS
 #define RUNTIME_MAX_TENSOR_PAIRS 64
 #endif
 
+// Offset alignment of buffers placed by the memory planner
+#ifndef RUNTIME_BUFFER_ALIGN
+#define RUNTIME_BUFFER_ALIGN 512
+#endif
+
+// Cap on the reachability bitsets of the memory planner (in 64-bit words,
+// 8 MB); larger graphs place their buffers back to back without reuse
+#ifndef RUNTIME_PLANNER_MAX_REACH_WORDS
+#define RUNTIME_PLANNER_MAX_REACH_WORDS (1024 * 1024)
+#endif
+
+// Cap on the reachability bitsets of the transitive edge reduction (in 64-bit
+// words, 8 MB: about 8K tasks); larger graphs keep their redundant edges
+#ifndef RUNTIME_REDUCE_MAX_REACH_WORDS
+#define RUNTIME_REDUCE_MAX_REACH_WORDS (1024 * 1024)
+#endif
+
+// Edges reserved per task by begin_streaming() when no edge limit is given
+#ifndef RUNTIME_STREAM_EDGES_PER_TASK
+#define RUNTIME_STREAM_EDGES_PER_TASK 8
+#endif
+
 // =============================================================================
 // Data Structures
 // =============================================================================
@@ -62,37 +112,80 @@
  * Protocol State Machine:
  * 1. Initialization: AICPU sets aicpu_ready=1
  * 2. Acknowledgment: AICore sets aicore_done=core_id+1
- * 3. Task Dispatch: AICPU assigns task pointer and sets task_status=1
- * 4. Task Execution: AICore reads task, executes, sets task_status=0
- * 5. Task Completion: AICPU reads task_status=0, clears task=0
+ * 3. Task Dispatch: AICPU writes the task pointer into
+ *    slot_task[dispatch_seq % RUNTIME_HANDSHAKE_SLOTS], then increments
+ *    dispatch_seq
+ * 4. Task Execution: while complete_seq != dispatch_seq, AICore executes the
+ *    task in slot complete_seq % RUNTIME_HANDSHAKE_SLOTS and increments
+ *    complete_seq
+ * 5. Task Completion: AICPU retires every task between its last seen
+ *    complete_seq and the current one, which frees their slots
  * 6. Shutdown: AICPU sets control=1, AICore exits
  *
+ * The AICPU keeps at most Runtime::handshake_depth tasks in flight per core,
+ * so with a depth > 1 the next task is already queued when the current one
+ * finishes and the core does not wait for a scheduler round trip.
+ *
  * Each AICore instance has its own handshake buffer to enable concurrent
  * task execution across multiple cores.
  */
 
+#ifndef RUNTIME_HANDSHAKE_SLOTS
+#define RUNTIME_HANDSHAKE_SLOTS 4
+#endif
+
 /**
  * Handshake buffer for AICPU-AICore communication
  *
  * Each AICore has its own handshake buffer for synchronization with AICPU.
  * The structure is cache-line aligned (64 bytes) to prevent false sharing
- * between cores and optimize cache coherency operations.
+ * between cores; the dispatch ring written by the AICPU sits on its own
+ * cache line, apart from the fields written by the AICore.
  *
  * Field Access Patterns:
  * - aicpu_ready: Written by AICPU, read by AICore
  * - aicore_done: Written by AICore, read by AICPU
- * - task: Written by AICPU, read by AICore (0 = no task assigned)
- * - task_status: Written by both (AICPU=1 on dispatch, AICore=0 on completion)
+ * - complete_seq: Written by AICore, read by AICPU (tasks finished so far)
  * - control: Written by AICPU, read by AICore (0 = continue, 1 = quit)
  * - core_type: Written by AICPU, read by AICore (0 = AIC, 1 = AIV)
+ * - completion_slot: Written by AICPU, read by AICore (index into
+ *   Runtime::completion_board, -1 = not used)
+ * - dispatch_seq: Written by AICPU, read by AICore (tasks posted so far)
+ * - slot_task: Written by AICPU, read by AICore (Task* ring)
  */
 struct Handshake {
-    volatile uint32_t aicpu_ready;  // AICPU ready signal: 0=not ready, 1=ready
-    volatile uint32_t aicore_done;  // AICore ready signal: 0=not ready, core_id+1=ready
-    volatile uint64_t task;         // Task pointer: 0=no task, non-zero=Task* address
-    volatile int32_t task_status;   // Task execution status: 0=idle, 1=busy
-    volatile int32_t control;       // Control signal: 0=execute, 1=quit
-    volatile int32_t core_type;     // Core type: 0=AIC, 1=AIV
+    volatile uint32_t aicpu_ready;   // AICPU ready signal: 0=not ready, 1=ready
+    volatile uint32_t aicore_done;   // AICore ready signal: 0=not ready, core_id+1=ready
+    volatile uint32_t complete_seq;  // Number of tasks completed by this core
+    volatile int32_t control;        // Control signal: 0=execute, 1=quit
+    volatile int32_t core_type;      // Core type: 0=AIC, 1=AIV
+    volatile int32_t completion_slot;  // Completion board entry mirroring complete_seq (-1 = none)
+
+    // Dispatch ring (AICPU -> AICore)
+    volatile uint32_t dispatch_seq __attribute__((aligned(64)));  // Number of tasks posted to this core
+    volatile uint64_t slot_task[RUNTIME_HANDSHAKE_SLOTS];          // Task* indexed by seq % RUNTIME_HANDSHAKE_SLOTS
+} __attribute__((aligned(64)));
+
+/**
+ * Hot-path counters of one AICPU scheduler thread
+ *
+ * Always collected. Each thread only writes its own block, so no atomics
+ * are needed; the AICPU resets all blocks at the start of every run, and
+ * they are copied back with the runtime header. Times are device system
+ * counter ticks (steady_clock ns in simulation).
+ */
+struct SchedulerStats {
+    uint64_t run_ticks;                   // Scheduler loop wall time of the last run
+    uint64_t loop_iterations;             // Scheduler loop passes
+    uint64_t idle_iterations;             // Passes that neither retired nor dispatched a task
+    uint64_t tasks_dispatched;            // Tasks posted to cores (a gang task counts once)
+    uint64_t tasks_completed;             // Tasks retired by this thread
+    uint64_t dispatch_latency_ticks;      // Sum of ready -> posted over the dispatched tasks
+    uint64_t max_dispatch_latency_ticks;  // Longest ready -> posted
+    uint64_t queue_op_ticks;              // Time spent in ready queue push/pop (CAS contention), sampled
+    uint64_t queue_ops;                   // Ready queue push/pop calls (see RUNTIME_QUEUE_TIMING_SAMPLE)
+    uint64_t blocks_migrated;             // Blocks taken over from another thread (CORE_PARTITION_DYNAMIC)
+    int max_ready_depth[3];               // Deepest ready queue seen, by core type (AIC, AIV, BLOCK)
 } __attribute__((aligned(64)));
 
 /**
@@ -101,10 +194,14 @@ struct Handshake {
  * Specifies which AICore type a task should run on.
  * AIC (AICore Compute) handles compute-intensive operations.
  * AIV (AICore Vector) handles vector/SIMD operations.
+ * BLOCK reserves one AIC and its two AIVs of the same block at once; the
+ * task's kernel is started on all three cores together and the task
+ * completes when the last of them finishes.
  */
 enum class CoreType : int {
-    AIC = 0,  // AICore Compute
-    AIV = 1   // AICore Vector
+    AIC = 0,   // AICore Compute
+    AIV = 1,   // AICore Vector
+    BLOCK = 2  // Gang: AIC + both AIVs of one block
 };
 
 /**
@@ -117,28 +214,243 @@ struct TensorPair {
     size_t size;
 };
 
+/**
+ * Device allocation that task args may point into, saved as a relocatable
+ * tensor slot of a graph file (see save_graph_impl())
+ */
+struct GraphTensor {
+    uint64_t dev_addr;  // Base device address
+    uint64_t size;      // Size in bytes
+};
+
+/**
+ * Logical intermediate buffer placed by the memory planner
+ */
+struct PlannedBuffer {
+    size_t size;      // Requested size in bytes
+    uint64_t offset;  // Offset in the planned arena (valid after plan_buffers()); device address when streaming
+};
+
+/**
+ * Task argument that receives the address of a planned buffer
+ */
+struct BufferBinding {
+    int task_id;
+    int arg_idx;
+    int buffer_id;
+    uint64_t byte_offset;  // Added to the buffer address
+};
+
+/**
+ * Byte range of a tensor that a task reads or writes
+ *
+ * With buffer_id >= 0 the range is relative to that planned buffer
+ * (add_buffer()), otherwise offset is a device address.
+ */
+struct TensorRegion {
+    uint64_t offset;  // Device address, or byte offset into the planned buffer
+    uint64_t size;    // Length in bytes
+    int buffer_id;    // Planned buffer, -1 = device memory
+};
+
+/**
+ * How a data-parallel task uses a tensor operand
+ */
+enum TensorAccess {
+    TENSOR_IN = 1,     // Read
+    TENSOR_OUT = 2,    // Written
+    TENSOR_INOUT = 3,  // Read and written
+};
+
+/**
+ * Tensor argument of add_parallel_task()
+ *
+ * The tensor is split along its flat element index: tile k of the task
+ * gets the address of element k * tile in args[arg_idx] and accesses the
+ * elements of that tile only.
+ */
+struct ParallelOperand {
+    int arg_idx;      // Argument receiving the tile address
+    int access;       // TensorAccess
+    uint64_t base;    // Device address, or byte offset into the planned buffer
+    int buffer_id;    // Planned buffer, -1 = device memory
+    int elem_size;    // Bytes per element
+};
+
+/**
+ * Span of one tensor address space with uniform access history, kept by
+ * the dependency tracker of add_task() with regions
+ *
+ * Segments of a space are disjoint and sorted by begin. Readers form a
+ * list through Runtime::tensor_readers that is only ever prepended to, so
+ * split segments can share it.
+ */
+struct TensorSegment {
+    int space;       // 0 = device memory, buffer_id + 1 for a planned buffer
+    int writer;      // Last task that wrote the span, -1 = none
+    int readers;     // Head of the readers since that write, -1 = none
+    uint64_t begin;  // First byte
+    uint64_t end;    // One past the last byte
+};
+
+struct TensorReader {
+    int task_id;
+    int next;  // Next (older) reader, -1 = end
+};
+
+class Runtime;
+
 /**
  * Host API function pointers for device memory operations.
  * Allows runtime to use pluggable device memory backends.
+ *
+ * device_malloc_host allocates the device copy of a host buffer. Where the
+ * platform can alias host memory (a2a3sim with set_host_aliasing()), it
+ * returns host_ptr itself and copies between the pair are no-ops;
+ * otherwise it behaves like device_malloc(size).
+ *
+ * release_runtime_memory, if set, frees every device allocation made while
+ * the runtime was initialized (its tensors and intermediates) in one call.
+ *
+ * get_function_bin_addr, if set, returns the device address of a registered
+ * kernel. Streaming runtimes use it to resolve the kernels of tasks that are
+ * published after the launch has started.
+ *
+ * copy_to_device_async/copy_from_device_async, if set, queue a copy and
+ * return; sync_transfers waits for every queued copy and must be called
+ * before the data is used (by a launch or on the host). A host buffer from
+ * host_malloc_pinned is transferred without a staging copy.
  */
 struct HostApi {
     void* (*device_malloc)(size_t size);
+    void* (*device_malloc_host)(void* host_ptr, size_t size);
     void (*device_free)(void* dev_ptr);
     int (*copy_to_device)(void* dev_ptr, const void* host_ptr, size_t size);
     int (*copy_from_device)(void* host_ptr, const void* dev_ptr, size_t size);
+    void (*release_runtime_memory)(Runtime* runtime);
+    uint64_t (*get_function_bin_addr)(int func_id);
+    void* (*host_malloc_pinned)(size_t size);
+    void (*host_free_pinned)(void* host_ptr);
+    int (*copy_to_device_async)(void* dev_ptr, const void* host_ptr, size_t size);
+    int (*copy_from_device_async)(void* host_ptr, const void* dev_ptr, size_t size);
+    int (*sync_transfers)();
+};
+
+/**
+ * Ordering of the AICPU ready queues
+ */
+enum ReadyQueuePolicy {
+    READY_QUEUE_LIFO = 0,  // Most recently released task first (default)
+    READY_QUEUE_FIFO = 1,  // Tasks dispatched in the order they became ready
+    READY_QUEUE_STEALING = 2,  // Per-thread deques (owner LIFO), idle threads steal
+    READY_QUEUE_PRIORITY = 3,  // Highest Task::priority (critical path) first
+};
+
+/**
+ * How the AICPU scheduler detects finished tasks
+ */
+enum CompletionMode {
+    COMPLETION_POLL_HANDSHAKE = 0,  // Read complete_seq from every core's handshake (default)
+    COMPLETION_BOARD = 1,           // Read Runtime::completion_board instead of the handshakes
+};
+
+/**
+ * Who resolves dependencies and hands out ready tasks
+ */
+enum SchedulingMode {
+    SCHEDULE_AICPU = 0,        // AICPU threads dispatch through the handshakes (default)
+    SCHEDULE_AICORE_PULL = 1,  // AICores claim tasks from Runtime::pull_queues themselves
+};
+
+/**
+ * How the AICPU scheduler threads share the blocks of a launch
+ *
+ * Either way each block (its AIC and both AIVs) is managed by one thread
+ * at a time, and threads beyond block_dim stay idle.
+ */
+enum CorePartitioning {
+    CORE_PARTITION_STATIC = 0,   // Fixed contiguous ranges, sizes differ by at most one block (default)
+    CORE_PARTITION_DYNAMIC = 1,  // Threads claim blocks as they start; idle threads take blocks from busy ones
+};
+
+/**
+ * First block managed by scheduler thread t under CORE_PARTITION_STATIC
+ *
+ * Thread t manages blocks [t * block_dim / thread_count,
+ * (t + 1) * block_dim / thread_count).
+ */
+inline int sched_thread_first_block(int t, int block_dim, int thread_count) {
+    return t * block_dim / thread_count;
+}
+
+/**
+ * Result of one aicore_poll() step, for simulators that multiplex cores
+ */
+enum AicorePollResult {
+    AICORE_POLL_IDLE = 0,      // Nothing posted to the core yet
+    AICORE_POLL_PROGRESS = 1,  // Completed the handshake or ran tasks
+    AICORE_POLL_EXIT = 2,      // The AICPU sent the quit signal
+};
+
+/**
+ * Device-global ready queue for SCHEDULE_AICORE_PULL
+ *
+ * Every task is pushed at most once per run, so a queue is a plain array
+ * slice of Runtime::pull_ring with two monotonically increasing cursors.
+ * Producers reserve a slot with tail.fetch_add() and then write the task ID;
+ * consumers claim a slot by advancing head with a CAS and wait for the
+ * entry to leave its -1 reset value.
+ */
+struct PullQueue {
+    std::atomic<int> head;  // Next slot a consumer claims
+    std::atomic<int> tail;  // Next slot a producer fills
+    int base;               // Index of the first entry in Runtime::pull_ring
+    int capacity;           // Entries reserved for this core type
+} __attribute__((aligned(64)));
+
+/**
+ * Values of Task::succ_head besides a link index
+ */
+enum StreamListState {
+    STREAM_LIST_EMPTY = -1,   // No successor has registered yet
+    STREAM_LIST_CLOSED = -2,  // The task has finished; successors no longer wait for it
+};
+
+/**
+ * Successor list entry built by the AICPU for a streaming runtime
+ *
+ * Link i belongs to predecessor slot i of Runtime::stream_preds. When the
+ * task owning that slot is admitted, it pushes the link onto the
+ * predecessor's Task::succ_head list, unless the list is already closed.
+ */
+struct StreamLink {
+    int task;  // Successor waiting for the predecessor
+    int next;  // Next link of the same list, -1 = end
+};
+
+/**
+ * Half-open range [begin, end) of indices into the runtime args pool.
+ * Used to track args modified since the last device upload.
+ */
+struct ArgRange {
+    int begin;
+    int end;
 };
 
 /**
  * Task entry in the runtime
  *
  * Each task has a unique ID (its index in the task array), arguments,
- * and dependency information (fanin/fanout).
+ * and dependency information (fanin/fanout). Arguments and successors
+ * are not stored inline: args_offset indexes the runtime's shared args
+ * pool and fanout_offset indexes its CSR successor array, which keeps the
+ * header small and the task array dense.
  */
 typedef struct {
-    int task_id;                      // Unique task identifier
-    int func_id;                      // Function identifier
-    uint64_t args[RUNTIME_MAX_ARGS];  // Task arguments
-    int num_args;                     // Number of valid arguments
+    int task_id;      // Unique task identifier
+    int func_id;      // Function identifier
+    int num_args;     // Number of valid arguments
+    int args_offset;  // Index of the first argument in Runtime::task_args
 
     // Runtime function pointer address (NEW)
     // This is the GM address where the kernel binary resides
@@ -146,19 +458,65 @@ typedef struct {
     uint64_t function_bin_addr;  // Address of kernel in device GM memory
 
     // Core type specification (NEW)
-    // Specifies which core type this task should run on: 0=AIC, 1=AIV
-    int core_type;  // 0=AIC, 1=AIV
+    // Specifies which core type this task should run on: 0=AIC, 1=AIV,
+    // 2=whole block (see CoreType::BLOCK)
+    int core_type;  // 0=AIC, 1=AIV, 2=BLOCK
 
     // Dependency tracking (using PTO runtime terminology)
-    std::atomic<int> fanin;          // Number of predecessors (dependencies)
-    int fanout[RUNTIME_MAX_FANOUT];  // Successor task IDs
-    int fanout_count;                // Number of successors
+    std::atomic<int> fanin;  // Unresolved predecessors (decremented during execution)
+    int initial_fanin;       // Number of predecessors as built (reset source for replay)
+    int fanout_offset;       // Index of the first successor in Runtime::fanout_edges
+    int fanout_count;        // Number of successors
+    int priority;            // Bottom-level rank: cost-weighted longest path to a sink
+
+    // Locality hints (used when Runtime::affinity_dispatch is set)
+    int affinity_block;  // Block requested by the orchestration (-1 = any)
+    int hint_block;      // Block of the predecessor that released this task (-1 = none)
 
-    // DFX-specific fields
-    uint64_t start_time;  // Start time of the task
-    uint64_t end_time;    // End time of the task
+    // Fused chains (see Runtime::fuse_chains()): the head is scheduled as one
+    // task and its core runs every member kernel in order
+    int fused_next;  // Next task of the chain run by the same core (-1 = none)
+    int fused_head;  // Head that runs this task (-1 = scheduled by itself)
+
+    // Streaming orchestration (see Runtime::begin_streaming()): predecessors
+    // are published with the task and successors register at admission
+    int pred_offset;             // First of initial_fanin predecessors in Runtime::stream_preds
+    std::atomic<int> succ_head;  // Successor list in Runtime::stream_links, or a StreamListState
+
+    // DFX-specific fields, filled in when Runtime::profiling_enabled is set.
+    // Times are device system counter ticks (steady_clock ns in simulation);
+    // 0 = not recorded.
+    uint64_t ready_time;     // AICPU: task became ready (always recorded, for SchedulerStats)
+    uint64_t start_time;     // AICore: kernel entry
+    uint64_t end_time;       // AICore: kernel return
+    uint64_t dispatch_time;  // AICPU: task posted to a core
+    uint64_t complete_time;  // AICPU: completion observed and successors released
+    int exec_core;           // Core that ran the task (the AIC of the block for gang tasks), -1 = none
 } Task;
 
+/**
+ * Doorbell for persistent executors
+ *
+ * In persistent mode the AICPU and AICore kernels are launched once and
+ * stay resident. The host submits a graph by uploading its runtime,
+ * writing its device address to `runtime` and incrementing submit_seq; the
+ * executors run it with the normal per-graph protocol and then idle-wait
+ * for the next submission. When every AICore has acknowledged the graph in
+ * core_seq[] and every AICPU thread has finished, the last AICPU thread
+ * publishes done_seq. Setting shutdown=1 makes idle executors exit.
+ *
+ * Only one submission is outstanding at a time: the host waits for
+ * done_seq to catch up before ringing again.
+ */
+struct ExecutorDoorbell {
+    volatile uint64_t runtime;      // Host -> device: Runtime* of the current submission
+    volatile uint32_t submit_seq;   // Host -> device: number of graphs submitted
+    volatile int32_t shutdown;      // Host -> device: 1 = exit when idle
+    volatile uint32_t done_seq __attribute__((aligned(64)));  // Device -> host: graphs finished
+    volatile int32_t status;        // Device -> host: first non-zero AICPU return code (0 = ok)
+    volatile uint32_t core_seq[RUNTIME_MAX_WORKER] __attribute__((aligned(64)));  // AICore acks
+} __attribute__((aligned(64)));
+
 // =============================================================================
 // Runtime Class
 // =============================================================================
@@ -166,11 +524,19 @@ typedef struct {
 /**
  * Runtime class for task dependency management
  *
- * Maintains a fixed-size array of tasks and uses a Queue for ready tasks.
- * Tasks are allocated monotonically and never reused within the same
- * runtime instance.
+ * Maintains a dense array of tasks plus a shared args pool and CSR edge
+ * array. All three grow geometrically on the host, starting from
+ * RUNTIME_INITIAL_TASKS tasks. Tasks are allocated monotonically and never
+ * reused within the same runtime instance.
  *
- * Dependencies are managed manually via add_successor().
+ * Dependencies are either added manually via add_successor() or inferred
+ * from the tensor regions declared to add_task(), and packed into CSR form
+ * by build_graph(), which also drops inferred edges implied by others.
+ *
+ * Memory layout: everything up to the host-only section is mirrored to
+ * device memory. The task, edge and args arrays are referenced through
+ * pointers so that only their used prefix has to be uploaded; see
+ * write_device_image().
  */
 class Runtime {
 public:
@@ -181,26 +547,132 @@ public:
     // Execution parameters for AICPU scheduling
     int block_dim;     // Number of AIC blocks (block dimension)
     int sche_cpu_num;  // Number of AICPU threads for scheduling
+    int partition;     // AICPU scheduler state slot (0..RUNTIME_MAX_PARTITIONS-1), set by the platform
+    int block_offset;  // First device block of the partition the runtime runs on
+    int ready_queue_policy;  // ReadyQueuePolicy used by the AICPU scheduler
+    int handshake_depth;     // Tasks in flight per core (1..RUNTIME_HANDSHAKE_SLOTS)
+    int completion_mode;     // CompletionMode used by the AICPU scheduler
+    int affinity_dispatch;   // Nonzero: prefer a task's affinity/producer block when it has a free core
+    int scheduling_mode;     // SchedulingMode
+    int core_partitioning;   // CorePartitioning
+    int profiling_enabled;   // Nonzero: executors stamp the DFX fields of every Task
+    uint64_t device_log_buffer;  // AICPU log ring buffer (set by the platform), 0 = log as text
+
+    // SCHEDULE_AICORE_PULL state, reset by the AICPU before every run
+    PullQueue pull_queues[2];                                 // Indexed by core type (0=AIC, 1=AIV)
+    std::atomic<int> pull_completed __attribute__((aligned(64)));  // Tasks finished by AICores
+
+    // Completion board: AICores mirror complete_seq into the entry named by
+    // Handshake::completion_slot, which is the core's own index. The entries
+    // are packed, so one pass over a few cache lines finds every core that
+    // finished work instead of touching each core's handshake line.
+    volatile uint32_t completion_board[RUNTIME_MAX_WORKER] __attribute__((aligned(64)));
+
+    // Scheduler counters of the last run (see SchedulerStats). Each core's
+    // busy time is the time it had at least one task posted but not yet
+    // retired, accumulated by the thread that owns the core.
+    SchedulerStats sched_stats[RUNTIME_MAX_SCHED_THREADS];
+    uint64_t core_busy_ticks[RUNTIME_MAX_WORKER];
+
+    // Packed task graph (device-visible)
+    // On the host these point to heap storage owned by the runtime; in the
+    // device image they are rebased to the uploaded copies.
+    Task* tasks;            // Dense task headers [task_count]
+    int* fanout_edges;      // CSR successor IDs [edge_count], sliced by Task::fanout_offset
+    uint64_t* task_args;    // Shared args pool [arg_count], sliced by Task::args_offset
+    int* pull_ring;         // Pull queue storage [task_count]; scratch, never uploaded
+
+    // Streaming orchestration (see begin_streaming()): the host publishes
+    // tasks in batches while the executors already run
+    int streaming;                     // Nonzero: tasks are admitted as they are published
+    int stream_capacity;               // Task limit of a streaming runtime
+    std::atomic<int> published_count;  // Host -> device: tasks [0, published_count) may be admitted
+    std::atomic<int> stream_sealed;    // Host -> device: nonzero once no more tasks will be published
+    int* stream_preds;                 // Predecessor IDs [edge limit], sliced by Task::pred_offset
+    StreamLink* stream_links;          // Successor lists [edge limit], written by the AICPU
 
 private:
-    // Task storage
-    Task tasks[RUNTIME_MAX_TASKS];  // Fixed-size task array
-    int next_task_id;               // Next available task ID
+    int next_task_id;  // Next available task ID (= task count)
+    int edge_count;    // Number of dependency edges
+    int arg_count;     // Number of used args pool entries
+    int fused_count;   // Tasks absorbed into fused chains (never dispatched)
+
+    // =========================================================================
+    // Host-only state (not copied to device)
+    // =========================================================================
+
+    // Allocated capacity of the graph arrays (in elements)
+    int task_capacity;
+    int edge_capacity;
+    int edge_src_capacity;
+    int edge_dst_capacity;
+    int arg_capacity;
+    int pull_ring_capacity;
+    int stream_edge_capacity;  // Edge limit of a streaming runtime
+    int published_edges;       // Edges already scattered into stream_preds
+    bool publish_failed;       // An upload of publish_tasks() failed; nothing more is published
+
+    // Edge list collected by add_successor(), packed into fanout_edges by build_graph()
+    int* edge_src;
+    int* edge_dst;
+    bool* edge_inferred;     // Edge derived from tensor regions (may be dropped by reduce_edges())
+    int edge_inferred_capacity;
+    int reduced_edge_count;  // Inferred edges dropped by reduce_edges() so far
+    bool graph_built;
+    uint64_t graph_version;
+
+    // Graph arrays adopted by attach_graph(): not owned, structure read-only
+    bool graph_external;
+    void* graph_mapping;
+    size_t graph_mapping_size;
 
-    // Initial ready tasks (computed once, read-only after)
-    int initial_ready_tasks[RUNTIME_MAX_TASKS];
-    int initial_ready_count;
+    // Args pool ranges modified since the last upload
+    ArgRange dirty_args[RUNTIME_MAX_DIRTY_RANGES];
+    int dirty_arg_count;
 
-  // Tensor pairs for host-device memory tracking
-  TensorPair tensor_pairs[RUNTIME_MAX_TENSOR_PAIRS];
-  int tensor_pair_count;
+    // Dependency tracker of add_task() with regions: access history per
+    // tensor span, sorted by (space, begin), plus the shared reader lists
+    TensorSegment* tensor_segments;
+    TensorReader* tensor_readers;
+    int* dep_scratch;  // Predecessors of the task being added
+    int tensor_segment_count;
+    int tensor_segment_capacity;
+    int tensor_reader_count;
+    int tensor_reader_capacity;
+    int dep_scratch_capacity;
+
+    // Per-func_id cost hints for priority computation
+    int func_cost[RUNTIME_MAX_FUNC_ID];
+
+    // Tensor pairs for host-device memory tracking
+    TensorPair tensor_pairs[RUNTIME_MAX_TENSOR_PAIRS];
+    int tensor_pair_count;
+
+    // Memory planner: logical buffers and the task args bound to them
+    PlannedBuffer* buffers;
+    BufferBinding* buffer_bindings;
+    int buffer_count;
+    int buffer_binding_count;
+    int buffer_capacity;
+    int buffer_binding_capacity;
+    void* planned_arena;  // Device allocation holding every planned buffer
+    size_t planned_arena_size;
 
 public:
     /**
-     * Constructor - zero-initialize all arrays
+     * Constructor - reserve RUNTIME_INITIAL_TASKS tasks
      */
     Runtime();
 
+    /**
+     * Destructor - release the graph arrays
+     */
+    ~Runtime();
+
+    // The runtime owns its graph arrays
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+
     // =========================================================================
     // Task Management
     // =========================================================================
@@ -211,22 +683,321 @@ public:
      * @param args      Array of uint64_t arguments
      * @param num_args  Number of arguments (must be <= RUNTIME_MAX_ARGS)
      * @param func_id   Function identifier
-     * @param core_type Core type for this task (0=AIC, 1=AIV)
+     * @param core_type Core type for this task (0=AIC, 1=AIV, 2=whole block)
+     * @param affinity_block Block this task should preferably run on, e.g.
+     *                  the block of the producer whose output it reads
+     *                  (-1 = no preference)
      * @return Task ID (>= 0) on success, -1 on failure
+     *
+     * NOTE: May grow the task array, which invalidates Task pointers
+     * returned earlier by get_task(); keep task IDs instead.
      */
-    int add_task(uint64_t *args, int num_args, int func_id, int core_type = 0);
+    int add_task(uint64_t *args, int num_args, int func_id, int core_type = 0, int affinity_block = -1);
+
+    /**
+     * Allocate a new task and derive its dependencies from the tensor
+     * regions it reads and writes
+     *
+     * The runtime tracks the access history of every byte range passed
+     * here and adds an edge from each earlier task the new one conflicts
+     * with: the last writer of what it reads (read-after-write), and the
+     * readers since the last write, or else the last writer, of what it
+     * writes (write-after-read, write-after-write). Regions only conflict
+     * within the same planned buffer or within device memory. Only tasks
+     * added through this variant are tracked; edges from add_successor()
+     * can be mixed in freely.
+     *
+     * @param args         Array of uint64_t arguments
+     * @param num_args     Number of arguments (must be <= RUNTIME_MAX_ARGS)
+     * @param func_id      Function identifier
+     * @param core_type    Core type for this task (0=AIC, 1=AIV, 2=whole block)
+     * @param inputs       Regions the task reads (may be nullptr if num_inputs is 0)
+     * @param num_inputs   Number of input regions
+     * @param outputs      Regions the task writes; read-modify-write regions
+     *                     go in both lists
+     * @param num_outputs  Number of output regions
+     * @param affinity_block Block this task should preferably run on (-1 = any)
+     * @return Task ID (>= 0) on success, -1 on failure
+     */
+    int add_task(uint64_t *args, int num_args, int func_id, int core_type, const TensorRegion *inputs,
+        int num_inputs, const TensorRegion *outputs, int num_outputs, int affinity_block = -1);
+
+    /**
+     * Allocate one task per tile of a data-parallel kernel
+     *
+     * Splits [0, extent) into tiles of `tile` elements (the last one may be
+     * shorter) and adds a task per tile with add_task() and regions: each
+     * operand's argument points at the tile's first element (planned
+     * buffers are bound with the matching byte offset) and args[size_arg]
+     * receives the tile's element count. Other arguments are copied as is.
+     *
+     * Dependencies are inferred per tile, so when consecutive stages are
+     * both added this way, tile k of a stage waits only for the tiles of
+     * the previous stage it reads, not for the whole stage.
+     *
+     * @param args          Argument template (operand and size slots are overwritten)
+     * @param num_args      Number of arguments (must be <= RUNTIME_MAX_ARGS)
+     * @param func_id       Function identifier
+     * @param core_type     Core type of every tile task
+     * @param operands      Tensor arguments
+     * @param num_operands  Number of operands (must be <= RUNTIME_MAX_ARGS)
+     * @param extent        Total number of elements
+     * @param tile          Elements per tile
+     * @param size_arg      Argument receiving the tile's element count (-1 = none)
+     * @return ID of the first tile task on success (tile k is that ID + k),
+     *         -1 on failure, in which case none of the tiles is added
+     */
+    int add_parallel_task(uint64_t *args, int num_args, int func_id, int core_type, const ParallelOperand *operands,
+        int num_operands, uint64_t extent, uint64_t tile, int size_arg);
 
     /**
      * Add a dependency edge: from_task -> to_task
      *
-     * This adds to_task to from_task's fanout array and increments
-     * to_task's fanin counter.
+     * This records the edge for build_graph() and increments to_task's
+     * fanin and initial_fanin counters.
      *
      * @param from_task  Producer task ID
      * @param to_task    Consumer task ID (depends on from_task)
      */
     void add_successor(int from_task, int to_task);
 
+    /**
+     * Pack the recorded edges into the CSR successor array
+     *
+     * Called once the orchestration function has finished. Inferred edges
+     * (see add_task() with regions) that are implied by other edges
+     * (duplicates, or u -> w when u -> v -> ... -> w exists) are removed
+     * first; edges from add_successor() are always kept, and graphs without
+     * inferred edges skip the pass. Graphs whose reachability sets would
+     * exceed RUNTIME_REDUCE_MAX_REACH_WORDS keep every edge. Successors keep the
+     * order in which add_successor() was called. Also computes each task's
+     * priority (bottom-level rank) from the func_id cost hints. Idempotent;
+     * adding tasks or edges afterwards marks the graph dirty again. Streaming
+     * runtimes keep every edge, since the executors use the published
+     * predecessor counts.
+     *
+     * @return 0 on success, -1 if the pull queue workspace cannot be
+     *         allocated (the graph stays unbuilt)
+     */
+    int build_graph();
+
+    /**
+     * Set the relative cost of a kernel for priority computation
+     *
+     * Task::priority of a task is its own cost plus the highest priority of
+     * its successors. Kernels without a hint cost 1, which makes the rank the
+     * number of tasks on the longest path to a sink.
+     *
+     * @param func_id  Function identifier (must be < RUNTIME_MAX_FUNC_ID)
+     * @param cost     Relative cost (>= 1)
+     */
+    void set_func_cost(int func_id, int cost);
+
+    /**
+     * Fuse linear chains of tasks into single scheduled tasks
+     *
+     * A task is absorbed into its predecessor when it is that predecessor's
+     * only successor and has no other predecessor, and both run on the same
+     * core type (not BLOCK) with the same affinity. The head of each chain
+     * inherits the successors of its last member and runs the member kernels
+     * back to back on one core, saving a dispatch round trip per absorbed
+     * task. Task IDs, args and bindings are unchanged, so set_task_arg()
+     * still works on absorbed tasks; with profiling each member kernel is
+     * stamped on its own.
+     *
+     * Call after orchestration, before the first launch. Calling it again
+     * extends the existing chains.
+     *
+     * @return Number of tasks absorbed by this call, -1 on a streaming runtime,
+     *         if the graph cannot be built, has a dependency cycle or memory
+     *         runs out
+     */
+    int fuse_chains();
+
+    // =========================================================================
+    // Streaming Orchestration
+    // =========================================================================
+
+    /**
+     * Switch an empty runtime to streaming orchestration
+     *
+     * A streaming runtime is launched before its graph is complete. The
+     * orchestration hands its tasks to the running executors in batches with
+     * publish_tasks(); a task waits for its predecessors as usual, and for
+     * tasks that are not published yet simply by not being admitted. The
+     * launch finishes once seal_graph() has been called and every published
+     * task has run, so device execution of early tasks overlaps host
+     * construction of later ones.
+     *
+     * The executors read the graph arrays while the host appends to them,
+     * so the arrays are allocated here once and never grow: adding more
+     * tasks, args or edges than reserved fails. Edges may only end in tasks
+     * that are not published yet. Transitive reduction, chain fusion and
+     * SCHEDULE_AICORE_PULL are not available, READY_QUEUE_PRIORITY falls
+     * back to FIFO order, and planned buffers get an allocation of their own
+     * instead of sharing a planned arena.
+     *
+     * @param max_tasks  Task limit
+     * @param max_args   Args pool limit (<= 0: max_tasks * RUNTIME_MAX_ARGS)
+     * @param max_edges  Edge limit (<= 0: max_tasks * RUNTIME_STREAM_EDGES_PER_TASK)
+     * @return 0 on success, -1 if the runtime already has tasks or is out of memory
+     */
+    int begin_streaming(int max_tasks, int max_args = 0, int max_edges = 0);
+
+    /**
+     * Hand the tasks added since the last call to the executors
+     *
+     * Packs the predecessors of the new tasks into stream_preds, resolves
+     * their kernel addresses, waits for queued input copies
+     * (host_api.sync_transfers) and then publishes them with one release
+     * store.
+     * Does nothing on a runtime that is not streaming, so orchestration
+     * functions can call it unconditionally.
+     *
+     * If the copies fail the tasks stay unpublished, as do all tasks added
+     * later; the launch then drains what was published before.
+     *
+     * @return Number of tasks published, or -1 if the input copies failed
+     */
+    int publish_tasks();
+
+    /**
+     * Publish the remaining tasks and tell the executors that none will follow
+     *
+     * Called by the runtime maker when a streaming orchestration returns,
+     * also when it fails, so that the launch can drain. Packs the CSR
+     * successor arrays for trace export and the cost model.
+     *
+     * @return 0 on success, -1 if a publish_tasks() call failed
+     */
+    int seal_graph();
+
+    /**
+     * Check whether begin_streaming() has been called
+     */
+    bool is_streaming() const;
+
+    /**
+     * Check that the executors can run the runtime as configured
+     *
+     * Called by the platform before a launch. SCHEDULE_AICORE_PULL does not
+     * support streaming orchestration or whole-block tasks; the AICPU would
+     * reject such a runtime only after the launch has started.
+     *
+     * @return 0 if the runtime can be launched, -1 otherwise
+     */
+    int check_launch() const;
+
+    // =========================================================================
+    // Graph Files
+    // =========================================================================
+
+    /**
+     * Adopt a built graph stored outside the runtime, e.g. in a mapped file
+     *
+     * The task, edge and args arrays are used in place, without copying;
+     * the runtime writes their execution state and patched args, so the
+     * memory must be writable (a private mapping is). The arrays must hold a
+     * packed graph as build_graph() leaves it, with priorities computed.
+     * The runtime does not free the arrays, and its structure is read-only
+     * afterwards: adding tasks or edges, fusing chains and streaming fail,
+     * while set_task_arg() keeps working.
+     *
+     * @param graph_tasks    Task headers [num_tasks]
+     * @param num_tasks      Number of tasks
+     * @param graph_edges    CSR successor IDs [num_edges]
+     * @param num_edges      Number of edges
+     * @param graph_args     Args pool [num_args]
+     * @param num_args       Number of args pool entries
+     * @param fused          Tasks absorbed into fused chains
+     * @param mapping        Memory holding the arrays, kept for the owner (may be nullptr)
+     * @param mapping_size   Size of that memory in bytes
+     * @return 0 on success, -1 if the runtime already has tasks or is out of memory
+     */
+    int attach_graph(Task* graph_tasks, int num_tasks, int* graph_edges, int num_edges, uint64_t* graph_args,
+        int num_args, int fused, void* mapping, size_t mapping_size);
+
+    /**
+     * Release the graph adopted by attach_graph()
+     *
+     * Hands the memory passed to attach_graph() back to its owner and leaves
+     * the runtime without tasks, edges or args, so nothing points into that
+     * memory once the owner frees it. Does nothing if the runtime owns its
+     * graph arrays.
+     *
+     * @param size  Output: size in bytes (may be nullptr)
+     * @return Mapping, or nullptr if the runtime owns its graph arrays
+     */
+    void* detach_graph(size_t* size);
+
+    // =========================================================================
+    // Memory Planning
+    // =========================================================================
+
+    /**
+     * Declare a logical intermediate buffer
+     *
+     * Instead of device_malloc'ing an intermediate for the whole lifetime of
+     * the graph, the orchestration declares it here and binds it to the task
+     * arguments that read or write it. plan_buffers() then packs all buffers
+     * into one device allocation, letting buffers whose users are ordered by
+     * the dependency graph share memory.
+     *
+     * A planned buffer is only valid while its bound tasks run: it has no
+     * defined initial contents and cannot be recorded as a tensor pair.
+     *
+     * On a streaming runtime the graph is never complete before launch, so
+     * the buffer is allocated right away and bound args are patched
+     * immediately.
+     *
+     * @param size  Size in bytes
+     * @return Buffer ID (>= 0) on success, -1 on failure
+     */
+    int add_buffer(size_t size);
+
+    /**
+     * Bind a task argument to a planned buffer
+     *
+     * The argument is overwritten with the buffer's device address plus
+     * byte_offset by plan_buffers(), and the task counts as a user of the
+     * buffer when lifetimes are computed.
+     *
+     * @param task_id      Task that reads or writes the buffer
+     * @param arg_idx      Argument index (must be < the task's num_args)
+     * @param buffer_id    Buffer returned by add_buffer()
+     * @param byte_offset  Offset into the buffer passed to the task
+     * @return 0 on success, -1 on invalid task, argument or buffer
+     */
+    int bind_buffer(int task_id, int arg_idx, int buffer_id, uint64_t byte_offset = 0);
+
+    /**
+     * Place the planned buffers and patch their addresses into the task args
+     *
+     * Two buffers may overlap only if every user of one is a dependency
+     * graph ancestor of every user of the other. Buffers are placed largest
+     * first at the lowest offset free of all conflicting buffers, then the
+     * arena is allocated with host_api.device_malloc. Called by the runtime
+     * maker after orchestration; does nothing if there are no buffers or
+     * they are already placed.
+     *
+     * @return 0 on success, -1 on a dependency cycle or allocation failure
+     */
+    int plan_buffers();
+
+    /**
+     * Get the device allocation holding the planned buffers
+     *
+     * @return Arena base, or nullptr before plan_buffers() or without buffers
+     */
+    void* get_planned_arena() const;
+
+    /**
+     * Get the size of the planned arena
+     *
+     * @return Arena size in bytes
+     */
+    size_t get_planned_arena_size() const;
+
     // =========================================================================
     // Query Methods
     // =========================================================================
@@ -246,11 +1017,99 @@ public:
      */
     int get_task_count() const;
 
+    /**
+     * Get the number of tasks the scheduler dispatches
+     *
+     * @return Task count minus the tasks absorbed by fuse_chains()
+     */
+    int get_scheduled_task_count() const;
+
+    /**
+     * Get the total number of dependency edges in the runtime
+     *
+     * @return Total edge count
+     */
+    int get_edge_count() const;
+
+    /**
+     * Get the successor IDs of a task (valid after build_graph())
+     *
+     * @param task  Task to query
+     * @return Pointer to task->fanout_count successor IDs
+     */
+    int *get_fanout(Task *task);
+
+    /**
+     * Get the argument slice of a task
+     *
+     * @param task  Task to query
+     * @return Pointer to task->num_args arguments
+     */
+    uint64_t *get_task_args(Task *task);
+
+    /**
+     * Replace one argument of an existing task
+     *
+     * Used to rebind tensor base pointers before replaying a resident graph.
+     * The changed slot is recorded as a dirty args range, so the next launch
+     * only uploads the modified args instead of the whole graph.
+     *
+     * @param task_id  Task to update
+     * @param arg_idx  Argument index (must be < the task's num_args)
+     * @param value    New argument value
+     * @return 0 on success, -1 on invalid task or argument index
+     */
+    int set_task_arg(int task_id, int arg_idx, uint64_t value);
+
+    /**
+     * Reset per-launch execution state so the graph can run again
+     *
+     * Restores fanin from initial_fanin and clears timestamps. Executors call
+     * this at the start of a launch, so a graph that is already resident on
+     * the device can be replayed without re-running orchestration.
+     */
+    void reset_execution_state();
+
+    /**
+     * Get the version of the graph structure
+     *
+     * Bumped whenever tasks or edges change. Argument updates through
+     * set_task_arg() do not bump it; they are tracked as dirty ranges. Used by
+     * the host to decide whether the device copy of the graph can be patched
+     * or has to be re-uploaded.
+     *
+     * @return Graph version counter
+     */
+    uint64_t get_graph_version() const;
+
+    /**
+     * Mark the device copy of the graph as stale
+     *
+     * Call after modifying tasks through get_task() directly.
+     */
+    void invalidate_graph();
+
+    /**
+     * Get the args pool ranges modified since the last upload
+     *
+     * Ranges are disjoint and nearby updates are already merged (see
+     * RUNTIME_DIRTY_MERGE_GAP), so each range maps to one copy.
+     *
+     * @param count  Output: number of ranges
+     * @return Pointer to the dirty ranges
+     */
+    const ArgRange* get_dirty_arg_ranges(int* count) const;
+
+    /**
+     * Forget dirty args ranges once the device copy is up to date
+     */
+    void clear_dirty_args();
+
     /**
      * Get initially ready tasks (fanin == 0) as entry point for execution
      *
      * This scans all tasks and populates the provided array with task IDs
-     * that have no dependencies (fanin == 0). The runtime can use this
+     * that have no dependencies (initial_fanin == 0). The runtime can use this
      * as the starting point for task scheduling.
      *
      * @param ready_tasks  Array to populate with ready task IDs (can be
@@ -259,6 +1118,59 @@ public:
      */
     int get_initial_ready_tasks(int *ready_tasks);
 
+    // =========================================================================
+    // Device Image
+    // =========================================================================
+
+    /**
+     * Get the size of the device image of this runtime
+     *
+     * The image is the device-visible header followed by the used prefix
+     * of the task, edge and args arrays.
+     *
+     * @return Image size in bytes
+     */
+    size_t get_device_image_size() const;
+
+    /**
+     * Get the size of the device-visible runtime header
+     *
+     * The header (handshake buffers, scheduling parameters and graph
+     * pointers) is the part that changes on every launch.
+     *
+     * @return Header size in bytes
+     */
+    size_t get_device_header_size() const;
+
+    /**
+     * Get the offset of the args pool within the device image
+     *
+     * @return Byte offset from the start of the image
+     */
+    size_t get_device_args_offset() const;
+
+    /**
+     * Serialize only the device header into a host staging buffer
+     *
+     * Graph pointers are rebased exactly as in write_device_image(), so the
+     * header can be refreshed while the graph stays resident.
+     *
+     * @param dst       Host buffer of at least get_device_header_size() bytes
+     * @param dev_base  Device address the full image lives at
+     */
+    void write_device_header(void* dst, uint64_t dev_base) const;
+
+    /**
+     * Serialize the device image into a host staging buffer
+     *
+     * Graph pointers in the written header are rebased so that they are
+     * valid once the buffer is copied to dev_base.
+     *
+     * @param dst       Host buffer of at least get_device_image_size() bytes
+     * @param dev_base  Device address the image will be copied to
+     */
+    void write_device_image(void* dst, uint64_t dev_base) const;
+
     // =========================================================================
     // Utility Methods
     // =========================================================================
@@ -309,6 +1221,58 @@ public:
     // Host API function pointers for device memory operations
     // NOTE: Placed at end of class to avoid affecting device memory layout
     HostApi host_api;
+
+private:
+    // Scatter the edge list into the CSR successor array
+    void pack_edges();
+
+    // Drop inferred edges implied by other paths (requires the CSR arrays);
+    // returns the number of edges removed
+    int reduce_edges();
+
+    // add_successor(), marking whether the edge was inferred
+    bool add_edge(int from_task, int to_task, bool inferred);
+    bool reserve_edges(int needed);
+
+    // Undo the last add_task() with regions when its dependencies could not
+    // be tracked; readers from index saved_readers on are its own
+    void drop_last_task(int saved_readers);
+
+    // Undo every task from first on, restoring the tensor map, edges and
+    // buffer bindings recorded before it was added
+    void drop_tasks(int first, const TensorSegment* segments, int segment_count, int saved_readers, int saved_edges,
+        int saved_bindings);
+
+    // Record an access of task_id to a tensor region in the dependency
+    // tracker, appending the tasks it must wait for to dep_scratch. A write
+    // collects its dependencies before any region is overwritten, and
+    // track_write() cannot fail once insert room for two segments is reserved.
+    bool track_read(int task_id, const TensorRegion& region, int* dep_count);
+    bool collect_write_deps(int task_id, const TensorRegion& region, int* dep_count);
+    bool track_write(int task_id, const TensorRegion& region);
+    bool add_dep(int task_id, int pred, int* dep_count);
+    int find_segment(int space, uint64_t begin) const;
+    bool insert_segment(int index, const TensorSegment& segment);
+    int push_reader(int task_id, int next);
+
+    // Compute Task::priority for all tasks (requires the CSR arrays)
+    void compute_priorities();
+
+    // Kahn's algorithm over the CSR arrays; returns the number of tasks
+    // written to order (< task count on a cycle), or -1 if out of memory
+    int topological_order(int* order) const;
+
+    // Record that args pool entry `index` changed since the last upload
+    void mark_arg_dirty(int index);
+
+    // Assign a new globally unique graph version
+    void bump_graph_version();
+
+    // Grow a POD array so that it holds at least `needed` elements
+    static bool reserve(void** array, int* capacity, int needed, size_t elem_size);
+
+    // Grow the task array (new[] and member-wise moves) to `needed` tasks
+    bool reserve_tasks(int needed);
 };
 
 #endif  // RUNTIME_H
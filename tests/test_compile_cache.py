@@ -0,0 +1,156 @@
+"""Tests for CompileCache."""
+
+import sys
+import threading
+from pathlib import Path
+
+import pytest
+
+# Add python/ to path so we can import compile_cache
+PROJECT_ROOT = Path(__file__).parent.parent
+sys.path.insert(0, str(PROJECT_ROOT / "python"))
+
+import compile_cache
+from compile_cache import CompileCache, get_compile_cache
+
+
+@pytest.fixture(autouse=True)
+def isolated_cache_dir(tmp_path, monkeypatch):
+    """Keep every case away from the developer's real cache."""
+    cache_dir = tmp_path / "env_cache"
+    monkeypatch.setenv("PTO_COMPILE_CACHE_DIR", str(cache_dir))
+    monkeypatch.delenv("PTO_COMPILE_CACHE", raising=False)
+    monkeypatch.setattr(compile_cache, "_default_cache", None)
+    return cache_dir
+
+
+@pytest.fixture
+def cache(tmp_path):
+    return CompileCache(cache_dir=tmp_path / "cache", enabled=True)
+
+
+@pytest.fixture
+def sources(tmp_path):
+    src = tmp_path / "src"
+    (src / "include").mkdir(parents=True)
+    (src / "kernel.cpp").write_text("int f() { return 1; }\n")
+    (src / "include" / "common.h").write_text("#define N 1\n")
+    return src
+
+
+# --- Key tests ---
+
+
+class TestCompileCacheKey:
+    """Test which inputs change an artifact's key."""
+
+    def key(self, cache, sources, **overrides):
+        args = dict(
+            kind="incore",
+            platform="a2a3sim",
+            flags=["-O2"],
+            files=[sources / "kernel.cpp"],
+            dirs=[sources / "include"],
+        )
+        args.update(overrides)
+        return cache.key(**args)
+
+    def test_same_inputs_same_key(self, cache, sources):
+        assert self.key(cache, sources) == self.key(cache, sources)
+
+    def test_source_contents_change_key(self, cache, sources):
+        before = self.key(cache, sources)
+        (sources / "kernel.cpp").write_text("int f() { return 2; }\n")
+        assert self.key(cache, sources) != before
+
+    def test_include_dir_contents_change_key(self, cache, sources):
+        before = self.key(cache, sources)
+        (sources / "include" / "common.h").write_text("#define N 2\n")
+        assert self.key(cache, sources) != before
+
+    def test_new_header_changes_key(self, cache, sources):
+        before = self.key(cache, sources)
+        (sources / "include" / "extra.h").write_text("\n")
+        assert self.key(cache, sources) != before
+
+    def test_flags_and_platform_change_key(self, cache, sources):
+        base = self.key(cache, sources)
+        assert self.key(cache, sources, flags=["-O3"]) != base
+        assert self.key(cache, sources, platform="a2a3") != base
+        assert self.key(cache, sources, kind="orchestration") != base
+
+
+# --- Configuration tests ---
+
+
+class TestCompileCacheConfig:
+    """Test the environment defaults."""
+
+    def test_default_dir_from_environment(self, isolated_cache_dir):
+        assert CompileCache().cache_dir == isolated_cache_dir
+        assert get_compile_cache().cache_dir == isolated_cache_dir
+
+    def test_disabled_from_environment(self, monkeypatch):
+        monkeypatch.setenv("PTO_COMPILE_CACHE", "0")
+        assert not CompileCache().enabled
+
+
+# --- Storage tests ---
+
+
+class TestCompileCacheStorage:
+    """Test loading, storing and concurrent builds."""
+
+    def test_miss_builds_and_hit_loads(self, cache):
+        calls = []
+
+        def build():
+            calls.append(1)
+            return b"artifact"
+
+        assert cache.get_or_build("ab" * 32, build) == b"artifact"
+        assert cache.get_or_build("ab" * 32, build) == b"artifact"
+        assert len(calls) == 1
+
+    def test_entries_persist_across_instances(self, tmp_path):
+        first = CompileCache(cache_dir=tmp_path, enabled=True)
+        first.get_or_build("cd" * 32, lambda: b"persisted")
+        second = CompileCache(cache_dir=tmp_path, enabled=True)
+        assert second.get_or_build("cd" * 32, lambda: pytest.fail("rebuilt")) == b"persisted"
+
+    def test_disabled_always_builds(self, tmp_path):
+        cache = CompileCache(cache_dir=tmp_path, enabled=False)
+        cache.get_or_build("ef" * 32, lambda: b"one")
+        assert cache.get_or_build("ef" * 32, lambda: b"two") == b"two"
+        assert not any(tmp_path.iterdir())
+
+    def test_failed_build_stores_nothing(self, cache):
+        def build():
+            raise RuntimeError("compile error")
+
+        with pytest.raises(RuntimeError):
+            cache.get_or_build("01" * 32, build)
+        assert cache.get_or_build("01" * 32, lambda: b"fixed") == b"fixed"
+
+    def test_concurrent_builders_build_once(self, tmp_path):
+        calls = []
+        results = []
+        started = threading.Barrier(4)
+
+        def build():
+            calls.append(1)
+            return b"shared"
+
+        def job():
+            # Separate instances, as parallel jobs would have
+            local = CompileCache(cache_dir=tmp_path, enabled=True)
+            started.wait()
+            results.append(local.get_or_build("23" * 32, build))
+
+        threads = [threading.Thread(target=job) for _ in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        assert results == [b"shared"] * 4
+        assert len(calls) == 1
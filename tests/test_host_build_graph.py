@@ -0,0 +1,640 @@
+"""Tests for the graph construction of the host_build_graph runtime (src/runtime/host_build_graph).
+
+Each test compiles a small C++ driver against the host side of the runtime,
+builds a graph with it and checks what the driver prints.
+"""
+
+import shutil
+import struct
+import subprocess
+from pathlib import Path
+
+import pytest
+
+PROJECT_ROOT = Path(__file__).parent.parent
+RUNTIME_DIR = PROJECT_ROOT / "src" / "runtime" / "host_build_graph"
+
+requires_gxx = pytest.mark.skipif(shutil.which("g++") is None, reason="g++ not found")
+
+DRIVER_PRELUDE = r"""
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "runtime.h"
+
+static void* fake_device_malloc(size_t size) { return malloc(size); }
+static void fake_device_free(void* ptr) { free(ptr); }
+
+static Runtime* new_runtime() {
+    Runtime* runtime = new Runtime();
+    runtime->host_api.device_malloc = fake_device_malloc;
+    runtime->host_api.device_free = fake_device_free;
+    return runtime;
+}
+
+static int add_plain_task(Runtime* runtime, int func_id = 0) {
+    uint64_t args[4] = {0, 0, 0, 0};
+    return runtime->add_task(args, 4, func_id, 1);
+}
+"""
+
+
+def build_driver(tmp_path, body, sources=("runtime/runtime.cpp",)):
+    """Compile a driver (DRIVER_PRELUDE + body) with the given runtime sources and return the executable."""
+    driver = tmp_path / "driver.cpp"
+    driver.write_text(DRIVER_PRELUDE + body)
+    exe = tmp_path / "driver"
+    cmd = [
+        "g++", "-std=c++17", "-O1",
+        f"-I{RUNTIME_DIR / 'runtime'}",
+        f"-I{PROJECT_ROOT / 'src' / 'platform' / 'include'}",
+        str(driver),
+        *[str(RUNTIME_DIR / source) for source in sources],
+        "-o", str(exe), "-lpthread",
+    ]
+    build = subprocess.run(cmd, capture_output=True, text=True)
+    assert build.returncode == 0, build.stderr
+    return exe
+
+
+def run_built_driver(exe, *argv):
+    """Run a driver and return its output lines."""
+    run = subprocess.run([str(exe), *[str(arg) for arg in argv]], capture_output=True, text=True, timeout=60)
+    assert run.returncode == 0, run.stdout + run.stderr
+    return run.stdout.splitlines()
+
+
+def run_driver(tmp_path, body, sources=("runtime/runtime.cpp",)):
+    """Compile and run a driver, returning its output lines."""
+    return run_built_driver(build_driver(tmp_path, body, sources))
+
+
+def records(lines, tag):
+    """Integer fields of the output lines starting with tag."""
+    return [tuple(int(field) for field in line.split()[1:]) for line in lines if line.split()[:1] == [tag]]
+
+
+# --- Buffer planning ---
+
+
+PRINT_PLACEMENT = r"""
+// "buffer <id> <begin> <end>" per bound buffer, as offsets into the arena
+static void print_placement(Runtime* runtime, const int* task_of, const int* size_of, int buffers) {
+    uint64_t base = reinterpret_cast<uint64_t>(runtime->get_planned_arena());
+    for (int b = 0; b < buffers; b++) {
+        uint64_t begin = runtime->get_task_args(runtime->get_task(task_of[b]))[0] - base;
+        printf("buffer %d %llu %llu\n", b, (unsigned long long)begin, (unsigned long long)(begin + size_of[b]));
+    }
+    printf("arena %zu\n", runtime->get_planned_arena_size());
+}
+"""
+
+
+def overlaps(a, b):
+    return a[1] < b[2] and b[1] < a[2]
+
+
+@requires_gxx
+class TestBufferPlanner:
+    """plan_buffers() places buffers without overlapping any two that are live together."""
+
+    def test_chain_reuses_dead_buffers(self, tmp_path):
+        """In t0 -> t1 -> t2 -> t3 passing buffers A, B, C along, only A and C may share memory."""
+        lines = run_driver(tmp_path, PRINT_PLACEMENT + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    int sizes[3] = {4096, 1024, 4096};
+    int writers[3];
+    int buffers[3];
+    for (int b = 0; b < 3; b++) {
+        buffers[b] = runtime->add_buffer(sizes[b]);
+    }
+    int previous = -1;
+    for (int t = 0; t < 4; t++) {
+        int task = add_plain_task(runtime);
+        if (previous >= 0) {
+            runtime->add_successor(previous, task);
+            runtime->bind_buffer(task, 1, buffers[t - 1]);  // Reads the previous output
+        }
+        if (t < 3) {
+            runtime->bind_buffer(task, 0, buffers[t]);
+            writers[t] = task;
+        }
+        previous = task;
+    }
+    if (runtime->plan_buffers() != 0) {
+        return 1;
+    }
+    print_placement(runtime, writers, sizes, 3);
+    return 0;
+}
+""")
+        a, b, c = records(lines, "buffer")
+        assert not overlaps(a, b)
+        assert not overlaps(b, c)
+        # A is dead once t1 has run, so C fits into it
+        assert records(lines, "arena")[0][0] < 4096 + 1024 + 4096
+
+    def test_unordered_users_never_share(self, tmp_path):
+        """Buffers written by two independent tasks and read by a third are all live at once."""
+        lines = run_driver(tmp_path, PRINT_PLACEMENT + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    int sizes[3] = {2048, 2048, 512};
+    int writers[3];
+    for (int b = 0; b < 3; b++) {
+        int buffer = runtime->add_buffer(sizes[b]);
+        writers[b] = add_plain_task(runtime);
+        runtime->bind_buffer(writers[b], 0, buffer);
+    }
+    int reader = add_plain_task(runtime);
+    for (int b = 0; b < 3; b++) {
+        runtime->add_successor(writers[b], reader);
+        runtime->bind_buffer(reader, b + 1, b);
+    }
+    if (runtime->plan_buffers() != 0) {
+        return 1;
+    }
+    print_placement(runtime, writers, sizes, 3);
+    return 0;
+}
+""")
+        placed = records(lines, "buffer")
+        for i in range(len(placed)):
+            for j in range(i + 1, len(placed)):
+                assert not overlaps(placed[i], placed[j]), (placed[i], placed[j])
+        assert records(lines, "arena")[0][0] >= 2048 + 2048 + 512
+
+
+# --- Cost model ---
+
+
+PREDICT = r"""
+#include "host/pto_runtime_c_api.h"
+
+extern "C" int predict_runtime_impl(Runtime* runtime, int thread_count, int block_dim, const CostModel* model,
+                                    RuntimePrediction* prediction);
+
+// Kernels take 10 us, or base_us + us_per_byte * args[0] for func_id 1;
+// the scheduler costs nothing
+static CostModel ideal_model() {
+    CostModel model;
+    memset(&model, 0, sizeof(model));
+    model.default_us = 10.0;
+    model.kernels[1].defined = 1;
+    model.kernels[1].bytes_arg = 0;
+    model.kernels[1].base_us = 2.0;
+    model.kernels[1].us_per_byte = 0.01;
+    model.ready_queue_policy = -1;
+    return model;
+}
+
+static int print_prediction(Runtime* runtime, const CostModel& model, int block_dim) {
+    RuntimePrediction prediction;
+    if (predict_runtime_impl(runtime, 1, block_dim, &model, &prediction) != 0) {
+        return 1;
+    }
+    printf("tasks %d\n", prediction.task_count);
+    printf("makespan %lld\n", (long long)(prediction.makespan_us * 1000 + 0.5));
+    printf("critical %lld\n", (long long)(prediction.critical_path_us * 1000 + 0.5));
+    printf("work %lld\n", (long long)(prediction.total_work_us * 1000 + 0.5));
+    return 0;
+}
+"""
+
+
+def prediction(lines):
+    """Prediction fields of a PREDICT driver, times in nanoseconds."""
+    return {tag: records(lines, tag)[0][0] for tag in ("tasks", "makespan", "critical", "work")}
+
+
+@requires_gxx
+class TestCostModel:
+    """predict_runtime_impl() replays a graph with modelled kernel and scheduler latencies."""
+
+    def test_chain_is_latency_bound(self, tmp_path):
+        """With a free scheduler a chain takes exactly the sum of its kernel latencies."""
+        lines = run_driver(tmp_path, PREDICT + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    int previous = -1;
+    for (int t = 0; t < 3; t++) {
+        int task = add_plain_task(runtime);
+        if (previous >= 0) {
+            runtime->add_successor(previous, task);
+        }
+        previous = task;
+    }
+    // func_id 1 with 800 bytes: 2 + 0.01 * 800 = 10 us
+    uint64_t args[4] = {800, 0, 0, 0};
+    runtime->add_successor(previous, runtime->add_task(args, 4, 1, 1));
+    return print_prediction(runtime, ideal_model(), 1);
+}
+""", sources=("runtime/runtime.cpp", "host/cost_model.cpp"))
+        result = prediction(lines)
+        assert result["tasks"] == 4
+        assert result["critical"] == 40000
+        assert result["work"] == 40000
+        assert result["makespan"] == 40000
+
+    def test_independent_tasks_share_the_cores(self, tmp_path):
+        """Four independent AIV tasks on the two AIV cores of one block run in two waves."""
+        lines = run_driver(tmp_path, PREDICT + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    for (int t = 0; t < 4; t++) {
+        add_plain_task(runtime);
+    }
+    return print_prediction(runtime, ideal_model(), 1);
+}
+""", sources=("runtime/runtime.cpp", "host/cost_model.cpp"))
+        result = prediction(lines)
+        assert result["critical"] == 10000
+        assert result["work"] == 40000
+        assert result["makespan"] == 20000
+
+    def test_scheduler_costs_add_to_the_makespan(self, tmp_path):
+        """Dispatch, retire and handshake latencies lengthen a chain beyond its critical path."""
+        lines = run_driver(tmp_path, PREDICT + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    runtime->add_successor(add_plain_task(runtime), add_plain_task(runtime));
+    CostModel model = ideal_model();
+    model.dispatch_us = 1.0;
+    model.complete_us = 1.0;
+    model.handshake_us = 0.5;
+    return print_prediction(runtime, model, 1);
+}
+""", sources=("runtime/runtime.cpp", "host/cost_model.cpp"))
+        result = prediction(lines)
+        assert result["critical"] == 20000
+        assert result["makespan"] > result["critical"]
+
+
+# --- Dependency inference ---
+
+
+PRINT_EDGES = r"""
+// "edge <from> <to>" per packed edge
+static void print_edges(Runtime* runtime) {
+    for (int i = 0; i < runtime->get_task_count(); i++) {
+        Task* task = runtime->get_task(i);
+        for (int j = 0; j < task->fanout_count; j++) {
+            printf("edge %d %d\n", i, runtime->get_fanout(task)[j]);
+        }
+    }
+}
+
+static int add_region_task(Runtime* runtime, const TensorRegion* inputs, int num_inputs,
+                           const TensorRegion* outputs, int num_outputs) {
+    uint64_t args[1] = {0};
+    return runtime->add_task(args, 1, 0, 1, inputs, num_inputs, outputs, num_outputs);
+}
+"""
+
+
+def dropped_edges(lines):
+    """Redundant inferred edges reported by print_runtime()."""
+    for line in lines:
+        if "Redundant inferred edges dropped:" in line:
+            return int(line.split(":")[1])
+    return 0
+
+
+@requires_gxx
+class TestDependencyInference:
+    """add_task() with tensor regions derives edges, and build_graph() drops the redundant inferred ones."""
+
+    def test_infers_raw_war_and_waw(self, tmp_path):
+        """Partially overlapping regions yield exactly the hazards between the overlapping bytes."""
+        lines = run_driver(tmp_path, PRINT_EDGES + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    TensorRegion x0_100{0, 100, -1}, x50_150{50, 100, -1}, x100_200{100, 100, -1}, x0_50{0, 50, -1};
+    TensorRegion x0_10{0, 10, -1};
+    add_region_task(runtime, nullptr, 0, &x0_100, 1);    // t0 writes [0, 100)
+    add_region_task(runtime, &x50_150, 1, nullptr, 0);   // t1 reads [50, 150): after t0
+    add_region_task(runtime, nullptr, 0, &x100_200, 1);  // t2 writes [100, 200): after t1
+    add_region_task(runtime, nullptr, 0, &x0_50, 1);     // t3 writes [0, 50): after t0
+    add_region_task(runtime, &x0_10, 1, nullptr, 0);     // t4 reads [0, 10): after t3 only
+    if (runtime->build_graph() != 0) {
+        return 1;
+    }
+    print_edges(runtime);
+    return 0;
+}
+""")
+        assert set(records(lines, "edge")) == {(0, 1), (1, 2), (0, 3), (3, 4)}
+
+    def test_drops_inferred_edges_implied_by_longer_paths(self, tmp_path):
+        """Of the ten inferred edges, the four implied by longer paths are dropped."""
+        lines = run_driver(tmp_path, PRINT_EDGES + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    TensorRegion a{0, 100, -1}, b{100, 100, -1}, ab{0, 200, -1}, middle{50, 100, -1};
+    add_region_task(runtime, nullptr, 0, &ab, 1);      // t0 writes everything
+    add_region_task(runtime, &a, 1, nullptr, 0);       // t1 reads a: 0->1
+    add_region_task(runtime, &b, 1, nullptr, 0);       // t2 reads b: 0->2
+    add_region_task(runtime, nullptr, 0, &middle, 1);  // t3 writes the middle: 1->3, 2->3
+    add_region_task(runtime, &ab, 1, nullptr, 0);      // t4 reads everything: 0->4, 3->4
+    add_region_task(runtime, &a, 1, &a, 1);            // t5 updates a: 0->5, 1->5, 3->5, 4->5
+    if (runtime->build_graph() != 0) {
+        return 1;
+    }
+    print_edges(runtime);
+    runtime->print_runtime();
+    return 0;
+}
+""")
+        assert set(records(lines, "edge")) == {(0, 1), (0, 2), (1, 3), (2, 3), (3, 4), (4, 5)}
+        assert dropped_edges(lines) == 4
+
+    def test_keeps_edges_added_with_add_successor(self, tmp_path):
+        """A redundant add_successor() edge stays; an inferred edge implied by add_successor() edges goes."""
+        lines = run_driver(tmp_path, PRINT_EDGES + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    TensorRegion x{0, 64, -1};
+    int t0 = add_region_task(runtime, nullptr, 0, &x, 1);
+    int t1 = add_plain_task(runtime);
+    int t2 = add_plain_task(runtime);
+    runtime->add_successor(t0, t1);
+    runtime->add_successor(t1, t2);
+    runtime->add_successor(t0, t2);                        // Redundant, but added by hand
+    int t3 = add_region_task(runtime, &x, 1, nullptr, 0);  // Infers t0->t3
+    runtime->add_successor(t2, t3);                        // ...which this makes redundant
+    if (runtime->build_graph() != 0) {
+        return 1;
+    }
+    print_edges(runtime);
+    runtime->print_runtime();
+    return 0;
+}
+""")
+        assert set(records(lines, "edge")) == {(0, 1), (1, 2), (0, 2), (2, 3)}
+        assert dropped_edges(lines) == 1
+
+
+# --- Chain fusion ---
+
+
+@requires_gxx
+class TestChainFusion:
+    """fuse_chains() absorbs single-successor, single-predecessor tasks of the same core type."""
+
+    def test_fuses_only_linear_same_type_links(self, tmp_path):
+        """t0 -> t1 -> t2 fuse; the fork after t2, the AIC task and the join stay scheduled."""
+        lines = run_driver(tmp_path, PRINT_EDGES + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    uint64_t args[1] = {0};
+    int t[7];
+    for (int i = 0; i < 7; i++) {
+        t[i] = runtime->add_task(args, 1, 0, i == 5 ? 0 : 1);  // t5 runs on the AIC
+    }
+    runtime->add_successor(t[0], t[1]);
+    runtime->add_successor(t[1], t[2]);
+    runtime->add_successor(t[2], t[3]);  // Fork
+    runtime->add_successor(t[2], t[4]);
+    runtime->add_successor(t[3], t[5]);  // Core type changes
+    runtime->add_successor(t[4], t[6]);  // Join
+    runtime->add_successor(t[5], t[6]);
+    printf("absorbed %d\n", runtime->fuse_chains());
+    printf("absorbed_again %d\n", runtime->fuse_chains());
+    printf("scheduled %d\n", runtime->get_scheduled_task_count());
+    for (int i = 0; i < 7; i++) {
+        printf("fused_next %d %d\n", i, runtime->get_task(i)->fused_next);
+    }
+    print_edges(runtime);
+    return 0;
+}
+""")
+        assert records(lines, "absorbed") == [(2,)]
+        assert records(lines, "absorbed_again") == [(0,)]
+        assert records(lines, "scheduled") == [(5,)]
+        chains = {task: following for task, following in records(lines, "fused_next") if following >= 0}
+        assert chains == {0: 1, 1: 2}
+        # The head inherits the successors of the chain's last member
+        assert set(records(lines, "edge")) == {(0, 3), (0, 4), (3, 5), (4, 6), (5, 6)}
+
+    def test_cycle_fails(self, tmp_path):
+        """A dependency cycle is an error, and no task is absorbed."""
+        lines = run_driver(tmp_path, r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    int t0 = add_plain_task(runtime);
+    int t1 = add_plain_task(runtime);
+    int t2 = add_plain_task(runtime);
+    runtime->add_successor(t0, t1);
+    runtime->add_successor(t1, t2);
+    runtime->add_successor(t2, t1);
+    printf("absorbed %d\n", runtime->fuse_chains());
+    printf("scheduled %d\n", runtime->get_scheduled_task_count());
+    return 0;
+}
+""")
+        assert records(lines, "absorbed") == [(-1,)]
+        assert records(lines, "scheduled") == [(3,)]
+
+
+# --- Data-parallel tasks ---
+
+
+@requires_gxx
+class TestParallelTask:
+    """add_parallel_task() adds one task per tile with tile-local arguments and dependencies."""
+
+    def test_tile_arguments(self, tmp_path):
+        """10 elements in tiles of 4: three tasks with shifted operand addresses and sizes 4, 4, 2."""
+        lines = run_driver(tmp_path, r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    int buffer = runtime->add_buffer(10 * sizeof(float));
+    uint64_t args[4] = {0, 0, 77, 0};
+    ParallelOperand operands[] = {
+        {0, TENSOR_IN, 0x10000, -1, sizeof(float)},
+        {1, TENSOR_OUT, 0, buffer, sizeof(float)},
+    };
+    int first = runtime->add_parallel_task(args, 4, 0, 1, operands, 2, 10, 4, 3);
+    if (first < 0 || runtime->plan_buffers() != 0) {
+        return 1;
+    }
+    uint64_t arena = reinterpret_cast<uint64_t>(runtime->get_planned_arena());
+    printf("tasks %d\n", runtime->get_task_count());
+    for (int k = 0; k < runtime->get_task_count(); k++) {
+        uint64_t* tile = runtime->get_task_args(runtime->get_task(first + k));
+        printf("tile %d %llu %llu %llu %llu\n", k, (unsigned long long)tile[0], (unsigned long long)(tile[1] - arena),
+            (unsigned long long)tile[2], (unsigned long long)tile[3]);
+    }
+    return 0;
+}
+""")
+        assert records(lines, "tasks") == [(3,)]
+        assert records(lines, "tile") == [
+            (0, 0x10000, 0, 77, 4),
+            (1, 0x10010, 16, 77, 4),
+            (2, 0x10020, 32, 77, 2),
+        ]
+
+    def test_tiles_wait_only_for_the_tiles_they_read(self, tmp_path):
+        """A stage tiled like its producer waits tile by tile; a coarser stage waits for the tiles it covers."""
+        lines = run_driver(tmp_path, PRINT_EDGES + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    uint64_t args[3] = {0, 0, 0};
+    ParallelOperand produce[] = {{0, TENSOR_OUT, 0x10000, -1, sizeof(float)}};
+    ParallelOperand consume[] = {
+        {0, TENSOR_IN, 0x10000, -1, sizeof(float)},
+        {1, TENSOR_OUT, 0x20000, -1, sizeof(float)},
+    };
+    ParallelOperand reduce[] = {{0, TENSOR_IN, 0x20000, -1, sizeof(float)}};
+    runtime->add_parallel_task(args, 3, 0, 1, produce, 1, 12, 4, 2);  // Tasks 0-2
+    runtime->add_parallel_task(args, 3, 0, 1, consume, 2, 12, 4, 2);  // Tasks 3-5
+    runtime->add_parallel_task(args, 3, 0, 1, reduce, 1, 12, 8, 2);   // Tasks 6-7
+    if (runtime->build_graph() != 0) {
+        return 1;
+    }
+    print_edges(runtime);
+    return 0;
+}
+""")
+        assert set(records(lines, "edge")) == {(0, 3), (1, 4), (2, 5), (3, 6), (4, 6), (5, 7)}
+
+    def test_failing_tile_unwinds_the_stage(self, tmp_path):
+        """A tile past the task limit of a streaming runtime drops the stage's earlier tiles and their edges."""
+        lines = run_driver(tmp_path, PRINT_EDGES + r"""
+int main() {
+    Runtime* runtime = new_runtime();
+    if (runtime->begin_streaming(5) != 0) {
+        return 1;
+    }
+    uint64_t args[3] = {0, 0, 0};
+    ParallelOperand produce[] = {{0, TENSOR_OUT, 0x10000, -1, sizeof(float)}};
+    ParallelOperand consume[] = {
+        {0, TENSOR_IN, 0x10000, -1, sizeof(float)},
+        {1, TENSOR_OUT, 0x20000, -1, sizeof(float)},
+    };
+    runtime->add_parallel_task(args, 3, 0, 1, produce, 1, 8, 4, 2);  // Tasks 0-1
+    printf("before %d %d\n", runtime->get_task_count(), runtime->get_edge_count());
+    // Tiles 2-4 fit, tile 5 does not
+    printf("rc %d\n", runtime->add_parallel_task(args, 3, 0, 1, consume, 2, 16, 4, 2));
+    printf("after %d %d\n", runtime->get_task_count(), runtime->get_edge_count());
+    // The tensor map and producer fanouts are as before the failed stage
+    printf("rc %d\n", runtime->add_parallel_task(args, 3, 0, 1, consume, 2, 8, 4, 2));  // Tasks 2-3
+    TensorRegion out{0x20000, 8 * sizeof(float), -1};
+    add_region_task(runtime, &out, 1, nullptr, 0);  // Task 4
+    runtime->seal_graph();
+    print_edges(runtime);
+    return 0;
+}
+""")
+        assert records(lines, "before") == [(2, 0)]
+        assert records(lines, "rc") == [(-1,), (2,)]
+        assert records(lines, "after") == [(2, 0)]
+        assert set(records(lines, "edge")) == {(0, 2), (1, 3), (2, 4), (3, 4)}
+
+
+# --- Graph files ---
+
+
+GRAPH_FILE_DRIVER = PRINT_EDGES + r"""
+#include <sys/mman.h>
+
+#include <cstddef>
+
+extern "C" int save_graph_impl(Runtime* runtime, const char* path, const GraphTensor* tensors, int tensor_count);
+extern "C" int load_graph_impl(Runtime* runtime, const char* path, const uint64_t* host_tensors,
+                               int host_tensor_count);
+
+static float tensor[64];  // Stands in for a device allocation
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        return 1;
+    }
+    Runtime* runtime = new_runtime();
+    if (strcmp(argv[1], "save") == 0) {
+        // Diamond t0 -> {t1, t2} -> t3, every task reading its own quarter of the tensor
+        uint64_t base = reinterpret_cast<uint64_t>(tensor);
+        for (int i = 0; i < 4; i++) {
+            uint64_t args[2] = {base + i * 16 * sizeof(float), 16};
+            runtime->add_task(args, 2, 0, 1);
+        }
+        runtime->add_successor(0, 1);
+        runtime->add_successor(0, 2);
+        runtime->add_successor(1, 3);
+        runtime->add_successor(2, 3);
+        GraphTensor slot{base, sizeof(tensor)};
+        printf("save %d\n", save_graph_impl(runtime, argv[2], &slot, 1));
+        printf("layout %zu %zu %zu\n", sizeof(Task), offsetof(Task, task_id), offsetof(Task, initial_fanin));
+    } else {
+        int rc = load_graph_impl(runtime, argv[2], nullptr, 0);
+        printf("load %d\n", rc);
+        if (rc != 0) {
+            return 0;
+        }
+        print_edges(runtime);
+        // The runtime lets go of the mapped file before it is unmapped
+        size_t size = 0;
+        void* mapping = runtime->detach_graph(&size);
+        printf("detach %d %d\n", mapping != nullptr && size > 0, runtime->get_task_count());
+        printf("detach %d %d\n", runtime->detach_graph(nullptr) != nullptr, runtime->get_task_count());
+        munmap(mapping, size);
+        delete runtime;
+        return 0;
+    }
+    print_edges(runtime);
+    return 0;
+}
+"""
+
+# magic, version, header_size, task_size, task/edge/arg/fused/tensor/reloc/func counts,
+# tasks/edges/args/tensors/relocs/funcs offsets, file_size (GraphFileHeader)
+GRAPH_FILE_HEADER = struct.Struct("<8s3I7i7Q")
+
+
+def corrupt_graph_file(data, corruption, layout):
+    """Damage a saved diamond graph file in one of the ways load_graph() must reject."""
+    header = GRAPH_FILE_HEADER.unpack_from(data)
+    tasks_offset, edges_offset = header[11], header[12]
+    task_size, task_id_offset, initial_fanin_offset = layout
+    if corruption == "magic":
+        data[0:8] = b"NOTGRAPH"
+    elif corruption == "truncated":
+        del data[-8:]
+    elif corruption == "edge_target":
+        struct.pack_into("<i", data, edges_offset, 4)
+    elif corruption == "task_id":
+        struct.pack_into("<i", data, tasks_offset + 2 * task_size + task_id_offset, 1)
+    elif corruption == "initial_fanin":
+        struct.pack_into("<i", data, tasks_offset + 3 * task_size + initial_fanin_offset, 1)
+    return data
+
+
+@requires_gxx
+class TestGraphFile:
+    """save_graph_impl() and load_graph_impl() round-trip a built graph and reject damaged files."""
+
+    def save(self, tmp_path):
+        exe = build_driver(tmp_path, GRAPH_FILE_DRIVER, sources=("runtime/runtime.cpp", "host/graph_file.cpp"))
+        path = tmp_path / "graph.ptog"
+        lines = run_built_driver(exe, "save", path)
+        assert records(lines, "save") == [(0,)]
+        return exe, path, records(lines, "layout")[0], set(records(lines, "edge"))
+
+    def test_round_trip(self, tmp_path):
+        """A loaded graph has the edges of the saved one."""
+        exe, path, _, saved_edges = self.save(tmp_path)
+        lines = run_built_driver(exe, "load", path)
+        assert records(lines, "load") == [(0,)]
+        assert set(records(lines, "edge")) == saved_edges == {(0, 1), (0, 2), (1, 3), (2, 3)}
+        assert records(lines, "detach") == [(1, 0), (0, 0)]
+
+    @pytest.mark.parametrize("corruption", ["magic", "truncated", "edge_target", "task_id", "initial_fanin"])
+    def test_rejects_corrupt_file(self, tmp_path, corruption):
+        """Bad magic, size, edge targets, task ids or fanin counts fail the load."""
+        exe, path, layout, _ = self.save(tmp_path)
+        path.write_bytes(bytes(corrupt_graph_file(bytearray(path.read_bytes()), corruption, layout)))
+        lines = run_built_driver(exe, "load", path)
+        assert records(lines, "load") == [(-1,)]
@@ -0,0 +1,116 @@
+"""Tests for the persistent executor of the host_build_graph runtime on a2a3sim.
+
+The runtime, an orchestration and a kernel are built for the simulator and
+graphs are submitted to executors kept resident with
+start_persistent_executor().
+"""
+
+import array
+import shutil
+import sys
+from pathlib import Path
+
+import pytest
+
+PROJECT_ROOT = Path(__file__).parent.parent
+sys.path.insert(0, str(PROJECT_ROOT / "python"))
+
+from elf_parser import extract_text_section  # noqa: E402
+
+requires_gxx = pytest.mark.skipif(shutil.which("g++") is None, reason="g++ not found")
+
+SIM_KERNELS = PROJECT_ROOT / "examples" / "host_build_graph_sim_example" / "kernels" / "aiv"
+
+# f = a + 1 with a single task
+# args: [host_a, host_f, bytes, elements, scheduling_mode, core_type]
+ADD_ONE_ORCH = r"""
+#include <cstring>
+
+#include "runtime.h"
+
+extern "C" int build_add_one(Runtime* runtime, uint64_t* args, int arg_count) {
+    if (arg_count < 6) {
+        return -1;
+    }
+    size_t size = static_cast<size_t>(args[2]);
+    void* dev_a = runtime->host_api.device_malloc(size);
+    void* dev_f = runtime->host_api.device_malloc(size);
+    if (dev_a == nullptr || dev_f == nullptr) {
+        return -1;
+    }
+    runtime->host_api.copy_to_device(dev_a, reinterpret_cast<void*>(args[0]), size);
+    runtime->record_tensor_pair(reinterpret_cast<void*>(args[1]), dev_f, size);
+    runtime->scheduling_mode = static_cast<int>(args[4]);
+
+    float one = 1.0f;
+    uint32_t one_bits;
+    memcpy(&one_bits, &one, sizeof(one_bits));
+    uint64_t task_args[4] = {reinterpret_cast<uint64_t>(dev_a), one_bits, reinterpret_cast<uint64_t>(dev_f), args[3]};
+    return runtime->add_task(task_args, 4, 0, static_cast<int>(args[5])) < 0 ? -1 : 0;
+}
+"""
+
+ELEMENTS = 1024
+BLOCK_DIM = 2
+
+
+@pytest.fixture(scope="module")
+def sim(tmp_path_factory):
+    """Build the runtime for a2a3sim, register kernel_add_scalar and compile ADD_ONE_ORCH."""
+    from bindings import bind_host_binary, register_kernel, set_device
+    from runtime_builder import RuntimeBuilder
+
+    builder = RuntimeBuilder(platform="a2a3sim")
+    compiler = builder.get_pto_compiler()
+    host, aicpu, aicore = builder.build("host_build_graph")
+    runtime_class = bind_host_binary(host)
+    set_device(0)
+
+    source = tmp_path_factory.mktemp("orch") / "add_one_orch.cpp"
+    source.write_text(ADD_ONE_ORCH)
+    include_dirs = [str(PROJECT_ROOT / "src" / "runtime" / "host_build_graph" / "runtime")]
+    orch = compiler.compile_orchestration(
+        str(source), extra_include_dirs=include_dirs + compiler.get_platform_include_dirs()
+    )
+    kernel = compiler.compile_incore(str(SIM_KERNELS / "kernel_add_scalar.cpp"), core_type="aiv")
+    register_kernel(0, extract_text_section(kernel))
+    return runtime_class, orch, aicpu, aicore
+
+
+def launch_add_one(sim, scheduling_mode=0, core_type=1):
+    """Build and launch an ADD_ONE_ORCH graph; return f, or raise RuntimeError if the launch fails."""
+    from bindings import host_buffer, launch_runtime
+
+    runtime_class, orch, aicpu, aicore = sim
+    a = array.array("f", [float(i) for i in range(ELEMENTS)])
+    f = array.array("f", [0.0] * ELEMENTS)
+    pa, size = host_buffer(a)
+    pf, _ = host_buffer(f)
+    runtime = runtime_class()
+    runtime.initialize(orch, "build_add_one", [pa, pf, size, ELEMENTS, scheduling_mode, core_type])
+    try:
+        launch_runtime(runtime, aicpu_thread_num=2, block_dim=BLOCK_DIM, device_id=0,
+                       aicpu_binary=aicpu, aicore_binary=aicore)
+    finally:
+        runtime.finalize()
+    return f
+
+
+@requires_gxx
+class TestPersistentExecutor:
+    """Failed submissions must leave the resident executors usable."""
+
+    def test_rejected_graph_then_valid_graph(self, sim):
+        from bindings import start_persistent_executor, stop_persistent_executor
+
+        _, _, aicpu, aicore = sim
+        start_persistent_executor(2, BLOCK_DIM, 0, aicpu, aicore)
+        try:
+            # Whole-block tasks cannot be pulled by the AICores
+            with pytest.raises(RuntimeError):
+                launch_add_one(sim, scheduling_mode=1, core_type=2)
+            for scheduling_mode in (0, 1):
+                f = launch_add_one(sim, scheduling_mode=scheduling_mode)
+                assert list(f) == [float(i) + 1.0 for i in range(ELEMENTS)]
+        finally:
+            stop_persistent_executor(0)